@@ -554,6 +554,8 @@ std::string ParseOrderBook(MarketManager* market, const OrderBook* order_book_pt
     csv.append(ParseOrderBookLevels(market, (*order_book_ptr).sell_stop(), "SELL_STOP"));
     csv.append(ParseOrderBookLevels(market, (*order_book_ptr).trailing_buy_stop(), "TRAILING_BUY_STOP"));
     csv.append(ParseOrderBookLevels(market, (*order_book_ptr).trailing_sell_stop(), "TRAILING_SELL_STOP"));
+    csv.append(ParseOrderBookLevels(market, (*order_book_ptr).trailing_buy_distance(), "TRAILING_BUY_DISTANCE"));
+    csv.append(ParseOrderBookLevels(market, (*order_book_ptr).trailing_sell_distance(), "TRAILING_SELL_DISTANCE"));
 
     return csv;
 }
@@ -0,0 +1,162 @@
+/*!
+    \file depth_cache.h
+    \brief Depth cache definition
+    \author Ivan Shynkarenka
+    \date 29.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_DEPTH_CACHE_H
+#define CPPTRADER_MATCHING_DEPTH_CACHE_H
+
+#include "level.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace CppTrader {
+namespace Matching {
+
+//! Depth price level
+/*!
+    Depth price level is a compact copy of the price level kept in the depth cache.
+*/
+template <typename TPrice, typename TQuantity>
+struct DepthLevelT
+{
+    //! Level price
+    TPrice Price;
+    //! Level visible volume
+    TQuantity VisibleVolume;
+    //! Level hidden volume
+    TQuantity HiddenVolume;
+    //! Level orders
+    size_t Orders;
+};
+
+//! Depth span
+/*!
+    Depth span is a non-owning view of contiguous depth price levels sorted
+    from the best one. Depth span is valid until the next modification of
+    the order book.
+*/
+template <typename TPrice, typename TQuantity>
+class DepthSpanT
+{
+public:
+    //! Depth price level type
+    typedef DepthLevelT<TPrice, TQuantity> DepthLevel;
+
+    DepthSpanT(const DepthLevel* data, size_t size) noexcept : _data(data), _size(size) {}
+    DepthSpanT(const DepthSpanT&) noexcept = default;
+    DepthSpanT(DepthSpanT&&) noexcept = default;
+    ~DepthSpanT() noexcept = default;
+
+    DepthSpanT& operator=(const DepthSpanT&) noexcept = default;
+    DepthSpanT& operator=(DepthSpanT&&) noexcept = default;
+
+    //! Check if the depth span is not empty
+    explicit operator bool() const noexcept { return !empty(); }
+
+    //! Get the depth price level with the given index (0 is the best one)
+    const DepthLevel& operator[](size_t index) const noexcept { return _data[index]; }
+
+    //! Is the depth span empty?
+    bool empty() const noexcept { return (_size == 0); }
+    //! Get the depth span size
+    size_t size() const noexcept { return _size; }
+    //! Get the depth span data
+    const DepthLevel* data() const noexcept { return _data; }
+
+    const DepthLevel* begin() const noexcept { return _data; }
+    const DepthLevel* end() const noexcept { return _data + _size; }
+
+private:
+    const DepthLevel* _data;
+    size_t _size;
+};
+
+//! Depth cache
+/*!
+    Depth cache keeps a fixed count of the best price levels of one side of
+    the order book in a contiguous array. It is updated in place from price
+    level updates, so the top of the order book could be copied without
+    walking the price levels container.
+
+    The depth cache keeps the best min(capacity, levels) price levels of the
+    order book side. When a cached price level is deleted from the full cache
+    the order book appends the next price level with Append() method.
+
+    Not thread-safe.
+*/
+template <typename TPrice, typename TQuantity>
+class DepthCacheT
+{
+public:
+    //! Depth price level type
+    typedef DepthLevelT<TPrice, TQuantity> DepthLevel;
+    //! Depth span type
+    typedef DepthSpanT<TPrice, TQuantity> DepthSpan;
+    //! Price level type
+    typedef LevelT<TPrice, TQuantity> Level;
+
+    explicit DepthCacheT(LevelType type) noexcept : _type(type), _capacity(0) {}
+    DepthCacheT(const DepthCacheT&) = delete;
+    DepthCacheT(DepthCacheT&&) = delete;
+    ~DepthCacheT() = default;
+
+    DepthCacheT& operator=(const DepthCacheT&) = delete;
+    DepthCacheT& operator=(DepthCacheT&&) = delete;
+
+    //! Is the depth cache enabled?
+    bool enabled() const noexcept { return (_capacity > 0); }
+    //! Is the depth cache empty?
+    bool empty() const noexcept { return _levels.empty(); }
+    //! Is the depth cache full?
+    bool full() const noexcept { return (_levels.size() == _capacity); }
+    //! Get the depth cache capacity
+    size_t capacity() const noexcept { return _capacity; }
+    //! Get the depth cache size
+    size_t size() const noexcept { return _levels.size(); }
+    //! Get the depth span of cached price levels
+    DepthSpan span() const noexcept { return DepthSpan(_levels.data(), _levels.size()); }
+    //! Get the worst cached price level
+    const DepthLevel& back() const noexcept { return _levels.back(); }
+
+    //! Reset the depth cache with the given capacity
+    /*!
+        \param capacity - Depth cache capacity (0 to disable the depth cache)
+    */
+    void Reset(size_t capacity);
+
+    //! Append the price level worse than all cached ones
+    /*!
+        \param level - Price level to append
+    */
+    void Append(const Level& level);
+
+    //! Update the depth cache with the given price level update
+    /*!
+        \param type - Update type
+        \param level - Updated price level
+        \return 'true' if the price level was deleted from the full depth cache and the next price level should be appended
+    */
+    bool Update(UpdateType type, const Level& level);
+
+private:
+    LevelType _type;
+    size_t _capacity;
+    std::vector<DepthLevel> _levels;
+
+    // Find the position of the given price in the depth cache
+    typename std::vector<DepthLevel>::iterator Find(TPrice price) noexcept;
+    static DepthLevel Convert(const Level& level) noexcept;
+};
+
+} // namespace Matching
+} // namespace CppTrader
+
+#include "depth_cache.inl"
+
+#endif // CPPTRADER_MATCHING_DEPTH_CACHE_H
@@ -0,0 +1,89 @@
+/*!
+    \file depth_cache.inl
+    \brief Depth cache inline implementation
+    \author Ivan Shynkarenka
+    \date 29.08.2017
+    \copyright MIT License
+*/
+
+namespace CppTrader {
+namespace Matching {
+
+template <typename TPrice, typename TQuantity>
+inline void DepthCacheT<TPrice, TQuantity>::Reset(size_t capacity)
+{
+    _capacity = capacity;
+    _levels.clear();
+    _levels.shrink_to_fit();
+    _levels.reserve(capacity);
+}
+
+template <typename TPrice, typename TQuantity>
+inline void DepthCacheT<TPrice, TQuantity>::Append(const Level& level)
+{
+    assert(!full() && "Depth cache is full!");
+    if (full())
+        return;
+
+    _levels.push_back(Convert(level));
+}
+
+template <typename TPrice, typename TQuantity>
+inline bool DepthCacheT<TPrice, TQuantity>::Update(UpdateType type, const Level& level)
+{
+    auto it = Find(level.Price);
+    bool found = (it != _levels.end()) && (it->Price == level.Price);
+
+    switch (type)
+    {
+        case UpdateType::ADD:
+        {
+            // Price levels worse than all cached ones are not cached in the full depth cache
+            if (found || (full() && (it == _levels.end())))
+                return false;
+
+            // Drop the worst cached price level from the full depth cache
+            if (full())
+                _levels.pop_back();
+
+            _levels.insert(Find(level.Price), Convert(level));
+            return false;
+        }
+        case UpdateType::UPDATE:
+        {
+            if (found)
+                *it = Convert(level);
+            return false;
+        }
+        case UpdateType::DELETE:
+        {
+            if (!found)
+                return false;
+
+            bool refill = full();
+            _levels.erase(it);
+            return refill;
+        }
+        default:
+            return false;
+    }
+}
+
+template <typename TPrice, typename TQuantity>
+inline typename std::vector<typename DepthCacheT<TPrice, TQuantity>::DepthLevel>::iterator DepthCacheT<TPrice, TQuantity>::Find(TPrice price) noexcept
+{
+    // Cached price levels are sorted from the best one
+    if (_type == LevelType::BID)
+        return std::lower_bound(_levels.begin(), _levels.end(), price, [](const DepthLevel& level, TPrice value) { return level.Price > value; });
+    else
+        return std::lower_bound(_levels.begin(), _levels.end(), price, [](const DepthLevel& level, TPrice value) { return level.Price < value; });
+}
+
+template <typename TPrice, typename TQuantity>
+inline typename DepthCacheT<TPrice, TQuantity>::DepthLevel DepthCacheT<TPrice, TQuantity>::Convert(const Level& level) noexcept
+{
+    return DepthLevel{ level.Price, level.VisibleVolume, level.HiddenVolume, level.Orders };
+}
+
+} // namespace Matching
+} // namespace CppTrader
@@ -0,0 +1,110 @@
+/*!
+    \file epoch_manager.h
+    \brief Epoch manager definition
+    \author Ivan Shynkarenka
+    \date 28.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_EPOCH_MANAGER_H
+#define CPPTRADER_MATCHING_EPOCH_MANAGER_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace CppTrader {
+namespace Matching {
+
+//! Epoch manager
+/*!
+    Epoch manager is used for epoch-based reclamation of objects shared with
+    reader threads. Each reader thread registers its own slot and marks its
+    read-side critical sections with Enter() and Leave() methods. The writer
+    unlinks a shared object, remembers the current epoch as the object retire
+    epoch and advances the global epoch. The retired object could be safely
+    reclaimed when its retire epoch is less than the safe epoch, so no active
+    reader could still hold it.
+
+    Thread-safe. Register(), Unregister(), Enter() and Leave() methods could
+    be called from any reader thread, Advance() and GetSafeEpoch() methods
+    must be called from a single writer thread.
+*/
+class EpochManager
+{
+public:
+    //! Initialize epoch manager with the given count of reader slots
+    /*!
+        \param readers - Reader slots count (default is 64)
+    */
+    explicit EpochManager(size_t readers = 64);
+    EpochManager(const EpochManager&) = delete;
+    EpochManager(EpochManager&&) = delete;
+    ~EpochManager() = default;
+
+    EpochManager& operator=(const EpochManager&) = delete;
+    EpochManager& operator=(EpochManager&&) = delete;
+
+    //! Get the reader slots count
+    size_t readers() const noexcept { return _readers; }
+    //! Get the current global epoch
+    uint64_t epoch() const noexcept { return _epoch.load(std::memory_order_acquire); }
+
+    //! Register a new reader
+    /*!
+        \return Reader slot index or readers() if there are no free slots
+    */
+    size_t Register() noexcept;
+    //! Unregister the reader
+    /*!
+        \param slot - Reader slot index
+    */
+    void Unregister(size_t slot) noexcept;
+
+    //! Enter the read-side critical section
+    /*!
+        \param slot - Reader slot index
+    */
+    void Enter(size_t slot) noexcept;
+    //! Leave the read-side critical section
+    /*!
+        \param slot - Reader slot index
+    */
+    void Leave(size_t slot) noexcept;
+
+    //! Advance the global epoch
+    /*!
+        \return Previous global epoch which should be used as a retire epoch of unlinked objects
+    */
+    uint64_t Advance() noexcept;
+
+    //! Get the safe epoch
+    /*!
+        Objects retired before the safe epoch are not reachable by any reader.
+
+        \return The minimal epoch of active readers or the current global epoch if there are no active readers
+    */
+    uint64_t GetSafeEpoch() const noexcept;
+
+private:
+    // Reader slot
+    struct alignas(64) Slot
+    {
+        std::atomic<bool> Used;
+        std::atomic<uint64_t> Epoch;
+    };
+
+    size_t _readers;
+    std::unique_ptr<Slot[]> _slots;
+    alignas(64) std::atomic<uint64_t> _epoch;
+};
+
+} // namespace Matching
+} // namespace CppTrader
+
+#include "epoch_manager.inl"
+
+#endif // CPPTRADER_MATCHING_EPOCH_MANAGER_H
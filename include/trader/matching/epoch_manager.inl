@@ -0,0 +1,77 @@
+/*!
+    \file epoch_manager.inl
+    \brief Epoch manager inline implementation
+    \author Ivan Shynkarenka
+    \date 28.08.2017
+    \copyright MIT License
+*/
+
+namespace CppTrader {
+namespace Matching {
+
+inline EpochManager::EpochManager(size_t readers)
+    : _readers(readers),
+      _slots(new Slot[readers]),
+      _epoch(1)
+{
+    // Inactive reader slot has zero epoch
+    for (size_t i = 0; i < _readers; ++i)
+    {
+        _slots[i].Used.store(false, std::memory_order_relaxed);
+        _slots[i].Epoch.store(0, std::memory_order_relaxed);
+    }
+}
+
+inline size_t EpochManager::Register() noexcept
+{
+    for (size_t i = 0; i < _readers; ++i)
+    {
+        bool used = false;
+        if (!_slots[i].Used.load(std::memory_order_relaxed) && _slots[i].Used.compare_exchange_strong(used, true, std::memory_order_acquire))
+            return i;
+    }
+
+    assert(false && "No free reader slots!");
+    return _readers;
+}
+
+inline void EpochManager::Unregister(size_t slot) noexcept
+{
+    assert((slot < _readers) && "Invalid reader slot!");
+    if (slot >= _readers)
+        return;
+
+    _slots[slot].Epoch.store(0, std::memory_order_release);
+    _slots[slot].Used.store(false, std::memory_order_release);
+}
+
+inline void EpochManager::Enter(size_t slot) noexcept
+{
+    // Announce the reader epoch before loading any shared pointer
+    _slots[slot].Epoch.store(_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+}
+
+inline void EpochManager::Leave(size_t slot) noexcept
+{
+    _slots[slot].Epoch.store(0, std::memory_order_release);
+}
+
+inline uint64_t EpochManager::Advance() noexcept
+{
+    return _epoch.fetch_add(1, std::memory_order_seq_cst);
+}
+
+inline uint64_t EpochManager::GetSafeEpoch() const noexcept
+{
+    uint64_t safe = _epoch.load(std::memory_order_seq_cst);
+    for (size_t i = 0; i < _readers; ++i)
+    {
+        uint64_t epoch = _slots[i].Epoch.load(std::memory_order_seq_cst);
+        if ((epoch != 0) && (epoch < safe))
+            safe = epoch;
+    }
+    return safe;
+}
+
+} // namespace Matching
+} // namespace CppTrader
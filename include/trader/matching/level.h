@@ -28,45 +28,49 @@ template <class TOutputStream>
 TOutputStream& operator<<(TOutputStream& stream, LevelType type);
 
 //! Price level
-struct Level
+/*!
+    Price level is parametrized with the same price and quantity types as orders.
+*/
+template <typename TPrice, typename TQuantity>
+struct LevelT
 {
     //! Level type
     LevelType Type;
     //! Level price
-    uint64_t Price;
+    TPrice Price;
     //! Level volume
-    uint64_t TotalVolume;
+    TQuantity TotalVolume;
     //! Level hidden volume
-    uint64_t HiddenVolume;
+    TQuantity HiddenVolume;
     //! Level visible volume
-    uint64_t VisibleVolume;
+    TQuantity VisibleVolume;
     //! Level orders
     size_t Orders;
 
-    Level(LevelType type, uint64_t price) noexcept;
-    Level(const Level&) noexcept = default;
-    Level(Level&&) noexcept = default;
-    ~Level() noexcept = default;
+    LevelT(LevelType type, TPrice price) noexcept;
+    LevelT(const LevelT&) noexcept = default;
+    LevelT(LevelT&&) noexcept = default;
+    ~LevelT() noexcept = default;
 
-    Level& operator=(const Level&) noexcept = default;
-    Level& operator=(Level&&) noexcept = default;
+    LevelT& operator=(const LevelT&) noexcept = default;
+    LevelT& operator=(LevelT&&) noexcept = default;
 
     // Price level comparison
-    friend bool operator==(const Level& level1, const Level& level2) noexcept
+    friend bool operator==(const LevelT& level1, const LevelT& level2) noexcept
     { return level1.Price == level2.Price; }
-    friend bool operator!=(const Level& level1, const Level& level2) noexcept
+    friend bool operator!=(const LevelT& level1, const LevelT& level2) noexcept
     { return level1.Price != level2.Price; }
-    friend bool operator<(const Level& level1, const Level& level2) noexcept
+    friend bool operator<(const LevelT& level1, const LevelT& level2) noexcept
     { return level1.Price < level2.Price; }
-    friend bool operator>(const Level& level1, const Level& level2) noexcept
+    friend bool operator>(const LevelT& level1, const LevelT& level2) noexcept
     { return level1.Price > level2.Price; }
-    friend bool operator<=(const Level& level1, const Level& level2) noexcept
+    friend bool operator<=(const LevelT& level1, const LevelT& level2) noexcept
     { return level1.Price <= level2.Price; }
-    friend bool operator>=(const Level& level1, const Level& level2) noexcept
+    friend bool operator>=(const LevelT& level1, const LevelT& level2) noexcept
     { return level1.Price >= level2.Price; }
 
-    template <class TOutputStream>
-    friend TOutputStream& operator<<(TOutputStream& stream, const Level& level);
+    template <class TOutputStream, typename P, typename Q>
+    friend TOutputStream& operator<<(TOutputStream& stream, const LevelT<P, Q>& level);
 
     //! Is the bid price level?
     bool IsBid() const noexcept { return Type == LevelType::BID; }
@@ -74,59 +78,70 @@ struct Level
     bool IsAsk() const noexcept { return Type == LevelType::ASK; }
 };
 
+//! Price level with 64-bit prices and quantities
+typedef LevelT<uint64_t, uint64_t> Level;
+
 //! Price level node
-struct LevelNode : public Level, public CppCommon::BinTreeAVL<LevelNode>::Node
+template <typename TPrice, typename TQuantity>
+struct LevelNodeT : public LevelT<TPrice, TQuantity>, public CppCommon::BinTreeAVL<LevelNodeT<TPrice, TQuantity>>::Node
 {
     //! Price level orders
-    CppCommon::List<OrderNode> OrderList;
+    CppCommon::List<OrderNodeT<TPrice, TQuantity>> OrderList;
 
-    LevelNode(LevelType type, uint64_t price) noexcept;
-    LevelNode(const Level& level) noexcept;
-    LevelNode(const LevelNode&) noexcept = default;
-    LevelNode(LevelNode&&) noexcept = default;
-    ~LevelNode() noexcept = default;
+    LevelNodeT(LevelType type, TPrice price) noexcept;
+    LevelNodeT(const LevelT<TPrice, TQuantity>& level) noexcept;
+    LevelNodeT(const LevelNodeT&) noexcept = default;
+    LevelNodeT(LevelNodeT&&) noexcept = default;
+    ~LevelNodeT() noexcept = default;
 
-    LevelNode& operator=(const Level& level) noexcept;
-    LevelNode& operator=(const LevelNode&) noexcept = default;
-    LevelNode& operator=(LevelNode&&) noexcept = default;
+    LevelNodeT& operator=(const LevelT<TPrice, TQuantity>& level) noexcept;
+    LevelNodeT& operator=(const LevelNodeT&) noexcept = default;
+    LevelNodeT& operator=(LevelNodeT&&) noexcept = default;
 
     // Price level comparison
-    friend bool operator==(const LevelNode& level1, const LevelNode& level2) noexcept
+    friend bool operator==(const LevelNodeT& level1, const LevelNodeT& level2) noexcept
     { return level1.Price == level2.Price; }
-    friend bool operator!=(const LevelNode& level1, const LevelNode& level2) noexcept
+    friend bool operator!=(const LevelNodeT& level1, const LevelNodeT& level2) noexcept
     { return level1.Price != level2.Price; }
-    friend bool operator<(const LevelNode& level1, const LevelNode& level2) noexcept
+    friend bool operator<(const LevelNodeT& level1, const LevelNodeT& level2) noexcept
     { return level1.Price < level2.Price; }
-    friend bool operator>(const LevelNode& level1, const LevelNode& level2) noexcept
+    friend bool operator>(const LevelNodeT& level1, const LevelNodeT& level2) noexcept
     { return level1.Price > level2.Price; }
-    friend bool operator<=(const LevelNode& level1, const LevelNode& level2) noexcept
+    friend bool operator<=(const LevelNodeT& level1, const LevelNodeT& level2) noexcept
     { return level1.Price <= level2.Price; }
-    friend bool operator>=(const LevelNode& level1, const LevelNode& level2) noexcept
+    friend bool operator>=(const LevelNodeT& level1, const LevelNodeT& level2) noexcept
     { return level1.Price >= level2.Price; }
 };
 
+//! Price level node with 64-bit prices and quantities
+typedef LevelNodeT<uint64_t, uint64_t> LevelNode;
+
 //! Price level update
-struct LevelUpdate
+template <typename TPrice, typename TQuantity>
+struct LevelUpdateT
 {
     //! Update type
     UpdateType Type;
     //! Level update value
-    Level Update;
+    LevelT<TPrice, TQuantity> Update;
     //! Top of the book flag
     bool Top;
 
-    LevelUpdate(UpdateType type, const Level& update, bool top) noexcept;
-    LevelUpdate(const LevelUpdate&) noexcept = default;
-    LevelUpdate(LevelUpdate&&) noexcept = default;
-    ~LevelUpdate() noexcept = default;
+    LevelUpdateT(UpdateType type, const LevelT<TPrice, TQuantity>& update, bool top) noexcept;
+    LevelUpdateT(const LevelUpdateT&) noexcept = default;
+    LevelUpdateT(LevelUpdateT&&) noexcept = default;
+    ~LevelUpdateT() noexcept = default;
 
-    LevelUpdate& operator=(const LevelUpdate&) noexcept = default;
-    LevelUpdate& operator=(LevelUpdate&&) noexcept = default;
+    LevelUpdateT& operator=(const LevelUpdateT&) noexcept = default;
+    LevelUpdateT& operator=(LevelUpdateT&&) noexcept = default;
 
-    template <class TOutputStream>
-    friend TOutputStream& operator<<(TOutputStream& stream, const LevelUpdate& update);
+    template <class TOutputStream, typename P, typename Q>
+    friend TOutputStream& operator<<(TOutputStream& stream, const LevelUpdateT<P, Q>& update);
 };
 
+//! Price level update with 64-bit prices and quantities
+typedef LevelUpdateT<uint64_t, uint64_t> LevelUpdate;
+
 } // namespace Matching
 } // namespace CppTrader
 
@@ -27,7 +27,8 @@ inline TOutputStream& operator<<(TOutputStream& stream, LevelType type)
     return stream;
 }
 
-inline Level::Level(LevelType type, uint64_t price) noexcept
+template <typename TPrice, typename TQuantity>
+inline LevelT<TPrice, TQuantity>::LevelT(LevelType type, TPrice price) noexcept
     : Type(type),
       Price(price),
       TotalVolume(0),
@@ -37,8 +38,8 @@ inline Level::Level(LevelType type, uint64_t price) noexcept
 {
 }
 
-template <class TOutputStream>
-inline TOutputStream& operator<<(TOutputStream& stream, const Level& level)
+template <class TOutputStream, typename TPrice, typename TQuantity>
+inline TOutputStream& operator<<(TOutputStream& stream, const LevelT<TPrice, TQuantity>& level)
 {
     stream << "Level(Type=" << level.Type
         << "; Price=" << level.Price
@@ -50,31 +51,35 @@ inline TOutputStream& operator<<(TOutputStream& stream, const Level& level)
     return stream;
 }
 
-inline LevelNode::LevelNode(LevelType type, uint64_t price) noexcept
-    : Level(type, price)
+template <typename TPrice, typename TQuantity>
+inline LevelNodeT<TPrice, TQuantity>::LevelNodeT(LevelType type, TPrice price) noexcept
+    : LevelT<TPrice, TQuantity>(type, price)
 {
 }
 
-inline LevelNode::LevelNode(const Level& level) noexcept : Level(level)
+template <typename TPrice, typename TQuantity>
+inline LevelNodeT<TPrice, TQuantity>::LevelNodeT(const LevelT<TPrice, TQuantity>& level) noexcept : LevelT<TPrice, TQuantity>(level)
 {
 }
 
-inline LevelNode& LevelNode::operator=(const Level& level) noexcept
+template <typename TPrice, typename TQuantity>
+inline LevelNodeT<TPrice, TQuantity>& LevelNodeT<TPrice, TQuantity>::operator=(const LevelT<TPrice, TQuantity>& level) noexcept
 {
-    Level::operator=(level);
+    LevelT<TPrice, TQuantity>::operator=(level);
     OrderList.clear();
     return *this;
 }
 
-inline LevelUpdate::LevelUpdate(UpdateType type, const Level& update, bool top) noexcept
+template <typename TPrice, typename TQuantity>
+inline LevelUpdateT<TPrice, TQuantity>::LevelUpdateT(UpdateType type, const LevelT<TPrice, TQuantity>& update, bool top) noexcept
     : Type(type),
       Update(update),
       Top(top)
 {
 }
 
-template <class TOutputStream>
-inline TOutputStream& operator<<(TOutputStream& stream, const LevelUpdate& update)
+template <class TOutputStream, typename TPrice, typename TQuantity>
+inline TOutputStream& operator<<(TOutputStream& stream, const LevelUpdateT<TPrice, TQuantity>& update)
 {
     stream << "LevelUpdate(Type=" << update.Type
         << "; Update=" << update.Update
@@ -0,0 +1,116 @@
+/*!
+    \file levels_avl.h
+    \brief Price levels AVL tree container definition
+    \author Ivan Shynkarenka
+    \date 17.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_LEVELS_AVL_H
+#define CPPTRADER_MATCHING_LEVELS_AVL_H
+
+#include "level.h"
+
+namespace CppTrader {
+namespace Matching {
+
+//! Price levels AVL tree container
+/*!
+    Price levels AVL tree container keeps price levels in the intrusive
+    balanced binary tree. All operations take O(log N) time and do not
+    require any additional memory. This is the default price levels
+    container of the order book.
+
+    Price levels are iterated in the ascending price order.
+
+    Not thread-safe.
+*/
+template <class TLevelNode>
+class LevelsAVL
+{
+public:
+    //! Price levels tree
+    typedef CppCommon::BinTreeAVL<TLevelNode, std::less<TLevelNode>> Tree;
+
+    // Standard container type definitions
+    typedef typename Tree::iterator iterator;
+    typedef typename Tree::const_iterator const_iterator;
+    typedef typename Tree::reverse_iterator reverse_iterator;
+    typedef typename Tree::const_reverse_iterator const_reverse_iterator;
+
+    explicit LevelsAVL(LevelType type) noexcept : _type(type) {}
+    LevelsAVL(const LevelsAVL&) noexcept = default;
+    LevelsAVL(LevelsAVL&&) noexcept = default;
+    ~LevelsAVL() noexcept = default;
+
+    LevelsAVL& operator=(const LevelsAVL&) noexcept = default;
+    LevelsAVL& operator=(LevelsAVL&&) noexcept = default;
+
+    //! Check if the container is not empty
+    explicit operator bool() const noexcept { return !empty(); }
+
+    //! Is the container empty?
+    bool empty() const noexcept { return _tree.empty(); }
+
+    //! Get the container size
+    size_t size() const noexcept { return _tree.size(); }
+
+    //! Get the begin container iterator
+    iterator begin() noexcept { return _tree.begin(); }
+    const_iterator begin() const noexcept { return _tree.begin(); }
+    //! Get the end container iterator
+    iterator end() noexcept { return _tree.end(); }
+    const_iterator end() const noexcept { return _tree.end(); }
+
+    //! Get the reverse begin container iterator
+    reverse_iterator rbegin() noexcept { return _tree.rbegin(); }
+    const_reverse_iterator rbegin() const noexcept { return _tree.rbegin(); }
+    //! Get the reverse end container iterator
+    reverse_iterator rend() noexcept { return _tree.rend(); }
+    const_reverse_iterator rend() const noexcept { return _tree.rend(); }
+
+    //! Find the price level with the given price
+    /*!
+        \param price - Price
+        \return Pointer to the price level with the given price or nullptr
+    */
+    TLevelNode* find(uint64_t price) const noexcept;
+
+    //! Get the price level with the nearest lower price
+    /*!
+        \param level - Price level in the container
+        \return Pointer to the price level with the nearest lower price or nullptr
+    */
+    TLevelNode* lower(const TLevelNode& level) const noexcept;
+    //! Get the price level with the nearest higher price
+    /*!
+        \param level - Price level in the container
+        \return Pointer to the price level with the nearest higher price or nullptr
+    */
+    TLevelNode* higher(const TLevelNode& level) const noexcept;
+
+    //! Insert a new price level into the container
+    /*!
+        \param level - Price level to insert
+    */
+    void insert(TLevelNode& level);
+    //! Erase the price level from the container
+    /*!
+        \param level - Price level to erase
+    */
+    void erase(TLevelNode& level) noexcept;
+
+    //! Clear the container
+    void clear() noexcept { _tree.clear(); }
+
+private:
+    LevelType _type;
+    Tree _tree;
+};
+
+} // namespace Matching
+} // namespace CppTrader
+
+#include "levels_avl.inl"
+
+#endif // CPPTRADER_MATCHING_LEVELS_AVL_H
@@ -0,0 +1,48 @@
+/*!
+    \file levels_avl.inl
+    \brief Price levels AVL tree container inline implementation
+    \author Ivan Shynkarenka
+    \date 17.08.2017
+    \copyright MIT License
+*/
+
+namespace CppTrader {
+namespace Matching {
+
+template <class TLevelNode>
+inline TLevelNode* LevelsAVL<TLevelNode>::find(uint64_t price) const noexcept
+{
+    auto it = _tree.find(TLevelNode(_type, price));
+    return (it != _tree.end()) ? (TLevelNode*)it.operator->() : nullptr;
+}
+
+template <class TLevelNode>
+inline TLevelNode* LevelsAVL<TLevelNode>::lower(const TLevelNode& level) const noexcept
+{
+    const_reverse_iterator it(&_tree, &level);
+    ++it;
+    return (TLevelNode*)it.operator->();
+}
+
+template <class TLevelNode>
+inline TLevelNode* LevelsAVL<TLevelNode>::higher(const TLevelNode& level) const noexcept
+{
+    const_iterator it(&_tree, &level);
+    ++it;
+    return (TLevelNode*)it.operator->();
+}
+
+template <class TLevelNode>
+inline void LevelsAVL<TLevelNode>::insert(TLevelNode& level)
+{
+    _tree.insert(level);
+}
+
+template <class TLevelNode>
+inline void LevelsAVL<TLevelNode>::erase(TLevelNode& level) noexcept
+{
+    _tree.erase(iterator(&_tree, &level));
+}
+
+} // namespace Matching
+} // namespace CppTrader
@@ -0,0 +1,256 @@
+/*!
+    \file levels_btree.h
+    \brief Price levels B+tree container definition
+    \author Ivan Shynkarenka
+    \date 19.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_LEVELS_BTREE_H
+#define CPPTRADER_MATCHING_LEVELS_BTREE_H
+
+#include "level.h"
+
+#include <cassert>
+#include <iterator>
+#include <type_traits>
+
+namespace CppTrader {
+namespace Matching {
+
+template <class TContainer, typename T>
+class LevelsBTreeIterator;
+
+//! Price levels B+tree container
+/*!
+    Price levels B+tree container keeps prices and pointers to price levels
+    in wide nodes with contiguous key arrays, so a lookup in the very deep
+    order book touches a few cache lines per tree level instead of a single
+    key per node as in binary trees. All price levels are stored in leaves
+    linked into the list, so depth iteration and matching sweeps stream
+    through contiguous leaf arrays instead of hopping tree nodes.
+
+    Leaves with the lowest and the highest prices are checked before the
+    tree descent, so operations near the top of the book usually do not
+    traverse the tree at all. Neighbour price levels are found from the
+    position of the last visited one, so depth walks with lower()/higher()
+    step through the linked leaves without the tree descent.
+
+    Nodes are aligned to the cache line. The default node size of 14 keys
+    makes a leaf exactly four cache lines long.
+
+    Price levels are iterated in the ascending price order.
+
+    Not thread-safe.
+*/
+template <class TLevelNode, size_t TNodeSize = 14>
+class BasicLevelsBTree
+{
+    friend class LevelsBTreeIterator<BasicLevelsBTree<TLevelNode, TNodeSize>, TLevelNode>;
+    friend class LevelsBTreeIterator<const BasicLevelsBTree<TLevelNode, TNodeSize>, const TLevelNode>;
+
+    static_assert((TNodeSize >= 4) && ((TNodeSize % 2) == 0), "B+tree node size must be even and not less than 4!");
+
+    // B+tree node
+    struct alignas(64) Node
+    {
+        bool leaf;
+        size_t count;
+        uint64_t keys[TNodeSize];
+    };
+
+    // B+tree leaf node with price levels
+    struct Leaf : public Node
+    {
+        TLevelNode* values[TNodeSize];
+        Leaf* prev;
+        Leaf* next;
+    };
+
+    // B+tree inner node with count + 1 children. Keys of children[i + 1] are not less than keys[i].
+    struct Inner : public Node
+    {
+        Node* children[TNodeSize + 1];
+    };
+
+public:
+    // Standard container type definitions
+    typedef LevelsBTreeIterator<BasicLevelsBTree<TLevelNode, TNodeSize>, TLevelNode> iterator;
+    typedef LevelsBTreeIterator<const BasicLevelsBTree<TLevelNode, TNodeSize>, const TLevelNode> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    explicit BasicLevelsBTree(LevelType type) noexcept : _type(type), _size(0), _depth(0), _root(nullptr), _head(nullptr), _tail(nullptr), _cursor(nullptr), _cursor_index(0) {}
+    BasicLevelsBTree(const BasicLevelsBTree&) = delete;
+    BasicLevelsBTree(BasicLevelsBTree&& levels) noexcept;
+    ~BasicLevelsBTree() noexcept { clear(); }
+
+    BasicLevelsBTree& operator=(const BasicLevelsBTree&) = delete;
+    BasicLevelsBTree& operator=(BasicLevelsBTree&& levels) noexcept;
+
+    //! Check if the container is not empty
+    explicit operator bool() const noexcept { return !empty(); }
+
+    //! Is the container empty?
+    bool empty() const noexcept { return _size == 0; }
+
+    //! Get the container size
+    size_t size() const noexcept { return _size; }
+    //! Get the B+tree depth
+    size_t depth() const noexcept { return _depth; }
+
+    //! Get the begin container iterator
+    iterator begin() noexcept { return iterator(this, _head, 0); }
+    const_iterator begin() const noexcept { return const_iterator(this, _head, 0); }
+    //! Get the end container iterator
+    iterator end() noexcept { return iterator(this, nullptr, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, nullptr, 0); }
+
+    //! Get the reverse begin container iterator
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    //! Get the reverse end container iterator
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    //! Find the price level with the given price
+    /*!
+        \param price - Price
+        \return Pointer to the price level with the given price or nullptr
+    */
+    TLevelNode* find(uint64_t price) const noexcept;
+
+    //! Get the price level with the nearest lower price
+    /*!
+        \param level - Price level in the container
+        \return Pointer to the price level with the nearest lower price or nullptr
+    */
+    TLevelNode* lower(const TLevelNode& level) const noexcept;
+    //! Get the price level with the nearest higher price
+    /*!
+        \param level - Price level in the container
+        \return Pointer to the price level with the nearest higher price or nullptr
+    */
+    TLevelNode* higher(const TLevelNode& level) const noexcept;
+
+    //! Insert a new price level into the container
+    /*!
+        \param level - Price level to insert
+    */
+    void insert(TLevelNode& level);
+    //! Erase the price level from the container
+    /*!
+        \param level - Price level to erase
+    */
+    void erase(TLevelNode& level) noexcept;
+
+    //! Clear the container
+    void clear() noexcept;
+
+private:
+    // Minimal count of keys in the non-root node
+    static const size_t MIN = TNodeSize / 2;
+    // Maximal B+tree depth
+    static const size_t MAX_DEPTH = 32;
+
+    // B+tree path item
+    struct Path
+    {
+        Inner* node;
+        size_t index;
+    };
+
+    LevelType _type;
+    size_t _size;
+    size_t _depth;
+    Node* _root;
+    Leaf* _head;
+    Leaf* _tail;
+    // Leaf and position of the last price level visited by lower()/higher()
+    mutable Leaf* _cursor;
+    mutable size_t _cursor_index;
+
+    // Get the index of the first key which is not less than the given price
+    static size_t LowerBound(const Node* node, uint64_t price) noexcept;
+    // Get the index of the child which may contain the given price
+    static size_t ChildIndex(const Inner* node, uint64_t price) noexcept;
+
+    // Find the leaf which may contain the given price and the position of the price in it
+    Leaf* Locate(uint64_t price, size_t& position) const noexcept;
+    // Find the leaf and the position of the given price level starting from the cursor
+    Leaf* Seek(const TLevelNode& level, size_t& position) const noexcept;
+    // Descend to the leaf which may contain the given price and remember the path
+    Leaf* Descend(uint64_t price, Path* path) const noexcept;
+
+    // Insert the separator key and the right child into the parent nodes
+    void InsertInner(Path* path, size_t depth, uint64_t key, Node* child);
+    // Rebalance the underflowed leaf and its parent nodes
+    void RebalanceLeaf(Path* path, size_t depth, Leaf* leaf) noexcept;
+    void RebalanceInner(Path* path, size_t depth, Inner* node) noexcept;
+    // Remove the separator key and the right child from the inner node
+    static void RemoveInner(Inner* node, size_t index) noexcept;
+
+    // Release the B+tree node recursively
+    static void Release(Node* node) noexcept;
+};
+
+//! Price levels B+tree container with the default node size
+template <class TLevelNode>
+using LevelsBTree = BasicLevelsBTree<TLevelNode>;
+
+//! Price levels B+tree container iterator
+/*!
+    Bidirectional iterator over price levels in the ascending price order.
+
+    Not thread-safe.
+*/
+template <class TContainer, typename T>
+class LevelsBTreeIterator
+{
+    typedef typename std::conditional<std::is_const<TContainer>::value, const typename TContainer::Leaf, typename TContainer::Leaf>::type Leaf;
+
+public:
+    // Standard iterator type definitions
+    typedef T value_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef std::bidirectional_iterator_tag iterator_category;
+
+    LevelsBTreeIterator() noexcept : _container(nullptr), _leaf(nullptr), _index(0) {}
+    explicit LevelsBTreeIterator(TContainer* container, Leaf* leaf, size_t index) noexcept : _container(container), _leaf(leaf), _index(index) {}
+    LevelsBTreeIterator(const LevelsBTreeIterator& it) noexcept = default;
+    LevelsBTreeIterator(LevelsBTreeIterator&& it) noexcept = default;
+    ~LevelsBTreeIterator() noexcept = default;
+
+    LevelsBTreeIterator& operator=(const LevelsBTreeIterator& it) noexcept = default;
+    LevelsBTreeIterator& operator=(LevelsBTreeIterator&& it) noexcept = default;
+
+    friend bool operator==(const LevelsBTreeIterator& it1, const LevelsBTreeIterator& it2) noexcept
+    { return (it1._container == it2._container) && (it1._leaf == it2._leaf) && (it1._index == it2._index); }
+    friend bool operator!=(const LevelsBTreeIterator& it1, const LevelsBTreeIterator& it2) noexcept
+    { return !(it1 == it2); }
+
+    LevelsBTreeIterator& operator++() noexcept;
+    LevelsBTreeIterator operator++(int) noexcept { LevelsBTreeIterator result(*this); operator++(); return result; }
+    LevelsBTreeIterator& operator--() noexcept;
+    LevelsBTreeIterator operator--(int) noexcept { LevelsBTreeIterator result(*this); operator--(); return result; }
+
+    reference operator*() const noexcept { return *_leaf->values[_index]; }
+    pointer operator->() const noexcept { return _leaf->values[_index]; }
+
+private:
+    TContainer* _container;
+    Leaf* _leaf;
+    size_t _index;
+};
+
+} // namespace Matching
+} // namespace CppTrader
+
+#include "levels_btree.inl"
+
+#endif // CPPTRADER_MATCHING_LEVELS_BTREE_H
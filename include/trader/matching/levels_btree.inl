@@ -0,0 +1,567 @@
+/*!
+    \file levels_btree.inl
+    \brief Price levels B+tree container inline implementation
+    \author Ivan Shynkarenka
+    \date 19.08.2017
+    \copyright MIT License
+*/
+
+namespace CppTrader {
+namespace Matching {
+
+template <class TLevelNode, size_t TNodeSize>
+inline BasicLevelsBTree<TLevelNode, TNodeSize>::BasicLevelsBTree(BasicLevelsBTree&& levels) noexcept
+    : _type(levels._type), _size(levels._size), _depth(levels._depth), _root(levels._root), _head(levels._head), _tail(levels._tail), _cursor(nullptr), _cursor_index(0)
+{
+    levels._size = 0;
+    levels._depth = 0;
+    levels._root = nullptr;
+    levels._head = nullptr;
+    levels._tail = nullptr;
+    levels._cursor = nullptr;
+}
+
+template <class TLevelNode, size_t TNodeSize>
+inline BasicLevelsBTree<TLevelNode, TNodeSize>& BasicLevelsBTree<TLevelNode, TNodeSize>::operator=(BasicLevelsBTree&& levels) noexcept
+{
+    if (this != &levels)
+    {
+        clear();
+        std::swap(_type, levels._type);
+        std::swap(_size, levels._size);
+        std::swap(_depth, levels._depth);
+        std::swap(_root, levels._root);
+        std::swap(_head, levels._head);
+        std::swap(_tail, levels._tail);
+        _cursor = levels._cursor = nullptr;
+    }
+    return *this;
+}
+
+template <class TLevelNode, size_t TNodeSize>
+inline size_t BasicLevelsBTree<TLevelNode, TNodeSize>::LowerBound(const Node* node, uint64_t price) noexcept
+{
+    size_t index = 0;
+    while ((index < node->count) && (node->keys[index] < price))
+        ++index;
+    return index;
+}
+
+template <class TLevelNode, size_t TNodeSize>
+inline size_t BasicLevelsBTree<TLevelNode, TNodeSize>::ChildIndex(const Inner* node, uint64_t price) noexcept
+{
+    size_t index = 0;
+    while ((index < node->count) && (node->keys[index] <= price))
+        ++index;
+    return index;
+}
+
+template <class TLevelNode, size_t TNodeSize>
+inline typename BasicLevelsBTree<TLevelNode, TNodeSize>::Leaf* BasicLevelsBTree<TLevelNode, TNodeSize>::Locate(uint64_t price, size_t& position) const noexcept
+{
+    if (_root == nullptr)
+        return nullptr;
+
+    // Check the leaves with the lowest and the highest prices first
+    Leaf* leaf;
+    if (price <= _head->keys[_head->count - 1])
+        leaf = _head;
+    else if (price >= _tail->keys[0])
+        leaf = _tail;
+    else
+        leaf = Descend(price, nullptr);
+
+    position = LowerBound(leaf, price);
+    return leaf;
+}
+
+template <class TLevelNode, size_t TNodeSize>
+inline typename BasicLevelsBTree<TLevelNode, TNodeSize>::Leaf* BasicLevelsBTree<TLevelNode, TNodeSize>::Seek(const TLevelNode& level, size_t& position) const noexcept
+{
+    // Continue from the last visited price level without the tree descent
+    if ((_cursor != nullptr) && (_cursor->values[_cursor_index] == &level))
+    {
+        position = _cursor_index;
+        return _cursor;
+    }
+
+    return Locate(level.Price, position);
+}
+
+template <class TLevelNode, size_t TNodeSize>
+inline typename BasicLevelsBTree<TLevelNode, TNodeSize>::Leaf* BasicLevelsBTree<TLevelNode, TNodeSize>::Descend(uint64_t price, Path* path) const noexcept
+{
+    Node* node = _root;
+    for (size_t depth = 0; depth < _depth; ++depth)
+    {
+        Inner* inner = static_cast<Inner*>(node);
+        size_t index = ChildIndex(inner, price);
+        if (path != nullptr)
+            path[depth] = { inner, index };
+        node = inner->children[index];
+    }
+    return static_cast<Leaf*>(node);
+}
+
+template <class TLevelNode, size_t TNodeSize>
+inline TLevelNode* BasicLevelsBTree<TLevelNode, TNodeSize>::find(uint64_t price) const noexcept
+{
+    size_t position = 0;
+    Leaf* leaf = Locate(price, position);
+    return ((leaf != nullptr) && (position < leaf->count) && (leaf->keys[position] == price)) ? leaf->values[position] : nullptr;
+}
+
+template <class TLevelNode, size_t TNodeSize>
+inline TLevelNode* BasicLevelsBTree<TLevelNode, TNodeSize>::lower(const TLevelNode& level) const noexcept
+{
+    size_t position = 0;
+    Leaf* leaf = Seek(level, position);
+    assert((leaf != nullptr) && (position < leaf->count) && (leaf->values[position] == &level) && "Price level not found!");
+
+    // Step to the previous price level in the same or in the previous linked leaf
+    if (position > 0)
+        --position;
+    else if (leaf->prev != nullptr)
+    {
+        leaf = leaf->prev;
+        position = leaf->count - 1;
+    }
+    else
+        return nullptr;
+
+    _cursor = leaf;
+    _cursor_index = position;
+    return leaf->values[position];
+}
+
+template <class TLevelNode, size_t TNodeSize>
+inline TLevelNode* BasicLevelsBTree<TLevelNode, TNodeSize>::higher(const TLevelNode& level) const noexcept
+{
+    size_t position = 0;
+    Leaf* leaf = Seek(level, position);
+    assert((leaf != nullptr) && (position < leaf->count) && (leaf->values[position] == &level) && "Price level not found!");
+
+    // Step to the next price level in the same or in the next linked leaf
+    if ((position + 1) < leaf->count)
+        ++position;
+    else if (leaf->next != nullptr)
+    {
+        leaf = leaf->next;
+        position = 0;
+    }
+    else
+        return nullptr;
+
+    _cursor = leaf;
+    _cursor_index = position;
+    return leaf->values[position];
+}
+
+template <class TLevelNode, size_t TNodeSize>
+void BasicLevelsBTree<TLevelNode, TNodeSize>::insert(TLevelNode& level)
+{
+    uint64_t price = level.Price;
+
+    // Positions of price levels are going to be changed
+    _cursor = nullptr;
+
+    // Create the root leaf
+    if (_root == nullptr)
+    {
+        Leaf* leaf = new Leaf();
+        leaf->leaf = true;
+        leaf->count = 1;
+        leaf->keys[0] = price;
+        leaf->values[0] = &level;
+        leaf->prev = nullptr;
+        leaf->next = nullptr;
+        _root = _head = _tail = leaf;
+        _size = 1;
+        return;
+    }
+
+    Path path[MAX_DEPTH];
+    Leaf* leaf = Descend(price, path);
+    size_t position = LowerBound(leaf, price);
+    assert(((position == leaf->count) || (leaf->keys[position] != price)) && "Price level with the same price already exists!");
+
+    ++_size;
+
+    // Insert the price level into the leaf with the free space
+    if (leaf->count < TNodeSize)
+    {
+        for (size_t i = leaf->count; i > position; --i)
+        {
+            leaf->keys[i] = leaf->keys[i - 1];
+            leaf->values[i] = leaf->values[i - 1];
+        }
+        leaf->keys[position] = price;
+        leaf->values[position] = &level;
+        ++leaf->count;
+        return;
+    }
+
+    // Split the full leaf into two halves
+    Leaf* right = new Leaf();
+    right->leaf = true;
+    right->count = 0;
+    for (size_t i = MIN; i < TNodeSize; ++i)
+    {
+        right->keys[right->count] = leaf->keys[i];
+        right->values[right->count] = leaf->values[i];
+        ++right->count;
+    }
+    leaf->count = MIN;
+
+    // Link the new leaf
+    right->prev = leaf;
+    right->next = leaf->next;
+    if (leaf->next != nullptr)
+        leaf->next->prev = right;
+    else
+        _tail = right;
+    leaf->next = right;
+
+    // Insert the price level into the corresponding half
+    Leaf* target = (position <= MIN) ? leaf : right;
+    if (target == right)
+        position -= MIN;
+    for (size_t i = target->count; i > position; --i)
+    {
+        target->keys[i] = target->keys[i - 1];
+        target->values[i] = target->values[i - 1];
+    }
+    target->keys[position] = price;
+    target->values[position] = &level;
+    ++target->count;
+
+    InsertInner(path, _depth, right->keys[0], right);
+}
+
+template <class TLevelNode, size_t TNodeSize>
+void BasicLevelsBTree<TLevelNode, TNodeSize>::InsertInner(Path* path, size_t depth, uint64_t key, Node* child)
+{
+    while (depth > 0)
+    {
+        Inner* node = path[depth - 1].node;
+        size_t index = path[depth - 1].index;
+
+        // Insert the separator key into the inner node with the free space
+        if (node->count < TNodeSize)
+        {
+            for (size_t i = node->count; i > index; --i)
+            {
+                node->keys[i] = node->keys[i - 1];
+                node->children[i + 1] = node->children[i];
+            }
+            node->keys[index] = key;
+            node->children[index + 1] = child;
+            ++node->count;
+            return;
+        }
+
+        // Merge the separator key into the temporary arrays
+        uint64_t keys[TNodeSize + 1];
+        Node* children[TNodeSize + 2];
+        children[0] = node->children[0];
+        for (size_t i = 0, j = 0; i <= TNodeSize; ++i)
+        {
+            if (i == index)
+            {
+                keys[i] = key;
+                children[i + 1] = child;
+            }
+            else
+            {
+                keys[i] = node->keys[j];
+                children[i + 1] = node->children[j + 1];
+                ++j;
+            }
+        }
+
+        // Split the full inner node and promote the middle key
+        Inner* right = new Inner();
+        right->leaf = false;
+        node->count = MIN;
+        for (size_t i = 0; i < MIN; ++i)
+        {
+            node->keys[i] = keys[i];
+            node->children[i + 1] = children[i + 1];
+        }
+        right->count = TNodeSize - MIN;
+        right->children[0] = children[MIN + 1];
+        for (size_t i = 0; i < right->count; ++i)
+        {
+            right->keys[i] = keys[MIN + 1 + i];
+            right->children[i + 1] = children[MIN + 2 + i];
+        }
+
+        key = keys[MIN];
+        child = right;
+        --depth;
+    }
+
+    // Grow the new root
+    assert((_depth < MAX_DEPTH) && "B+tree depth overflow!");
+    Inner* root = new Inner();
+    root->leaf = false;
+    root->count = 1;
+    root->keys[0] = key;
+    root->children[0] = _root;
+    root->children[1] = child;
+    _root = root;
+    ++_depth;
+}
+
+template <class TLevelNode, size_t TNodeSize>
+void BasicLevelsBTree<TLevelNode, TNodeSize>::erase(TLevelNode& level) noexcept
+{
+    uint64_t price = level.Price;
+
+    // Positions of price levels are going to be changed
+    _cursor = nullptr;
+
+    Path path[MAX_DEPTH];
+    Leaf* leaf = Descend(price, path);
+    size_t position = LowerBound(leaf, price);
+    assert((position < leaf->count) && (leaf->values[position] == &level) && "Price level not found!");
+
+    --_size;
+
+    // Remove the price level from the leaf
+    for (size_t i = position + 1; i < leaf->count; ++i)
+    {
+        leaf->keys[i - 1] = leaf->keys[i];
+        leaf->values[i - 1] = leaf->values[i];
+    }
+    --leaf->count;
+
+    if (leaf->count < MIN)
+        RebalanceLeaf(path, _depth, leaf);
+}
+
+template <class TLevelNode, size_t TNodeSize>
+void BasicLevelsBTree<TLevelNode, TNodeSize>::RebalanceLeaf(Path* path, size_t depth, Leaf* leaf) noexcept
+{
+    // The root leaf may contain any count of price levels
+    if (depth == 0)
+    {
+        if (leaf->count == 0)
+        {
+            delete leaf;
+            _root = _head = _tail = nullptr;
+        }
+        return;
+    }
+
+    Inner* parent = path[depth - 1].node;
+    size_t index = path[depth - 1].index;
+    Leaf* left = (index > 0) ? static_cast<Leaf*>(parent->children[index - 1]) : nullptr;
+    Leaf* right = (index < parent->count) ? static_cast<Leaf*>(parent->children[index + 1]) : nullptr;
+
+    // Borrow the price level from the left sibling
+    if ((left != nullptr) && (left->count > MIN))
+    {
+        for (size_t i = leaf->count; i > 0; --i)
+        {
+            leaf->keys[i] = leaf->keys[i - 1];
+            leaf->values[i] = leaf->values[i - 1];
+        }
+        --left->count;
+        leaf->keys[0] = left->keys[left->count];
+        leaf->values[0] = left->values[left->count];
+        ++leaf->count;
+        parent->keys[index - 1] = leaf->keys[0];
+        return;
+    }
+
+    // Borrow the price level from the right sibling
+    if ((right != nullptr) && (right->count > MIN))
+    {
+        leaf->keys[leaf->count] = right->keys[0];
+        leaf->values[leaf->count] = right->values[0];
+        ++leaf->count;
+        for (size_t i = 1; i < right->count; ++i)
+        {
+            right->keys[i - 1] = right->keys[i];
+            right->values[i - 1] = right->values[i];
+        }
+        --right->count;
+        parent->keys[index] = right->keys[0];
+        return;
+    }
+
+    // Merge the leaf with its sibling
+    if (left == nullptr)
+    {
+        left = leaf;
+        ++index;
+    }
+    else
+        right = leaf;
+    for (size_t i = 0; i < right->count; ++i)
+    {
+        left->keys[left->count] = right->keys[i];
+        left->values[left->count] = right->values[i];
+        ++left->count;
+    }
+    left->next = right->next;
+    if (right->next != nullptr)
+        right->next->prev = left;
+    else
+        _tail = left;
+    delete right;
+
+    RemoveInner(parent, index - 1);
+    RebalanceInner(path, depth - 1, parent);
+}
+
+template <class TLevelNode, size_t TNodeSize>
+void BasicLevelsBTree<TLevelNode, TNodeSize>::RebalanceInner(Path* path, size_t depth, Inner* node) noexcept
+{
+    // Shrink the root with the single child
+    if (depth == 0)
+    {
+        if (node->count == 0)
+        {
+            _root = node->children[0];
+            --_depth;
+            delete node;
+        }
+        return;
+    }
+
+    if (node->count >= MIN)
+        return;
+
+    Inner* parent = path[depth - 1].node;
+    size_t index = path[depth - 1].index;
+    Inner* left = (index > 0) ? static_cast<Inner*>(parent->children[index - 1]) : nullptr;
+    Inner* right = (index < parent->count) ? static_cast<Inner*>(parent->children[index + 1]) : nullptr;
+
+    // Borrow the child from the left sibling
+    if ((left != nullptr) && (left->count > MIN))
+    {
+        node->children[node->count + 1] = node->children[node->count];
+        for (size_t i = node->count; i > 0; --i)
+        {
+            node->keys[i] = node->keys[i - 1];
+            node->children[i] = node->children[i - 1];
+        }
+        node->keys[0] = parent->keys[index - 1];
+        node->children[0] = left->children[left->count];
+        ++node->count;
+        parent->keys[index - 1] = left->keys[left->count - 1];
+        --left->count;
+        return;
+    }
+
+    // Borrow the child from the right sibling
+    if ((right != nullptr) && (right->count > MIN))
+    {
+        node->keys[node->count] = parent->keys[index];
+        node->children[node->count + 1] = right->children[0];
+        ++node->count;
+        parent->keys[index] = right->keys[0];
+        right->children[0] = right->children[1];
+        for (size_t i = 1; i < right->count; ++i)
+        {
+            right->keys[i - 1] = right->keys[i];
+            right->children[i] = right->children[i + 1];
+        }
+        --right->count;
+        return;
+    }
+
+    // Merge the inner node with its sibling
+    if (left == nullptr)
+    {
+        left = node;
+        ++index;
+    }
+    else
+        right = node;
+    left->keys[left->count] = parent->keys[index - 1];
+    left->children[left->count + 1] = right->children[0];
+    ++left->count;
+    for (size_t i = 0; i < right->count; ++i)
+    {
+        left->keys[left->count] = right->keys[i];
+        left->children[left->count + 1] = right->children[i + 1];
+        ++left->count;
+    }
+    delete right;
+
+    RemoveInner(parent, index - 1);
+    RebalanceInner(path, depth - 1, parent);
+}
+
+template <class TLevelNode, size_t TNodeSize>
+inline void BasicLevelsBTree<TLevelNode, TNodeSize>::RemoveInner(Inner* node, size_t index) noexcept
+{
+    for (size_t i = index + 1; i < node->count; ++i)
+    {
+        node->keys[i - 1] = node->keys[i];
+        node->children[i] = node->children[i + 1];
+    }
+    --node->count;
+}
+
+template <class TLevelNode, size_t TNodeSize>
+void BasicLevelsBTree<TLevelNode, TNodeSize>::Release(Node* node) noexcept
+{
+    if (node->leaf)
+        delete static_cast<Leaf*>(node);
+    else
+    {
+        Inner* inner = static_cast<Inner*>(node);
+        for (size_t i = 0; i <= inner->count; ++i)
+            Release(inner->children[i]);
+        delete inner;
+    }
+}
+
+template <class TLevelNode, size_t TNodeSize>
+inline void BasicLevelsBTree<TLevelNode, TNodeSize>::clear() noexcept
+{
+    if (_root != nullptr)
+        Release(_root);
+    _size = 0;
+    _depth = 0;
+    _root = nullptr;
+    _head = nullptr;
+    _tail = nullptr;
+    _cursor = nullptr;
+}
+
+template <class TContainer, typename T>
+inline LevelsBTreeIterator<TContainer, T>& LevelsBTreeIterator<TContainer, T>::operator++() noexcept
+{
+    if (++_index >= _leaf->count)
+    {
+        _leaf = _leaf->next;
+        _index = 0;
+    }
+    return *this;
+}
+
+template <class TContainer, typename T>
+inline LevelsBTreeIterator<TContainer, T>& LevelsBTreeIterator<TContainer, T>::operator--() noexcept
+{
+    if (_leaf == nullptr)
+    {
+        _leaf = _container->_tail;
+        _index = _leaf->count - 1;
+    }
+    else if (_index == 0)
+    {
+        _leaf = _leaf->prev;
+        _index = _leaf->count - 1;
+    }
+    else
+        --_index;
+    return *this;
+}
+
+} // namespace Matching
+} // namespace CppTrader
@@ -0,0 +1,243 @@
+/*!
+    \file levels_ladder.h
+    \brief Price levels tick ladder container definition
+    \author Ivan Shynkarenka
+    \date 18.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_LEVELS_LADDER_H
+#define CPPTRADER_MATCHING_LEVELS_LADDER_H
+
+#include "level.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace CppTrader {
+namespace Matching {
+
+template <class TContainer, typename T>
+class LevelsLadderIterator;
+
+//! Price levels tick ladder container
+/*!
+    Price levels tick ladder container keeps pointers to price levels in the
+    direct addressed array (window) indexed by (price - base) / tick. Occupied
+    slots of the window are tracked with two-level occupancy bitmap of 64-bit
+    words, so the nearest lower/higher price level is found with a couple of
+    bit scan instructions without any tree traversal.
+
+    The window is allocated on the first insert, grows up to the given capacity
+    and recenters to follow the market when prices drift outside of it. When
+    the new best price is too far from other price levels, the window is
+    recentered around it and price levels out of the new window are demoted
+    to the intrusive AVL tree. Other prices which cannot be placed into the
+    window (not aligned to the tick size or too far from the best price) fall
+    back to the tree as well. The window base is always aligned to the tick
+    size, so only prices which are multiples of the tick size are placed into
+    the window. Window buffers are reused when the window is rebuilt.
+
+    Tick size is fixed for the container type, so it is usually bound with an
+    alias template:
+    \code{.cpp}
+    template <class TLevelNode>
+    using LevelsLadderCent = BasicLevelsLadder<TLevelNode, 100>;
+
+    MarketManagerT<MarketTraits<LevelsLadderCent>> market;
+    \endcode
+
+    Price levels are iterated in the ascending price order.
+
+    Not thread-safe.
+*/
+template <class TLevelNode, uint64_t TTickSize = 1, size_t TCapacity = 4096>
+class BasicLevelsLadder
+{
+    friend class LevelsLadderIterator<BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>, TLevelNode>;
+    friend class LevelsLadderIterator<const BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>, const TLevelNode>;
+
+    static_assert(TTickSize > 0, "Tick size must be greater than zero!");
+    static_assert((TCapacity >= 64) && ((TCapacity & (TCapacity - 1)) == 0), "Ladder capacity must be a power of two not less than 64!");
+
+public:
+    //! Fallback price levels tree
+    typedef CppCommon::BinTreeAVL<TLevelNode, std::less<TLevelNode>> Tree;
+
+    // Standard container type definitions
+    typedef LevelsLadderIterator<BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>, TLevelNode> iterator;
+    typedef LevelsLadderIterator<const BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>, const TLevelNode> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    explicit BasicLevelsLadder(LevelType type) noexcept : _type(type), _base(0), _size(0), _count(0) {}
+    BasicLevelsLadder(const BasicLevelsLadder&) = default;
+    BasicLevelsLadder(BasicLevelsLadder&&) noexcept = default;
+    ~BasicLevelsLadder() noexcept = default;
+
+    BasicLevelsLadder& operator=(const BasicLevelsLadder&) = default;
+    BasicLevelsLadder& operator=(BasicLevelsLadder&&) noexcept = default;
+
+    //! Check if the container is not empty
+    explicit operator bool() const noexcept { return !empty(); }
+
+    //! Is the container empty?
+    bool empty() const noexcept { return size() == 0; }
+
+    //! Get the container size
+    size_t size() const noexcept { return _count + _tree.size(); }
+
+    //! Get the ladder window base price
+    uint64_t base() const noexcept { return _base; }
+    //! Get the ladder window size in ticks
+    size_t window() const noexcept { return _size; }
+    //! Get the fallback price levels tree
+    const Tree& fallback() const noexcept { return _tree; }
+
+    //! Get the begin container iterator
+    iterator begin() noexcept { return iterator(this, Lowest()); }
+    const_iterator begin() const noexcept { return const_iterator(this, Lowest()); }
+    //! Get the end container iterator
+    iterator end() noexcept { return iterator(this, nullptr); }
+    const_iterator end() const noexcept { return const_iterator(this, nullptr); }
+
+    //! Get the reverse begin container iterator
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    //! Get the reverse end container iterator
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    //! Find the price level with the given price
+    /*!
+        \param price - Price
+        \return Pointer to the price level with the given price or nullptr
+    */
+    TLevelNode* find(uint64_t price) const noexcept;
+
+    //! Get the price level with the nearest lower price
+    /*!
+        \param level - Price level in the container
+        \return Pointer to the price level with the nearest lower price or nullptr
+    */
+    TLevelNode* lower(const TLevelNode& level) const noexcept;
+    //! Get the price level with the nearest higher price
+    /*!
+        \param level - Price level in the container
+        \return Pointer to the price level with the nearest higher price or nullptr
+    */
+    TLevelNode* higher(const TLevelNode& level) const noexcept;
+
+    //! Insert a new price level into the container
+    /*!
+        \param level - Price level to insert
+    */
+    void insert(TLevelNode& level);
+    //! Erase the price level from the container
+    /*!
+        \param level - Price level to erase
+    */
+    void erase(TLevelNode& level) noexcept;
+
+    //! Clear the container
+    void clear() noexcept;
+
+private:
+    // Invalid window index
+    static const size_t NPOS = std::numeric_limits<size_t>::max();
+
+    LevelType _type;
+    uint64_t _base;
+    size_t _size;
+    size_t _count;
+    std::vector<TLevelNode*> _slots;
+    std::vector<uint64_t> _bits;
+    std::vector<uint64_t> _summary;
+    std::vector<TLevelNode*> _moving;
+    Tree _tree;
+
+    // Is the given price aligned to the tick size?
+    static bool IsAligned(uint64_t price) noexcept { return (price % TTickSize) == 0; }
+    // Is the given price placed in the window? Calculate its window index.
+    bool IsWindow(uint64_t price, size_t& index) const noexcept;
+
+    // Occupancy bitmap management
+    void SetBit(size_t index) noexcept;
+    void ResetBit(size_t index) noexcept;
+    size_t NextBit(size_t index) const noexcept;
+    size_t PrevBit(size_t index) const noexcept;
+
+    // Window management
+    bool Relayout(uint64_t low, uint64_t high);
+    bool Recenter(uint64_t price);
+    void Rebuild(uint64_t base, size_t size);
+
+    // Nearest price levels lookup
+    TLevelNode* Lowest() const noexcept;
+    TLevelNode* Highest() const noexcept;
+    TLevelNode* WindowLower(uint64_t price) const noexcept;
+    TLevelNode* WindowHigher(uint64_t price) const noexcept;
+    TLevelNode* TreeLower(uint64_t price) const noexcept;
+    TLevelNode* TreeHigher(uint64_t price) const noexcept;
+};
+
+//! Price levels tick ladder container with the default tick size and capacity
+template <class TLevelNode>
+using LevelsLadder = BasicLevelsLadder<TLevelNode>;
+
+//! Price levels tick ladder container iterator
+/*!
+    Bidirectional iterator over price levels in the ascending price order.
+
+    Not thread-safe.
+*/
+template <class TContainer, typename T>
+class LevelsLadderIterator
+{
+public:
+    // Standard iterator type definitions
+    typedef T value_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef std::bidirectional_iterator_tag iterator_category;
+
+    LevelsLadderIterator() noexcept : _container(nullptr), _node(nullptr) {}
+    explicit LevelsLadderIterator(TContainer* container, T* node) noexcept : _container(container), _node(node) {}
+    LevelsLadderIterator(const LevelsLadderIterator& it) noexcept = default;
+    LevelsLadderIterator(LevelsLadderIterator&& it) noexcept = default;
+    ~LevelsLadderIterator() noexcept = default;
+
+    LevelsLadderIterator& operator=(const LevelsLadderIterator& it) noexcept = default;
+    LevelsLadderIterator& operator=(LevelsLadderIterator&& it) noexcept = default;
+
+    friend bool operator==(const LevelsLadderIterator& it1, const LevelsLadderIterator& it2) noexcept
+    { return (it1._container == it2._container) && (it1._node == it2._node); }
+    friend bool operator!=(const LevelsLadderIterator& it1, const LevelsLadderIterator& it2) noexcept
+    { return !(it1 == it2); }
+
+    LevelsLadderIterator& operator++() noexcept { _node = _container->higher(*_node); return *this; }
+    LevelsLadderIterator operator++(int) noexcept { LevelsLadderIterator result(*this); operator++(); return result; }
+    LevelsLadderIterator& operator--() noexcept { _node = (_node != nullptr) ? _container->lower(*_node) : _container->Highest(); return *this; }
+    LevelsLadderIterator operator--(int) noexcept { LevelsLadderIterator result(*this); operator--(); return result; }
+
+    reference operator*() const noexcept { return *_node; }
+    pointer operator->() const noexcept { return _node; }
+
+private:
+    TContainer* _container;
+    T* _node;
+};
+
+} // namespace Matching
+} // namespace CppTrader
+
+#include "levels_ladder.inl"
+
+#endif // CPPTRADER_MATCHING_LEVELS_LADDER_H
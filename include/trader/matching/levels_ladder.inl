@@ -0,0 +1,437 @@
+/*!
+    \file levels_ladder.inl
+    \brief Price levels tick ladder container inline implementation
+    \author Ivan Shynkarenka
+    \date 18.08.2017
+    \copyright MIT License
+*/
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace CppTrader {
+namespace Matching {
+
+namespace Internal {
+
+//! Get the index of the least significant set bit in the non-zero word
+inline size_t LowestBit(uint64_t word) noexcept
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (size_t)index;
+#else
+    return (size_t)__builtin_ctzll(word);
+#endif
+}
+
+//! Get the index of the most significant set bit in the non-zero word
+inline size_t HighestBit(uint64_t word) noexcept
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, word);
+    return (size_t)index;
+#else
+    return (size_t)(63 - __builtin_clzll(word));
+#endif
+}
+
+} // namespace Internal
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline bool BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::IsWindow(uint64_t price, size_t& index) const noexcept
+{
+    if ((_size == 0) || (price < _base))
+        return false;
+
+    uint64_t offset = price - _base;
+    if ((offset % TTickSize) != 0)
+        return false;
+
+    offset /= TTickSize;
+    if (offset >= _size)
+        return false;
+
+    index = (size_t)offset;
+    return true;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline void BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::SetBit(size_t index) noexcept
+{
+    size_t word = index / 64;
+    _bits[word] |= (1ull << (index % 64));
+    _summary[word / 64] |= (1ull << (word % 64));
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline void BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::ResetBit(size_t index) noexcept
+{
+    size_t word = index / 64;
+    _bits[word] &= ~(1ull << (index % 64));
+    if (_bits[word] == 0)
+        _summary[word / 64] &= ~(1ull << (word % 64));
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline size_t BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::NextBit(size_t index) const noexcept
+{
+    if (index >= _size)
+        return NPOS;
+
+    // Search in the current word
+    size_t word = index / 64;
+    uint64_t bits = _bits[word] & (~0ull << (index % 64));
+    if (bits != 0)
+        return word * 64 + Internal::LowestBit(bits);
+
+    // Search for the next non-empty word in the summary
+    ++word;
+    if (word >= _bits.size())
+        return NPOS;
+    size_t summary = word / 64;
+    uint64_t words = _summary[summary] & (~0ull << (word % 64));
+    while (words == 0)
+    {
+        if (++summary >= _summary.size())
+            return NPOS;
+        words = _summary[summary];
+    }
+
+    word = summary * 64 + Internal::LowestBit(words);
+    return word * 64 + Internal::LowestBit(_bits[word]);
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline size_t BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::PrevBit(size_t index) const noexcept
+{
+    if (_size == 0)
+        return NPOS;
+    if (index >= _size)
+        index = _size - 1;
+
+    // Search in the current word
+    size_t word = index / 64;
+    uint64_t bits = _bits[word] & (~0ull >> (63 - (index % 64)));
+    if (bits != 0)
+        return word * 64 + Internal::HighestBit(bits);
+
+    // Search for the previous non-empty word in the summary
+    if (word == 0)
+        return NPOS;
+    --word;
+    size_t summary = word / 64;
+    uint64_t words = _summary[summary] & (~0ull >> (63 - (word % 64)));
+    while (words == 0)
+    {
+        if (summary-- == 0)
+            return NPOS;
+        words = _summary[summary];
+    }
+
+    word = summary * 64 + Internal::HighestBit(words);
+    return word * 64 + Internal::HighestBit(_bits[word]);
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+bool BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::Relayout(uint64_t low, uint64_t high)
+{
+    // Check if the given price range fits into the window capacity
+    uint64_t span = (high - low) / TTickSize + 1;
+    if (span > TCapacity)
+        return false;
+
+    // Grow the window to keep some space for the price drift
+    size_t size = std::max(_size, (size_t)64);
+    while ((size < 2 * span) && (size < TCapacity))
+        size *= 2;
+
+    // Center the window around the given price range
+    uint64_t margin = std::min((uint64_t)(size - span) / 2, low / TTickSize);
+    uint64_t base = low - margin * TTickSize;
+    if (base > (std::numeric_limits<uint64_t>::max() - size * TTickSize))
+        return false;
+
+    Rebuild(base, size);
+    return true;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+bool BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::Recenter(uint64_t price)
+{
+    // Keep a quarter of the full window for better prices and the rest for worse ones
+    size_t size = TCapacity;
+    uint64_t ahead = size / 4;
+    uint64_t margin = (_type == LevelType::BID) ? (size - 1 - ahead) : ahead;
+    margin = std::min(margin, price / TTickSize);
+    uint64_t base = price - margin * TTickSize;
+    if (base > (std::numeric_limits<uint64_t>::max() - size * TTickSize))
+        return false;
+
+    Rebuild(base, size);
+    return true;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+void BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::Rebuild(uint64_t base, size_t size)
+{
+    assert(IsAligned(base) && "Window base must be aligned to the tick size!");
+
+    // Collect price levels of the old window
+    _moving.clear();
+    for (size_t index = NextBit(0); index != NPOS; index = NextBit(index + 1))
+        _moving.push_back(_slots[index]);
+    size_t window = _moving.size();
+
+    _base = base;
+    _size = size;
+    _count = 0;
+
+    // Collect fallback price levels which fit into the new window
+    if (!_tree.empty())
+    {
+        size_t index = 0;
+        for (auto& level : _tree)
+            if (IsWindow(level.Price, index))
+                _moving.push_back(&level);
+        for (size_t i = window; i < _moving.size(); ++i)
+            _tree.erase(typename Tree::iterator(&_tree, _moving[i]));
+    }
+
+    // Clear the window reusing its buffers
+    _slots.assign(size, nullptr);
+    _bits.assign(size / 64, 0);
+    _summary.assign((size / 64 + 63) / 64, 0);
+
+    // Place price levels into the new window and demote ones out of it to the tree
+    for (auto level : _moving)
+    {
+        size_t index = 0;
+        if (IsWindow(level->Price, index))
+        {
+            _slots[index] = level;
+            SetBit(index);
+            ++_count;
+        }
+        else
+            _tree.insert(*level);
+    }
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline TLevelNode* BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::Lowest() const noexcept
+{
+    size_t index = NextBit(0);
+    TLevelNode* result = (index != NPOS) ? _slots[index] : nullptr;
+    if (!_tree.empty())
+    {
+        TLevelNode* level = (TLevelNode*)_tree.root();
+        while (level->left != nullptr)
+            level = level->left;
+        if ((result == nullptr) || (level->Price < result->Price))
+            result = level;
+    }
+    return result;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline TLevelNode* BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::Highest() const noexcept
+{
+    size_t index = PrevBit(NPOS);
+    TLevelNode* result = (index != NPOS) ? _slots[index] : nullptr;
+    if (!_tree.empty())
+    {
+        TLevelNode* level = (TLevelNode*)_tree.root();
+        while (level->right != nullptr)
+            level = level->right;
+        if ((result == nullptr) || (level->Price > result->Price))
+            result = level;
+    }
+    return result;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline TLevelNode* BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::WindowLower(uint64_t price) const noexcept
+{
+    if ((_count == 0) || (price <= _base))
+        return nullptr;
+
+    // Get the window index of the nearest lower aligned price
+    uint64_t offset = (price - _base - 1) / TTickSize;
+    size_t index = PrevBit((offset < _size) ? (size_t)offset : NPOS);
+    return (index != NPOS) ? _slots[index] : nullptr;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline TLevelNode* BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::WindowHigher(uint64_t price) const noexcept
+{
+    if (_count == 0)
+        return nullptr;
+
+    // Get the window index of the nearest higher aligned price
+    uint64_t offset = (price < _base) ? 0 : ((price - _base) / TTickSize + 1);
+    if (offset >= _size)
+        return nullptr;
+    size_t index = NextBit((size_t)offset);
+    return (index != NPOS) ? _slots[index] : nullptr;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline TLevelNode* BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::TreeLower(uint64_t price) const noexcept
+{
+    TLevelNode* result = nullptr;
+    TLevelNode* level = (TLevelNode*)_tree.root();
+    while (level != nullptr)
+    {
+        if (level->Price < price)
+        {
+            result = level;
+            level = level->right;
+        }
+        else
+            level = level->left;
+    }
+    return result;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline TLevelNode* BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::TreeHigher(uint64_t price) const noexcept
+{
+    TLevelNode* result = nullptr;
+    TLevelNode* level = (TLevelNode*)_tree.root();
+    while (level != nullptr)
+    {
+        if (level->Price > price)
+        {
+            result = level;
+            level = level->left;
+        }
+        else
+            level = level->right;
+    }
+    return result;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline TLevelNode* BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::find(uint64_t price) const noexcept
+{
+    size_t index = 0;
+    if (IsWindow(price, index))
+        return _slots[index];
+
+    if (_tree.empty())
+        return nullptr;
+
+    TLevelNode* level = (TLevelNode*)_tree.root();
+    while (level != nullptr)
+    {
+        if (price < level->Price)
+            level = level->left;
+        else if (price > level->Price)
+            level = level->right;
+        else
+            return level;
+    }
+    return nullptr;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline TLevelNode* BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::lower(const TLevelNode& level) const noexcept
+{
+    TLevelNode* result = WindowLower(level.Price);
+
+    // Fallback price levels may be placed between window price levels
+    if (!_tree.empty())
+    {
+        TLevelNode* fallback = TreeLower(level.Price);
+        if ((fallback != nullptr) && ((result == nullptr) || (fallback->Price > result->Price)))
+            result = fallback;
+    }
+
+    return result;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline TLevelNode* BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::higher(const TLevelNode& level) const noexcept
+{
+    TLevelNode* result = WindowHigher(level.Price);
+
+    // Fallback price levels may be placed between window price levels
+    if (!_tree.empty())
+    {
+        TLevelNode* fallback = TreeHigher(level.Price);
+        if ((fallback != nullptr) && ((result == nullptr) || (fallback->Price < result->Price)))
+            result = fallback;
+    }
+
+    return result;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline void BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::insert(TLevelNode& level)
+{
+    uint64_t price = level.Price;
+
+    size_t index = 0;
+    if (!IsWindow(price, index))
+    {
+        // Recenter the empty window or try to grow the window to cover the new price.
+        // Prices not aligned to the tick size never fit into the window.
+        bool fits = false;
+        if (IsAligned(price) && (_count == 0))
+            fits = Relayout(price, price);
+        else if (IsAligned(price))
+        {
+            uint64_t low = _slots[NextBit(0)]->Price;
+            uint64_t high = _slots[PrevBit(NPOS)]->Price;
+            fits = Relayout(std::min(low, price), std::max(high, price));
+
+            // Follow the market with the window when the new best price is too far from other price levels
+            if (!fits && ((_type == LevelType::BID) ? (price > high) : (price < low)))
+                fits = Recenter(price);
+        }
+
+        // Out-of-band price level falls back to the tree
+        if (!fits || !IsWindow(price, index))
+        {
+            _tree.insert(level);
+            return;
+        }
+    }
+
+    assert((_slots[index] == nullptr) && "Price level with the same price already exists!");
+    _slots[index] = &level;
+    SetBit(index);
+    ++_count;
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline void BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::erase(TLevelNode& level) noexcept
+{
+    size_t index = 0;
+    if (IsWindow(level.Price, index))
+    {
+        assert((_slots[index] == &level) && "Price level not found!");
+        _slots[index] = nullptr;
+        ResetBit(index);
+        --_count;
+    }
+    else
+        _tree.erase(typename Tree::iterator(&_tree, &level));
+}
+
+template <class TLevelNode, uint64_t TTickSize, size_t TCapacity>
+inline void BasicLevelsLadder<TLevelNode, TTickSize, TCapacity>::clear() noexcept
+{
+    std::fill(_slots.begin(), _slots.end(), nullptr);
+    std::fill(_bits.begin(), _bits.end(), 0);
+    std::fill(_summary.begin(), _summary.end(), 0);
+    _count = 0;
+    _tree.clear();
+}
+
+} // namespace Matching
+} // namespace CppTrader
@@ -0,0 +1,186 @@
+/*!
+    \file levels_vector.h
+    \brief Price levels sorted vector container definition
+    \author Ivan Shynkarenka
+    \date 17.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_LEVELS_VECTOR_H
+#define CPPTRADER_MATCHING_LEVELS_VECTOR_H
+
+#include "level.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <vector>
+
+namespace CppTrader {
+namespace Matching {
+
+template <class TContainer, typename T>
+class LevelsVectorIterator;
+
+//! Price levels sorted vector container
+/*!
+    Price levels sorted vector container keeps pointers to price levels in
+    the contiguous array sorted from the worst price to the best one, so the
+    best price level is always at the end of the array. Real order books are
+    clustered near the top of the book, so most of insert/erase/find operations
+    touch only a few cache lines at the end of the array and move a small tail
+    of pointers. Deep price levels are located with a binary search.
+
+    Price levels are iterated in the ascending price order.
+
+    Not thread-safe.
+*/
+template <class TLevelNode>
+class LevelsVector
+{
+    friend class LevelsVectorIterator<LevelsVector<TLevelNode>, TLevelNode>;
+    friend class LevelsVectorIterator<const LevelsVector<TLevelNode>, const TLevelNode>;
+
+public:
+    // Standard container type definitions
+    typedef LevelsVectorIterator<LevelsVector<TLevelNode>, TLevelNode> iterator;
+    typedef LevelsVectorIterator<const LevelsVector<TLevelNode>, const TLevelNode> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    explicit LevelsVector(LevelType type) noexcept : _type(type) {}
+    LevelsVector(const LevelsVector&) = default;
+    LevelsVector(LevelsVector&&) noexcept = default;
+    ~LevelsVector() noexcept = default;
+
+    LevelsVector& operator=(const LevelsVector&) = default;
+    LevelsVector& operator=(LevelsVector&&) noexcept = default;
+
+    //! Check if the container is not empty
+    explicit operator bool() const noexcept { return !empty(); }
+
+    //! Is the container empty?
+    bool empty() const noexcept { return _levels.empty(); }
+
+    //! Get the container size
+    size_t size() const noexcept { return _levels.size(); }
+
+    //! Get the begin container iterator
+    iterator begin() noexcept { return iterator(this, 0); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    //! Get the end container iterator
+    iterator end() noexcept { return iterator(this, size()); }
+    const_iterator end() const noexcept { return const_iterator(this, size()); }
+
+    //! Get the reverse begin container iterator
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    //! Get the reverse end container iterator
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    //! Find the price level with the given price
+    /*!
+        \param price - Price
+        \return Pointer to the price level with the given price or nullptr
+    */
+    TLevelNode* find(uint64_t price) const noexcept;
+
+    //! Get the price level with the nearest lower price
+    /*!
+        \param level - Price level in the container
+        \return Pointer to the price level with the nearest lower price or nullptr
+    */
+    TLevelNode* lower(const TLevelNode& level) const noexcept;
+    //! Get the price level with the nearest higher price
+    /*!
+        \param level - Price level in the container
+        \return Pointer to the price level with the nearest higher price or nullptr
+    */
+    TLevelNode* higher(const TLevelNode& level) const noexcept;
+
+    //! Insert a new price level into the container
+    /*!
+        \param level - Price level to insert
+    */
+    void insert(TLevelNode& level);
+    //! Erase the price level from the container
+    /*!
+        \param level - Price level to erase
+    */
+    void erase(TLevelNode& level) noexcept;
+
+    //! Clear the container
+    void clear() noexcept { _levels.clear(); }
+
+private:
+    // Count of price levels to scan linearly from the best price before falling back to the binary search
+    static const size_t SCAN = 8;
+
+    LevelType _type;
+    std::vector<TLevelNode*> _levels;
+
+    // Is the first price worse than the second one?
+    bool IsWorse(uint64_t price1, uint64_t price2) const noexcept
+    { return (_type == LevelType::BID) ? (price1 < price2) : (price1 > price2); }
+
+    // Get the index of the first price level which price is not worse than the given one
+    size_t Search(uint64_t price) const noexcept;
+    // Get the price level with the given index in the ascending price order
+    TLevelNode* Get(size_t index) const noexcept
+    { return (_type == LevelType::BID) ? _levels[index] : _levels[_levels.size() - index - 1]; }
+};
+
+//! Price levels sorted vector container iterator
+/*!
+    Bidirectional iterator over price levels in the ascending price order.
+
+    Not thread-safe.
+*/
+template <class TContainer, typename T>
+class LevelsVectorIterator
+{
+public:
+    // Standard iterator type definitions
+    typedef T value_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef std::bidirectional_iterator_tag iterator_category;
+
+    LevelsVectorIterator() noexcept : _container(nullptr), _index(0) {}
+    explicit LevelsVectorIterator(TContainer* container, size_t index) noexcept : _container(container), _index(index) {}
+    LevelsVectorIterator(const LevelsVectorIterator& it) noexcept = default;
+    LevelsVectorIterator(LevelsVectorIterator&& it) noexcept = default;
+    ~LevelsVectorIterator() noexcept = default;
+
+    LevelsVectorIterator& operator=(const LevelsVectorIterator& it) noexcept = default;
+    LevelsVectorIterator& operator=(LevelsVectorIterator&& it) noexcept = default;
+
+    friend bool operator==(const LevelsVectorIterator& it1, const LevelsVectorIterator& it2) noexcept
+    { return (it1._container == it2._container) && (it1._index == it2._index); }
+    friend bool operator!=(const LevelsVectorIterator& it1, const LevelsVectorIterator& it2) noexcept
+    { return !(it1 == it2); }
+
+    LevelsVectorIterator& operator++() noexcept { ++_index; return *this; }
+    LevelsVectorIterator operator++(int) noexcept { LevelsVectorIterator result(*this); ++_index; return result; }
+    LevelsVectorIterator& operator--() noexcept { --_index; return *this; }
+    LevelsVectorIterator operator--(int) noexcept { LevelsVectorIterator result(*this); --_index; return result; }
+
+    reference operator*() const noexcept { return *_container->Get(_index); }
+    pointer operator->() const noexcept { return _container->Get(_index); }
+
+private:
+    TContainer* _container;
+    size_t _index;
+};
+
+} // namespace Matching
+} // namespace CppTrader
+
+#include "levels_vector.inl"
+
+#endif // CPPTRADER_MATCHING_LEVELS_VECTOR_H
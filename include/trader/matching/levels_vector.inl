@@ -0,0 +1,73 @@
+/*!
+    \file levels_vector.inl
+    \brief Price levels sorted vector container inline implementation
+    \author Ivan Shynkarenka
+    \date 17.08.2017
+    \copyright MIT License
+*/
+
+namespace CppTrader {
+namespace Matching {
+
+template <class TLevelNode>
+inline size_t LevelsVector<TLevelNode>::Search(uint64_t price) const noexcept
+{
+    size_t index = _levels.size();
+
+    // Scan price levels near the best price
+    size_t limit = (index > SCAN) ? (index - SCAN) : 0;
+    while (index > limit)
+    {
+        if (IsWorse(_levels[index - 1]->Price, price))
+            return index;
+        --index;
+    }
+
+    // Binary search in the rest of price levels
+    auto it = std::partition_point(_levels.begin(), _levels.begin() + index, [this, price](const TLevelNode* level) { return IsWorse(level->Price, price); });
+    return (size_t)(it - _levels.begin());
+}
+
+template <class TLevelNode>
+inline TLevelNode* LevelsVector<TLevelNode>::find(uint64_t price) const noexcept
+{
+    size_t index = Search(price);
+    return ((index < _levels.size()) && (_levels[index]->Price == price)) ? _levels[index] : nullptr;
+}
+
+template <class TLevelNode>
+inline TLevelNode* LevelsVector<TLevelNode>::lower(const TLevelNode& level) const noexcept
+{
+    size_t index = Search(level.Price);
+    if (_type == LevelType::BID)
+        return (index > 0) ? _levels[index - 1] : nullptr;
+    else
+        return ((index + 1) < _levels.size()) ? _levels[index + 1] : nullptr;
+}
+
+template <class TLevelNode>
+inline TLevelNode* LevelsVector<TLevelNode>::higher(const TLevelNode& level) const noexcept
+{
+    size_t index = Search(level.Price);
+    if (_type == LevelType::BID)
+        return ((index + 1) < _levels.size()) ? _levels[index + 1] : nullptr;
+    else
+        return (index > 0) ? _levels[index - 1] : nullptr;
+}
+
+template <class TLevelNode>
+inline void LevelsVector<TLevelNode>::insert(TLevelNode& level)
+{
+    _levels.insert(_levels.begin() + Search(level.Price), &level);
+}
+
+template <class TLevelNode>
+inline void LevelsVector<TLevelNode>::erase(TLevelNode& level) noexcept
+{
+    size_t index = Search(level.Price);
+    assert((index < _levels.size()) && (_levels[index] == &level) && "Price level not found!");
+    _levels.erase(_levels.begin() + index);
+}
+
+} // namespace Matching
+} // namespace CppTrader
@@ -0,0 +1,271 @@
+/*!
+    \file market_command.h
+    \brief Market command definition
+    \author Ivan Shynkarenka
+    \date 26.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_MARKET_COMMAND_H
+#define CPPTRADER_MATCHING_MARKET_COMMAND_H
+
+#include "market_manager.h"
+
+#include "time/timestamp.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace CppTrader {
+namespace Matching {
+
+//! Market command type
+enum class MarketCommandType : uint8_t
+{
+    ADD_SYMBOL,
+    DELETE_SYMBOL,
+    ADD_ORDER_BOOK,
+    DELETE_ORDER_BOOK,
+    ADD_ORDER,
+    REDUCE_ORDER,
+    MODIFY_ORDER,
+    MITIGATE_ORDER,
+    REPLACE_ORDER,
+    REPLACE_NEW_ORDER,
+    DELETE_ORDER,
+    EXECUTE_ORDER,
+    EXECUTE_ORDER_PRICE,
+    ENABLE_MATCHING,
+    DISABLE_MATCHING,
+    MATCH
+};
+
+template <class TOutputStream>
+TOutputStream& operator<<(TOutputStream& stream, MarketCommandType type);
+
+//! Market command
+/*!
+    Market command is a fixed-size POD record which mirrors a single call of
+    the MarketManager API. Market commands are used to pass market operations
+    between threads through lock-free queues and to apply them later on the
+    thread which owns the market manager.
+
+    Market command should be parametrized with the same market traits as
+    the market manager.
+*/
+template <class TTraits>
+struct MarketCommandT
+{
+    //! Price type
+    typedef typename TTraits::PriceType PriceType;
+    //! Quantity type
+    typedef typename TTraits::QuantityType QuantityType;
+    //! Order type
+    typedef typename TTraits::Order Order;
+    //! Market manager type
+    typedef MarketManagerT<TTraits> MarketManager;
+
+    //! Command type
+    MarketCommandType Type;
+    //! Order Id
+    uint64_t Id;
+    //! New order Id of the replace command
+    uint64_t NewId;
+    //! Order price
+    PriceType Price;
+    //! Order quantity
+    QuantityType Quantity;
+    //! Enqueue timestamp in nanoseconds
+    uint64_t Timestamp;
+    //! Symbol of symbol and order book commands
+    Symbol SymbolData;
+    //! Order of add and replace commands
+    Order OrderData;
+
+    //! Is the command operates with a single order?
+    bool IsOrderCommand() const noexcept { return (Type >= MarketCommandType::ADD_ORDER) && (Type <= MarketCommandType::EXECUTE_ORDER_PRICE); }
+    //! Is the command adds an order which must be matched immediately ('Market', 'Immediate-Or-Cancel', 'Fill-Or-Kill')?
+    bool IsImmediateOrder() const noexcept
+    {
+        return ((Type == MarketCommandType::ADD_ORDER) || (Type == MarketCommandType::REPLACE_NEW_ORDER)) &&
+               (OrderData.IsMarket() || OrderData.IsIOC() || OrderData.IsFOK());
+    }
+
+    //! Get the order book affected by the order command
+    /*!
+        \param manager - Market manager
+        \return Pointer to the affected order book or nullptr
+    */
+    template <class TMarketManager>
+    const typename TMarketManager::OrderBook* GetOrderBook(const TMarketManager& manager) const noexcept;
+
+    //! Execute the command with the given market manager
+    /*!
+        \param manager - Market manager (of any market handler type)
+        \return Error code
+    */
+    template <class TMarketManager>
+    ErrorCode Execute(TMarketManager& manager) const;
+
+    template <class TOutputStream, class T>
+    friend TOutputStream& operator<<(TOutputStream& stream, const MarketCommandT<T>& command);
+
+    // Market command factory methods
+    static MarketCommandT AddSymbol(const Symbol& symbol) noexcept;
+    static MarketCommandT DeleteSymbol(uint32_t id) noexcept;
+    static MarketCommandT AddOrderBook(const Symbol& symbol) noexcept;
+    static MarketCommandT DeleteOrderBook(uint32_t id) noexcept;
+    static MarketCommandT AddOrder(const Order& order) noexcept;
+    static MarketCommandT ReduceOrder(uint64_t id, QuantityType quantity) noexcept;
+    static MarketCommandT ModifyOrder(uint64_t id, PriceType new_price, QuantityType new_quantity) noexcept;
+    static MarketCommandT MitigateOrder(uint64_t id, PriceType new_price, QuantityType new_quantity) noexcept;
+    static MarketCommandT ReplaceOrder(uint64_t id, uint64_t new_id, PriceType new_price, QuantityType new_quantity) noexcept;
+    static MarketCommandT ReplaceOrder(uint64_t id, const Order& new_order) noexcept;
+    static MarketCommandT DeleteOrder(uint64_t id) noexcept;
+    static MarketCommandT ExecuteOrder(uint64_t id, QuantityType quantity) noexcept;
+    static MarketCommandT ExecuteOrder(uint64_t id, PriceType price, QuantityType quantity) noexcept;
+    static MarketCommandT EnableMatching() noexcept;
+    static MarketCommandT DisableMatching() noexcept;
+    static MarketCommandT Match() noexcept;
+
+private:
+    static MarketCommandT Create(MarketCommandType type) noexcept;
+};
+
+//! Market command with the default market traits
+typedef MarketCommandT<MarketTraits<>> MarketCommand;
+
+//! Market commands batch
+/*!
+    Market commands batch statistics is reported by the market command queue
+    for each drained batch of commands.
+*/
+struct MarketCommandBatch
+{
+    //! Count of executed commands
+    size_t Commands;
+    //! Count of failed commands
+    size_t Errors;
+    //! Batch start timestamp in nanoseconds
+    uint64_t Timestamp;
+    //! Batch processing time in nanoseconds
+    uint64_t Time;
+    //! Total queueing latency of batch commands in nanoseconds
+    uint64_t TotalLatency;
+    //! Maximal queueing latency of batch commands in nanoseconds
+    uint64_t MaxLatency;
+
+    //! Get the average queueing latency of batch commands in nanoseconds
+    uint64_t AvgLatency() const noexcept { return (Commands > 0) ? (TotalLatency / Commands) : 0; }
+};
+
+//! Market command queue
+/*!
+    Market command queue is a bounded lock-free ring of market commands in
+    front of the market manager. Any number of producer threads (gateways,
+    feed handlers) enqueue commands without external serialization, and the
+    single thread which owns the market manager drains them in batches:
+    \code{.cpp}
+    MarketCommandQueue queue(65536);
+
+    // Producer threads
+    queue.Enqueue(MarketCommand::AddOrder(Order::BuyLimit(1, 0, 100, 10)));
+
+    // Market manager thread
+    while (running)
+    {
+        MarketCommandBatch batch = queue.Drain(market);
+        if (batch.Commands == 0)
+            CppCommon::Thread::Yield();
+    }
+    \endcode
+
+    Each ring cell has its own sequence number, so producers reserve cells
+    with a single CAS operation and the consumer never touches the producers
+    position. Commands are stamped with the enqueue time, so each drained
+    batch reports its queueing latency.
+
+    Thread-safe for multiple producers and a single consumer.
+*/
+template <class TTraits>
+class MarketCommandQueueT
+{
+public:
+    //! Market command type
+    typedef MarketCommandT<TTraits> MarketCommand;
+    //! Market manager type
+    typedef MarketManagerT<TTraits> MarketManager;
+
+    //! Initialize the queue with the given capacity
+    /*!
+        \param capacity - Queue capacity, must be a power of two (default is 65536)
+    */
+    explicit MarketCommandQueueT(size_t capacity = 65536);
+    MarketCommandQueueT(const MarketCommandQueueT&) = delete;
+    MarketCommandQueueT(MarketCommandQueueT&&) = delete;
+    ~MarketCommandQueueT();
+
+    MarketCommandQueueT& operator=(const MarketCommandQueueT&) = delete;
+    MarketCommandQueueT& operator=(MarketCommandQueueT&&) = delete;
+
+    //! Check if the queue is not empty
+    explicit operator bool() const noexcept { return !empty(); }
+
+    //! Is the queue empty?
+    bool empty() const noexcept { return (size() == 0); }
+    //! Get the queue capacity
+    size_t capacity() const noexcept { return _capacity; }
+    //! Get the approximate queue size
+    size_t size() const noexcept;
+
+    //! Enqueue the command (multiple producers)
+    /*!
+        \param command - Command to enqueue
+        \return 'true' if the command was successfully enqueued, 'false' if the queue is full
+    */
+    bool Enqueue(const MarketCommand& command) noexcept;
+
+    //! Dequeue the command (single consumer)
+    /*!
+        \param command - Dequeued command
+        \return 'true' if the command was successfully dequeued, 'false' if the queue is empty
+    */
+    bool Dequeue(MarketCommand& command) noexcept;
+
+    //! Drain enqueued commands into the market manager (single consumer)
+    /*!
+        Dequeue up to the given count of commands and execute them with the
+        given market manager as one batch.
+
+        \param manager - Market manager (of any market handler type)
+        \param limit - Batch limit (default is 1024)
+        \return Batch statistics
+    */
+    template <class TMarketManager>
+    MarketCommandBatch Drain(TMarketManager& manager, size_t limit = 1024);
+
+private:
+    // Ring cell with its sequence number
+    struct Cell
+    {
+        std::atomic<size_t> Sequence;
+        MarketCommand Command;
+    };
+
+    const size_t _capacity;
+    const size_t _mask;
+    Cell* _buffer;
+
+    alignas(64) std::atomic<size_t> _head;
+    alignas(64) std::atomic<size_t> _tail;
+};
+
+//! Market command queue with the default market traits
+typedef MarketCommandQueueT<MarketTraits<>> MarketCommandQueue;
+
+} // namespace Matching
+} // namespace CppTrader
+
+#include "market_command.inl"
+
+#endif // CPPTRADER_MATCHING_MARKET_COMMAND_H
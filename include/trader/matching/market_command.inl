@@ -0,0 +1,423 @@
+/*!
+    \file market_command.inl
+    \brief Market command inline implementation
+    \author Ivan Shynkarenka
+    \date 26.08.2017
+    \copyright MIT License
+*/
+
+namespace CppTrader {
+namespace Matching {
+
+template <class TOutputStream>
+inline TOutputStream& operator<<(TOutputStream& stream, MarketCommandType type)
+{
+    switch (type)
+    {
+        case MarketCommandType::ADD_SYMBOL:
+            stream << "ADD_SYMBOL";
+            break;
+        case MarketCommandType::DELETE_SYMBOL:
+            stream << "DELETE_SYMBOL";
+            break;
+        case MarketCommandType::ADD_ORDER_BOOK:
+            stream << "ADD_ORDER_BOOK";
+            break;
+        case MarketCommandType::DELETE_ORDER_BOOK:
+            stream << "DELETE_ORDER_BOOK";
+            break;
+        case MarketCommandType::ADD_ORDER:
+            stream << "ADD_ORDER";
+            break;
+        case MarketCommandType::REDUCE_ORDER:
+            stream << "REDUCE_ORDER";
+            break;
+        case MarketCommandType::MODIFY_ORDER:
+            stream << "MODIFY_ORDER";
+            break;
+        case MarketCommandType::MITIGATE_ORDER:
+            stream << "MITIGATE_ORDER";
+            break;
+        case MarketCommandType::REPLACE_ORDER:
+            stream << "REPLACE_ORDER";
+            break;
+        case MarketCommandType::REPLACE_NEW_ORDER:
+            stream << "REPLACE_NEW_ORDER";
+            break;
+        case MarketCommandType::DELETE_ORDER:
+            stream << "DELETE_ORDER";
+            break;
+        case MarketCommandType::EXECUTE_ORDER:
+            stream << "EXECUTE_ORDER";
+            break;
+        case MarketCommandType::EXECUTE_ORDER_PRICE:
+            stream << "EXECUTE_ORDER_PRICE";
+            break;
+        case MarketCommandType::ENABLE_MATCHING:
+            stream << "ENABLE_MATCHING";
+            break;
+        case MarketCommandType::DISABLE_MATCHING:
+            stream << "DISABLE_MATCHING";
+            break;
+        case MarketCommandType::MATCH:
+            stream << "MATCH";
+            break;
+        default:
+            stream << "<unknown>";
+            break;
+    }
+    return stream;
+}
+
+template <class TTraits>
+template <class TMarketManager>
+inline const typename TMarketManager::OrderBook* MarketCommandT<TTraits>::GetOrderBook(const TMarketManager& manager) const noexcept
+{
+    switch (Type)
+    {
+        case MarketCommandType::ADD_ORDER:
+        case MarketCommandType::REPLACE_NEW_ORDER:
+            return manager.GetOrderBook(OrderData.SymbolId);
+        case MarketCommandType::REDUCE_ORDER:
+        case MarketCommandType::MODIFY_ORDER:
+        case MarketCommandType::MITIGATE_ORDER:
+        case MarketCommandType::REPLACE_ORDER:
+        case MarketCommandType::DELETE_ORDER:
+        case MarketCommandType::EXECUTE_ORDER:
+        case MarketCommandType::EXECUTE_ORDER_PRICE:
+        {
+            const Order* order_ptr = manager.GetOrder(Id);
+            return (order_ptr != nullptr) ? manager.GetOrderBook(order_ptr->SymbolId) : nullptr;
+        }
+        default:
+            return nullptr;
+    }
+}
+
+template <class TTraits>
+template <class TMarketManager>
+inline ErrorCode MarketCommandT<TTraits>::Execute(TMarketManager& manager) const
+{
+    switch (Type)
+    {
+        case MarketCommandType::ADD_SYMBOL:
+            return manager.AddSymbol(SymbolData);
+        case MarketCommandType::DELETE_SYMBOL:
+            return manager.DeleteSymbol(SymbolData.Id);
+        case MarketCommandType::ADD_ORDER_BOOK:
+            return manager.AddOrderBook(SymbolData);
+        case MarketCommandType::DELETE_ORDER_BOOK:
+            return manager.DeleteOrderBook(SymbolData.Id);
+        case MarketCommandType::ADD_ORDER:
+            return manager.AddOrder(OrderData);
+        case MarketCommandType::REDUCE_ORDER:
+            return manager.ReduceOrder(Id, Quantity);
+        case MarketCommandType::MODIFY_ORDER:
+            return manager.ModifyOrder(Id, Price, Quantity);
+        case MarketCommandType::MITIGATE_ORDER:
+            return manager.MitigateOrder(Id, Price, Quantity);
+        case MarketCommandType::REPLACE_ORDER:
+            return manager.ReplaceOrder(Id, NewId, Price, Quantity);
+        case MarketCommandType::REPLACE_NEW_ORDER:
+            return manager.ReplaceOrder(Id, OrderData);
+        case MarketCommandType::DELETE_ORDER:
+            return manager.DeleteOrder(Id);
+        case MarketCommandType::EXECUTE_ORDER:
+            return manager.ExecuteOrder(Id, Quantity);
+        case MarketCommandType::EXECUTE_ORDER_PRICE:
+            return manager.ExecuteOrder(Id, Price, Quantity);
+        case MarketCommandType::ENABLE_MATCHING:
+            manager.EnableMatching();
+            return ErrorCode::OK;
+        case MarketCommandType::DISABLE_MATCHING:
+            manager.DisableMatching();
+            return ErrorCode::OK;
+        case MarketCommandType::MATCH:
+            manager.Match();
+            return ErrorCode::OK;
+        default:
+            assert(false && "Unsupported market command type!");
+            return ErrorCode::OK;
+    }
+}
+
+template <class TOutputStream, class TTraits>
+inline TOutputStream& operator<<(TOutputStream& stream, const MarketCommandT<TTraits>& command)
+{
+    stream << "MarketCommand(Type=" << command.Type
+        << "; Id=" << command.Id
+        << "; NewId=" << command.NewId
+        << "; Price=" << command.Price
+        << "; Quantity=" << command.Quantity
+        << "; Timestamp=" << command.Timestamp
+        << ")";
+    return stream;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::Create(MarketCommandType type) noexcept
+{
+    MarketCommandT command;
+    command.Type = type;
+    command.Id = 0;
+    command.NewId = 0;
+    command.Price = 0;
+    command.Quantity = 0;
+    command.Timestamp = 0;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::AddSymbol(const Symbol& symbol) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::ADD_SYMBOL);
+    command.SymbolData = symbol;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::DeleteSymbol(uint32_t id) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::DELETE_SYMBOL);
+    command.SymbolData.Id = id;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::AddOrderBook(const Symbol& symbol) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::ADD_ORDER_BOOK);
+    command.SymbolData = symbol;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::DeleteOrderBook(uint32_t id) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::DELETE_ORDER_BOOK);
+    command.SymbolData.Id = id;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::AddOrder(const Order& order) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::ADD_ORDER);
+    command.Id = order.Id;
+    command.OrderData = order;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::ReduceOrder(uint64_t id, QuantityType quantity) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::REDUCE_ORDER);
+    command.Id = id;
+    command.Quantity = quantity;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::ModifyOrder(uint64_t id, PriceType new_price, QuantityType new_quantity) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::MODIFY_ORDER);
+    command.Id = id;
+    command.Price = new_price;
+    command.Quantity = new_quantity;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::MitigateOrder(uint64_t id, PriceType new_price, QuantityType new_quantity) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::MITIGATE_ORDER);
+    command.Id = id;
+    command.Price = new_price;
+    command.Quantity = new_quantity;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::ReplaceOrder(uint64_t id, uint64_t new_id, PriceType new_price, QuantityType new_quantity) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::REPLACE_ORDER);
+    command.Id = id;
+    command.NewId = new_id;
+    command.Price = new_price;
+    command.Quantity = new_quantity;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::ReplaceOrder(uint64_t id, const Order& new_order) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::REPLACE_NEW_ORDER);
+    command.Id = id;
+    command.NewId = new_order.Id;
+    command.OrderData = new_order;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::DeleteOrder(uint64_t id) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::DELETE_ORDER);
+    command.Id = id;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::ExecuteOrder(uint64_t id, QuantityType quantity) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::EXECUTE_ORDER);
+    command.Id = id;
+    command.Quantity = quantity;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::ExecuteOrder(uint64_t id, PriceType price, QuantityType quantity) noexcept
+{
+    MarketCommandT command = Create(MarketCommandType::EXECUTE_ORDER_PRICE);
+    command.Id = id;
+    command.Price = price;
+    command.Quantity = quantity;
+    return command;
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::EnableMatching() noexcept
+{
+    return Create(MarketCommandType::ENABLE_MATCHING);
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::DisableMatching() noexcept
+{
+    return Create(MarketCommandType::DISABLE_MATCHING);
+}
+
+template <class TTraits>
+inline MarketCommandT<TTraits> MarketCommandT<TTraits>::Match() noexcept
+{
+    return Create(MarketCommandType::MATCH);
+}
+
+template <class TTraits>
+inline MarketCommandQueueT<TTraits>::MarketCommandQueueT(size_t capacity)
+    : _capacity(capacity),
+      _mask(capacity - 1),
+      _buffer(new Cell[capacity]),
+      _head(0),
+      _tail(0)
+{
+    assert((capacity > 1) && ((capacity & (capacity - 1)) == 0) && "Market command queue capacity must be a power of two!");
+
+    // Each cell expects the producer of its own position
+    for (size_t i = 0; i < capacity; ++i)
+        _buffer[i].Sequence.store(i, std::memory_order_relaxed);
+}
+
+template <class TTraits>
+inline MarketCommandQueueT<TTraits>::~MarketCommandQueueT()
+{
+    delete[] _buffer;
+}
+
+template <class TTraits>
+inline size_t MarketCommandQueueT<TTraits>::size() const noexcept
+{
+    size_t head = _head.load(std::memory_order_acquire);
+    size_t tail = _tail.load(std::memory_order_acquire);
+    return (head > tail) ? (head - tail) : 0;
+}
+
+template <class TTraits>
+inline bool MarketCommandQueueT<TTraits>::Enqueue(const MarketCommand& command) noexcept
+{
+    size_t head = _head.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        Cell& cell = _buffer[head & _mask];
+        size_t sequence = cell.Sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)head;
+
+        if (diff == 0)
+        {
+            // Reserve the cell for the current producer
+            if (_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+            {
+                cell.Command = command;
+                cell.Command.Timestamp = CppCommon::Timestamp::nano();
+
+                // Publish the command to the consumer
+                cell.Sequence.store(head + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The queue is full
+            return false;
+        }
+        else
+        {
+            // Another producer reserved the cell
+            head = _head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <class TTraits>
+inline bool MarketCommandQueueT<TTraits>::Dequeue(MarketCommand& command) noexcept
+{
+    size_t tail = _tail.load(std::memory_order_relaxed);
+
+    Cell& cell = _buffer[tail & _mask];
+    size_t sequence = cell.Sequence.load(std::memory_order_acquire);
+
+    // The queue is empty or the command is not published yet
+    if (sequence != (tail + 1))
+        return false;
+
+    command = cell.Command;
+
+    // Release the cell for producers of the next round
+    cell.Sequence.store(tail + _capacity, std::memory_order_release);
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <class TTraits>
+template <class TMarketManager>
+inline MarketCommandBatch MarketCommandQueueT<TTraits>::Drain(TMarketManager& manager, size_t limit)
+{
+    MarketCommandBatch batch = { 0, 0, CppCommon::Timestamp::nano(), 0, 0, 0 };
+
+    MarketCommand command;
+    while ((batch.Commands < limit) && Dequeue(command))
+    {
+        // Queueing latency is measured from the enqueue to the batch start
+        uint64_t latency = (batch.Timestamp > command.Timestamp) ? (batch.Timestamp - command.Timestamp) : 0;
+        batch.TotalLatency += latency;
+        batch.MaxLatency = std::max(batch.MaxLatency, latency);
+
+        if (command.Execute(manager) != ErrorCode::OK)
+            ++batch.Errors;
+
+        ++batch.Commands;
+    }
+
+    if (batch.Commands > 0)
+        batch.Time = CppCommon::Timestamp::nano() - batch.Timestamp;
+
+    return batch;
+}
+
+// Market command & queue with the default market traits are instantiated in the library
+extern template struct MarketCommandT<MarketTraits<>>;
+extern template class MarketCommandQueueT<MarketTraits<>>;
+
+} // namespace Matching
+} // namespace CppTrader
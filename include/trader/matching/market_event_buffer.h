@@ -0,0 +1,265 @@
+/*!
+    \file market_event_buffer.h
+    \brief Market event buffer definition
+    \author Ivan Shynkarenka
+    \date 01.09.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_MARKET_EVENT_BUFFER_H
+#define CPPTRADER_MATCHING_MARKET_EVENT_BUFFER_H
+
+#include "market_manager.h"
+
+#include <cstdint>
+#include <new>
+
+namespace CppTrader {
+namespace Matching {
+
+//! Market event type
+enum class MarketEventType : uint8_t
+{
+    ADD_SYMBOL,
+    DELETE_SYMBOL,
+    ADD_ORDER_BOOK,
+    DELETE_ORDER_BOOK,
+    ADD_LEVEL,
+    UPDATE_LEVEL,
+    DELETE_LEVEL,
+    ADD_ORDER,
+    UPDATE_ORDER,
+    DELETE_ORDER,
+    EXECUTE_ORDER
+};
+
+template <class TOutputStream>
+TOutputStream& operator<<(TOutputStream& stream, MarketEventType type);
+
+//! Market event
+/*!
+    Market event is a header of the binary market event record. Symbol and
+    order book events are represented with the header only, other events
+    extend it with their own fields.
+*/
+struct MarketEvent
+{
+    //! Event record size in bytes
+    uint16_t Size;
+    //! Event type
+    MarketEventType Type;
+    //! Symbol Id
+    uint32_t SymbolId;
+};
+
+//! Order market event
+template <class TTraits>
+struct OrderEventT : MarketEvent
+{
+    //! Order Id
+    uint64_t Id;
+    //! Order price
+    typename TTraits::PriceType Price;
+    //! Order leaves quantity
+    typename TTraits::QuantityType LeavesQuantity;
+    //! Order executed quantity
+    typename TTraits::QuantityType ExecutedQuantity;
+    //! Order side
+    OrderSide Side;
+    //! Order type
+    OrderType Kind;
+};
+
+//! Price level market event
+template <class TTraits>
+struct LevelEventT : MarketEvent
+{
+    //! Level price
+    typename TTraits::PriceType Price;
+    //! Level total volume
+    typename TTraits::QuantityType TotalVolume;
+    //! Level hidden volume
+    typename TTraits::QuantityType HiddenVolume;
+    //! Level visible volume
+    typename TTraits::QuantityType VisibleVolume;
+    //! Level orders
+    uint32_t Orders;
+    //! Level side
+    LevelType Side;
+    //! Top of the book flag
+    bool Top;
+};
+
+//! Order execution market event
+template <class TTraits>
+struct ExecutionEventT : MarketEvent
+{
+    //! Order Id
+    uint64_t Id;
+    //! Execution price
+    typename TTraits::PriceType Price;
+    //! Execution quantity
+    typename TTraits::QuantityType Quantity;
+};
+
+//! Market event buffer
+/*!
+    Market event buffer is a market handler which appends compact binary
+    market event records into the caller provided memory arena instead of
+    calling per-event callbacks. The caller drains the whole batch of events
+    after one or several market operations, so recorded events could be
+    processed at once, copied or handed to another thread or socket as a
+    single memory block.
+
+    Market event buffer is dispatched statically by the market manager:
+    \code
+    MarketEventBuffer buffer(arena, sizeof(arena));
+    MarketManagerT<MarketTraits<>, MarketEventBuffer> market(buffer);
+    \endcode
+
+    Order book update events are not recorded, because each of them follows
+    the price level event with the same top of the book flag. When the next
+    event does not fit into the arena the overflow handler is called to drain
+    the buffer or to reset it with another arena. If there is no overflow
+    handler or it does not free enough space, the event is counted as lost
+    together with all following events until the buffer is drained or
+    cleared.
+
+    Not thread-safe.
+*/
+template <class TTraits>
+class MarketEventBufferT : public NullMarketHandlerT<TTraits>
+{
+    template <class, class>
+    friend class MarketManagerT;
+
+public:
+    //! Price type
+    typedef typename TTraits::PriceType PriceType;
+    //! Quantity type
+    typedef typename TTraits::QuantityType QuantityType;
+    //! Order type
+    typedef typename TTraits::Order Order;
+    //! Price level type
+    typedef typename TTraits::Level Level;
+    //! Order book type
+    typedef OrderBookT<TTraits> OrderBook;
+    //! Order event type
+    typedef OrderEventT<TTraits> OrderEvent;
+    //! Price level event type
+    typedef LevelEventT<TTraits> LevelEvent;
+    //! Order execution event type
+    typedef ExecutionEventT<TTraits> ExecutionEvent;
+    //! Overflow handler type
+    /*!
+        Overflow handler is called with the market event buffer and the given
+        context when the next event does not fit into the memory arena. It
+        should drain, clear or reset the buffer and must not throw.
+    */
+    typedef void (*OverflowHandler)(MarketEventBufferT& buffer, void* context);
+
+    //! Initialize the market event buffer with the given memory arena
+    /*!
+        \param buffer - Memory arena (must be aligned to 8 bytes)
+        \param capacity - Memory arena capacity in bytes
+    */
+    MarketEventBufferT(void* buffer, size_t capacity) noexcept;
+    MarketEventBufferT(const MarketEventBufferT&) = delete;
+    MarketEventBufferT(MarketEventBufferT&&) = delete;
+    ~MarketEventBufferT() = default;
+
+    MarketEventBufferT& operator=(const MarketEventBufferT&) = delete;
+    MarketEventBufferT& operator=(MarketEventBufferT&&) = delete;
+
+    //! Is the market event buffer empty?
+    bool empty() const noexcept { return (_size == 0); }
+    //! Get the recorded events data
+    const uint8_t* data() const noexcept { return _buffer; }
+    //! Get the recorded events size in bytes
+    size_t size() const noexcept { return _size; }
+    //! Get the memory arena capacity in bytes
+    size_t capacity() const noexcept { return _capacity; }
+    //! Get the count of recorded events
+    size_t count() const noexcept { return _count; }
+    //! Get the count of lost events which does not fit into the memory arena
+    size_t lost() const noexcept { return _lost; }
+
+    //! Set the overflow handler
+    /*!
+        \param handler - Overflow handler (nullptr to lose events which does not fit into the memory arena)
+        \param context - Overflow handler context (default is nullptr)
+    */
+    void SetOverflowHandler(OverflowHandler handler, void* context = nullptr) noexcept { _overflow = handler; _overflow_context = context; }
+
+    //! Drain all recorded events
+    /*!
+        Visitor is called with the reference to each recorded market event
+        header in the recording order. It should cast the event to the type
+        given by the header type (e.g. static_cast<const OrderEvent&>(event)).
+        Market event buffer is cleared after the drain.
+
+        \param visitor - Market event visitor
+        \return Count of drained events
+    */
+    template <class TVisitor>
+    size_t Drain(TVisitor&& visitor);
+
+    //! Clear the market event buffer
+    void Clear() noexcept { _size = 0; _count = 0; _lost = 0; }
+
+    //! Reset the market event buffer with another memory arena
+    /*!
+        Method could be used to switch between several memory arenas while
+        recorded events of the previous one are processed by another thread.
+
+        \param buffer - Memory arena (must be aligned to 8 bytes)
+        \param capacity - Memory arena capacity in bytes
+    */
+    void Reset(void* buffer, size_t capacity) noexcept;
+
+protected:
+    // Symbol handlers
+    void onAddSymbol(const Symbol& symbol) { Append<MarketEvent>(MarketEventType::ADD_SYMBOL, symbol.Id); }
+    void onDeleteSymbol(const Symbol& symbol) { Append<MarketEvent>(MarketEventType::DELETE_SYMBOL, symbol.Id); }
+
+    // Order book handlers
+    void onAddOrderBook(const OrderBook& order_book) { Append<MarketEvent>(MarketEventType::ADD_ORDER_BOOK, order_book.symbol().Id); }
+    void onDeleteOrderBook(const OrderBook& order_book) { Append<MarketEvent>(MarketEventType::DELETE_ORDER_BOOK, order_book.symbol().Id); }
+
+    // Price level handlers
+    void onAddLevel(const OrderBook& order_book, const Level& level, bool top) { AppendLevel(MarketEventType::ADD_LEVEL, order_book, level, top); }
+    void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) { AppendLevel(MarketEventType::UPDATE_LEVEL, order_book, level, top); }
+    void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) { AppendLevel(MarketEventType::DELETE_LEVEL, order_book, level, top); }
+
+    // Order handlers
+    void onAddOrder(const Order& order) { AppendOrder(MarketEventType::ADD_ORDER, order); }
+    void onUpdateOrder(const Order& order) { AppendOrder(MarketEventType::UPDATE_ORDER, order); }
+    void onDeleteOrder(const Order& order) { AppendOrder(MarketEventType::DELETE_ORDER, order); }
+
+    // Order execution handlers
+    void onExecuteOrder(const Order& order, PriceType price, QuantityType quantity);
+
+private:
+    uint8_t* _buffer;
+    size_t _capacity;
+    size_t _size;
+    size_t _count;
+    size_t _lost;
+    OverflowHandler _overflow;
+    void* _overflow_context;
+
+    template <class TEvent>
+    TEvent* Append(MarketEventType type, uint32_t symbol_id) noexcept;
+    void AppendLevel(MarketEventType type, const OrderBook& order_book, const Level& level, bool top) noexcept;
+    void AppendOrder(MarketEventType type, const Order& order) noexcept;
+};
+
+//! Market event buffer with the default market traits
+typedef MarketEventBufferT<MarketTraits<>> MarketEventBuffer;
+
+} // namespace Matching
+} // namespace CppTrader
+
+#include "market_event_buffer.inl"
+
+#endif // CPPTRADER_MATCHING_MARKET_EVENT_BUFFER_H
@@ -0,0 +1,171 @@
+/*!
+    \file market_event_buffer.inl
+    \brief Market event buffer inline implementation
+    \author Ivan Shynkarenka
+    \date 01.09.2017
+    \copyright MIT License
+*/
+
+namespace CppTrader {
+namespace Matching {
+
+template <class TOutputStream>
+inline TOutputStream& operator<<(TOutputStream& stream, MarketEventType type)
+{
+    switch (type)
+    {
+        case MarketEventType::ADD_SYMBOL:
+            stream << "ADD_SYMBOL";
+            break;
+        case MarketEventType::DELETE_SYMBOL:
+            stream << "DELETE_SYMBOL";
+            break;
+        case MarketEventType::ADD_ORDER_BOOK:
+            stream << "ADD_ORDER_BOOK";
+            break;
+        case MarketEventType::DELETE_ORDER_BOOK:
+            stream << "DELETE_ORDER_BOOK";
+            break;
+        case MarketEventType::ADD_LEVEL:
+            stream << "ADD_LEVEL";
+            break;
+        case MarketEventType::UPDATE_LEVEL:
+            stream << "UPDATE_LEVEL";
+            break;
+        case MarketEventType::DELETE_LEVEL:
+            stream << "DELETE_LEVEL";
+            break;
+        case MarketEventType::ADD_ORDER:
+            stream << "ADD_ORDER";
+            break;
+        case MarketEventType::UPDATE_ORDER:
+            stream << "UPDATE_ORDER";
+            break;
+        case MarketEventType::DELETE_ORDER:
+            stream << "DELETE_ORDER";
+            break;
+        case MarketEventType::EXECUTE_ORDER:
+            stream << "EXECUTE_ORDER";
+            break;
+        default:
+            stream << "<unknown>";
+            break;
+    }
+    return stream;
+}
+
+template <class TTraits>
+inline MarketEventBufferT<TTraits>::MarketEventBufferT(void* buffer, size_t capacity) noexcept
+    : _buffer(nullptr),
+      _capacity(0),
+      _size(0),
+      _count(0),
+      _lost(0),
+      _overflow(nullptr),
+      _overflow_context(nullptr)
+{
+    Reset(buffer, capacity);
+}
+
+template <class TTraits>
+inline void MarketEventBufferT<TTraits>::Reset(void* buffer, size_t capacity) noexcept
+{
+    assert((((uintptr_t)buffer % alignof(uint64_t)) == 0) && "Market event buffer must be aligned to 8 bytes!");
+
+    _buffer = (uint8_t*)buffer;
+    _capacity = capacity;
+    Clear();
+}
+
+template <class TTraits>
+template <class TVisitor>
+inline size_t MarketEventBufferT<TTraits>::Drain(TVisitor&& visitor)
+{
+    size_t count = 0;
+    for (size_t offset = 0; offset < _size; ++count)
+    {
+        const MarketEvent* event_ptr = (const MarketEvent*)(_buffer + offset);
+        visitor(*event_ptr);
+        offset += event_ptr->Size;
+    }
+    Clear();
+    return count;
+}
+
+template <class TTraits>
+template <class TEvent>
+inline TEvent* MarketEventBufferT<TTraits>::Append(MarketEventType type, uint32_t symbol_id) noexcept
+{
+    // Keep all event records aligned to 8 bytes
+    const size_t size = (sizeof(TEvent) + alignof(uint64_t) - 1) & ~(alignof(uint64_t) - 1);
+
+    // Let the overflow handler drain the full memory arena
+    if ((_lost == 0) && ((_capacity - _size) < size) && (_overflow != nullptr))
+        _overflow(*this, _overflow_context);
+
+    // Lose all events after the first one which does not fit into the memory arena
+    if ((_lost > 0) || ((_capacity - _size) < size))
+    {
+        ++_lost;
+        return nullptr;
+    }
+
+    // Value-initialize the event record to zero its padding
+    TEvent* event_ptr = new (_buffer + _size) TEvent();
+    event_ptr->Size = (uint16_t)size;
+    event_ptr->Type = type;
+    event_ptr->SymbolId = symbol_id;
+
+    _size += size;
+    ++_count;
+    return event_ptr;
+}
+
+template <class TTraits>
+inline void MarketEventBufferT<TTraits>::AppendLevel(MarketEventType type, const OrderBook& order_book, const Level& level, bool top) noexcept
+{
+    LevelEvent* event_ptr = Append<LevelEvent>(type, order_book.symbol().Id);
+    if (event_ptr == nullptr)
+        return;
+
+    event_ptr->Price = level.Price;
+    event_ptr->TotalVolume = level.TotalVolume;
+    event_ptr->HiddenVolume = level.HiddenVolume;
+    event_ptr->VisibleVolume = level.VisibleVolume;
+    event_ptr->Orders = (uint32_t)level.Orders;
+    event_ptr->Side = level.Type;
+    event_ptr->Top = top;
+}
+
+template <class TTraits>
+inline void MarketEventBufferT<TTraits>::AppendOrder(MarketEventType type, const Order& order) noexcept
+{
+    OrderEvent* event_ptr = Append<OrderEvent>(type, order.SymbolId);
+    if (event_ptr == nullptr)
+        return;
+
+    event_ptr->Id = order.Id;
+    event_ptr->Price = order.Price;
+    event_ptr->LeavesQuantity = order.LeavesQuantity;
+    event_ptr->ExecutedQuantity = order.ExecutedQuantity;
+    event_ptr->Side = order.Side;
+    event_ptr->Kind = order.Type;
+}
+
+template <class TTraits>
+inline void MarketEventBufferT<TTraits>::onExecuteOrder(const Order& order, PriceType price, QuantityType quantity)
+{
+    ExecutionEvent* event_ptr = Append<ExecutionEvent>(MarketEventType::EXECUTE_ORDER, order.SymbolId);
+    if (event_ptr == nullptr)
+        return;
+
+    event_ptr->Id = order.Id;
+    event_ptr->Price = price;
+    event_ptr->Quantity = quantity;
+}
+
+// Market event buffer with the default market traits is instantiated in the library
+extern template class MarketEventBufferT<MarketTraits<>>;
+
+} // namespace Matching
+} // namespace CppTrader
@@ -17,6 +17,29 @@
 namespace CppTrader {
 namespace Matching {
 
+//! Market events
+/*!
+    Market events are used as a subscription mask of the market manager to
+    select market handler notifications to perform.
+*/
+enum class MarketEvents : uint8_t
+{
+    NONE        = 0x00, //!< No market events
+    SYMBOLS     = 0x01, //!< Add/Delete symbol
+    ORDER_BOOKS = 0x02, //!< Add/Update/Delete order book
+    LEVELS      = 0x04, //!< Add/Update/Delete price level
+    ORDERS      = 0x08, //!< Add/Update/Delete order
+    EXECUTIONS  = 0x10, //!< Execute order
+    ALL         = 0x1F  //!< All market events
+};
+
+inline constexpr MarketEvents operator|(MarketEvents events1, MarketEvents events2) noexcept
+{ return (MarketEvents)((uint8_t)events1 | (uint8_t)events2); }
+inline constexpr MarketEvents operator&(MarketEvents events1, MarketEvents events2) noexcept
+{ return (MarketEvents)((uint8_t)events1 & (uint8_t)events2); }
+inline constexpr MarketEvents operator~(MarketEvents events) noexcept
+{ return (MarketEvents)(~(uint8_t)events & (uint8_t)MarketEvents::ALL); }
+
 //! Market handler class
 /*!
     Market handler is used to handle all market events from MarketManager
@@ -27,22 +50,45 @@ namespace Matching {
     \li Order executions
     \li Order book updates
 
+    While order events are subscribed onUpdateOrder() is called for each
+    recalculated stop price of trailing stop orders, so orders seen by the
+    market handler never keep a stale stop price.
+
+    Market handler should be parametrized with the same market traits as
+    the market manager.
+
     Not thread-safe.
 */
-class MarketHandler
+template <class TTraits>
+class MarketHandlerT
 {
-    friend class MarketManager;
+    template <class, class>
+    friend class MarketManagerT;
 
 public:
-    MarketHandler() = default;
-    MarketHandler(const MarketHandler&) = delete;
-    MarketHandler(MarketHandler&&) = delete;
-    virtual ~MarketHandler() = default;
+    //! Price type
+    typedef typename TTraits::PriceType PriceType;
+    //! Quantity type
+    typedef typename TTraits::QuantityType QuantityType;
+    //! Order type
+    typedef typename TTraits::Order Order;
+    //! Price level type
+    typedef typename TTraits::Level Level;
+    //! Order book type
+    typedef OrderBookT<TTraits> OrderBook;
 
-    MarketHandler& operator=(const MarketHandler&) = delete;
-    MarketHandler& operator=(MarketHandler&&) = delete;
+    MarketHandlerT() = default;
+    MarketHandlerT(const MarketHandlerT&) = delete;
+    MarketHandlerT(MarketHandlerT&&) = delete;
+    virtual ~MarketHandlerT() = default;
+
+    MarketHandlerT& operator=(const MarketHandlerT&) = delete;
+    MarketHandlerT& operator=(MarketHandlerT&&) = delete;
 
 protected:
+    // Market events which must be subscribed for the market handler
+    virtual MarketEvents RequiredEvents() const noexcept { return MarketEvents::NONE; }
+
     // Symbol handlers
     virtual void onAddSymbol(const Symbol& symbol) {}
     virtual void onDeleteSymbol(const Symbol& symbol) {}
@@ -63,9 +109,105 @@ protected:
     virtual void onDeleteOrder(const Order& order) {}
 
     // Order execution handlers
-    virtual void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) {}
+    virtual void onExecuteOrder(const Order& order, PriceType price, QuantityType quantity) {}
+
+    // Market events forwarding to the decorated market handler
+    static void ForwardAddSymbol(MarketHandlerT& handler, const Symbol& symbol) { handler.onAddSymbol(symbol); }
+    static void ForwardDeleteSymbol(MarketHandlerT& handler, const Symbol& symbol) { handler.onDeleteSymbol(symbol); }
+    static void ForwardAddOrderBook(MarketHandlerT& handler, const OrderBook& order_book) { handler.onAddOrderBook(order_book); }
+    static void ForwardUpdateOrderBook(MarketHandlerT& handler, const OrderBook& order_book, bool top) { handler.onUpdateOrderBook(order_book, top); }
+    static void ForwardDeleteOrderBook(MarketHandlerT& handler, const OrderBook& order_book) { handler.onDeleteOrderBook(order_book); }
+    static void ForwardAddLevel(MarketHandlerT& handler, const OrderBook& order_book, const Level& level, bool top) { handler.onAddLevel(order_book, level, top); }
+    static void ForwardUpdateLevel(MarketHandlerT& handler, const OrderBook& order_book, const Level& level, bool top) { handler.onUpdateLevel(order_book, level, top); }
+    static void ForwardDeleteLevel(MarketHandlerT& handler, const OrderBook& order_book, const Level& level, bool top) { handler.onDeleteLevel(order_book, level, top); }
+    static void ForwardAddOrder(MarketHandlerT& handler, const Order& order) { handler.onAddOrder(order); }
+    static void ForwardUpdateOrder(MarketHandlerT& handler, const Order& order) { handler.onUpdateOrder(order); }
+    static void ForwardDeleteOrder(MarketHandlerT& handler, const Order& order) { handler.onDeleteOrder(order); }
+    static void ForwardExecuteOrder(MarketHandlerT& handler, const Order& order, PriceType price, QuantityType quantity) { handler.onExecuteOrder(order, price, quantity); }
+};
+
+//! Market handler with the default market traits
+typedef MarketHandlerT<MarketTraits<>> MarketHandler;
+
+//! Null market handler class
+/*!
+    Null market handler ignores all market events without virtual calls.
+    It is used as a base class for market handlers dispatched statically
+    by MarketManagerT<TTraits, THandler>. Derived handler hides required
+    callbacks with non-virtual methods available to the market manager
+    and all other callbacks are inlined away.
+
+    Friendship with the market manager is not inherited, so derived handler
+    with protected or private callbacks must befriend it again:
+    \code{.cpp}
+    class MyMarketHandler : public NullMarketHandler
+    {
+        template <class, class>
+        friend class CppTrader::Matching::MarketManagerT;
+
+    protected:
+        void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) { ... }
+    };
+    \endcode
+
+    Not thread-safe.
+*/
+template <class TTraits>
+class NullMarketHandlerT
+{
+    template <class, class>
+    friend class MarketManagerT;
+
+public:
+    //! Price type
+    typedef typename TTraits::PriceType PriceType;
+    //! Quantity type
+    typedef typename TTraits::QuantityType QuantityType;
+    //! Order type
+    typedef typename TTraits::Order Order;
+    //! Price level type
+    typedef typename TTraits::Level Level;
+    //! Order book type
+    typedef OrderBookT<TTraits> OrderBook;
+
+    NullMarketHandlerT() = default;
+    NullMarketHandlerT(const NullMarketHandlerT&) = delete;
+    NullMarketHandlerT(NullMarketHandlerT&&) = delete;
+    ~NullMarketHandlerT() = default;
+
+    NullMarketHandlerT& operator=(const NullMarketHandlerT&) = delete;
+    NullMarketHandlerT& operator=(NullMarketHandlerT&&) = delete;
+
+protected:
+    // Market events which must be subscribed for the market handler
+    MarketEvents RequiredEvents() const noexcept { return MarketEvents::NONE; }
+
+    // Symbol handlers
+    void onAddSymbol(const Symbol& symbol) {}
+    void onDeleteSymbol(const Symbol& symbol) {}
+
+    // Order book handlers
+    void onAddOrderBook(const OrderBook& order_book) {}
+    void onUpdateOrderBook(const OrderBook& order_book, bool top) {}
+    void onDeleteOrderBook(const OrderBook& order_book) {}
+
+    // Price level handlers
+    void onAddLevel(const OrderBook& order_book, const Level& level, bool top) {}
+    void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) {}
+    void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) {}
+
+    // Order handlers
+    void onAddOrder(const Order& order) {}
+    void onUpdateOrder(const Order& order) {}
+    void onDeleteOrder(const Order& order) {}
+
+    // Order execution handlers
+    void onExecuteOrder(const Order& order, PriceType price, QuantityType quantity) {}
 };
 
+//! Null market handler with the default market traits
+typedef NullMarketHandlerT<MarketTraits<>> NullMarketHandler;
+
 } // namespace Matching
 } // namespace CppTrader
 
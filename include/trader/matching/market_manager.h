@@ -16,6 +16,7 @@
 #include "memory/allocator_pool.h"
 
 #include <cassert>
+#include <memory>
 #include <vector>
 
 namespace CppTrader {
@@ -26,6 +27,9 @@ namespace CppTrader {
 */
 namespace Matching {
 
+template <class TTraits>
+struct MarketCommandT;
+
 //! Market manager
 /*!
     Market manager is used to manage the market with symbols, orders and order books.
@@ -33,28 +37,58 @@ namespace Matching {
     Automatic orders matching can be enabled with EnableMatching() method or can be
     manually performed with Match() method.
 
+    Data structures of the market manager are customized with the given market
+    traits (e.g. MarketTraits<LevelsVector> to keep price levels in sorted vectors).
+
+    Market events are dispatched to the market handler of the given type. By
+    default it is the virtual MarketHandlerT class, so any custom handler could
+    be attached at runtime. Handlers of the concrete type are dispatched statically,
+    so unused callbacks of NullMarketHandlerT based handlers are inlined away
+    (e.g. MarketManagerT<MarketTraits<>, MyHandler> with MyHandler derived from
+    NullMarketHandler and hiding required callbacks).
+
     Not thread-safe.
 */
-class MarketManager
+template <class TTraits, class THandler = MarketHandlerT<TTraits>>
+class MarketManagerT
 {
-    friend class OrderBook;
-
 public:
+    //! Price type
+    typedef typename TTraits::PriceType PriceType;
+    //! Quantity type
+    typedef typename TTraits::QuantityType QuantityType;
+    //! Order type
+    typedef typename TTraits::Order Order;
+    //! Order node type
+    typedef typename TTraits::OrderNode OrderNode;
+    //! Price level type
+    typedef typename TTraits::Level Level;
+    //! Price level node type
+    typedef typename TTraits::LevelNode LevelNode;
+    //! Price level update type
+    typedef typename TTraits::LevelUpdate LevelUpdate;
+    //! Order book type
+    typedef OrderBookT<TTraits> OrderBook;
+    //! Market handler type
+    typedef THandler MarketHandler;
+    //! Market command type
+    typedef MarketCommandT<TTraits> MarketCommand;
+
     //! Symbols container
     typedef std::vector<Symbol*> Symbols;
     //! Order books container
     typedef std::vector<OrderBook*> OrderBooks;
     //! Orders container
-    typedef CppCommon::HashMap<uint64_t, OrderNode*, FastHash> Orders;
+    typedef typename TTraits::template Orders<OrderNode> Orders;
 
-    MarketManager();
-    MarketManager(MarketHandler& market_handler);
-    MarketManager(const MarketManager&) = delete;
-    MarketManager(MarketManager&&) = delete;
-    ~MarketManager();
+    MarketManagerT();
+    MarketManagerT(MarketHandler& market_handler);
+    MarketManagerT(const MarketManagerT&) = delete;
+    MarketManagerT(MarketManagerT&&) = delete;
+    ~MarketManagerT();
 
-    MarketManager& operator=(const MarketManager&) = delete;
-    MarketManager& operator=(MarketManager&&) = delete;
+    MarketManagerT& operator=(const MarketManagerT&) = delete;
+    MarketManagerT& operator=(MarketManagerT&&) = delete;
 
     //! Get the symbols container
     const Symbols& symbols() const noexcept { return _symbols; }
@@ -77,6 +111,10 @@ public:
     const OrderBook* GetOrderBook(uint32_t id) const noexcept;
     //! Get the order with the given Id
     /*!
+        Without subscribed order events stop price of the trailing stop order
+        which follows the trailing reference price of its order book is updated
+        only when the order is reduced, modified, deleted, executed or activated.
+
         \param id - Order Id
         \return Pointer to the order with the given Id or nullptr
     */
@@ -108,6 +146,25 @@ public:
     */
     ErrorCode DeleteOrderBook(uint32_t id);
 
+    //! Enable the depth cache of the order book
+    /*!
+        Depth cache keeps the given count of the best price levels of each
+        side of the order book in contiguous arrays updated in place. Cached
+        price levels are available with OrderBook::bid_depth() and
+        OrderBook::ask_depth() methods.
+
+        \param id - Symbol Id of the order book
+        \param depth - Count of the best price levels to cache for each side
+        \return Error code
+    */
+    ErrorCode EnableDepthCache(uint32_t id, size_t depth);
+    //! Disable the depth cache of the order book
+    /*!
+        \param id - Symbol Id of the order book
+        \return Error code
+    */
+    ErrorCode DisableDepthCache(uint32_t id) { return EnableDepthCache(id, 0); }
+
     //! Add a new order
     /*!
         \param order - Order to add
@@ -120,7 +177,7 @@ public:
         \param quantity - Order quantity to reduce
         \return Error code
     */
-    ErrorCode ReduceOrder(uint64_t id, uint64_t quantity);
+    ErrorCode ReduceOrder(uint64_t id, QuantityType quantity);
     //! Modify the order
     /*!
         Order new quantity will be calculated in a following way:
@@ -134,7 +191,7 @@ public:
         \param new_quantity - Order quantity to modify
         \return Error code
     */
-    ErrorCode ModifyOrder(uint64_t id, uint64_t new_price, uint64_t new_quantity);
+    ErrorCode ModifyOrder(uint64_t id, PriceType new_price, QuantityType new_quantity);
     //! Mitigate the order
     /*!
         The in-flight mitigation functionality prevents an order from being filled
@@ -166,7 +223,7 @@ public:
         \param new_quantity - Order quantity to mitigate
         \return Error code
     */
-    ErrorCode MitigateOrder(uint64_t id, uint64_t new_price, uint64_t new_quantity);
+    ErrorCode MitigateOrder(uint64_t id, PriceType new_price, QuantityType new_quantity);
     //! Replace the order with a similar order but different Id, price and quantity
     /*!
         \param id - Order Id
@@ -175,7 +232,7 @@ public:
         \param new_quantity - Order quantity to replace
         \return Error code
     */
-    ErrorCode ReplaceOrder(uint64_t id, uint64_t new_id, uint64_t new_price, uint64_t new_quantity);
+    ErrorCode ReplaceOrder(uint64_t id, uint64_t new_id, PriceType new_price, QuantityType new_quantity);
     //! Replace the order with a new one
     /*!
         \param id - Order Id
@@ -196,7 +253,7 @@ public:
         \param quantity - Order executed quantity
         \return Error code
     */
-    ErrorCode ExecuteOrder(uint64_t id, uint64_t quantity);
+    ErrorCode ExecuteOrder(uint64_t id, QuantityType quantity);
     //! Execute the order
     /*!
         \param id - Order Id
@@ -204,7 +261,32 @@ public:
         \param quantity - Order executed quantity
         \return Error code
     */
-    ErrorCode ExecuteOrder(uint64_t id, uint64_t price, uint64_t quantity);
+    ErrorCode ExecuteOrder(uint64_t id, PriceType price, QuantityType quantity);
+
+    //! Get the market events subscription mask
+    MarketEvents events() const noexcept { return _events; }
+    //! Is the given market events subscribed?
+    bool IsSubscribed(MarketEvents events) const noexcept { return (_events & events) != MarketEvents::NONE; }
+    //! Subscribe to the given market events
+    /*!
+        Market handler is notified only with subscribed market events. All
+        market events are subscribed by default. Unsubscribed market events
+        are skipped without calling the market handler, e.g. consumers of
+        executions and the top of the book could subscribe only to
+        MarketEvents::EXECUTIONS and poll OrderBook::top_of_book().
+
+        Market events required by the market handler (e.g. order book
+        snapshots) are always subscribed in addition to the given ones.
+
+        Without subscribed order events trailing stop orders with an absolute
+        trailing distance and without trailing step follow the single trailing
+        reference price of their order book instead of the per-order stop price
+        recalculation. Subscribing to order events moves such orders back to
+        the per-order recalculation and notifies their actual stop prices.
+
+        \param events - Market events subscription mask
+    */
+    void Subscribe(MarketEvents events);
 
     //! Is automatic matching enabled?
     bool IsMatchingEnabled() const noexcept { return _matching; }
@@ -213,6 +295,26 @@ public:
     //! Disable automatic matching
     void DisableMatching() { _matching = false; }
 
+    //! Is price level updates coalescing enabled?
+    bool IsLevelCoalescingEnabled() const noexcept { return _coalescing; }
+    //! Enable price level updates coalescing
+    /*!
+        When price level updates coalescing is enabled, price level changes
+        are accumulated during each market operation (e.g. AddOrder() with
+        automatic matching) and the market handler is notified with one net
+        update for each touched price level followed by one order book update
+        for each touched order book at the end of the operation. A price
+        level added and deleted within the same operation is not reported.
+        Order and execution events are not delayed, so they precede the price
+        level updates of the operation.
+
+        Index of pending price level updates is allocated when coalescing is
+        enabled and released when it is disabled.
+    */
+    void EnableLevelCoalescing();
+    //! Disable price level updates coalescing
+    void DisableLevelCoalescing();
+
     //! Match crossed orders in all order books
     /*!
         Method will match all crossed orders in each order book. Buy orders will be
@@ -220,9 +322,37 @@ public:
         Matched orders will be executed with deleted form the order book. After the
         matching operation each order book will have the best bid price guarantied
         less than the best ask price!
+
+        Order books modified while automatic matching is disabled are tracked in
+        the dirty order books list, so only they are visited by the method and its
+        cost depends on the market activity instead of the count of order books.
     */
     void Match();
 
+    //! Apply the batch of market commands
+    /*!
+        Method applies market commands one by one with the same result codes as
+        separate MarketManager calls. When automatic matching is enabled, matching
+        of order commands is deferred: each touched order book is marked dirty and
+        matched once at the end of the batch (or before the next symbol, order book
+        or matching command) instead of matching it after each order command.
+
+        Deferred matching executes crossed orders of dirty order books at arbitrage
+        prices the same way as Match() method does, so executions of a batch with
+        crossing orders could differ from the strict sequence. 'Market',
+        'Immediate-Or-Cancel' and 'Fill-Or-Kill' orders are always matched
+        immediately after their dirty order book is matched. Strict mode keeps
+        the exact sequential matching semantics of each command.
+
+        Market commands must be parametrized with the same market traits.
+
+        \param commands - Market commands to apply
+        \param count - Count of market commands
+        \param strict - Strict sequence flag to match after each command (default is false)
+        \return Count of failed market commands
+    */
+    size_t ApplyBatch(const MarketCommand* commands, size_t count, bool strict = false);
+
 private:
     // Market handler
     static MarketHandler _default;
@@ -250,36 +380,83 @@ private:
     CppCommon::PoolAllocator<OrderNode, CppCommon::DefaultMemoryManager> _order_pool;
     Orders _orders;
 
+    // Market events subscription
+    MarketEvents _events;
+
     ErrorCode AddMarketOrder(const Order& order, bool recursive);
     ErrorCode AddLimitOrder(const Order& order, bool recursive);
     ErrorCode AddStopOrder(const Order& order, bool recursive);
     ErrorCode AddStopLimitOrder(const Order& order, bool recursive);
-    ErrorCode ReduceOrder(uint64_t id, uint64_t quantity, bool recursive);
-    ErrorCode ModifyOrder(uint64_t id, uint64_t new_price, uint64_t new_quantity, bool mitigate, bool recursive);
-    ErrorCode ReplaceOrder(uint64_t id, uint64_t new_id, uint64_t new_price, uint64_t new_quantity, bool recursive);
+    ErrorCode ReduceOrder(uint64_t id, QuantityType quantity, bool recursive);
+    ErrorCode ModifyOrder(uint64_t id, PriceType new_price, QuantityType new_quantity, bool mitigate, bool recursive);
+    ErrorCode ReplaceOrder(uint64_t id, uint64_t new_id, PriceType new_price, QuantityType new_quantity, bool recursive);
     ErrorCode DeleteOrder(uint64_t id, bool recursive);
 
     // Matching
     bool _matching;
 
+    // Dirty order books with deferred matching
+    OrderBook* _dirty_books;
+
+    void MarkDirty(OrderBook* order_book_ptr) noexcept;
+    void UnmarkDirty(OrderBook* order_book_ptr) noexcept;
+    void MatchDirty();
+    void MatchDirty(OrderBook* order_book_ptr);
+
     void Match(OrderBook* order_book_ptr);
     void MatchMarket(OrderBook* order_book_ptr, Order* order_ptr);
     void MatchLimit(OrderBook* order_book_ptr, Order* order_ptr);
     void MatchOrder(OrderBook* order_book_ptr, Order* order_ptr);
+    void SweepLevel(OrderBook* order_book_ptr, LevelNode* level_ptr, Order* order_ptr);
 
     bool ActivateStopOrders(OrderBook* order_book_ptr);
-    bool ActivateStopOrders(OrderBook* order_book_ptr, LevelNode* level_ptr, uint64_t stop_price);
+    bool ActivateStopOrders(OrderBook* order_book_ptr, OrderSide side);
+    bool ActivateStopOrders(OrderBook* order_book_ptr, LevelNode* level_ptr, PriceType stop_price);
+    bool ActivateStopOrders(OrderBook* order_book_ptr, LevelNode* level_ptr);
+    bool ActivateTrailingStopOrders(OrderBook* order_book_ptr, OrderSide side, PriceType stop_price);
     bool ActivateStopOrder(OrderBook* order_book_ptr, OrderNode* order_ptr);
     bool ActivateStopLimitOrder(OrderBook* order_book_ptr, OrderNode* order_ptr);
 
-    uint64_t CalculateMatchingChain(OrderBook* order_book_ptr, LevelNode* level_ptr, uint64_t price, uint64_t volume);
-    uint64_t CalculateMatchingChain(OrderBook* order_book_ptr, LevelNode* bid_level_ptr, LevelNode* ask_level_ptr);
-    void ExecuteMatchingChain(OrderBook* order_book_ptr, LevelNode* level_ptr, uint64_t price, uint64_t volume);
+    QuantityType CalculateMatchingChain(OrderBook* order_book_ptr, LevelNode* level_ptr, PriceType price, QuantityType volume);
+    QuantityType CalculateMatchingChain(OrderBook* order_book_ptr, LevelNode* bid_level_ptr, LevelNode* ask_level_ptr);
+    void ExecuteMatchingChain(OrderBook* order_book_ptr, LevelNode* level_ptr, PriceType price, QuantityType volume);
+    void RecalculateTrailingStopPrice(OrderBook* order_book_ptr, OrderSide side);
     void RecalculateTrailingStopPrice(OrderBook* order_book_ptr, LevelNode* level_ptr);
-
-    void UpdateLevel(const OrderBook& order_book, const LevelUpdate& update) const;
+    void UnlinkTrailingDistanceOrders(OrderBook* order_book_ptr);
+
+    // Price level updates coalescing
+    bool _coalescing;
+    std::vector<std::pair<OrderBook*, LevelUpdate>> _level_updates;
+
+    // Pending price level update key
+    struct LevelKey
+    {
+        const OrderBook* Book;
+        LevelType Type;
+        PriceType Price;
+
+        friend bool operator==(const LevelKey& key1, const LevelKey& key2) noexcept
+        { return (key1.Book == key2.Book) && (key1.Type == key2.Type) && (key1.Price == key2.Price); }
+    };
+
+    // Pending price level update key hash
+    struct LevelKeyHash
+    {
+        size_t operator()(const LevelKey& key) const noexcept
+        { return FastHash()((uint64_t)key.Price ^ ((uint64_t)(uintptr_t)key.Book << 1) ^ (uint64_t)key.Type); }
+    };
+
+    // Index of pending price level updates
+    std::unique_ptr<CppCommon::HashMap<LevelKey, size_t, LevelKeyHash>> _level_slots;
+
+    void UpdateLevel(OrderBook& order_book, const LevelUpdate& update);
+    void CoalesceLevel(OrderBook& order_book, const LevelUpdate& update);
+    void FlushLevelUpdates();
 };
 
+//! Market manager with the default market traits
+typedef MarketManagerT<MarketTraits<>> MarketManager;
+
 /*! \example market_manager.cpp Market manager example */
 /*! \example matching_engine.cpp Matching engine example */
 
@@ -288,4 +465,7 @@ private:
 
 #include "market_manager.inl"
 
+// Market commands applied with ApplyBatch() method
+#include "market_command.h"
+
 #endif // CPPTRADER_MATCHING_MARKET_MANAGER_H
@@ -9,12 +9,14 @@
 namespace CppTrader {
 namespace Matching {
 
-inline MarketManager::MarketManager()
-    : MarketManager(_default)
+template <class TTraits, class THandler>
+inline MarketManagerT<TTraits, THandler>::MarketManagerT()
+    : MarketManagerT(_default)
 {
 }
 
-inline MarketManager::MarketManager(MarketHandler& market_handler)
+template <class TTraits, class THandler>
+inline MarketManagerT<TTraits, THandler>::MarketManagerT(MarketHandler& market_handler)
     : _market_handler(market_handler),
       _auxiliary_memory_manager(),
       _level_memory_manager(_auxiliary_memory_manager),
@@ -25,23 +27,29 @@ inline MarketManager::MarketManager(MarketHandler& market_handler)
       _order_book_pool(_order_book_memory_manager),
       _order_memory_manager(_auxiliary_memory_manager),
       _order_pool(_order_memory_manager),
-      _orders(16384, 0),
-      _matching(false)
+      _orders(),
+      _events(MarketEvents::ALL),
+      _matching(false),
+      _dirty_books(nullptr),
+      _coalescing(false)
 {
 
 }
 
-inline const Symbol* MarketManager::GetSymbol(uint32_t id) const noexcept
+template <class TTraits, class THandler>
+inline const Symbol* MarketManagerT<TTraits, THandler>::GetSymbol(uint32_t id) const noexcept
 {
     return ((id < _symbols.size()) ? _symbols[id] : nullptr);
 }
 
-inline const OrderBook* MarketManager::GetOrderBook(uint32_t id) const noexcept
+template <class TTraits, class THandler>
+inline const OrderBookT<TTraits>* MarketManagerT<TTraits, THandler>::GetOrderBook(uint32_t id) const noexcept
 {
     return ((id < _order_books.size()) ? _order_books[id] : nullptr);
 }
 
-inline const Order* MarketManager::GetOrder(uint64_t id) const noexcept
+template <class TTraits, class THandler>
+inline const typename MarketManagerT<TTraits, THandler>::Order* MarketManagerT<TTraits, THandler>::GetOrder(uint64_t id) const noexcept
 {
     assert((id > 0) && "Order Id must be greater than zero!");
     if (id == 0)
@@ -51,5 +59,2405 @@ inline const Order* MarketManager::GetOrder(uint64_t id) const noexcept
     return ((it != _orders.end()) ? it->second : nullptr);
 }
 
+template <class TTraits, class THandler>
+THandler MarketManagerT<TTraits, THandler>::_default;
+
+template <class TTraits, class THandler>
+MarketManagerT<TTraits, THandler>::~MarketManagerT()
+{
+    // Release orders
+    for (const auto& order : _orders)
+        _order_pool.Release(order.second);
+    _orders.clear();
+
+    // Release order books
+    for (auto order_book_ptr : _order_books)
+        if (order_book_ptr != nullptr)
+            _order_book_pool.Release(order_book_ptr);
+    _order_books.clear();
+
+    // Release symbols
+    for (auto symbol_ptr : _symbols)
+        if (symbol_ptr != nullptr)
+            _symbol_pool.Release(symbol_ptr);
+    _symbols.clear();
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::AddSymbol(const Symbol& symbol)
+{
+    // Resize the symbol container
+    if (_symbols.size() <= symbol.Id)
+        _symbols.resize(symbol.Id + 1, nullptr);
+
+    // Create a new symbol
+    Symbol* symbol_ptr = _symbol_pool.Create(symbol);
+
+    // Insert the symbol
+    assert((_symbols[symbol.Id] == nullptr) && "Duplicate symbol detected!");
+    if (_symbols[symbol.Id] != nullptr)
+    {
+        // Release the symbol
+        _symbol_pool.Release(symbol_ptr);
+        return ErrorCode::SYMBOL_DUPLICATE;
+    }
+    _symbols[symbol.Id] = symbol_ptr;
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::SYMBOLS))
+        _market_handler.onAddSymbol(*symbol_ptr);
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::DeleteSymbol(uint32_t id)
+{
+    assert(((id < _symbols.size()) && (_symbols[id] != nullptr)) && "Symbol not found!");
+    if ((_symbols.size() <= id) || (_symbols[id] == nullptr))
+        return ErrorCode::SYMBOL_NOT_FOUND;
+
+    // Get the symbol by Id
+    Symbol* symbol_ptr = _symbols[id];
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::SYMBOLS))
+        _market_handler.onDeleteSymbol(*symbol_ptr);
+
+    // Erase the symbol
+    _symbols[id] = nullptr;
+
+    // Release the symbol
+    _symbol_pool.Release(symbol_ptr);
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::AddOrderBook(const Symbol& symbol)
+{
+    assert(((symbol.Id < _symbols.size()) && (_symbols[symbol.Id] != nullptr)) && "Symbol not found!");
+    if ((_symbols.size() <= symbol.Id) || (_symbols[symbol.Id] == nullptr))
+        return ErrorCode::SYMBOL_NOT_FOUND;
+
+    // Get the symbol by Id
+    Symbol* symbol_ptr = _symbols[symbol.Id];
+
+    // Resize the order book container
+    if (_order_books.size() <= symbol.Id)
+        _order_books.resize(symbol.Id + 1, nullptr);
+
+    // Create a new order book
+    OrderBook* order_book_ptr = _order_book_pool.Create(_level_pool, *symbol_ptr);
+
+    // Insert the order book
+    assert((_order_books[symbol.Id] == nullptr) && "Duplicate order book detected!");
+    if (_order_books[symbol.Id] != nullptr)
+    {
+        // Release the order book
+        _order_book_pool.Release(order_book_ptr);
+        return ErrorCode::ORDER_BOOK_DUPLICATE;
+    }
+    _order_books[symbol.Id] = order_book_ptr;
+
+    // Copy price level volumes only for subscribed price level updates
+    order_book_ptr->_level_updates = IsSubscribed(MarketEvents::LEVELS);
+
+    // Follow trailing reference prices only without subscribed order updates
+    order_book_ptr->_trailing_references = !IsSubscribed(MarketEvents::ORDERS);
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDER_BOOKS))
+        _market_handler.onAddOrderBook(*order_book_ptr);
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::DeleteOrderBook(uint32_t id)
+{
+    assert(((id < _order_books.size()) && (_order_books[id] != nullptr)) && "Order book not found!");
+    if ((_order_books.size() <= id) || (_order_books[id] == nullptr))
+        return ErrorCode::ORDER_BOOK_NOT_FOUND;
+
+    // Get the order book by Id
+    OrderBook* order_book_ptr = _order_books[id];
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDER_BOOKS))
+        _market_handler.onDeleteOrderBook(*order_book_ptr);
+
+    // Erase the order book
+    _order_books[id] = nullptr;
+
+    // Unlink the order book from the dirty order books list
+    if (order_book_ptr->_dirty)
+        UnmarkDirty(order_book_ptr);
+
+    // Release the order book
+    _order_book_pool.Release(order_book_ptr);
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::EnableDepthCache(uint32_t id, size_t depth)
+{
+    assert(((id < _order_books.size()) && (_order_books[id] != nullptr)) && "Order book not found!");
+    if ((_order_books.size() <= id) || (_order_books[id] == nullptr))
+        return ErrorCode::ORDER_BOOK_NOT_FOUND;
+
+    // Fill the depth cache from the current price levels
+    _order_books[id]->ResetDepthCache(depth);
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::AddOrder(const Order& order)
+{
+    // Validate order parameters
+    ErrorCode result = order.Validate();
+    if (result == ErrorCode::OK)
+    {
+        // Add the corresponding order type
+        switch (order.Type)
+        {
+            case OrderType::MARKET:
+                result = AddMarketOrder(order, false);
+                break;
+            case OrderType::LIMIT:
+                result = AddLimitOrder(order, false);
+                break;
+            case OrderType::STOP:
+            case OrderType::TRAILING_STOP:
+                result = AddStopOrder(order, false);
+                break;
+            case OrderType::STOP_LIMIT:
+            case OrderType::TRAILING_STOP_LIMIT:
+                result = AddStopLimitOrder(order, false);
+                break;
+            default:
+                result = ErrorCode::ORDER_TYPE_INVALID;
+                break;
+        }
+    }
+
+    // Flush coalesced price level updates of the operation on every exit path
+    FlushLevelUpdates();
+
+    return result;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::AddMarketOrder(const Order& order, bool recursive)
+{
+    // Get the valid order book for the order
+    OrderBook* order_book_ptr = (OrderBook*)GetOrderBook(order.SymbolId);
+    if (order_book_ptr == nullptr)
+        return ErrorCode::ORDER_BOOK_NOT_FOUND;
+
+    Order new_order(order);
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDERS))
+        _market_handler.onAddOrder(new_order);
+
+    // Automatic order matching
+    if (_matching && !recursive)
+        MatchMarket(order_book_ptr, &new_order);
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDERS))
+        _market_handler.onDeleteOrder(new_order);
+
+    // Automatic order matching
+    if (_matching && !recursive)
+        Match(order_book_ptr);
+
+    // Deferred order matching
+    if (!_matching && !recursive)
+        MarkDirty(order_book_ptr);
+
+    // Reset matching price
+    order_book_ptr->ResetMatchingPrice();
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::AddLimitOrder(const Order& order, bool recursive)
+{
+    // Get the valid order book for the order
+    OrderBook* order_book_ptr = (OrderBook*)GetOrderBook(order.SymbolId);
+    if (order_book_ptr == nullptr)
+        return ErrorCode::ORDER_BOOK_NOT_FOUND;
+
+    Order new_order(order);
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDERS))
+        _market_handler.onAddOrder(new_order);
+
+    // Automatic order matching
+    if (_matching && !recursive)
+        MatchLimit(order_book_ptr, &new_order);
+
+    // Add a new order or delete remaining part in case of 'Immediate-Or-Cancel'/'Fill-Or-Kill' order
+    if ((new_order.LeavesQuantity > 0) && !new_order.IsIOC() && !new_order.IsFOK())
+    {
+        // Create a new order
+        OrderNode* order_ptr = _order_pool.Create(new_order);
+
+        // Insert the order
+        if (!_orders.insert(std::make_pair(order_ptr->Id, order_ptr)).second)
+        {
+            // Call the corresponding handler
+            if (IsSubscribed(MarketEvents::ORDERS))
+                _market_handler.onDeleteOrder(*order_ptr);
+
+            // Release the order
+            _order_pool.Release(order_ptr);
+
+            return ErrorCode::ORDER_DUPLICATE;
+        }
+
+        // Add the new limit order into the order book
+        UpdateLevel(*order_book_ptr, order_book_ptr->AddOrder(order_ptr));
+    }
+    else
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onDeleteOrder(new_order);
+    }
+
+    // Automatic order matching
+    if (_matching && !recursive)
+        Match(order_book_ptr);
+
+    // Deferred order matching
+    if (!_matching && !recursive)
+        MarkDirty(order_book_ptr);
+
+    // Reset matching price
+    order_book_ptr->ResetMatchingPrice();
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::AddStopOrder(const Order& order, bool recursive)
+{
+    // Get the valid order book for the order
+    OrderBook* order_book_ptr = (OrderBook*)GetOrderBook(order.SymbolId);
+    if (order_book_ptr == nullptr)
+        return ErrorCode::ORDER_BOOK_NOT_FOUND;
+
+    Order new_order(order);
+
+    // Recalculate stop price for trailing stop orders
+    if (new_order.IsTrailingStop() || new_order.IsTrailingStopLimit())
+        new_order.StopPrice = order_book_ptr->CalculateTrailingStopPrice(new_order);
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDERS))
+        _market_handler.onAddOrder(new_order);
+
+    // Automatic order matching
+    if (_matching && !recursive)
+    {
+        // Find the price to match the stop order
+        PriceType stop_price = new_order.IsBuy() ? order_book_ptr->GetMarketPriceAsk() : order_book_ptr->GetMarketPriceBid();
+
+        // Check the arbitrage bid/ask prices
+        bool arbitrage = new_order.IsBuy() ? (new_order.StopPrice <= stop_price) : (new_order.StopPrice >= stop_price);
+        if (arbitrage)
+        {
+            // Convert the stop order into the market order
+            new_order.Type = OrderType::MARKET;
+            new_order.Price = 0;
+            new_order.StopPrice = 0;
+            new_order.TimeInForce = new_order.IsFOK() ? OrderTimeInForce::FOK : OrderTimeInForce::IOC;
+
+            // Call the corresponding handler
+            if (IsSubscribed(MarketEvents::ORDERS))
+                _market_handler.onUpdateOrder(new_order);
+
+            // Match the market order
+            MatchMarket(order_book_ptr, &new_order);
+
+            // Call the corresponding handler
+            if (IsSubscribed(MarketEvents::ORDERS))
+                _market_handler.onDeleteOrder(new_order);
+
+            // Automatic order matching
+            if (_matching && !recursive)
+                Match(order_book_ptr);
+
+            // Reset matching price
+            order_book_ptr->ResetMatchingPrice();
+
+            return ErrorCode::OK;
+        }
+    }
+
+    // Add a new order
+    if (new_order.LeavesQuantity > 0)
+    {
+        // Create a new order
+        OrderNode* order_ptr = _order_pool.Create(new_order);
+
+        // Insert the order
+        if (!_orders.insert(std::make_pair(order_ptr->Id, order_ptr)).second)
+        {
+            // Call the corresponding handler
+            if (IsSubscribed(MarketEvents::ORDERS))
+                _market_handler.onDeleteOrder(*order_ptr);
+
+            // Release the order
+            _order_pool.Release(order_ptr);
+
+            return ErrorCode::ORDER_DUPLICATE;
+        }
+
+        // Add the new stop order into the order book
+        if (order_ptr->IsTrailingStop() || order_ptr->IsTrailingStopLimit())
+            order_book_ptr->AddTrailingStopOrder(order_ptr);
+        else
+            order_book_ptr->AddStopOrder(order_ptr);
+    }
+    else
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onDeleteOrder(new_order);
+    }
+
+    // Automatic order matching
+    if (_matching && !recursive)
+        Match(order_book_ptr);
+
+    // Deferred order matching
+    if (!_matching && !recursive)
+        MarkDirty(order_book_ptr);
+
+    // Reset matching price
+    order_book_ptr->ResetMatchingPrice();
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::AddStopLimitOrder(const Order& order, bool recursive)
+{
+    // Get the valid order book for the order
+    OrderBook* order_book_ptr = (OrderBook*)GetOrderBook(order.SymbolId);
+    if (order_book_ptr == nullptr)
+        return ErrorCode::ORDER_BOOK_NOT_FOUND;
+
+    Order new_order(order);
+
+    // Recalculate stop price for trailing stop orders
+    if (new_order.IsTrailingStop() || new_order.IsTrailingStopLimit())
+    {
+        int64_t diff = new_order.Price - new_order.StopPrice;
+        new_order.StopPrice = order_book_ptr->CalculateTrailingStopPrice(new_order);
+        new_order.Price = new_order.StopPrice + diff;
+    }
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDERS))
+        _market_handler.onAddOrder(new_order);
+
+    // Automatic order matching
+    if (_matching && !recursive)
+    {
+        // Find the price to match the stop-limit order
+        PriceType stop_price = new_order.IsBuy() ? order_book_ptr->GetMarketPriceAsk() : order_book_ptr->GetMarketPriceBid();
+
+        // Check the arbitrage bid/ask prices
+        bool arbitrage = new_order.IsBuy() ? (new_order.StopPrice <= stop_price) : (new_order.StopPrice >= stop_price);
+        if (arbitrage)
+        {
+            // Convert the stop-limit order into the limit order
+            new_order.Type = OrderType::LIMIT;
+            new_order.StopPrice = 0;
+
+            // Call the corresponding handler
+            if (IsSubscribed(MarketEvents::ORDERS))
+                _market_handler.onUpdateOrder(new_order);
+
+            // Match the limit order
+            MatchLimit(order_book_ptr, &new_order);
+
+            // Add a new limit order or delete remaining part in case of 'Immediate-Or-Cancel'/'Fill-Or-Kill' order
+            if ((new_order.LeavesQuantity > 0) && !new_order.IsIOC() && !new_order.IsFOK())
+            {
+                // Create a new order
+                OrderNode* order_ptr = _order_pool.Create(new_order);
+
+                // Insert the order
+                if (!_orders.insert(std::make_pair(order_ptr->Id, order_ptr)).second)
+                {
+                    // Call the corresponding handler
+                    if (IsSubscribed(MarketEvents::ORDERS))
+                        _market_handler.onDeleteOrder(*order_ptr);
+
+                    // Release the order
+                    _order_pool.Release(order_ptr);
+
+                    return ErrorCode::ORDER_DUPLICATE;
+                }
+
+                // Add the new limit order into the order book
+                UpdateLevel(*order_book_ptr, order_book_ptr->AddOrder(order_ptr));
+            }
+            else
+            {
+                // Call the corresponding handler
+                if (IsSubscribed(MarketEvents::ORDERS))
+                    _market_handler.onDeleteOrder(new_order);
+            }
+
+            // Automatic order matching
+            if (_matching && !recursive)
+                Match(order_book_ptr);
+
+            // Reset matching price
+            order_book_ptr->ResetMatchingPrice();
+
+            return ErrorCode::OK;
+        }
+    }
+
+    // Add a new order
+    if (new_order.LeavesQuantity > 0)
+    {
+        // Create a new order
+        OrderNode* order_ptr = _order_pool.Create(new_order);
+
+        // Insert the order
+        if (!_orders.insert(std::make_pair(order_ptr->Id, order_ptr)).second)
+        {
+            // Call the corresponding handler
+            if (IsSubscribed(MarketEvents::ORDERS))
+                _market_handler.onDeleteOrder(*order_ptr);
+
+            // Release the order
+            _order_pool.Release(order_ptr);
+
+            return ErrorCode::ORDER_DUPLICATE;
+        }
+
+        // Add the new stop order into the order book
+        if (order_ptr->IsTrailingStop() || order_ptr->IsTrailingStopLimit())
+            order_book_ptr->AddTrailingStopOrder(order_ptr);
+        else
+            order_book_ptr->AddStopOrder(order_ptr);
+    }
+    else
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onDeleteOrder(new_order);
+    }
+
+    // Automatic order matching
+    if (_matching && !recursive)
+        Match(order_book_ptr);
+
+    // Deferred order matching
+    if (!_matching && !recursive)
+        MarkDirty(order_book_ptr);
+
+    // Reset matching price
+    order_book_ptr->ResetMatchingPrice();
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::ReduceOrder(uint64_t id, QuantityType quantity)
+{
+    ErrorCode result = ReduceOrder(id, quantity, false);
+
+    // Flush coalesced price level updates of the operation
+    FlushLevelUpdates();
+
+    return result;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::ReduceOrder(uint64_t id, QuantityType quantity, bool recursive)
+{
+    // Validate parameters
+    assert((id > 0) && "Order Id must be greater than zero!");
+    if (id == 0)
+        return ErrorCode::ORDER_ID_INVALID;
+    assert((quantity > 0) && "Order quantity must be greater than zero!");
+    if (quantity == 0)
+        return ErrorCode::ORDER_QUANTITY_INVALID;
+
+    // Get the order to reduce
+    auto order_it = _orders.find(id);
+    assert((order_it != _orders.end()) && "Order not found!");
+    if (order_it == _orders.end())
+        return ErrorCode::ORDER_NOT_FOUND;
+    OrderNode* order_ptr = (OrderNode*)order_it->second;
+
+    // Get the valid order book for the order
+    OrderBook* order_book_ptr = (OrderBook*)GetOrderBook(order_ptr->SymbolId);
+    if (order_book_ptr == nullptr)
+        return ErrorCode::ORDER_BOOK_NOT_FOUND;
+
+    // Calculate the stop price of the trailing stop order from the trailing reference price
+    order_book_ptr->MaterializeTrailingStopOrder(order_ptr);
+
+    // Calculate the minimal possible order quantity to reduce
+    quantity = std::min(quantity, order_ptr->LeavesQuantity);
+
+    QuantityType hidden = order_ptr->HiddenQuantity();
+    QuantityType visible = order_ptr->VisibleQuantity();
+
+    // Reduce the order leaves quantity
+    order_ptr->LeavesQuantity -= quantity;
+
+    hidden -= order_ptr->HiddenQuantity();
+    visible -= order_ptr->VisibleQuantity();
+
+    // Update the order or delete the empty order
+    if (order_ptr->LeavesQuantity > 0)
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onUpdateOrder(*order_ptr);
+
+        // Reduce the order in the order book
+        switch (order_ptr->Type)
+        {
+            case OrderType::LIMIT:
+                UpdateLevel(*order_book_ptr, order_book_ptr->ReduceOrder(order_ptr, quantity, hidden, visible));
+                break;
+            case OrderType::STOP:
+            case OrderType::STOP_LIMIT:
+                order_book_ptr->ReduceStopOrder(order_ptr, quantity, hidden, visible);
+                break;
+            case OrderType::TRAILING_STOP:
+            case OrderType::TRAILING_STOP_LIMIT:
+                order_book_ptr->ReduceTrailingStopOrder(order_ptr, quantity, hidden, visible);
+                break;
+            default:
+                assert(false && "Unsupported order type!");
+                break;
+        }
+     }
+    else
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onDeleteOrder(*order_ptr);
+
+        // Reduce the order in the order book
+        switch (order_ptr->Type)
+        {
+            case OrderType::LIMIT:
+                UpdateLevel(*order_book_ptr, order_book_ptr->ReduceOrder(order_ptr, quantity, hidden, visible));
+                break;
+            case OrderType::STOP:
+            case OrderType::STOP_LIMIT:
+                order_book_ptr->ReduceStopOrder(order_ptr, quantity, hidden, visible);
+                break;
+            case OrderType::TRAILING_STOP:
+            case OrderType::TRAILING_STOP_LIMIT:
+                order_book_ptr->ReduceTrailingStopOrder(order_ptr, quantity, hidden, visible);
+                break;
+            default:
+                assert(false && "Unsupported order type!");
+                break;
+        }
+
+        // Erase the order
+        _orders.erase(order_it);
+
+        // Relase the order
+        _order_pool.Release(order_ptr);
+    }
+
+    // Automatic order matching
+    if (_matching && !recursive)
+        Match(order_book_ptr);
+
+    // Deferred order matching
+    if (!_matching && !recursive)
+        MarkDirty(order_book_ptr);
+
+    // Reset matching price
+    order_book_ptr->ResetMatchingPrice();
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::ModifyOrder(uint64_t id, PriceType new_price, QuantityType new_quantity)
+{
+    ErrorCode result = ModifyOrder(id, new_price, new_quantity, false, false);
+
+    // Flush coalesced price level updates of the operation
+    FlushLevelUpdates();
+
+    return result;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::MitigateOrder(uint64_t id, PriceType new_price, QuantityType new_quantity)
+{
+    ErrorCode result = ModifyOrder(id, new_price, new_quantity, true, false);
+
+    // Flush coalesced price level updates of the operation
+    FlushLevelUpdates();
+
+    return result;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::ModifyOrder(uint64_t id, PriceType new_price, QuantityType new_quantity, bool mitigate, bool recursive)
+{
+    // Validate parameters
+    assert((id > 0) && "Order Id must be greater than zero!");
+    if (id == 0)
+        return ErrorCode::ORDER_ID_INVALID;
+    assert((new_quantity > 0) && "Order quantity must be greater than zero!");
+    if (new_quantity == 0)
+        return ErrorCode::ORDER_QUANTITY_INVALID;
+
+    // Get the order to modify
+    auto order_it = _orders.find(id);
+    assert((order_it != _orders.end()) && "Order not found!");
+    if (order_it == _orders.end())
+        return ErrorCode::ORDER_NOT_FOUND;
+    OrderNode* order_ptr = (OrderNode*)order_it->second;
+
+    // Get the valid order book for the order
+    OrderBook* order_book_ptr = (OrderBook*)GetOrderBook(order_ptr->SymbolId);
+    if (order_book_ptr == nullptr)
+        return ErrorCode::ORDER_BOOK_NOT_FOUND;
+
+    // Calculate the stop price of the trailing stop order from the trailing reference price
+    order_book_ptr->MaterializeTrailingStopOrder(order_ptr);
+
+    // Delete the order from the order book
+    switch (order_ptr->Type)
+    {
+        case OrderType::LIMIT:
+            UpdateLevel(*order_book_ptr, order_book_ptr->DeleteOrder(order_ptr));
+            break;
+        case OrderType::STOP:
+        case OrderType::STOP_LIMIT:
+            order_book_ptr->DeleteStopOrder(order_ptr);
+            break;
+        case OrderType::TRAILING_STOP:
+        case OrderType::TRAILING_STOP_LIMIT:
+            order_book_ptr->DeleteTrailingStopOrder(order_ptr);
+            break;
+        default:
+            assert(false && "Unsupported order type!");
+            break;
+    }
+
+    // Modify the order
+    order_ptr->Price = new_price;
+    order_ptr->Quantity = new_quantity;
+    order_ptr->LeavesQuantity = new_quantity;
+
+    // In-Flight Mitigation (IFM)
+    if (mitigate)
+    {
+        // This calculation has the goal of preventing orders from being overfilled
+        if (new_quantity > order_ptr->ExecutedQuantity)
+            order_ptr->LeavesQuantity = new_quantity - order_ptr->ExecutedQuantity;
+        else
+            order_ptr->LeavesQuantity = 0;
+    }
+
+    // Update the order
+    if (order_ptr->LeavesQuantity > 0)
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onUpdateOrder(*order_ptr);
+
+        // Automatic order matching
+        if (_matching && !recursive)
+            MatchLimit(order_book_ptr, order_ptr);
+
+        // Add non empty order into the order book
+        if (order_ptr->LeavesQuantity > 0)
+        {
+            // Add the modified order into the order book
+            switch (order_ptr->Type)
+            {
+                case OrderType::LIMIT:
+                    UpdateLevel(*order_book_ptr, order_book_ptr->AddOrder(order_ptr));
+                    break;
+                case OrderType::STOP:
+                case OrderType::STOP_LIMIT:
+                    order_book_ptr->AddStopOrder(order_ptr);
+                    break;
+                case OrderType::TRAILING_STOP:
+                case OrderType::TRAILING_STOP_LIMIT:
+                    order_book_ptr->AddTrailingStopOrder(order_ptr);
+                    break;
+                default:
+                    assert(false && "Unsupported order type!");
+                    break;
+            }
+        }
+    }
+
+    // Delete the empty order
+    if (order_ptr->LeavesQuantity == 0)
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onDeleteOrder(*order_ptr);
+
+        // Erase the order
+        _orders.erase(order_it);
+
+        // Relase the order
+        _order_pool.Release(order_ptr);
+    }
+
+    // Automatic order matching
+    if (_matching && !recursive)
+        Match(order_book_ptr);
+
+    // Deferred order matching
+    if (!_matching && !recursive)
+        MarkDirty(order_book_ptr);
+
+    // Reset matching price
+    order_book_ptr->ResetMatchingPrice();
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::ReplaceOrder(uint64_t id, uint64_t new_id, PriceType new_price, QuantityType new_quantity)
+{
+    ErrorCode result = ReplaceOrder(id, new_id, new_price, new_quantity, false);
+
+    // Flush coalesced price level updates of the operation
+    FlushLevelUpdates();
+
+    return result;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::ReplaceOrder(uint64_t id, uint64_t new_id, PriceType new_price, QuantityType new_quantity, bool recursive)
+{
+    // Validate parameters
+    assert((id > 0) && "Order Id must be greater than zero!");
+    if (id == 0)
+        return ErrorCode::ORDER_ID_INVALID;
+    assert((new_id > 0) && "New order Id must be greater than zero!");
+    if (new_id == 0)
+        return ErrorCode::ORDER_ID_INVALID;
+    assert((new_quantity > 0) && "Order quantity must be greater than zero!");
+    if (new_quantity == 0)
+        return ErrorCode::ORDER_QUANTITY_INVALID;
+
+    // Get the order to replace
+    auto order_it = _orders.find(id);
+    assert((order_it != _orders.end()) && "Order not found!");
+    if (order_it == _orders.end())
+        return ErrorCode::ORDER_NOT_FOUND;
+    OrderNode* order_ptr = (OrderNode*)order_it->second;
+    assert(order_ptr->IsLimit() && "Replace order operation is valid only for limit orders!");
+    if (!order_ptr->IsLimit())
+        return ErrorCode::ORDER_TYPE_INVALID;
+
+    // Get the valid order book for the order
+    OrderBook* order_book_ptr = (OrderBook*)GetOrderBook(order_ptr->SymbolId);
+    if (order_book_ptr == nullptr)
+        return ErrorCode::ORDER_BOOK_NOT_FOUND;
+
+    // Delete the old order from the order book
+    switch (order_ptr->Type)
+    {
+        case OrderType::LIMIT:
+            UpdateLevel(*order_book_ptr, order_book_ptr->DeleteOrder(order_ptr));
+            break;
+        case OrderType::STOP:
+        case OrderType::STOP_LIMIT:
+            order_book_ptr->DeleteStopOrder(order_ptr);
+            break;
+        case OrderType::TRAILING_STOP:
+        case OrderType::TRAILING_STOP_LIMIT:
+            order_book_ptr->DeleteTrailingStopOrder(order_ptr);
+            break;
+        default:
+            assert(false && "Unsupported order type!");
+            break;
+    }
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDERS))
+        _market_handler.onDeleteOrder(*order_ptr);
+
+    // Erase the order
+    _orders.erase(order_it);
+
+    // Replace the order
+    order_ptr->Id = new_id;
+    order_ptr->Price = new_price;
+    order_ptr->Quantity = new_quantity;
+    order_ptr->ExecutedQuantity = 0;
+    order_ptr->LeavesQuantity = new_quantity;
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDERS))
+        _market_handler.onAddOrder(*order_ptr);
+
+    // Automatic order matching
+    if (_matching && !recursive)
+        MatchLimit(order_book_ptr, order_ptr);
+
+    if (order_ptr->LeavesQuantity > 0)
+    {
+        // Insert the order
+        if (!_orders.insert(std::make_pair(order_ptr->Id, order_ptr)).second)
+        {
+            // Call the corresponding handler
+            if (IsSubscribed(MarketEvents::ORDERS))
+                _market_handler.onDeleteOrder(*order_ptr);
+
+            // Release the order
+            _order_pool.Release(order_ptr);
+
+            return ErrorCode::ORDER_DUPLICATE;
+        }
+
+        // Add the modified order into the order book
+        switch (order_ptr->Type)
+        {
+            case OrderType::LIMIT:
+                UpdateLevel(*order_book_ptr, order_book_ptr->AddOrder(order_ptr));
+                break;
+            case OrderType::STOP:
+            case OrderType::STOP_LIMIT:
+                order_book_ptr->AddStopOrder(order_ptr);
+                break;
+            case OrderType::TRAILING_STOP:
+            case OrderType::TRAILING_STOP_LIMIT:
+                order_book_ptr->AddTrailingStopOrder(order_ptr);
+                break;
+            default:
+                assert(false && "Unsupported order type!");
+                break;
+        }
+    }
+    else
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onDeleteOrder(*order_ptr);
+
+        // Relase the order
+        _order_pool.Release(order_ptr);
+    }
+
+    // Automatic order matching
+    if (_matching && !recursive)
+        Match(order_book_ptr);
+
+    // Deferred order matching
+    if (!_matching && !recursive)
+        MarkDirty(order_book_ptr);
+
+    // Reset matching price
+    order_book_ptr->ResetMatchingPrice();
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::ReplaceOrder(uint64_t id, const Order& new_order)
+{
+    // Delete the previous order by Id
+    ErrorCode result = DeleteOrder(id, false);
+    if (result != ErrorCode::OK)
+    {
+        // Flush coalesced price level updates of the operation
+        FlushLevelUpdates();
+        return result;
+    }
+
+    // Add the new order. Price level updates of both orders are flushed
+    // together by AddOrder() even if the new order is rejected
+    return AddOrder(new_order);
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::DeleteOrder(uint64_t id)
+{
+    ErrorCode result = DeleteOrder(id, false);
+
+    // Flush coalesced price level updates of the operation
+    FlushLevelUpdates();
+
+    return result;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::DeleteOrder(uint64_t id, bool recursive)
+{
+    // Validate parameters
+    assert((id > 0) && "Order Id must be greater than zero!");
+    if (id == 0)
+        return ErrorCode::ORDER_ID_INVALID;
+
+    // Get the order to delete
+    auto order_it = _orders.find(id);
+    assert((order_it != _orders.end()) && "Order not found!");
+    if (order_it == _orders.end())
+        return ErrorCode::ORDER_NOT_FOUND;
+    OrderNode* order_ptr = (OrderNode*)order_it->second;
+
+    // Get the valid order book for the order
+    OrderBook* order_book_ptr = (OrderBook*)GetOrderBook(order_ptr->SymbolId);
+    if (order_book_ptr == nullptr)
+        return ErrorCode::ORDER_BOOK_NOT_FOUND;
+
+    // Calculate the stop price of the trailing stop order from the trailing reference price
+    order_book_ptr->MaterializeTrailingStopOrder(order_ptr);
+
+    // Delete the order from the order book
+    switch (order_ptr->Type)
+    {
+        case OrderType::LIMIT:
+            UpdateLevel(*order_book_ptr, order_book_ptr->DeleteOrder(order_ptr));
+            break;
+        case OrderType::STOP:
+        case OrderType::STOP_LIMIT:
+            order_book_ptr->DeleteStopOrder(order_ptr);
+            break;
+        case OrderType::TRAILING_STOP:
+        case OrderType::TRAILING_STOP_LIMIT:
+            order_book_ptr->DeleteTrailingStopOrder(order_ptr);
+            break;
+        default:
+            assert(false && "Unsupported order type!");
+            break;
+    }
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDERS))
+        _market_handler.onDeleteOrder(*order_ptr);
+
+    // Erase the order
+    _orders.erase(order_it);
+
+    // Relase the order
+    _order_pool.Release(order_ptr);
+
+    // Automatic order matching
+    if (_matching && !recursive)
+        Match(order_book_ptr);
+
+    // Deferred order matching
+    if (!_matching && !recursive)
+        MarkDirty(order_book_ptr);
+
+    // Reset matching price
+    order_book_ptr->ResetMatchingPrice();
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::ExecuteOrder(uint64_t id, QuantityType quantity)
+{
+    // Validate parameters
+    assert((id > 0) && "Order Id must be greater than zero!");
+    if (id == 0)
+        return ErrorCode::ORDER_ID_INVALID;
+    assert((quantity > 0) && "Order quantity must be greater than zero!");
+    if (quantity == 0)
+        return ErrorCode::ORDER_QUANTITY_INVALID;
+
+    // Get the order to execute
+    auto order_it = _orders.find(id);
+    assert((order_it != _orders.end()) && "Order not found!");
+    if (order_it == _orders.end())
+        return ErrorCode::ORDER_NOT_FOUND;
+    OrderNode* order_ptr = (OrderNode*)order_it->second;
+
+    // Get the valid order book for the order
+    OrderBook* order_book_ptr = (OrderBook*)GetOrderBook(order_ptr->SymbolId);
+    if (order_book_ptr == nullptr)
+        return ErrorCode::ORDER_BOOK_NOT_FOUND;
+
+    // Calculate the stop price of the trailing stop order from the trailing reference price
+    order_book_ptr->MaterializeTrailingStopOrder(order_ptr);
+
+    // Calculate the minimal possible order quantity to execute
+    quantity = std::min(quantity, order_ptr->LeavesQuantity);
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::EXECUTIONS))
+        _market_handler.onExecuteOrder(*order_ptr, order_ptr->Price, quantity);
+
+    // Update the corresponding market price
+    order_book_ptr->UpdateLastPrice(*order_ptr, order_ptr->Price);
+    order_book_ptr->UpdateMatchingPrice(*order_ptr, order_ptr->Price);
+
+    QuantityType hidden = order_ptr->HiddenQuantity();
+    QuantityType visible = order_ptr->VisibleQuantity();
+
+    // Increase the order executed quantity
+    order_ptr->ExecutedQuantity += quantity;
+
+    // Reduce the order leaves quantity
+    order_ptr->LeavesQuantity -= quantity;
+
+    hidden -= order_ptr->HiddenQuantity();
+    visible -= order_ptr->VisibleQuantity();
+
+    // Reduce the order in the order book
+    switch (order_ptr->Type)
+    {
+        case OrderType::LIMIT:
+            UpdateLevel(*order_book_ptr, order_book_ptr->ReduceOrder(order_ptr, quantity, hidden, visible));
+            break;
+        case OrderType::STOP:
+        case OrderType::STOP_LIMIT:
+            order_book_ptr->ReduceStopOrder(order_ptr, quantity, hidden, visible);
+            break;
+        case OrderType::TRAILING_STOP:
+        case OrderType::TRAILING_STOP_LIMIT:
+            order_book_ptr->ReduceTrailingStopOrder(order_ptr, quantity, hidden, visible);
+            break;
+        default:
+            assert(false && "Unsupported order type!");
+            break;
+    }
+
+    // Update the order or delete the empty order
+    if (order_ptr->LeavesQuantity > 0)
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onUpdateOrder(*order_ptr);
+    }
+    else
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onDeleteOrder(*order_ptr);
+
+        // Erase the order
+        _orders.erase(order_it);
+
+        // Relase the order
+        _order_pool.Release(order_ptr);
+    }
+
+    // Automatic order matching
+    if (_matching)
+        Match(order_book_ptr);
+
+    // Deferred order matching
+    if (!_matching)
+        MarkDirty(order_book_ptr);
+
+    // Reset matching price
+    order_book_ptr->ResetMatchingPrice();
+
+    // Flush coalesced price level updates of the operation
+    FlushLevelUpdates();
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+ErrorCode MarketManagerT<TTraits, THandler>::ExecuteOrder(uint64_t id, PriceType price, QuantityType quantity)
+{
+    // Validate parameters
+    assert((id > 0) && "Order Id must be greater than zero!");
+    if (id == 0)
+        return ErrorCode::ORDER_ID_INVALID;
+    assert((quantity > 0) && "Order quantity must be greater than zero!");
+    if (quantity == 0)
+        return ErrorCode::ORDER_QUANTITY_INVALID;
+
+    // Get the order to execute
+    auto order_it = _orders.find(id);
+    assert((order_it != _orders.end()) && "Order not found!");
+    if (order_it == _orders.end())
+        return ErrorCode::ORDER_NOT_FOUND;
+    OrderNode* order_ptr = (OrderNode*)order_it->second;
+
+    // Get the valid order book for the order
+    OrderBook* order_book_ptr = (OrderBook*)GetOrderBook(order_ptr->SymbolId);
+    if (order_book_ptr == nullptr)
+        return ErrorCode::ORDER_BOOK_NOT_FOUND;
+
+    // Calculate the stop price of the trailing stop order from the trailing reference price
+    order_book_ptr->MaterializeTrailingStopOrder(order_ptr);
+
+    // Calculate the minimal possible order quantity to execute
+    quantity = std::min(quantity, order_ptr->LeavesQuantity);
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::EXECUTIONS))
+        _market_handler.onExecuteOrder(*order_ptr, price, quantity);
+
+    // Update the corresponding market price
+    order_book_ptr->UpdateLastPrice(*order_ptr, price);
+    order_book_ptr->UpdateMatchingPrice(*order_ptr, price);
+
+    QuantityType hidden = order_ptr->HiddenQuantity();
+    QuantityType visible = order_ptr->VisibleQuantity();
+
+    // Increase the order executed quantity
+    order_ptr->ExecutedQuantity += quantity;
+
+    // Reduce the order leaves quantity
+    order_ptr->LeavesQuantity -= quantity;
+
+    hidden -= order_ptr->HiddenQuantity();
+    visible -= order_ptr->VisibleQuantity();
+
+    // Reduce the order in the order book
+    switch (order_ptr->Type)
+    {
+        case OrderType::LIMIT:
+            UpdateLevel(*order_book_ptr, order_book_ptr->ReduceOrder(order_ptr, quantity, hidden, visible));
+            break;
+        case OrderType::STOP:
+        case OrderType::STOP_LIMIT:
+            order_book_ptr->ReduceStopOrder(order_ptr, quantity, hidden, visible);
+            break;
+        case OrderType::TRAILING_STOP:
+        case OrderType::TRAILING_STOP_LIMIT:
+            order_book_ptr->ReduceTrailingStopOrder(order_ptr, quantity, hidden, visible);
+            break;
+        default:
+            assert(false && "Unsupported order type!");
+            break;
+    }
+
+    // Update the order or delete the empty order
+    if (order_ptr->LeavesQuantity > 0)
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onUpdateOrder(*order_ptr);
+    }
+    else
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onDeleteOrder(*order_ptr);
+
+        // Erase the order
+        _orders.erase(order_it);
+
+        // Relase the order
+        _order_pool.Release(order_ptr);
+    }
+
+    // Automatic order matching
+    if (_matching)
+        Match(order_book_ptr);
+
+    // Deferred order matching
+    if (!_matching)
+        MarkDirty(order_book_ptr);
+
+    // Reset matching price
+    order_book_ptr->ResetMatchingPrice();
+
+    // Flush coalesced price level updates of the operation
+    FlushLevelUpdates();
+
+    return ErrorCode::OK;
+}
+
+template <class TTraits, class THandler>
+inline void MarketManagerT<TTraits, THandler>::Subscribe(MarketEvents events)
+{
+    _events = events | _market_handler.RequiredEvents();
+
+    for (auto order_book_ptr : _order_books)
+    {
+        if (order_book_ptr != nullptr)
+        {
+            // Copy price level volumes only for subscribed price level updates
+            order_book_ptr->_level_updates = IsSubscribed(MarketEvents::LEVELS);
+
+            // Follow trailing reference prices only without subscribed order updates
+            order_book_ptr->_trailing_references = !IsSubscribed(MarketEvents::ORDERS);
+            if (IsSubscribed(MarketEvents::ORDERS))
+                UnlinkTrailingDistanceOrders(order_book_ptr);
+        }
+    }
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::EnableLevelCoalescing()
+{
+    // Allocate the index of pending price level updates
+    if (!_level_slots)
+        _level_slots = std::make_unique<CppCommon::HashMap<LevelKey, size_t, LevelKeyHash>>(1024, LevelKey{ nullptr, LevelType::BID, 0 });
+
+    _coalescing = true;
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::DisableLevelCoalescing()
+{
+    FlushLevelUpdates();
+    _coalescing = false;
+
+    // Release the index and the buffer of pending price level updates
+    _level_slots.reset();
+    _level_updates.shrink_to_fit();
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::Match()
+{
+    // Only dirty order books could be crossed or have stop orders to activate
+    MatchDirty();
+
+    // Flush coalesced price level updates of the operation
+    FlushLevelUpdates();
+}
+
+template <class TTraits, class THandler>
+size_t MarketManagerT<TTraits, THandler>::ApplyBatch(const MarketCommand* commands, size_t count, bool strict)
+{
+    size_t errors = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const MarketCommand& command = commands[i];
+
+        ErrorCode result;
+        if (strict || !_matching || !command.IsOrderCommand())
+        {
+            // Match dirty order books before symbol, order book and matching commands
+            if (_matching)
+                Match();
+
+            result = command.Execute(*this);
+        }
+        else if (command.IsImmediateOrder())
+        {
+            // Match the dirty order book before the immediate order
+            const OrderBook* order_book_ptr = command.GetOrderBook(*this);
+            if ((order_book_ptr != nullptr) && order_book_ptr->_dirty)
+                MatchDirty(_order_books[order_book_ptr->symbol().Id]);
+
+            result = command.Execute(*this);
+        }
+        else
+        {
+            // Disable matching until the end of the command even if it throws
+            struct MatchingGuard
+            {
+                bool& matching;
+                explicit MatchingGuard(bool& enabled) noexcept : matching(enabled) { matching = false; }
+                ~MatchingGuard() noexcept { matching = true; }
+            };
+
+            // Touched order book is marked dirty while matching is disabled
+            MatchingGuard guard(_matching);
+            result = command.Execute(*this);
+        }
+
+        if (result != ErrorCode::OK)
+            ++errors;
+    }
+
+    // Match dirty order books at the end of the batch
+    if (_matching)
+        Match();
+
+    return errors;
+}
+
+template <class TTraits, class THandler>
+inline void MarketManagerT<TTraits, THandler>::MarkDirty(OrderBook* order_book_ptr) noexcept
+{
+    if (order_book_ptr->_dirty)
+        return;
+
+    // Link the order book into the head of the dirty order books list
+    order_book_ptr->_dirty = true;
+    order_book_ptr->_prev_dirty = nullptr;
+    order_book_ptr->_next_dirty = _dirty_books;
+    if (_dirty_books != nullptr)
+        _dirty_books->_prev_dirty = order_book_ptr;
+    _dirty_books = order_book_ptr;
+}
+
+template <class TTraits, class THandler>
+inline void MarketManagerT<TTraits, THandler>::UnmarkDirty(OrderBook* order_book_ptr) noexcept
+{
+    assert(order_book_ptr->_dirty && "Order book is not dirty!");
+
+    // Unlink the order book from the dirty order books list
+    if (order_book_ptr->_prev_dirty != nullptr)
+        order_book_ptr->_prev_dirty->_next_dirty = order_book_ptr->_next_dirty;
+    else
+        _dirty_books = order_book_ptr->_next_dirty;
+    if (order_book_ptr->_next_dirty != nullptr)
+        order_book_ptr->_next_dirty->_prev_dirty = order_book_ptr->_prev_dirty;
+    order_book_ptr->_dirty = false;
+    order_book_ptr->_prev_dirty = nullptr;
+    order_book_ptr->_next_dirty = nullptr;
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::MatchDirty()
+{
+    while (_dirty_books != nullptr)
+        MatchDirty(_dirty_books);
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::MatchDirty(OrderBook* order_book_ptr)
+{
+    UnmarkDirty(order_book_ptr);
+
+    Match(order_book_ptr);
+
+    // Reset matching price
+    order_book_ptr->ResetMatchingPrice();
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::Match(OrderBook* order_book_ptr)
+{
+    // Matching loop
+    for (;;)
+    {
+        // Check the arbitrage bid/ask prices
+        while ((order_book_ptr->_best_bid != nullptr) &&
+               (order_book_ptr->_best_ask != nullptr) &&
+               (order_book_ptr->_best_bid->Price >= order_book_ptr->_best_ask->Price))
+        {
+            // Find the best bid/ask price level
+            LevelNode* bid_level_ptr = order_book_ptr->_best_bid;
+            LevelNode* ask_level_ptr = order_book_ptr->_best_ask;
+
+            // Find the first order to execute and the first order to reduce
+            OrderNode* bid_order_ptr = bid_level_ptr->OrderList.front();
+            OrderNode* ask_order_ptr = ask_level_ptr->OrderList.front();
+
+            // Execute crossed orders
+            while ((bid_order_ptr != nullptr) && (ask_order_ptr != nullptr))
+            {
+                // Find the next orders pair
+                OrderNode* next_bid_order_ptr = bid_order_ptr->next;
+                OrderNode* next_ask_order_ptr = ask_order_ptr->next;
+
+                // Special case for 'All-Or-None' orders
+                if (bid_order_ptr->IsAON() || ask_order_ptr->IsAON())
+                {
+                    // Calculate the matching chain
+                    QuantityType chain = CalculateMatchingChain(order_book_ptr, bid_level_ptr, ask_level_ptr);
+
+                    // Matching is not avaliable
+                    if (chain == 0)
+                        return;
+
+                    // Execute orders in the matching chain
+                    if (bid_order_ptr->IsAON())
+                    {
+                        PriceType price = bid_order_ptr->Price;
+                        ExecuteMatchingChain(order_book_ptr, bid_level_ptr, price, chain);
+                        ExecuteMatchingChain(order_book_ptr, ask_level_ptr, price, chain);
+                    }
+                    else
+                    {
+                        PriceType price = ask_order_ptr->Price;
+                        ExecuteMatchingChain(order_book_ptr, ask_level_ptr, price, chain);
+                        ExecuteMatchingChain(order_book_ptr, bid_level_ptr, price, chain);
+                    }
+
+                    break;
+                }
+
+                // Find the best order to execute and the best order to reduce
+                OrderNode* executing_order_ptr = bid_order_ptr;
+                OrderNode* reducing_order_ptr = ask_order_ptr;
+                if (executing_order_ptr->LeavesQuantity > reducing_order_ptr->LeavesQuantity)
+                    std::swap(executing_order_ptr, reducing_order_ptr);
+
+                // Get the execution quantity
+                QuantityType quantity = executing_order_ptr->LeavesQuantity;
+
+                // Get the execution price
+                PriceType price = executing_order_ptr->Price;
+
+                // Call the corresponding handler
+                if (IsSubscribed(MarketEvents::EXECUTIONS))
+                    _market_handler.onExecuteOrder(*executing_order_ptr, price, quantity);
+
+                // Update the corresponding market price
+                order_book_ptr->UpdateLastPrice(*executing_order_ptr, price);
+                order_book_ptr->UpdateMatchingPrice(*executing_order_ptr, price);
+
+                // Increase the order executed quantity
+                executing_order_ptr->ExecutedQuantity += quantity;
+
+                // Delete the executing order from the order book
+                DeleteOrder(executing_order_ptr->Id, true);
+
+                // Call the corresponding handler
+                if (IsSubscribed(MarketEvents::EXECUTIONS))
+                    _market_handler.onExecuteOrder(*reducing_order_ptr, price, quantity);
+
+                // Update the corresponding market price
+                order_book_ptr->UpdateLastPrice(*reducing_order_ptr, price);
+                order_book_ptr->UpdateMatchingPrice(*reducing_order_ptr, price);
+
+                // Increase the order executed quantity
+                reducing_order_ptr->ExecutedQuantity += quantity;
+
+                // Reduce the remaining order in the order book
+                ReduceOrder(reducing_order_ptr->Id, quantity, true);
+
+                // Move to the next orders pair at the same price level
+                bid_order_ptr = next_bid_order_ptr;
+                ask_order_ptr = next_ask_order_ptr;
+            }
+
+            // Activate stop orders only if the current price level changed
+            if (order_book_ptr->IsStopActivationRequired(OrderSide::BUY))
+                ActivateStopOrders(order_book_ptr, (LevelNode*)order_book_ptr->best_buy_stop(), order_book_ptr->GetMarketPriceAsk());
+            if (order_book_ptr->IsStopActivationRequired(OrderSide::SELL))
+                ActivateStopOrders(order_book_ptr, (LevelNode*)order_book_ptr->best_sell_stop(), order_book_ptr->GetMarketPriceBid());
+        }
+
+        // Activate stop orders until there is something to activate
+        if (!ActivateStopOrders(order_book_ptr))
+            break;
+    }
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::MatchMarket(OrderBook* order_book_ptr, Order* order_ptr)
+{
+    // Calculate acceptable marker order price with optional slippage value
+    if (order_ptr->IsBuy())
+    {
+        // Check if there is nothing to buy
+        if (order_book_ptr->best_ask() == nullptr)
+            return;
+
+        order_ptr->Price = order_book_ptr->best_ask()->Price;
+        if (order_ptr->Price > (std::numeric_limits<PriceType>::max() - order_ptr->Slippage))
+            order_ptr->Price = std::numeric_limits<PriceType>::max();
+        else
+            order_ptr->Price += order_ptr->Slippage;
+    }
+    else
+    {
+        // Check if there is nothing to sell
+        if (order_book_ptr->best_bid() == nullptr)
+            return;
+
+        order_ptr->Price = order_book_ptr->best_bid()->Price;
+        if (order_ptr->Price < (std::numeric_limits<PriceType>::min() + order_ptr->Slippage))
+            order_ptr->Price = std::numeric_limits<PriceType>::min();
+        else
+            order_ptr->Price -= order_ptr->Slippage;
+    }
+
+    // Match the market order
+    MatchOrder(order_book_ptr, order_ptr);
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::MatchLimit(OrderBook* order_book_ptr, Order* order_ptr)
+{
+    // Match the limit order
+    MatchOrder(order_book_ptr, order_ptr);
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::MatchOrder(OrderBook* order_book_ptr, Order* order_ptr)
+{
+    // Start the matching from the top of the book
+    LevelNode* level_ptr;
+    while ((level_ptr = order_ptr->IsBuy() ? order_book_ptr->_best_ask : order_book_ptr->_best_bid) != nullptr)
+    {
+        // Check the arbitrage bid/ask prices
+        bool arbitrage = order_ptr->IsBuy() ? (order_ptr->Price >= level_ptr->Price) : (order_ptr->Price <= level_ptr->Price);
+        if (!arbitrage)
+            return;
+
+        // Special case for 'Fill-Or-Kill'/'All-Or-None' order
+        if (order_ptr->IsFOK() || order_ptr->IsAON())
+        {
+            // Calculate the matching chain
+            QuantityType chain = CalculateMatchingChain(order_book_ptr, level_ptr, order_ptr->Price, order_ptr->LeavesQuantity);
+
+            // Matching is not avaliable
+            if (chain == 0)
+                return;
+
+            // Execute orders in the matching chain
+            ExecuteMatchingChain(order_book_ptr, level_ptr, order_ptr->Price, chain);
+
+            // Call the corresponding handler
+            if (IsSubscribed(MarketEvents::EXECUTIONS))
+                _market_handler.onExecuteOrder(*order_ptr, order_ptr->Price, order_ptr->LeavesQuantity);
+
+            // Update the corresponding market price
+            order_book_ptr->UpdateLastPrice(*order_ptr, order_ptr->Price);
+            order_book_ptr->UpdateMatchingPrice(*order_ptr, order_ptr->Price);
+
+            // Increase the order executed quantity
+            order_ptr->ExecutedQuantity += order_ptr->LeavesQuantity;
+
+            // Reduce the order leaves quantity
+            order_ptr->LeavesQuantity = 0;
+
+            return;
+        }
+
+        // Sweep the whole price level covered by the order
+        if (order_ptr->LeavesQuantity >= level_ptr->TotalVolume)
+        {
+            SweepLevel(order_book_ptr, level_ptr, order_ptr);
+            if (order_ptr->LeavesQuantity == 0)
+                return;
+            continue;
+        }
+
+        // Find the first order to execute
+        OrderNode* executing_order_ptr = level_ptr->OrderList.front();
+
+        // Execute crossed orders
+        while (executing_order_ptr != nullptr)
+        {
+            // Find the next order to execute
+            OrderNode* next_executing_order_ptr = executing_order_ptr->next;
+
+            // Get the execution quantity
+            QuantityType quantity = std::min(executing_order_ptr->LeavesQuantity, order_ptr->LeavesQuantity);
+
+            // Special case for 'All-Or-None' orders
+            if (executing_order_ptr->IsAON() && (executing_order_ptr->LeavesQuantity > order_ptr->LeavesQuantity))
+                return;
+
+            // Get the execution price
+            PriceType price = executing_order_ptr->Price;
+
+            // Call the corresponding handler
+            if (IsSubscribed(MarketEvents::EXECUTIONS))
+                _market_handler.onExecuteOrder(*executing_order_ptr, price, quantity);
+
+            // Update the corresponding market price
+            order_book_ptr->UpdateLastPrice(*executing_order_ptr, price);
+            order_book_ptr->UpdateMatchingPrice(*executing_order_ptr, price);
+
+            // Increase the order executed quantity
+            executing_order_ptr->ExecutedQuantity += quantity;
+
+            // Reduce the executing order in the order book
+            ReduceOrder(executing_order_ptr->Id, quantity, true);
+
+            // Call the corresponding handler
+            if (IsSubscribed(MarketEvents::EXECUTIONS))
+                _market_handler.onExecuteOrder(*order_ptr, price, quantity);
+
+            // Update the corresponding market price
+            order_book_ptr->UpdateLastPrice(*order_ptr, price);
+            order_book_ptr->UpdateMatchingPrice(*order_ptr, price);
+
+            // Increase the order executed quantity
+            order_ptr->ExecutedQuantity += quantity;
+
+            // Reduce the order leaves quantity
+            order_ptr->LeavesQuantity -= quantity;
+            if (order_ptr->LeavesQuantity == 0)
+                return;
+
+            // Move to the next order to execute at the same price level
+            executing_order_ptr = next_executing_order_ptr;
+        }
+    }
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::SweepLevel(OrderBook* order_book_ptr, LevelNode* level_ptr, Order* order_ptr)
+{
+    // Get the execution price
+    PriceType price = level_ptr->Price;
+
+    // Execute all orders of the price level in one pass
+    OrderNode* executing_order_ptr;
+    while ((executing_order_ptr = level_ptr->OrderList.pop_front()) != nullptr)
+    {
+        // Get the execution quantity
+        QuantityType quantity = executing_order_ptr->LeavesQuantity;
+
+        // Reduce the price level volume by the unlinked order, so handlers see the rest of the price level
+        level_ptr->TotalVolume -= quantity;
+        level_ptr->HiddenVolume -= executing_order_ptr->HiddenQuantity();
+        level_ptr->VisibleVolume -= executing_order_ptr->VisibleQuantity();
+        --level_ptr->Orders;
+
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::EXECUTIONS))
+            _market_handler.onExecuteOrder(*executing_order_ptr, price, quantity);
+
+        // Update the corresponding market price
+        order_book_ptr->UpdateLastPrice(*executing_order_ptr, price);
+
+        // Increase the order executed quantity
+        executing_order_ptr->ExecutedQuantity += quantity;
+
+        // Reduce the order leaves quantity
+        executing_order_ptr->LeavesQuantity = 0;
+
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onDeleteOrder(*executing_order_ptr);
+
+        // Erase the order
+        _orders.erase(_orders.find(executing_order_ptr->Id));
+
+        // Release the order
+        _order_pool.Release(executing_order_ptr);
+
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::EXECUTIONS))
+            _market_handler.onExecuteOrder(*order_ptr, price, quantity);
+
+        // Update the corresponding market price
+        order_book_ptr->UpdateLastPrice(*order_ptr, price);
+
+        // Increase the order executed quantity
+        order_ptr->ExecutedQuantity += quantity;
+
+        // Reduce the order leaves quantity
+        order_ptr->LeavesQuantity -= quantity;
+    }
+
+    // Reset matching price the same way as the executed order reduce does
+    // and keep the matching price of the order
+    order_book_ptr->ResetMatchingPrice();
+    order_book_ptr->UpdateMatchingPrice(*order_ptr, price);
+
+    // Delete the swept price level with a single update
+    UpdateLevel(*order_book_ptr, order_book_ptr->SweepLevel(level_ptr));
+}
+
+template <class TTraits, class THandler>
+bool MarketManagerT<TTraits, THandler>::ActivateStopOrders(OrderBook* order_book_ptr)
+{
+    bool result = false;
+    bool stop = false;
+
+    while (!stop)
+    {
+        stop = true;
+
+        // Try to activate buy stop orders
+        if (ActivateStopOrders(order_book_ptr, OrderSide::BUY))
+        {
+            result = true;
+            stop = false;
+        }
+
+        // Recalculate trailing buy stop orders
+        RecalculateTrailingStopPrice(order_book_ptr, OrderSide::BUY);
+
+        // Try to activate sell stop orders
+        if (ActivateStopOrders(order_book_ptr, OrderSide::SELL))
+        {
+            result = true;
+            stop = false;
+        }
+
+        // Recalculate trailing sell stop orders
+        RecalculateTrailingStopPrice(order_book_ptr, OrderSide::SELL);
+    }
+
+    return result;
+}
+
+template <class TTraits, class THandler>
+bool MarketManagerT<TTraits, THandler>::ActivateStopOrders(OrderBook* order_book_ptr, OrderSide side)
+{
+    bool result = false;
+    OrderSide opposite = (side == OrderSide::BUY) ? OrderSide::SELL : OrderSide::BUY;
+
+    // Activate all stop price levels crossed by the market price in one batch
+    while (order_book_ptr->IsStopActivationRequired(side))
+    {
+        bool activated;
+        if (side == OrderSide::BUY)
+            activated = ActivateStopOrders(order_book_ptr, (LevelNode*)order_book_ptr->best_buy_stop(), order_book_ptr->GetMarketPriceAsk()) ||
+                        ActivateTrailingStopOrders(order_book_ptr, side, order_book_ptr->GetMarketPriceAsk());
+        else
+            activated = ActivateStopOrders(order_book_ptr, (LevelNode*)order_book_ptr->best_sell_stop(), order_book_ptr->GetMarketPriceBid()) ||
+                        ActivateTrailingStopOrders(order_book_ptr, side, order_book_ptr->GetMarketPriceBid());
+
+        if (!activated)
+            break;
+
+        result = true;
+
+        // Recalculate trailing stop orders of the same side
+        RecalculateTrailingStopPrice(order_book_ptr, side);
+
+        // Stop the batch if the opposite side is crossed as well. Both sides are
+        // then activated in turns, one stop price level of each side per pass.
+        if (order_book_ptr->IsStopActivationRequired(opposite))
+            break;
+
+        // Recalculate trailing stop orders of the opposite side
+        RecalculateTrailingStopPrice(order_book_ptr, opposite);
+    }
+
+    return result;
+}
+
+template <class TTraits, class THandler>
+bool MarketManagerT<TTraits, THandler>::ActivateStopOrders(OrderBook* order_book_ptr, LevelNode* level_ptr, PriceType stop_price)
+{
+    if (level_ptr == nullptr)
+        return false;
+
+    // Check the arbitrage bid/ask prices
+    bool arbitrage = level_ptr->IsBid() ? (stop_price <= level_ptr->Price) : (stop_price >= level_ptr->Price);
+    if (!arbitrage)
+        return false;
+
+    return ActivateStopOrders(order_book_ptr, level_ptr);
+}
+
+template <class TTraits, class THandler>
+bool MarketManagerT<TTraits, THandler>::ActivateStopOrders(OrderBook* order_book_ptr, LevelNode* level_ptr)
+{
+    bool result = false;
+
+    // Find the stop order to activate
+    OrderNode* activating_order_ptr = level_ptr->OrderList.front();
+
+    // Activate all stop orders
+    while (activating_order_ptr != nullptr)
+    {
+        // Find the next order to activate
+        OrderNode* next_activating_order_ptr = activating_order_ptr->next;
+
+        // Calculate the stop price of the trailing stop order from the trailing reference price
+        order_book_ptr->MaterializeTrailingStopOrder(activating_order_ptr);
+
+        // Activate the stop order
+        switch (activating_order_ptr->Type)
+        {
+            case OrderType::STOP:
+            case OrderType::TRAILING_STOP:
+                result = ActivateStopOrder(order_book_ptr, activating_order_ptr);
+                break;
+            case OrderType::STOP_LIMIT:
+            case OrderType::TRAILING_STOP_LIMIT:
+                result = ActivateStopLimitOrder(order_book_ptr, activating_order_ptr);
+                break;
+            default:
+                assert(false && "Unsupported order type!");
+                break;
+
+        }
+
+        // Move to the next order to activate at the same price level
+        activating_order_ptr = next_activating_order_ptr;
+    }
+
+    return result;
+}
+
+template <class TTraits, class THandler>
+bool MarketManagerT<TTraits, THandler>::ActivateTrailingStopOrders(OrderBook* order_book_ptr, OrderSide side, PriceType stop_price)
+{
+    LevelNode* level_ptr = (side == OrderSide::BUY) ? order_book_ptr->_best_trailing_buy_stop : order_book_ptr->_best_trailing_sell_stop;
+    LevelNode* distance_ptr = (side == OrderSide::BUY) ? order_book_ptr->_best_trailing_buy_distance : order_book_ptr->_best_trailing_sell_distance;
+    if (distance_ptr == nullptr)
+        return ActivateStopOrders(order_book_ptr, level_ptr, stop_price);
+
+    // Activate the best trailing stop price level first if its stop price is not worse
+    PriceType distance_stop_price = order_book_ptr->GetTrailingDistanceStopPrice(side, distance_ptr->Price);
+    if ((level_ptr != nullptr) && ((side == OrderSide::BUY) ? (level_ptr->Price <= distance_stop_price) : (level_ptr->Price >= distance_stop_price)))
+        return ActivateStopOrders(order_book_ptr, level_ptr, stop_price);
+
+    // Check the arbitrage bid/ask prices with the stop price of the best trailing distance
+    bool arbitrage = (side == OrderSide::BUY) ? (stop_price >= distance_stop_price) : (stop_price <= distance_stop_price);
+    if (!arbitrage)
+        return false;
+
+    return ActivateStopOrders(order_book_ptr, distance_ptr);
+}
+
+template <class TTraits, class THandler>
+bool MarketManagerT<TTraits, THandler>::ActivateStopOrder(OrderBook* order_book_ptr, OrderNode* order_ptr)
+{
+    // Delete the stop order from the order book
+    if (order_ptr->IsTrailingStop() || order_ptr->IsTrailingStopLimit())
+        order_book_ptr->DeleteTrailingStopOrder(order_ptr);
+    else
+        order_book_ptr->DeleteStopOrder(order_ptr);
+
+    // Convert the stop order into the market order
+    order_ptr->Type = OrderType::MARKET;
+    order_ptr->Price = 0;
+    order_ptr->StopPrice = 0;
+    order_ptr->TimeInForce = order_ptr->IsFOK() ? OrderTimeInForce::FOK : OrderTimeInForce::IOC;
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDERS))
+        _market_handler.onUpdateOrder(*order_ptr);
+
+    // Match the market order
+    MatchMarket(order_book_ptr, order_ptr);
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDERS))
+        _market_handler.onDeleteOrder(*order_ptr);
+
+    // Erase the order
+    _orders.erase(_orders.find(order_ptr->Id));
+
+    // Relase the order
+    _order_pool.Release(order_ptr);
+
+    return true;
+}
+
+template <class TTraits, class THandler>
+bool MarketManagerT<TTraits, THandler>::ActivateStopLimitOrder(OrderBook* order_book_ptr, OrderNode* order_ptr)
+{
+    // Delete the stop order from the order book
+    if (order_ptr->IsTrailingStop() || order_ptr->IsTrailingStopLimit())
+        order_book_ptr->DeleteTrailingStopOrder(order_ptr);
+    else
+        order_book_ptr->DeleteStopOrder(order_ptr);
+
+    // Convert the stop-limit order into the limit order
+    order_ptr->Type = OrderType::LIMIT;
+    order_ptr->StopPrice = 0;
+
+    // Call the corresponding handler
+    if (IsSubscribed(MarketEvents::ORDERS))
+        _market_handler.onUpdateOrder(*order_ptr);
+
+    // Match the limit order
+    MatchLimit(order_book_ptr, order_ptr);
+
+    // Add a new limit order or delete remaining part in case of 'Immediate-Or-Cancel'/'Fill-Or-Kill' order
+    if ((order_ptr->LeavesQuantity > 0) && !order_ptr->IsIOC() && !order_ptr->IsFOK())
+    {
+        // Add the new limit order into the order book
+        UpdateLevel(*order_book_ptr, order_book_ptr->AddOrder(order_ptr));
+    }
+    else
+    {
+        // Call the corresponding handler
+        if (IsSubscribed(MarketEvents::ORDERS))
+            _market_handler.onDeleteOrder(*order_ptr);
+
+        // Erase the order
+        _orders.erase(_orders.find(order_ptr->Id));
+
+        // Relase the order
+        _order_pool.Release(order_ptr);
+    }
+
+    return true;
+}
+
+template <class TTraits, class THandler>
+typename MarketManagerT<TTraits, THandler>::QuantityType MarketManagerT<TTraits, THandler>::CalculateMatchingChain(OrderBook* order_book_ptr, LevelNode* level_ptr, PriceType price, QuantityType volume)
+{
+    OrderNode* order_ptr = level_ptr->OrderList.front();
+    QuantityType available = 0;
+
+    // Travel through price levels
+    while (level_ptr != nullptr)
+    {
+        // Check the arbitrage bid/ask prices
+        bool arbitrage = level_ptr->IsBid() ? (price <= level_ptr->Price) : (price >= level_ptr->Price);
+        if (!arbitrage)
+            return 0;
+
+        // Travel through orders at current price levels
+        while (order_ptr != nullptr)
+        {
+            QuantityType need = volume - available;
+            QuantityType quantity = order_ptr->IsAON() ? order_ptr->LeavesQuantity : std::min(order_ptr->LeavesQuantity, need);
+            available += quantity;
+
+            // Matching is possible, return the chain size
+            if (volume == available)
+                return available;
+
+            // Matching is not possible
+            if (volume < available)
+                return 0;
+
+            // Take the next order
+            order_ptr = order_ptr->next;
+        }
+
+        // Switch to the next price level
+        if (order_ptr == nullptr)
+        {
+            level_ptr = order_book_ptr->GetNextLevel(level_ptr);
+            if (level_ptr != nullptr)
+                order_ptr = level_ptr->OrderList.front();
+        }
+    }
+
+    // Matching is not available
+    return 0;
+}
+
+template <class TTraits, class THandler>
+typename MarketManagerT<TTraits, THandler>::QuantityType MarketManagerT<TTraits, THandler>::CalculateMatchingChain(OrderBook* order_book_ptr, LevelNode* bid_level_ptr, LevelNode* ask_level_ptr)
+{
+    LevelNode* longest_level_ptr = bid_level_ptr;
+    LevelNode* shortest_level_ptr = ask_level_ptr;
+    OrderNode* longest_order_ptr = bid_level_ptr->OrderList.front();
+    OrderNode* shortest_order_ptr = ask_level_ptr->OrderList.front();
+    QuantityType required = longest_order_ptr->LeavesQuantity;
+    QuantityType available = 0;
+
+    // Find the initial longest order chain
+    if (longest_order_ptr->IsAON() && shortest_order_ptr->IsAON())
+    {
+        // Choose the longest 'All-Or-None' order
+        if (shortest_order_ptr->LeavesQuantity > longest_order_ptr->LeavesQuantity)
+        {
+            required = shortest_order_ptr->LeavesQuantity;
+            available = 0;
+            std::swap(longest_level_ptr, shortest_level_ptr);
+            std::swap(longest_order_ptr, shortest_order_ptr);
+        }
+    }
+    else if (shortest_order_ptr->IsAON())
+    {
+        required = shortest_order_ptr->LeavesQuantity;
+        available = 0;
+        std::swap(longest_level_ptr, shortest_level_ptr);
+        std::swap(longest_order_ptr, shortest_order_ptr);
+    }
+
+    // Travel through price levels
+    while ((longest_level_ptr != nullptr) && (shortest_level_ptr != nullptr))
+    {
+        // Travel through orders at current price levels
+        while ((longest_order_ptr != nullptr) && (shortest_order_ptr != nullptr))
+        {
+            QuantityType need = required - available;
+            QuantityType quantity = shortest_order_ptr->IsAON() ? shortest_order_ptr->LeavesQuantity : std::min(shortest_order_ptr->LeavesQuantity, need);
+            available += quantity;
+
+            // Matching is possible, return the chain size
+            if (required == available)
+                return required;
+
+            // Swap longest and shortest chains
+            if (required < available)
+            {
+                OrderNode* next = longest_order_ptr->next;
+                longest_order_ptr = shortest_order_ptr;
+                shortest_order_ptr = next;
+                std::swap(required, available);
+                continue;
+            }
+
+            // Take the next order
+            shortest_order_ptr = shortest_order_ptr->next;
+        }
+
+        // Switch to the next longest price level
+        if (longest_order_ptr == nullptr)
+        {
+            longest_level_ptr = order_book_ptr->GetNextLevel(longest_level_ptr);
+            if (longest_level_ptr != nullptr)
+                longest_order_ptr = longest_level_ptr->OrderList.front();
+        }
+
+        // Switch to the next shortest price level
+        if (shortest_order_ptr == nullptr)
+        {
+            shortest_level_ptr = order_book_ptr->GetNextLevel(shortest_level_ptr);
+            if (shortest_level_ptr != nullptr)
+                shortest_order_ptr = shortest_level_ptr->OrderList.front();
+        }
+    }
+
+    // Matching is not available
+    return 0;
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::ExecuteMatchingChain(OrderBook* order_book_ptr, LevelNode* level_ptr, PriceType price, QuantityType volume)
+{
+    // Execute all orders in the matching chain
+    while ((volume > 0) && (level_ptr != nullptr))
+    {
+        // Get the next prive level to execute
+        LevelNode* next_level_ptr = order_book_ptr->GetNextLevel(level_ptr);
+
+        // Find the first order to execute
+        OrderNode* executing_order_ptr = level_ptr->OrderList.front();
+
+        // Execute all orders in the current price level
+        while ((volume > 0) && (executing_order_ptr != nullptr))
+        {
+            // Find the next order to execute
+            OrderNode* next_executing_order_ptr = executing_order_ptr->next;
+
+            QuantityType quantity;
+
+            // Execute order
+            if (executing_order_ptr->IsAON())
+            {
+                // Get the execution quantity
+                quantity = executing_order_ptr->LeavesQuantity;
+
+                // Call the corresponding handler
+                if (IsSubscribed(MarketEvents::EXECUTIONS))
+                    _market_handler.onExecuteOrder(*executing_order_ptr, price, quantity);
+
+                // Update the corresponding market price
+                order_book_ptr->UpdateLastPrice(*executing_order_ptr, price);
+                order_book_ptr->UpdateMatchingPrice(*executing_order_ptr, price);
+
+                // Increase the order executed quantity
+                executing_order_ptr->ExecutedQuantity += quantity;
+
+                // Delete the executing order from the order book
+                DeleteOrder(executing_order_ptr->Id, true);
+            }
+            else
+            {
+                // Get the execution quantity
+                quantity = std::min(executing_order_ptr->LeavesQuantity, volume);
+
+                // Call the corresponding handler
+                if (IsSubscribed(MarketEvents::EXECUTIONS))
+                    _market_handler.onExecuteOrder(*executing_order_ptr, price, quantity);
+
+                // Update the corresponding market price
+                order_book_ptr->UpdateLastPrice(*executing_order_ptr, price);
+                order_book_ptr->UpdateMatchingPrice(*executing_order_ptr, price);
+
+                // Increase the order executed quantity
+                executing_order_ptr->ExecutedQuantity += quantity;
+
+                // Reduce the executing order in the order book
+                ReduceOrder(executing_order_ptr->Id, quantity, true);
+            }
+
+            // Reduce the execution chain
+            volume -= quantity;
+
+            // Move to the next order to execute at the same price level
+            executing_order_ptr = next_executing_order_ptr;
+        }
+
+        // Move to the next price level
+        level_ptr = next_level_ptr;
+    }
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::RecalculateTrailingStopPrice(OrderBook* order_book_ptr, OrderSide side)
+{
+    // Recalculate trailing stop orders only if the market price changed
+    if (side == OrderSide::BUY)
+    {
+        if (order_book_ptr->GetMarketTrailingStopPriceAsk() != order_book_ptr->_trailing_ask_price)
+            RecalculateTrailingStopPrice(order_book_ptr, order_book_ptr->_best_ask);
+    }
+    else
+    {
+        if (order_book_ptr->GetMarketTrailingStopPriceBid() != order_book_ptr->_trailing_bid_price)
+            RecalculateTrailingStopPrice(order_book_ptr, order_book_ptr->_best_bid);
+    }
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::RecalculateTrailingStopPrice(OrderBook* order_book_ptr, LevelNode* level_ptr)
+{
+    if (level_ptr == nullptr)
+        return;
+
+    PriceType new_trailing_price;
+
+    // Check if we should skip the recalculation because of the market price goes to the wrong direction
+    if (level_ptr->Type == LevelType::ASK)
+    {
+        PriceType old_trailing_price = order_book_ptr->_trailing_ask_price;
+        new_trailing_price = order_book_ptr->GetMarketTrailingStopPriceAsk();
+        order_book_ptr->_trailing_ask_price = new_trailing_price;
+        if (new_trailing_price >= old_trailing_price)
+            return;
+    }
+    if (level_ptr->Type == LevelType::BID)
+    {
+        PriceType old_trailing_price = order_book_ptr->_trailing_bid_price;
+        new_trailing_price = order_book_ptr->GetMarketTrailingStopPriceBid();
+        order_book_ptr->_trailing_bid_price = new_trailing_price;
+        if (new_trailing_price <= old_trailing_price)
+            return;
+    }
+
+    // Move all trailing distance orders with a single trailing reference price update
+    order_book_ptr->UpdateTrailingReferencePrice((level_ptr->Type == LevelType::ASK) ? OrderSide::BUY : OrderSide::SELL, new_trailing_price);
+
+    // Recalculate trailing stop orders in a single pass from the best stop price level.
+    // Recalculated orders always move to better stop price levels which are already
+    // passed, so there is no need to restart the pass from the previous price level.
+    LevelNode* current = (level_ptr->Type == LevelType::ASK) ? order_book_ptr->_best_trailing_buy_stop : order_book_ptr->_best_trailing_sell_stop;
+    while (current != nullptr)
+    {
+        // Find the next stop price level before the current one might be deleted
+        LevelNode* next = order_book_ptr->GetNextTrailingStopLevel(current);
+
+        // Find the first order to recalculate
+        OrderNode* order_ptr = current->OrderList.front();
+
+        while (order_ptr != nullptr)
+        {
+            // Find the next order to recalculate
+            OrderNode* next_order_ptr = order_ptr->next;
+
+            PriceType old_stop_price = order_ptr->StopPrice;
+            PriceType new_stop_price = order_book_ptr->CalculateTrailingStopPrice(*order_ptr);
+
+            // Trailing distance for the order must be changed
+            if (new_stop_price != old_stop_price)
+            {
+                // Delete the order from the order book
+                order_book_ptr->DeleteTrailingStopOrder(order_ptr);
+
+                // Update the stop order price
+                switch (order_ptr->Type)
+                {
+                    case OrderType::TRAILING_STOP:
+                        order_ptr->StopPrice = new_stop_price;
+                        break;
+                    case OrderType::TRAILING_STOP_LIMIT:
+                    {
+                        int64_t diff = order_ptr->Price - order_ptr->StopPrice;
+                        order_ptr->StopPrice = new_stop_price;
+                        order_ptr->Price = order_ptr->StopPrice + diff;
+                        break;
+                    }
+                    default:
+                        assert(false && "Unsupported order type!");
+                        break;
+
+                }
+
+                // Call the corresponding handler
+                if (IsSubscribed(MarketEvents::ORDERS))
+                    _market_handler.onUpdateOrder(*order_ptr);
+
+                // Add the new stop order into the order book
+                order_book_ptr->AddTrailingStopOrder(order_ptr);
+            }
+
+            // Move to the next order to recalculate at the same price level
+            order_ptr = next_order_ptr;
+        }
+
+        // Move to the next stop price level
+        current = next;
+    }
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::UnlinkTrailingDistanceOrders(OrderBook* order_book_ptr)
+{
+    for (OrderSide side : { OrderSide::BUY, OrderSide::SELL })
+    {
+        LevelNode* level_ptr = (side == OrderSide::BUY) ? order_book_ptr->_best_trailing_buy_distance : order_book_ptr->_best_trailing_sell_distance;
+        while (level_ptr != nullptr)
+        {
+            OrderNode* order_ptr = level_ptr->OrderList.front();
+            PriceType old_stop_price = order_ptr->StopPrice;
+
+            // Calculate the stop price of the trailing stop order from the trailing reference price
+            order_book_ptr->MaterializeTrailingStopOrder(order_ptr);
+
+            // Move the order to the trailing stop price level of its stop price
+            order_book_ptr->DeleteTrailingStopOrder(order_ptr);
+            order_book_ptr->AddTrailingStopOrder(order_ptr);
+
+            // Call the corresponding handler
+            if (order_ptr->StopPrice != old_stop_price)
+                _market_handler.onUpdateOrder(*order_ptr);
+
+            // Move to the next trailing distance order
+            level_ptr = (side == OrderSide::BUY) ? order_book_ptr->_best_trailing_buy_distance : order_book_ptr->_best_trailing_sell_distance;
+        }
+    }
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::UpdateLevel(OrderBook& order_book, const LevelUpdate& update)
+{
+    // Publish the top of the book before market handler notifications
+    if (order_book.IsTopOfBookUpdate(update.Update))
+        order_book.PublishTopOfBook(update.Update.Type);
+
+    // Coalesce price level updates until the end of the operation
+    if (_coalescing)
+    {
+        if (IsSubscribed(MarketEvents::LEVELS | MarketEvents::ORDER_BOOKS))
+            CoalesceLevel(order_book, update);
+        return;
+    }
+
+    if (IsSubscribed(MarketEvents::LEVELS))
+    {
+        switch (update.Type)
+        {
+            case UpdateType::ADD:
+                _market_handler.onAddLevel(order_book, update.Update, update.Top);
+                break;
+            case UpdateType::UPDATE:
+                _market_handler.onUpdateLevel(order_book, update.Update, update.Top);
+                break;
+            case UpdateType::DELETE:
+                _market_handler.onDeleteLevel(order_book, update.Update, update.Top);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (IsSubscribed(MarketEvents::ORDER_BOOKS))
+        _market_handler.onUpdateOrderBook(order_book, update.Top);
+}
+
+template <class TTraits, class THandler>
+void MarketManagerT<TTraits, THandler>::CoalesceLevel(OrderBook& order_book, const LevelUpdate& update)
+{
+    LevelKey key = { &order_book, update.Update.Type, update.Update.Price };
+
+    // Merge the update with the pending update of the same price level
+    auto slot = _level_slots->find(key);
+    if ((slot != _level_slots->end()) && (_level_updates[slot->second].second.Type != UpdateType::NONE))
+    {
+        LevelUpdate& pending = _level_updates[slot->second].second;
+
+        // Price level was added and deleted during the operation
+        if ((pending.Type == UpdateType::ADD) && (update.Type == UpdateType::DELETE))
+        {
+            pending.Type = UpdateType::NONE;
+            return;
+        }
+
+        // Price level was deleted and added again during the operation
+        if (pending.Type == UpdateType::DELETE)
+            pending.Type = UpdateType::UPDATE;
+        else if (update.Type == UpdateType::DELETE)
+            pending.Type = UpdateType::DELETE;
+
+        pending.Update = update.Update;
+        pending.Top = pending.Top || update.Top;
+        return;
+    }
+
+    // Index the new pending update of the price level
+    if (slot != _level_slots->end())
+        slot->second = _level_updates.size();
+    else
+        _level_slots->insert(std::make_pair(key, _level_updates.size()));
+    _level_updates.emplace_back(&order_book, update);
+}
+
+template <class TTraits, class THandler>
+inline void MarketManagerT<TTraits, THandler>::FlushLevelUpdates()
+{
+    if (_level_updates.empty())
+        return;
+
+    // Call the corresponding handler once for each touched price level.
+    // Price levels added and deleted during the operation are skipped.
+    if (IsSubscribed(MarketEvents::LEVELS))
+    {
+        for (const auto& level_update : _level_updates)
+        {
+            const LevelUpdate& update = level_update.second;
+            switch (update.Type)
+            {
+                case UpdateType::ADD:
+                    _market_handler.onAddLevel(*level_update.first, update.Update, update.Top);
+                    break;
+                case UpdateType::UPDATE:
+                    _market_handler.onUpdateLevel(*level_update.first, update.Update, update.Top);
+                    break;
+                case UpdateType::DELETE:
+                    _market_handler.onDeleteLevel(*level_update.first, update.Update, update.Top);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    // Call the corresponding handler once for each touched order book
+    if (IsSubscribed(MarketEvents::ORDER_BOOKS))
+    {
+        // Collect top of the book flags of touched order books
+        for (const auto& level_update : _level_updates)
+        {
+            if (level_update.second.Type == UpdateType::NONE)
+                continue;
+
+            level_update.first->_coalesced = true;
+            level_update.first->_coalesced_top = level_update.first->_coalesced_top || level_update.second.Top;
+        }
+
+        // Notify each order book in the order of its first update
+        for (const auto& level_update : _level_updates)
+        {
+            OrderBook* order_book_ptr = level_update.first;
+            if (!order_book_ptr->_coalesced)
+                continue;
+
+            bool top = order_book_ptr->_coalesced_top;
+            order_book_ptr->_coalesced = false;
+            order_book_ptr->_coalesced_top = false;
+
+            _market_handler.onUpdateOrderBook(*order_book_ptr, top);
+        }
+    }
+
+    // Clear the index of pending price level updates
+    for (const auto& level_update : _level_updates)
+        _level_slots->erase(LevelKey{ level_update.first, level_update.second.Update.Type, level_update.second.Update.Price });
+    _level_updates.clear();
+}
+
+// Market manager with the default market traits is instantiated in the library
+extern template class MarketManagerT<MarketTraits<>>;
+
 } // namespace Matching
 } // namespace CppTrader
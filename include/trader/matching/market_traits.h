@@ -0,0 +1,118 @@
+/*!
+    \file market_traits.h
+    \brief Market traits definition
+    \author Ivan Shynkarenka
+    \date 17.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_MARKET_TRAITS_H
+#define CPPTRADER_MATCHING_MARKET_TRAITS_H
+
+#include "depth_cache.h"
+#include "levels_avl.h"
+#include "levels_btree.h"
+#include "levels_ladder.h"
+#include "levels_vector.h"
+#include "orders_hash.h"
+#include "orders_paged.h"
+#include "top_of_book.h"
+
+#include <type_traits>
+
+namespace CppTrader {
+namespace Matching {
+
+//! Market traits
+/*!
+    Market traits are used to customize data structures of the matching engine
+    at compile time. Order book, market manager and market handler are
+    parametrized with the same market traits type.
+
+    Price levels container policy is a class template of the price level node
+    type which must provide the following interface:
+    \code{.cpp}
+    template <class TLevelNode>
+    class Levels
+    {
+    public:
+        explicit Levels(LevelType type);
+
+        // Price levels iteration in the ascending price order
+        bool empty() const;
+        size_t size() const;
+        iterator begin();
+        iterator end();
+
+        // Find the price level with the given price or return nullptr
+        TLevelNode* find(uint64_t price) const;
+        // Get the price level with the nearest lower/higher price or return nullptr
+        TLevelNode* lower(const TLevelNode& level) const;
+        TLevelNode* higher(const TLevelNode& level) const;
+
+        void insert(TLevelNode& level);
+        void erase(TLevelNode& level);
+        void clear();
+    };
+    \endcode
+
+    Available price levels containers:
+    \li LevelsAVL - intrusive AVL tree (default)
+    \li LevelsVector - sorted vector with the best price at the end
+    \li LevelsLadder - direct addressed tick ladder with occupancy bitmap
+    \li LevelsBTree - B+tree with linked leaves for very deep order books
+
+    Orders container policy is a class template of the order node type which
+    maps order Ids to order nodes with the subset of the hash map interface
+    (find(), insert(), erase(), clear() and iteration over Id/node pairs).
+
+    Available orders containers:
+    \li OrdersHash - open addressing hash map (default)
+    \li OrdersPaged - paged direct array for near-dense order Ids with the hash map fallback
+
+    Price and quantity types are used for orders, price levels and all prices
+    and quantities of the matching engine API. 64-bit types are used by default.
+    32-bit types are enough for most equity feeds (e.g. NASDAQ ITCH prices and
+    shares) and make order nodes and price levels smaller, so more of them fit
+    into the cache:
+    \code{.cpp}
+    MarketManagerT<MarketTraits<LevelsAVL, OrdersHash, uint32_t, uint32_t>> market;
+    \endcode
+*/
+template <template <class> class TLevels = LevelsAVL, template <class> class TOrders = OrdersHash, typename TPrice = uint64_t, typename TQuantity = uint64_t>
+struct MarketTraits
+{
+    static_assert(std::is_unsigned<TPrice>::value && std::is_unsigned<TQuantity>::value, "Price and quantity types must be unsigned integers!");
+
+    //! Price type
+    typedef TPrice PriceType;
+    //! Quantity type
+    typedef TQuantity QuantityType;
+
+    //! Order
+    typedef OrderT<TPrice, TQuantity> Order;
+    //! Order node
+    typedef OrderNodeT<TPrice, TQuantity> OrderNode;
+    //! Price level
+    typedef LevelT<TPrice, TQuantity> Level;
+    //! Price level node
+    typedef LevelNodeT<TPrice, TQuantity> LevelNode;
+    //! Price level update
+    typedef LevelUpdateT<TPrice, TQuantity> LevelUpdate;
+    //! Top of the order book
+    typedef TopOfBookT<TPrice, TQuantity> TopOfBook;
+    //! Depth cache
+    typedef DepthCacheT<TPrice, TQuantity> DepthCache;
+
+    //! Price levels container
+    template <class TLevelNode>
+    using Levels = TLevels<TLevelNode>;
+    //! Orders container
+    template <class TOrderNode>
+    using Orders = TOrders<TOrderNode>;
+};
+
+} // namespace Matching
+} // namespace CppTrader
+
+#endif // CPPTRADER_MATCHING_MARKET_TRAITS_H
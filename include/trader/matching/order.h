@@ -123,31 +123,25 @@ TOutputStream& operator<<(TOutputStream& stream, OrderTimeInForce tif);
     bond market, commodity market, or financial derivative market. These instructions can
     be simple or complicated, and can be sent to either a broker or directly to a trading
     venue via direct market access.
+
+    Order is parametrized with price and quantity types. Narrow 32-bit types
+    are enough for most equity feeds (e.g. NASDAQ ITCH prices and shares) and
+    make order nodes and price levels smaller.
 */
-struct Order
+template <typename TPrice, typename TQuantity>
+struct OrderT
 {
+    //! Price type
+    typedef TPrice PriceType;
+    //! Quantity type
+    typedef TQuantity QuantityType;
+
     //! Order Id
     uint64_t Id;
-    //! Symbol Id
-    uint32_t SymbolId;
-    //! Order type
-    OrderType Type;
-    //! Order side
-    OrderSide Side;
     //! Order price
-    uint64_t Price;
-    //! Order stop price
-    uint64_t StopPrice;
-
-    //! Order quantity
-    uint64_t Quantity;
-    //! Order executed quantity
-    uint64_t ExecutedQuantity;
+    TPrice Price;
     //! Order leaves quantity
-    uint64_t LeavesQuantity;
-
-    //! Time in Force
-    OrderTimeInForce TimeInForce;
+    TQuantity LeavesQuantity;
 
     //! Order max visible quantity
     /*!
@@ -159,11 +153,28 @@ struct Order
 
         Supported only for limit and stop-limit orders!
     */
-    uint64_t MaxVisibleQuantity;
+    TQuantity MaxVisibleQuantity;
     //! Order hidden quantity
-    uint64_t HiddenQuantity() const noexcept { return (LeavesQuantity > MaxVisibleQuantity) ? (LeavesQuantity - MaxVisibleQuantity) : 0; }
+    TQuantity HiddenQuantity() const noexcept { return (LeavesQuantity > MaxVisibleQuantity) ? (LeavesQuantity - MaxVisibleQuantity) : 0; }
     //! Order visible quantity
-    uint64_t VisibleQuantity() const noexcept { return std::min(LeavesQuantity, MaxVisibleQuantity); }
+    TQuantity VisibleQuantity() const noexcept { return std::min(LeavesQuantity, MaxVisibleQuantity); }
+
+    //! Symbol Id
+    uint32_t SymbolId;
+    //! Order type
+    OrderType Type;
+    //! Order side
+    OrderSide Side;
+    //! Time in Force
+    OrderTimeInForce TimeInForce;
+
+    //! Order stop price
+    TPrice StopPrice;
+
+    //! Order quantity
+    TQuantity Quantity;
+    //! Order executed quantity
+    TQuantity ExecutedQuantity;
 
     //! Market order slippage
     /*!
@@ -176,7 +187,7 @@ struct Order
 
         Supported only for market and stop orders!
     */
-    uint64_t Slippage;
+    TPrice Slippage;
 
     //! Order trailing distance to market
     /*!
@@ -197,22 +208,22 @@ struct Order
     */
     int64_t TrailingStep;
 
-    Order() noexcept = default;
-    Order(uint64_t id, uint32_t symbol, OrderType type, OrderSide side, uint64_t price, uint64_t stop_price, uint64_t quantity,
+    OrderT() noexcept = default;
+    OrderT(uint64_t id, uint32_t symbol, OrderType type, OrderSide side, TPrice price, TPrice stop_price, TQuantity quantity,
         OrderTimeInForce tif = OrderTimeInForce::GTC,
-        uint64_t max_visible_quantity = std::numeric_limits<uint64_t>::max(),
-        uint64_t slippage = std::numeric_limits<uint64_t>::max(),
+        TQuantity max_visible_quantity = std::numeric_limits<TQuantity>::max(),
+        TPrice slippage = std::numeric_limits<TPrice>::max(),
         int64_t trailing_distance = 0,
         int64_t trailing_step = 0) noexcept;
-    Order(const Order&) noexcept = default;
-    Order(Order&&) noexcept = default;
-    ~Order() noexcept = default;
+    OrderT(const OrderT&) noexcept = default;
+    OrderT(OrderT&&) noexcept = default;
+    ~OrderT() noexcept = default;
 
-    Order& operator=(const Order&) noexcept = default;
-    Order& operator=(Order&&) noexcept = default;
+    OrderT& operator=(const OrderT&) noexcept = default;
+    OrderT& operator=(OrderT&&) noexcept = default;
 
-    template <class TOutputStream>
-    friend TOutputStream& operator<<(TOutputStream& stream, const Order& order);
+    template <class TOutputStream, typename P, typename Q>
+    friend TOutputStream& operator<<(TOutputStream& stream, const OrderT<P, Q>& order);
 
     //! Is the market order?
     bool IsMarket() const noexcept { return Type == OrderType::MARKET; }
@@ -244,74 +255,96 @@ struct Order
     //! Is the 'Hidden' order?
     bool IsHidden() const noexcept { return MaxVisibleQuantity == 0; }
     //! Is the 'Iceberg' order?
-    bool IsIceberg() const noexcept { return MaxVisibleQuantity < std::numeric_limits<uint64_t>::max(); }
+    bool IsIceberg() const noexcept { return MaxVisibleQuantity < std::numeric_limits<TQuantity>::max(); }
 
     //! Is the order have slippage?
-    bool IsSlippage() const noexcept { return Slippage < std::numeric_limits<uint64_t>::max(); }
+    bool IsSlippage() const noexcept { return Slippage < std::numeric_limits<TPrice>::max(); }
 
     //! Validate order parameters
     ErrorCode Validate() const noexcept;
 
     //! Prepare a new market order
-    static Order Market(uint64_t id, uint32_t symbol, OrderSide side, uint64_t quantity, uint64_t slippage = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT Market(uint64_t id, uint32_t symbol, OrderSide side, TQuantity quantity, TPrice slippage = std::numeric_limits<TPrice>::max()) noexcept;
     //! Prepare a new buy market order
-    static Order BuyMarket(uint64_t id, uint32_t symbol, uint64_t quantity, uint64_t slippage = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT BuyMarket(uint64_t id, uint32_t symbol, TQuantity quantity, TPrice slippage = std::numeric_limits<TPrice>::max()) noexcept;
     //! Prepare a new sell market order
-    static Order SellMarket(uint64_t id, uint32_t symbol, uint64_t quantity, uint64_t slippage = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT SellMarket(uint64_t id, uint32_t symbol, TQuantity quantity, TPrice slippage = std::numeric_limits<TPrice>::max()) noexcept;
 
     //! Prepare a new limit order
-    static Order Limit(uint64_t id, uint32_t symbol, OrderSide side, uint64_t price, uint64_t quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t max_visible_quantity = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT Limit(uint64_t id, uint32_t symbol, OrderSide side, TPrice price, TQuantity quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, TQuantity max_visible_quantity = std::numeric_limits<TQuantity>::max()) noexcept;
     //! Prepare a new buy limit order
-    static Order BuyLimit(uint64_t id, uint32_t symbol, uint64_t price, uint64_t quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t max_visible_quantity = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT BuyLimit(uint64_t id, uint32_t symbol, TPrice price, TQuantity quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, TQuantity max_visible_quantity = std::numeric_limits<TQuantity>::max()) noexcept;
     //! Prepare a new sell limit order
-    static Order SellLimit(uint64_t id, uint32_t symbol, uint64_t price, uint64_t quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t max_visible_quantity = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT SellLimit(uint64_t id, uint32_t symbol, TPrice price, TQuantity quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, TQuantity max_visible_quantity = std::numeric_limits<TQuantity>::max()) noexcept;
 
     //! Prepare a new stop order
-    static Order Stop(uint64_t id, uint32_t symbol, OrderSide side, uint64_t stop_price, uint64_t quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t slippage = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT Stop(uint64_t id, uint32_t symbol, OrderSide side, TPrice stop_price, TQuantity quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, TPrice slippage = std::numeric_limits<TPrice>::max()) noexcept;
     //! Prepare a new buy stop order
-    static Order BuyStop(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t slippage = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT BuyStop(uint64_t id, uint32_t symbol, TPrice stop_price, TQuantity quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, TPrice slippage = std::numeric_limits<TPrice>::max()) noexcept;
     //! Prepare a new sell stop order
-    static Order SellStop(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t slippage = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT SellStop(uint64_t id, uint32_t symbol, TPrice stop_price, TQuantity quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, TPrice slippage = std::numeric_limits<TPrice>::max()) noexcept;
 
     //! Prepare a new stop-limit order
-    static Order StopLimit(uint64_t id, uint32_t symbol, OrderSide side, uint64_t stop_price, uint64_t price, uint64_t quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t max_visible_quantity = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT StopLimit(uint64_t id, uint32_t symbol, OrderSide side, TPrice stop_price, TPrice price, TQuantity quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, TQuantity max_visible_quantity = std::numeric_limits<TQuantity>::max()) noexcept;
     //! Prepare a new buy stop-limit order
-    static Order BuyStopLimit(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t price, uint64_t quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t max_visible_quantity = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT BuyStopLimit(uint64_t id, uint32_t symbol, TPrice stop_price, TPrice price, TQuantity quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, TQuantity max_visible_quantity = std::numeric_limits<TQuantity>::max()) noexcept;
     //! Prepare a new sell stop-limit order
-    static Order SellStopLimit(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t price, uint64_t quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t max_visible_quantity = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT SellStopLimit(uint64_t id, uint32_t symbol, TPrice stop_price, TPrice price, TQuantity quantity, OrderTimeInForce tif = OrderTimeInForce::GTC, TQuantity max_visible_quantity = std::numeric_limits<TQuantity>::max()) noexcept;
 
     //! Prepare a new trailing stop order
-    static Order TrailingStop(uint64_t id, uint32_t symbol, OrderSide side, uint64_t stop_price, uint64_t quantity, int64_t trailing_distance, int64_t trailing_step = 0, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t slippage = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT TrailingStop(uint64_t id, uint32_t symbol, OrderSide side, TPrice stop_price, TQuantity quantity, int64_t trailing_distance, int64_t trailing_step = 0, OrderTimeInForce tif = OrderTimeInForce::GTC, TPrice slippage = std::numeric_limits<TPrice>::max()) noexcept;
     //! Prepare a new trailing buy stop order
-    static Order TrailingBuyStop(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t quantity, int64_t trailing_distance, int64_t trailing_step = 0, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t slippage = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT TrailingBuyStop(uint64_t id, uint32_t symbol, TPrice stop_price, TQuantity quantity, int64_t trailing_distance, int64_t trailing_step = 0, OrderTimeInForce tif = OrderTimeInForce::GTC, TPrice slippage = std::numeric_limits<TPrice>::max()) noexcept;
     //! Prepare a new trailing sell stop order
-    static Order TrailingSellStop(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t quantity, int64_t trailing_distance, int64_t trailing_step = 0, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t slippage = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT TrailingSellStop(uint64_t id, uint32_t symbol, TPrice stop_price, TQuantity quantity, int64_t trailing_distance, int64_t trailing_step = 0, OrderTimeInForce tif = OrderTimeInForce::GTC, TPrice slippage = std::numeric_limits<TPrice>::max()) noexcept;
 
     //! Prepare a new trailing stop-limit order
-    static Order TrailingStopLimit(uint64_t id, uint32_t symbol, OrderSide side, uint64_t stop_price, uint64_t price, uint64_t quantity, int64_t trailing_distance, int64_t trailing_step = 0, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t max_visible_quantity = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT TrailingStopLimit(uint64_t id, uint32_t symbol, OrderSide side, TPrice stop_price, TPrice price, TQuantity quantity, int64_t trailing_distance, int64_t trailing_step = 0, OrderTimeInForce tif = OrderTimeInForce::GTC, TQuantity max_visible_quantity = std::numeric_limits<TQuantity>::max()) noexcept;
     //! Prepare a new trailing buy stop-limit order
-    static Order TrailingBuyStopLimit(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t price, uint64_t quantity, int64_t trailing_distance, int64_t trailing_step = 0, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t max_visible_quantity = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT TrailingBuyStopLimit(uint64_t id, uint32_t symbol, TPrice stop_price, TPrice price, TQuantity quantity, int64_t trailing_distance, int64_t trailing_step = 0, OrderTimeInForce tif = OrderTimeInForce::GTC, TQuantity max_visible_quantity = std::numeric_limits<TQuantity>::max()) noexcept;
     //! Prepare a new trailing sell stop-limit order
-    static Order TrailingSellStopLimit(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t price, uint64_t quantity, int64_t trailing_distance, int64_t trailing_step = 0, OrderTimeInForce tif = OrderTimeInForce::GTC, uint64_t max_visible_quantity = std::numeric_limits<uint64_t>::max()) noexcept;
+    static OrderT TrailingSellStopLimit(uint64_t id, uint32_t symbol, TPrice stop_price, TPrice price, TQuantity quantity, int64_t trailing_distance, int64_t trailing_step = 0, OrderTimeInForce tif = OrderTimeInForce::GTC, TQuantity max_visible_quantity = std::numeric_limits<TQuantity>::max()) noexcept;
 };
 
-struct LevelNode;
+//! Order with 64-bit prices and quantities
+typedef OrderT<uint64_t, uint64_t> Order;
 
-//! Order node
-struct OrderNode : public Order, public CppCommon::List<OrderNode>::Node
-{
-    LevelNode* Level;
+template <typename TPrice, typename TQuantity>
+struct LevelNodeT;
 
-    OrderNode(const Order& order) noexcept;
-    OrderNode(const OrderNode&) noexcept = default;
-    OrderNode(OrderNode&&) noexcept = default;
-    ~OrderNode() noexcept = default;
+//! Order price level link
+template <typename TPrice, typename TQuantity>
+struct OrderLevelLinkT
+{
+    //! Price level of the order
+    LevelNodeT<TPrice, TQuantity>* Level;
+};
 
-    OrderNode& operator=(const Order& order) noexcept;
-    OrderNode& operator=(const OrderNode&) noexcept = default;
-    OrderNode& operator=(OrderNode&&) noexcept = default;
+//! Order node
+/*!
+    The first 64 bytes of the order node contain all fields used to match
+    orders: list links, price level, Id, price, leaves and max visible
+    quantities, symbol, type, side and time in force. Total and executed
+    quantities, stop price, slippage and trailing parameters are placed
+    after them. Order nodes are not aligned to cache lines by the pool, so
+    the first 64 bytes might still span two cache lines.
+*/
+template <typename TPrice, typename TQuantity>
+struct OrderNodeT : public CppCommon::List<OrderNodeT<TPrice, TQuantity>>::Node, public OrderLevelLinkT<TPrice, TQuantity>, public OrderT<TPrice, TQuantity>
+{
+    OrderNodeT(const OrderT<TPrice, TQuantity>& order) noexcept;
+    OrderNodeT(const OrderNodeT&) noexcept = default;
+    OrderNodeT(OrderNodeT&&) noexcept = default;
+    ~OrderNodeT() noexcept = default;
+
+    OrderNodeT& operator=(const OrderT<TPrice, TQuantity>& order) noexcept;
+    OrderNodeT& operator=(const OrderNodeT&) noexcept = default;
+    OrderNodeT& operator=(OrderNodeT&&) noexcept = default;
 };
 
+//! Order node with 64-bit prices and quantities
+typedef OrderNodeT<uint64_t, uint64_t> OrderNode;
+
 } // namespace Matching
 } // namespace CppTrader
 
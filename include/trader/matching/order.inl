@@ -81,26 +81,27 @@ inline TOutputStream& operator<<(TOutputStream& stream, OrderTimeInForce tif)
     return stream;
 }
 
-inline Order::Order(uint64_t id, uint32_t symbol, OrderType type, OrderSide side, uint64_t price, uint64_t stop_price, uint64_t quantity, OrderTimeInForce tif, uint64_t max_visible_quantity, uint64_t slippage, int64_t trailing_distance, int64_t trailing_step) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity>::OrderT(uint64_t id, uint32_t symbol, OrderType type, OrderSide side, TPrice price, TPrice stop_price, TQuantity quantity, OrderTimeInForce tif, TQuantity max_visible_quantity, TPrice slippage, int64_t trailing_distance, int64_t trailing_step) noexcept
     : Id(id),
+      Price(price),
+      LeavesQuantity(quantity),
+      MaxVisibleQuantity(max_visible_quantity),
       SymbolId(symbol),
       Type(type),
       Side(side),
-      Price(price),
+      TimeInForce(tif),
       StopPrice(stop_price),
       Quantity(quantity),
       ExecutedQuantity(0),
-      LeavesQuantity(quantity),
-      TimeInForce(tif),
-      MaxVisibleQuantity(max_visible_quantity),
       Slippage(slippage),
       TrailingDistance(trailing_distance),
       TrailingStep(trailing_step)
 {
 }
 
-template <class TOutputStream>
-inline TOutputStream& operator<<(TOutputStream& stream, const Order& order)
+template <class TOutputStream, typename TPrice, typename TQuantity>
+inline TOutputStream& operator<<(TOutputStream& stream, const OrderT<TPrice, TQuantity>& order)
 {
     stream << "Order(Id=" << order.Id
         << "; SymbolId=" << order.SymbolId
@@ -125,106 +126,210 @@ inline TOutputStream& operator<<(TOutputStream& stream, const Order& order)
     return stream;
 }
 
-inline Order Order::Market(uint64_t id, uint32_t symbol, OrderSide side, uint64_t quantity, uint64_t slippage) noexcept
+template <typename TPrice, typename TQuantity>
+inline ErrorCode OrderT<TPrice, TQuantity>::Validate() const noexcept
 {
-    return Order(id, symbol, OrderType::MARKET, side, 0, 0, quantity, OrderTimeInForce::IOC, std::numeric_limits<uint64_t>::max(), slippage, 0, 0);
+    // Validate order Id
+    assert((Id > 0) && "Order Id must be greater than zero!");
+    if (Id == 0)
+        return ErrorCode::ORDER_ID_INVALID;
+
+    // Validate order quantity
+    assert((Quantity >= LeavesQuantity) && "Order quantity must be greater than or equal to order leaves quantity!");
+    if (Quantity < LeavesQuantity)
+        return ErrorCode::ORDER_QUANTITY_INVALID;
+    assert((LeavesQuantity > 0) && "Order leaves quantity must be greater than zero!");
+    if (LeavesQuantity == 0)
+        return ErrorCode::ORDER_QUANTITY_INVALID;
+
+    // Validate market order
+    if (IsMarket())
+    {
+        assert((IsIOC() || IsFOK()) && "Market order must have 'Immediate-Or-Cancel' or 'Fill-Or-Kill' parameter!");
+        if (!IsIOC() && !IsFOK())
+            return ErrorCode::ORDER_PARAMETER_INVALID;
+        assert(!IsIceberg() && "Market order cannot be 'Iceberg'!");
+        if (IsIceberg())
+            return ErrorCode::ORDER_PARAMETER_INVALID;
+    }
+
+    // Validate limit order
+    if (IsLimit())
+    {
+        assert(!IsSlippage() && "Limit order cannot have slippage parameter!");
+        if (IsSlippage())
+            return ErrorCode::ORDER_PARAMETER_INVALID;
+    }
+
+    // Validate stop order
+    if (IsStop() || IsTrailingStop())
+    {
+        assert(!IsAON() && "Stop order cannot have 'All-Or-None' parameter!");
+        if (IsAON())
+            return ErrorCode::ORDER_PARAMETER_INVALID;
+        assert(!IsIceberg() && "Stop order cannot be 'Iceberg'!");
+        if (IsIceberg())
+            return ErrorCode::ORDER_PARAMETER_INVALID;
+    }
+
+    // Validate stop-limit order
+    if (IsStopLimit() || IsTrailingStopLimit())
+    {
+        assert(!IsSlippage() && "Stop-limit order cannot have slippage!");
+        if (IsSlippage())
+            return ErrorCode::ORDER_PARAMETER_INVALID;
+    }
+
+    // Validate trailing order
+    if (IsTrailingStop() || IsTrailingStopLimit())
+    {
+        assert((TrailingDistance != 0) && "Trailing stop order must have non zero distance to the market!");
+        if (TrailingDistance == 0)
+            return ErrorCode::ORDER_PARAMETER_INVALID;
+
+        if (TrailingDistance > 0)
+        {
+            assert(((TrailingStep >= 0) && (TrailingStep < TrailingDistance)) && "Trailing step must be less than trailing distance!");
+            if ((TrailingStep < 0) || (TrailingStep >= TrailingDistance))
+                return ErrorCode::ORDER_PARAMETER_INVALID;
+        }
+        else
+        {
+            assert(((TrailingDistance <= -1) && (TrailingDistance >= -1000)) && "Trailing percentage distance must be in the range [0.01, 100%] (from -1 down to -10000)!");
+            if ((TrailingDistance > -1) || (TrailingDistance < -1000))
+                return ErrorCode::ORDER_PARAMETER_INVALID;
+            assert(((TrailingStep <= 0) && (TrailingStep > TrailingDistance)) && "Trailing step must be less than trailing distance!");
+            if ((TrailingStep > 0) || (TrailingStep <= TrailingDistance))
+                return ErrorCode::ORDER_PARAMETER_INVALID;
+        }
+    }
+
+    return ErrorCode::OK;
 }
 
-inline Order Order::BuyMarket(uint64_t id, uint32_t symbol, uint64_t quantity, uint64_t slippage) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::Market(uint64_t id, uint32_t symbol, OrderSide side, TQuantity quantity, TPrice slippage) noexcept
 {
-    return Order(id, symbol, OrderType::MARKET, OrderSide::BUY, 0, 0, quantity, OrderTimeInForce::IOC, std::numeric_limits<uint64_t>::max(), slippage, 0, 0);
+    return OrderT(id, symbol, OrderType::MARKET, side, 0, 0, quantity, OrderTimeInForce::IOC, std::numeric_limits<TQuantity>::max(), slippage, 0, 0);
 }
 
-inline Order Order::SellMarket(uint64_t id, uint32_t symbol, uint64_t quantity, uint64_t slippage) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::BuyMarket(uint64_t id, uint32_t symbol, TQuantity quantity, TPrice slippage) noexcept
 {
-    return Order(id, symbol, OrderType::MARKET, OrderSide::SELL, 0, 0, quantity, OrderTimeInForce::IOC, std::numeric_limits<uint64_t>::max(), slippage, 0, 0);
+    return OrderT(id, symbol, OrderType::MARKET, OrderSide::BUY, 0, 0, quantity, OrderTimeInForce::IOC, std::numeric_limits<TQuantity>::max(), slippage, 0, 0);
 }
 
-inline Order Order::Limit(uint64_t id, uint32_t symbol, OrderSide side, uint64_t price, uint64_t quantity, OrderTimeInForce tif, uint64_t max_visible_quantity) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::SellMarket(uint64_t id, uint32_t symbol, TQuantity quantity, TPrice slippage) noexcept
 {
-    return Order(id, symbol, OrderType::LIMIT, side, price, 0, quantity, tif, max_visible_quantity, std::numeric_limits<uint64_t>::max(), 0, 0);
+    return OrderT(id, symbol, OrderType::MARKET, OrderSide::SELL, 0, 0, quantity, OrderTimeInForce::IOC, std::numeric_limits<TQuantity>::max(), slippage, 0, 0);
 }
 
-inline Order Order::BuyLimit(uint64_t id, uint32_t symbol, uint64_t price, uint64_t quantity, OrderTimeInForce tif, uint64_t max_visible_quantity) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::Limit(uint64_t id, uint32_t symbol, OrderSide side, TPrice price, TQuantity quantity, OrderTimeInForce tif, TQuantity max_visible_quantity) noexcept
 {
-    return Order(id, symbol, OrderType::LIMIT, OrderSide::BUY, price, 0, quantity, tif, max_visible_quantity, std::numeric_limits<uint64_t>::max(), 0, 0);
+    return OrderT(id, symbol, OrderType::LIMIT, side, price, 0, quantity, tif, max_visible_quantity, std::numeric_limits<TPrice>::max(), 0, 0);
 }
 
-inline Order Order::SellLimit(uint64_t id, uint32_t symbol, uint64_t price, uint64_t quantity, OrderTimeInForce tif, uint64_t max_visible_quantity) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::BuyLimit(uint64_t id, uint32_t symbol, TPrice price, TQuantity quantity, OrderTimeInForce tif, TQuantity max_visible_quantity) noexcept
 {
-    return Order(id, symbol, OrderType::LIMIT, OrderSide::SELL, price, 0, quantity, tif, max_visible_quantity, std::numeric_limits<uint64_t>::max(), 0, 0);
+    return OrderT(id, symbol, OrderType::LIMIT, OrderSide::BUY, price, 0, quantity, tif, max_visible_quantity, std::numeric_limits<TPrice>::max(), 0, 0);
 }
 
-inline Order Order::Stop(uint64_t id, uint32_t symbol, OrderSide side, uint64_t stop_price, uint64_t quantity, OrderTimeInForce tif, uint64_t slippage) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::SellLimit(uint64_t id, uint32_t symbol, TPrice price, TQuantity quantity, OrderTimeInForce tif, TQuantity max_visible_quantity) noexcept
 {
-    return Order(id, symbol, OrderType::STOP, side, 0, stop_price, quantity, tif, std::numeric_limits<uint64_t>::max(), slippage, 0, 0);
+    return OrderT(id, symbol, OrderType::LIMIT, OrderSide::SELL, price, 0, quantity, tif, max_visible_quantity, std::numeric_limits<TPrice>::max(), 0, 0);
 }
 
-inline Order Order::BuyStop(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t quantity, OrderTimeInForce tif, uint64_t slippage) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::Stop(uint64_t id, uint32_t symbol, OrderSide side, TPrice stop_price, TQuantity quantity, OrderTimeInForce tif, TPrice slippage) noexcept
 {
-    return Order(id, symbol, OrderType::STOP, OrderSide::BUY, 0, stop_price, quantity, tif, std::numeric_limits<uint64_t>::max(), slippage, 0, 0);
+    return OrderT(id, symbol, OrderType::STOP, side, 0, stop_price, quantity, tif, std::numeric_limits<TQuantity>::max(), slippage, 0, 0);
 }
 
-inline Order Order::SellStop(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t quantity, OrderTimeInForce tif, uint64_t slippage) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::BuyStop(uint64_t id, uint32_t symbol, TPrice stop_price, TQuantity quantity, OrderTimeInForce tif, TPrice slippage) noexcept
 {
-    return Order(id, symbol, OrderType::STOP, OrderSide::SELL, 0, stop_price, quantity, tif, std::numeric_limits<uint64_t>::max(), slippage, 0, 0);
+    return OrderT(id, symbol, OrderType::STOP, OrderSide::BUY, 0, stop_price, quantity, tif, std::numeric_limits<TQuantity>::max(), slippage, 0, 0);
 }
 
-inline Order Order::StopLimit(uint64_t id, uint32_t symbol, OrderSide side, uint64_t stop_price, uint64_t price, uint64_t quantity, OrderTimeInForce tif, uint64_t max_visible_quantity) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::SellStop(uint64_t id, uint32_t symbol, TPrice stop_price, TQuantity quantity, OrderTimeInForce tif, TPrice slippage) noexcept
 {
-    return Order(id, symbol, OrderType::STOP_LIMIT, side, price, stop_price, quantity, tif, max_visible_quantity, std::numeric_limits<uint64_t>::max(), 0, 0);
+    return OrderT(id, symbol, OrderType::STOP, OrderSide::SELL, 0, stop_price, quantity, tif, std::numeric_limits<TQuantity>::max(), slippage, 0, 0);
 }
 
-inline Order Order::BuyStopLimit(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t price, uint64_t quantity, OrderTimeInForce tif, uint64_t max_visible_quantity) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::StopLimit(uint64_t id, uint32_t symbol, OrderSide side, TPrice stop_price, TPrice price, TQuantity quantity, OrderTimeInForce tif, TQuantity max_visible_quantity) noexcept
 {
-    return Order(id, symbol, OrderType::STOP_LIMIT, OrderSide::BUY, price, stop_price, quantity, tif, max_visible_quantity, std::numeric_limits<uint64_t>::max(), 0, 0);
+    return OrderT(id, symbol, OrderType::STOP_LIMIT, side, price, stop_price, quantity, tif, max_visible_quantity, std::numeric_limits<TPrice>::max(), 0, 0);
 }
 
-inline Order Order::SellStopLimit(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t price, uint64_t quantity, OrderTimeInForce tif, uint64_t max_visible_quantity) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::BuyStopLimit(uint64_t id, uint32_t symbol, TPrice stop_price, TPrice price, TQuantity quantity, OrderTimeInForce tif, TQuantity max_visible_quantity) noexcept
 {
-    return Order(id, symbol, OrderType::STOP_LIMIT, OrderSide::SELL, price, stop_price, quantity, tif, max_visible_quantity, std::numeric_limits<uint64_t>::max(), 0, 0);
+    return OrderT(id, symbol, OrderType::STOP_LIMIT, OrderSide::BUY, price, stop_price, quantity, tif, max_visible_quantity, std::numeric_limits<TPrice>::max(), 0, 0);
 }
 
-inline Order Order::TrailingStop(uint64_t id, uint32_t symbol, OrderSide side, uint64_t stop_price, uint64_t quantity, int64_t trailing_distance, int64_t trailing_step, OrderTimeInForce tif, uint64_t slippage) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::SellStopLimit(uint64_t id, uint32_t symbol, TPrice stop_price, TPrice price, TQuantity quantity, OrderTimeInForce tif, TQuantity max_visible_quantity) noexcept
 {
-    return Order(id, symbol, OrderType::TRAILING_STOP, side, 0, stop_price, quantity, tif, std::numeric_limits<uint64_t>::max(), slippage, trailing_distance, trailing_step);
+    return OrderT(id, symbol, OrderType::STOP_LIMIT, OrderSide::SELL, price, stop_price, quantity, tif, max_visible_quantity, std::numeric_limits<TPrice>::max(), 0, 0);
 }
 
-inline Order Order::TrailingBuyStop(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t quantity, int64_t trailing_distance, int64_t trailing_step, OrderTimeInForce tif, uint64_t slippage) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::TrailingStop(uint64_t id, uint32_t symbol, OrderSide side, TPrice stop_price, TQuantity quantity, int64_t trailing_distance, int64_t trailing_step, OrderTimeInForce tif, TPrice slippage) noexcept
 {
-    return Order(id, symbol, OrderType::TRAILING_STOP, OrderSide::BUY, 0, stop_price, quantity, tif, std::numeric_limits<uint64_t>::max(), slippage, trailing_distance, trailing_step);
+    return OrderT(id, symbol, OrderType::TRAILING_STOP, side, 0, stop_price, quantity, tif, std::numeric_limits<TQuantity>::max(), slippage, trailing_distance, trailing_step);
 }
 
-inline Order Order::TrailingSellStop(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t quantity, int64_t trailing_distance, int64_t trailing_step, OrderTimeInForce tif, uint64_t slippage) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::TrailingBuyStop(uint64_t id, uint32_t symbol, TPrice stop_price, TQuantity quantity, int64_t trailing_distance, int64_t trailing_step, OrderTimeInForce tif, TPrice slippage) noexcept
 {
-    return Order(id, symbol, OrderType::TRAILING_STOP, OrderSide::SELL, 0, stop_price, quantity, tif, std::numeric_limits<uint64_t>::max(), slippage, trailing_distance, trailing_step);
+    return OrderT(id, symbol, OrderType::TRAILING_STOP, OrderSide::BUY, 0, stop_price, quantity, tif, std::numeric_limits<TQuantity>::max(), slippage, trailing_distance, trailing_step);
 }
 
-inline Order Order::TrailingStopLimit(uint64_t id, uint32_t symbol, OrderSide side, uint64_t stop_price, uint64_t price, uint64_t quantity, int64_t trailing_distance, int64_t trailing_step, OrderTimeInForce tif, uint64_t max_visible_quantity) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::TrailingSellStop(uint64_t id, uint32_t symbol, TPrice stop_price, TQuantity quantity, int64_t trailing_distance, int64_t trailing_step, OrderTimeInForce tif, TPrice slippage) noexcept
 {
-    return Order(id, symbol, OrderType::TRAILING_STOP_LIMIT, side, price, stop_price, quantity, tif, max_visible_quantity, std::numeric_limits<uint64_t>::max(), trailing_distance, trailing_step);
+    return OrderT(id, symbol, OrderType::TRAILING_STOP, OrderSide::SELL, 0, stop_price, quantity, tif, std::numeric_limits<TQuantity>::max(), slippage, trailing_distance, trailing_step);
 }
 
-inline Order Order::TrailingBuyStopLimit(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t price, uint64_t quantity, int64_t trailing_distance, int64_t trailing_step, OrderTimeInForce tif, uint64_t max_visible_quantity) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::TrailingStopLimit(uint64_t id, uint32_t symbol, OrderSide side, TPrice stop_price, TPrice price, TQuantity quantity, int64_t trailing_distance, int64_t trailing_step, OrderTimeInForce tif, TQuantity max_visible_quantity) noexcept
 {
-    return Order(id, symbol, OrderType::TRAILING_STOP_LIMIT, OrderSide::BUY, price, stop_price, quantity, tif, max_visible_quantity, std::numeric_limits<uint64_t>::max(), trailing_distance, trailing_step);
+    return OrderT(id, symbol, OrderType::TRAILING_STOP_LIMIT, side, price, stop_price, quantity, tif, max_visible_quantity, std::numeric_limits<TPrice>::max(), trailing_distance, trailing_step);
 }
 
-inline Order Order::TrailingSellStopLimit(uint64_t id, uint32_t symbol, uint64_t stop_price, uint64_t price, uint64_t quantity, int64_t trailing_distance, int64_t trailing_step, OrderTimeInForce tif, uint64_t max_visible_quantity) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::TrailingBuyStopLimit(uint64_t id, uint32_t symbol, TPrice stop_price, TPrice price, TQuantity quantity, int64_t trailing_distance, int64_t trailing_step, OrderTimeInForce tif, TQuantity max_visible_quantity) noexcept
 {
-    return Order(id, symbol, OrderType::TRAILING_STOP_LIMIT, OrderSide::SELL, price, stop_price, quantity, tif, max_visible_quantity, std::numeric_limits<uint64_t>::max(), trailing_distance, trailing_step);
+    return OrderT(id, symbol, OrderType::TRAILING_STOP_LIMIT, OrderSide::BUY, price, stop_price, quantity, tif, max_visible_quantity, std::numeric_limits<TPrice>::max(), trailing_distance, trailing_step);
 }
 
-inline OrderNode::OrderNode(const Order& order) noexcept : Order(order), Level(nullptr)
+template <typename TPrice, typename TQuantity>
+inline OrderT<TPrice, TQuantity> OrderT<TPrice, TQuantity>::TrailingSellStopLimit(uint64_t id, uint32_t symbol, TPrice stop_price, TPrice price, TQuantity quantity, int64_t trailing_distance, int64_t trailing_step, OrderTimeInForce tif, TQuantity max_visible_quantity) noexcept
 {
+    return OrderT(id, symbol, OrderType::TRAILING_STOP_LIMIT, OrderSide::SELL, price, stop_price, quantity, tif, max_visible_quantity, std::numeric_limits<TPrice>::max(), trailing_distance, trailing_step);
 }
 
-inline OrderNode& OrderNode::operator=(const Order& order) noexcept
+template <typename TPrice, typename TQuantity>
+inline OrderNodeT<TPrice, TQuantity>::OrderNodeT(const OrderT<TPrice, TQuantity>& order) noexcept : OrderLevelLinkT<TPrice, TQuantity>{ nullptr }, OrderT<TPrice, TQuantity>(order)
 {
-    Order::operator=(order);
-    Level = nullptr;
+}
+
+template <typename TPrice, typename TQuantity>
+inline OrderNodeT<TPrice, TQuantity>& OrderNodeT<TPrice, TQuantity>::operator=(const OrderT<TPrice, TQuantity>& order) noexcept
+{
+    OrderT<TPrice, TQuantity>::operator=(order);
+    this->Level = nullptr;
     return *this;
 }
 
+// Order with 64-bit prices and quantities is instantiated in the library
+extern template struct OrderT<uint64_t, uint64_t>;
+
 } // namespace Matching
 } // namespace CppTrader
@@ -10,36 +10,74 @@
 #define CPPTRADER_MATCHING_ORDER_BOOK_H
 
 #include "level.h"
+#include "market_traits.h"
 #include "symbol.h"
 
 #include "memory/allocator_pool.h"
+#include "threads/seq_lock.h"
 
 namespace CppTrader {
 namespace Matching {
 
-class MarketManager;
+template <class TTraits, class THandler>
+class MarketManagerT;
 
 //! Order book
 /*!
     Order book is used to keep buy and sell orders in a price level order.
 
-    Not thread-safe.
+    Price levels container is selected with the given market traits.
+
+    Trailing stop orders with an absolute trailing distance and without
+    trailing step follow a single trailing reference price for each side
+    of the book and are kept in price levels of their trailing distances.
+    Market moves update only the trailing reference price, stop prices of
+    such orders are calculated from it when they are activated or accessed
+    through the market manager.
+
+    Not thread-safe except top_of_book() method which could be called from
+    any thread while the order book is alive.
 */
-class OrderBook
+template <class TTraits>
+class OrderBookT
 {
-    friend class MarketManager;
+    template <class, class>
+    friend class MarketManagerT;
 
 public:
+    //! Price type
+    typedef typename TTraits::PriceType PriceType;
+    //! Quantity type
+    typedef typename TTraits::QuantityType QuantityType;
+    //! Order type
+    typedef typename TTraits::Order Order;
+    //! Order node type
+    typedef typename TTraits::OrderNode OrderNode;
+    //! Price level type
+    typedef typename TTraits::Level Level;
+    //! Price level node type
+    typedef typename TTraits::LevelNode LevelNode;
+    //! Price level update type
+    typedef typename TTraits::LevelUpdate LevelUpdate;
+    //! Top of the order book type
+    typedef typename TTraits::TopOfBook TopOfBook;
+    //! Depth cache type
+    typedef typename TTraits::DepthCache DepthCache;
+    //! Depth span type
+    typedef typename DepthCache::DepthSpan DepthSpan;
+
     //! Price level container
-    typedef CppCommon::BinTreeAVL<LevelNode, std::less<LevelNode>> Levels;
+    typedef typename TTraits::template Levels<LevelNode> Levels;
+    //! Price level pool
+    typedef CppCommon::PoolAllocator<LevelNode, CppCommon::DefaultMemoryManager> LevelPool;
 
-    OrderBook(MarketManager& manager, const Symbol& symbol);
-    OrderBook(const OrderBook&) = delete;
-    OrderBook(OrderBook&&) = delete;
-    ~OrderBook();
+    OrderBookT(LevelPool& level_pool, const Symbol& symbol);
+    OrderBookT(const OrderBookT&) = delete;
+    OrderBookT(OrderBookT&&) = delete;
+    ~OrderBookT();
 
-    OrderBook& operator=(const OrderBook&) = delete;
-    OrderBook& operator=(OrderBook&&) = delete;
+    OrderBookT& operator=(const OrderBookT&) = delete;
+    OrderBookT& operator=(OrderBookT&&) = delete;
 
     //! Check if the order book is not empty
     explicit operator bool() const noexcept { return !empty(); }
@@ -48,7 +86,7 @@ public:
     bool empty() const noexcept { return size() == 0; }
 
     //! Get the order book size
-    size_t size() const noexcept { return _bids.size() + _asks.size() + _buy_stop.size() + _sell_stop.size() + _trailing_buy_stop.size() + _trailing_sell_stop.size(); }
+    size_t size() const noexcept { return _bids.size() + _asks.size() + _buy_stop.size() + _sell_stop.size() + _trailing_buy_stop.size() + _trailing_sell_stop.size() + _trailing_buy_distance.size() + _trailing_sell_distance.size(); }
 
     //! Get the order book symbol
     const Symbol& symbol() const noexcept { return _symbol; }
@@ -58,6 +96,38 @@ public:
     //! Get the order book best ask price level
     const LevelNode* best_ask() const noexcept { return _best_ask; }
 
+    //! Get the order book top of the book
+    /*!
+        Top of the order book is published by the market manager with a
+        seqlock, so any number of reader threads could poll it without
+        blocking the matching thread. Readers retry only when they overlap
+        with the publication.
+
+        Thread-safe.
+
+        \return Consistent copy of the last published top of the book
+    */
+    TopOfBook top_of_book() const noexcept { return _top_of_book.Read(); }
+
+    //! Get the order book depth cache capacity (0 if the depth cache is disabled)
+    size_t depth() const noexcept { return _bid_depth.capacity(); }
+    //! Get the order book bids depth
+    /*!
+        Bids depth is a contiguous array of the best bid price levels kept
+        by the depth cache. It is empty if the depth cache is disabled.
+
+        \return Span of the best bid price levels from the best one
+    */
+    DepthSpan bid_depth() const noexcept { return _bid_depth.span(); }
+    //! Get the order book asks depth
+    /*!
+        Asks depth is a contiguous array of the best ask price levels kept
+        by the depth cache. It is empty if the depth cache is disabled.
+
+        \return Span of the best ask price levels from the best one
+    */
+    DepthSpan ask_depth() const noexcept { return _ask_depth.span(); }
+
     //! Get the order book bids container
     const Levels& bids() const noexcept { return _bids; }
     //! Get the order book asks container
@@ -83,51 +153,99 @@ public:
     //! Get the order book trailing sell stop orders container
     const Levels& trailing_sell_stop() const noexcept { return _trailing_sell_stop; }
 
-    template <class TOutputStream>
-    friend TOutputStream& operator<<(TOutputStream& stream, const OrderBook& order_book);
+    //! Get the order book best trailing buy distance price level
+    const LevelNode* best_trailing_buy_distance() const noexcept { return _best_trailing_buy_distance; }
+    //! Get the order book best trailing sell distance price level
+    const LevelNode* best_trailing_sell_distance() const noexcept { return _best_trailing_sell_distance; }
+
+    //! Get the order book trailing buy distance orders container
+    /*!
+        Price levels of the container are trailing distances of trailing
+        buy stop orders which follow the trailing buy reference price.
+    */
+    const Levels& trailing_buy_distance() const noexcept { return _trailing_buy_distance; }
+    //! Get the order book trailing sell distance orders container
+    /*!
+        Price levels of the container are trailing distances of trailing
+        sell stop orders which follow the trailing sell reference price.
+    */
+    const Levels& trailing_sell_distance() const noexcept { return _trailing_sell_distance; }
+
+    //! Get the trailing buy reference price
+    /*!
+        The lowest market ask price since trailing buy distance orders were
+        linked. Stop price of each order is the reference price plus its
+        trailing distance.
+    */
+    PriceType trailing_buy_reference() const noexcept { return _trailing_buy_reference; }
+    //! Get the trailing sell reference price
+    /*!
+        The highest market bid price since trailing sell distance orders were
+        linked. Stop price of each order is the reference price minus its
+        trailing distance.
+    */
+    PriceType trailing_sell_reference() const noexcept { return _trailing_sell_reference; }
+
+    //! Get the buy stop orders activation price
+    /*!
+        Buy stop orders are activated when the market ask price rises up to
+        this price. It is the lowest stop price of buy stop and trailing buy
+        stop orders or the maximal price if there are no buy stop orders.
+    */
+    PriceType buy_stop_activation_price() const noexcept { return _buy_stop_activation_price; }
+    //! Get the sell stop orders activation price
+    /*!
+        Sell stop orders are activated when the market bid price falls down to
+        this price. It is the highest stop price of sell stop and trailing
+        sell stop orders or zero if there are no sell stop orders.
+    */
+    PriceType sell_stop_activation_price() const noexcept { return _sell_stop_activation_price; }
+
+    template <class TOutputStream, class T>
+    friend TOutputStream& operator<<(TOutputStream& stream, const OrderBookT<T>& order_book);
 
     //! Get the order book bid price level with the given price
     /*!
         \param price - Price
         \return Pointer to the order book bid price level with the given price or nullptr
     */
-    const LevelNode* GetBid(uint64_t price) const noexcept;
+    const LevelNode* GetBid(PriceType price) const noexcept;
     //! Get the order book ask price level with the given price
     /*!
         \param price - Price
         \return Pointer to the order book ask price level with the given price or nullptr
     */
-    const LevelNode* GetAsk(uint64_t price) const noexcept;
+    const LevelNode* GetAsk(PriceType price) const noexcept;
 
     //! Get the order book buy stop level with the given price
     /*!
         \param price - Price
         \return Pointer to the order book buy stop level with the given price or nullptr
     */
-    const LevelNode* GetBuyStopLevel(uint64_t price) const noexcept;
+    const LevelNode* GetBuyStopLevel(PriceType price) const noexcept;
     //! Get the order book sell stop level with the given price
     /*!
         \param price - Price
         \return Pointer to the order book sell stop level with the given price or nullptr
     */
-    const LevelNode* GetSellStopLevel(uint64_t price) const noexcept;
+    const LevelNode* GetSellStopLevel(PriceType price) const noexcept;
 
     //! Get the order book trailing buy stop level with the given price
     /*!
         \param price - Price
         \return Pointer to the order book trailing buy stop level with the given price or nullptr
     */
-    const LevelNode* GetTrailingBuyStopLevel(uint64_t price) const noexcept;
+    const LevelNode* GetTrailingBuyStopLevel(PriceType price) const noexcept;
     //! Get the order book trailing sell stop level with the given price
     /*!
         \param price - Price
         \return Pointer to the order book trailing sell stop level with the given price or nullptr
     */
-    const LevelNode* GetTrailingSellStopLevel(uint64_t price) const noexcept;
+    const LevelNode* GetTrailingSellStopLevel(PriceType price) const noexcept;
 
 private:
-    // Market manager
-    MarketManager& _manager;
+    // Price level pool of the market manager
+    LevelPool& _level_pool;
 
     // Order book symbol
     Symbol _symbol;
@@ -142,11 +260,17 @@ private:
     LevelNode* GetNextLevel(LevelNode* level) noexcept;
     LevelNode* AddLevel(OrderNode* order_ptr);
     LevelNode* DeleteLevel(OrderNode* order_ptr);
+    LevelNode* DeleteLevel(LevelNode* level_ptr);
+
+    // Price level updates subscribed by the market manager
+    bool _level_updates;
 
     // Orders management
+    LevelUpdate GetLevelUpdate(UpdateType type, const LevelNode& level, bool top) const noexcept;
     LevelUpdate AddOrder(OrderNode* order_ptr);
-    LevelUpdate ReduceOrder(OrderNode* order_ptr, uint64_t quantity, uint64_t hidden, uint64_t visible);
+    LevelUpdate ReduceOrder(OrderNode* order_ptr, QuantityType quantity, QuantityType hidden, QuantityType visible);
     LevelUpdate DeleteOrder(OrderNode* order_ptr);
+    LevelUpdate SweepLevel(LevelNode* level_ptr);
 
     // Buy/Sell stop orders levels
     LevelNode* _best_buy_stop;
@@ -161,7 +285,7 @@ private:
 
     // Stop orders management
     void AddStopOrder(OrderNode* order_ptr);
-    void ReduceStopOrder(OrderNode* order_ptr, uint64_t quantity, uint64_t hidden, uint64_t visible);
+    void ReduceStopOrder(OrderNode* order_ptr, QuantityType quantity, QuantityType hidden, QuantityType visible);
     void DeleteStopOrder(OrderNode* order_ptr);
 
     // Buy/Sell trailing stop orders levels
@@ -177,30 +301,90 @@ private:
 
     // Trailing stop orders management
     void AddTrailingStopOrder(OrderNode* order_ptr);
-    void ReduceTrailingStopOrder(OrderNode* order_ptr, uint64_t quantity, uint64_t hidden, uint64_t visible);
+    void ReduceTrailingStopOrder(OrderNode* order_ptr, QuantityType quantity, QuantityType hidden, QuantityType visible);
     void DeleteTrailingStopOrder(OrderNode* order_ptr);
 
+    // Buy/Sell trailing distance orders levels
+    LevelNode* _best_trailing_buy_distance;
+    LevelNode* _best_trailing_sell_distance;
+    Levels _trailing_buy_distance;
+    Levels _trailing_sell_distance;
+
+    // Buy/Sell trailing reference prices
+    PriceType _trailing_buy_reference;
+    PriceType _trailing_sell_reference;
+
+    // Trailing distance orders follow trailing reference prices only without subscribed order updates
+    bool _trailing_references;
+
+    // Trailing distance orders price level management
+    LevelNode* AddTrailingDistanceLevel(OrderNode* order_ptr);
+    LevelNode* DeleteTrailingDistanceLevel(OrderNode* order_ptr);
+
+    // Trailing distance orders management
+    bool IsTrailingDistanceOrder(const OrderNode* order_ptr) const noexcept;
+    bool LinkTrailingDistanceOrder(const Order& order) noexcept;
+    PriceType GetTrailingDistanceStopPrice(OrderSide side, PriceType distance) const noexcept;
+    void UpdateTrailingReferencePrice(OrderSide side, PriceType price) noexcept;
+    void MaterializeTrailingStopOrder(OrderNode* order_ptr) noexcept;
+
     // Trailing stop price calculation
-    uint64_t CalculateTrailingStopPrice(const Order& order) const noexcept;
+    PriceType CalculateTrailingStopPrice(const Order& order) const noexcept;
+
+    // Stop orders activation prices
+    PriceType _buy_stop_activation_price;
+    PriceType _sell_stop_activation_price;
+
+    // Stop orders activation scheduling
+    bool IsStopActivationRequired(OrderSide side) const noexcept;
+    void UpdateStopActivationPrice(OrderSide side) noexcept;
 
     // Market last and trailing prices
-    uint64_t _last_bid_price;
-    uint64_t _last_ask_price;
-    uint64_t _matching_bid_price;
-    uint64_t _matching_ask_price;
-    uint64_t _trailing_bid_price;
-    uint64_t _trailing_ask_price;
+    PriceType _last_bid_price;
+    PriceType _last_ask_price;
+    PriceType _matching_bid_price;
+    PriceType _matching_ask_price;
+    PriceType _trailing_bid_price;
+    PriceType _trailing_ask_price;
 
     // Update market last prices
-    uint64_t GetMarketPriceBid() const noexcept;
-    uint64_t GetMarketPriceAsk() const noexcept;
-    uint64_t GetMarketTrailingStopPriceBid() const noexcept;
-    uint64_t GetMarketTrailingStopPriceAsk() const noexcept;
-    void UpdateLastPrice(const Order& order, uint64_t price) noexcept;
-    void UpdateMatchingPrice(const Order& order, uint64_t price) noexcept;
+    PriceType GetMarketPriceBid() const noexcept;
+    PriceType GetMarketPriceAsk() const noexcept;
+    PriceType GetMarketTrailingStopPriceBid() const noexcept;
+    PriceType GetMarketTrailingStopPriceAsk() const noexcept;
+    void UpdateLastPrice(const Order& order, PriceType price) noexcept;
+    void UpdateMatchingPrice(const Order& order, PriceType price) noexcept;
     void ResetMatchingPrice() noexcept;
+
+    // Top of the book published for concurrent readers
+    TopOfBook _top;
+    CppCommon::SeqLock<TopOfBook> _top_of_book;
+
+    // Top of the book publication
+    bool IsTopOfBookUpdate(const Level& level) const noexcept;
+    void PublishTopOfBook(LevelType type) noexcept;
+
+    // Bid/Ask depth caches
+    DepthCache _bid_depth;
+    DepthCache _ask_depth;
+
+    // Depth cache management
+    void ResetDepthCache(size_t depth);
+    void UpdateDepthCache(const LevelUpdate& update);
+
+    // Dirty order books list of the market manager
+    bool _dirty;
+    OrderBookT* _prev_dirty;
+    OrderBookT* _next_dirty;
+
+    // Coalesced order book update of the market manager
+    bool _coalesced;
+    bool _coalesced_top;
 };
 
+//! Order book with the default market traits
+typedef OrderBookT<MarketTraits<>> OrderBook;
+
 } // namespace Matching
 } // namespace CppTrader
 
@@ -9,8 +9,8 @@
 namespace CppTrader {
 namespace Matching {
 
-template <class TOutputStream>
-inline TOutputStream& operator<<(TOutputStream& stream, const OrderBook& order_book)
+template <class TOutputStream, class TTraits>
+inline TOutputStream& operator<<(TOutputStream& stream, const OrderBookT<TTraits>& order_book)
 {
     stream << "OrderBook(Symbol=" << order_book._symbol
         << "; Bids=" << order_book._bids.size()
@@ -19,143 +19,1085 @@ inline TOutputStream& operator<<(TOutputStream& stream, const OrderBook& order_b
         << "; SellStop=" << order_book._sell_stop.size()
         << "; TrailingBuyStop=" << order_book._trailing_buy_stop.size()
         << "; TrailingSellStop=" << order_book._trailing_sell_stop.size()
+        << "; TrailingBuyDistance=" << order_book._trailing_buy_distance.size()
+        << "; TrailingSellDistance=" << order_book._trailing_sell_distance.size()
         << ")";
     return stream;
 }
 
-inline const LevelNode* OrderBook::GetBid(uint64_t price) const noexcept
+template <class TTraits>
+inline const typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::GetBid(PriceType price) const noexcept
 {
-    auto it = _bids.find(LevelNode(LevelType::BID, price));
-    return (it != _bids.end()) ? it.operator->() : nullptr;
+    return _bids.find(price);
 }
 
-inline const LevelNode* OrderBook::GetAsk(uint64_t price) const noexcept
+template <class TTraits>
+inline const typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::GetAsk(PriceType price) const noexcept
 {
-    auto it = _asks.find(LevelNode(LevelType::ASK, price));
-    return (it != _asks.end()) ? it.operator->() : nullptr;
+    return _asks.find(price);
 }
 
-inline const LevelNode* OrderBook::GetBuyStopLevel(uint64_t price) const noexcept
+template <class TTraits>
+inline const typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::GetBuyStopLevel(PriceType price) const noexcept
 {
-    auto it = _buy_stop.find(LevelNode(LevelType::ASK, price));
-    return (it != _buy_stop.end()) ? it.operator->() : nullptr;
+    return _buy_stop.find(price);
 }
 
-inline const LevelNode* OrderBook::GetSellStopLevel(uint64_t price) const noexcept
+template <class TTraits>
+inline const typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::GetSellStopLevel(PriceType price) const noexcept
 {
-    auto it = _sell_stop.find(LevelNode(LevelType::BID, price));
-    return (it != _sell_stop.end()) ? it.operator->() : nullptr;
+    return _sell_stop.find(price);
 }
 
-inline const LevelNode* OrderBook::GetTrailingBuyStopLevel(uint64_t price) const noexcept
+template <class TTraits>
+inline const typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::GetTrailingBuyStopLevel(PriceType price) const noexcept
 {
-    auto it = _trailing_buy_stop.find(LevelNode(LevelType::ASK, price));
-    return (it != _trailing_buy_stop.end()) ? it.operator->() : nullptr;
+    return _trailing_buy_stop.find(price);
 }
 
-inline const LevelNode* OrderBook::GetTrailingSellStopLevel(uint64_t price) const noexcept
+template <class TTraits>
+inline const typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::GetTrailingSellStopLevel(PriceType price) const noexcept
 {
-    auto it = _trailing_sell_stop.find(LevelNode(LevelType::BID, price));
-    return (it != _trailing_sell_stop.end()) ? it.operator->() : nullptr;
+    return _trailing_sell_stop.find(price);
 }
 
-inline LevelNode* OrderBook::GetNextLevel(LevelNode* level) noexcept
+template <class TTraits>
+inline typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::GetNextLevel(LevelNode* level) noexcept
 {
     if (level->IsBid())
+        return _bids.lower(*level);
+    else
+        return _asks.higher(*level);
+}
+
+template <class TTraits>
+inline typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::GetNextStopLevel(LevelNode* level) noexcept
+{
+    if (level->IsBid())
+        return _sell_stop.lower(*level);
+    else
+        return _buy_stop.higher(*level);
+}
+
+template <class TTraits>
+inline typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::GetNextTrailingStopLevel(LevelNode* level) noexcept
+{
+    if (level->IsBid())
+        return _trailing_sell_stop.lower(*level);
+    else
+        return _trailing_buy_stop.higher(*level);
+}
+
+template <class TTraits>
+inline typename OrderBookT<TTraits>::PriceType OrderBookT<TTraits>::GetMarketPriceBid() const noexcept
+{
+    PriceType matching_price = _matching_bid_price;
+    PriceType best_price = (_best_bid != nullptr) ? _best_bid->Price : 0;
+    return std::max(matching_price, best_price);
+}
+
+template <class TTraits>
+inline typename OrderBookT<TTraits>::PriceType OrderBookT<TTraits>::GetMarketPriceAsk() const noexcept
+{
+    PriceType matching_price = _matching_ask_price;
+    PriceType best_price = (_best_ask != nullptr) ? _best_ask->Price : std::numeric_limits<PriceType>::max();
+    return std::min(matching_price, best_price);
+}
+
+template <class TTraits>
+inline typename OrderBookT<TTraits>::PriceType OrderBookT<TTraits>::GetMarketTrailingStopPriceBid() const noexcept
+{
+    PriceType last_price = _last_bid_price;
+    PriceType best_price = (_best_bid != nullptr) ? _best_bid->Price : 0;
+    return std::min(last_price, best_price);
+}
+
+template <class TTraits>
+inline typename OrderBookT<TTraits>::PriceType OrderBookT<TTraits>::GetMarketTrailingStopPriceAsk() const noexcept
+{
+    PriceType last_price = _last_ask_price;
+    PriceType best_price = (_best_ask != nullptr) ? _best_ask->Price : std::numeric_limits<PriceType>::max();
+    return std::max(last_price, best_price);
+}
+
+template <class TTraits>
+inline bool OrderBookT<TTraits>::IsTopOfBookUpdate(const Level& level) const noexcept
+{
+    // Price levels worse than the last published one are not published
+    if (level.IsBid())
+        return (_top.BidLevels < TopOfBook::DEPTH) || (level.Price >= _top.Bids[_top.BidLevels - 1].Price);
+    else
+        return (_top.AskLevels < TopOfBook::DEPTH) || (level.Price <= _top.Asks[_top.AskLevels - 1].Price);
+}
+
+template <class TTraits>
+inline void OrderBookT<TTraits>::PublishTopOfBook(LevelType type) noexcept
+{
+    // Collect the best price levels of the given side
+    bool bid = (type == LevelType::BID);
+    typename TopOfBook::Quote* quotes = bid ? _top.Bids : _top.Asks;
+    const DepthCache& cache = bid ? _bid_depth : _ask_depth;
+    size_t count = 0;
+    if (cache.capacity() >= TopOfBook::DEPTH)
     {
-        Levels::reverse_iterator it(&_bids, level);
-        ++it;
-        return it.operator->();
+        // Copy the best price levels from the deep enough depth cache
+        for (const auto& level : cache.span())
+        {
+            if (count == TopOfBook::DEPTH)
+                break;
+            quotes[count].Price = level.Price;
+            quotes[count].Volume = level.VisibleVolume;
+            quotes[count].Orders = level.Orders;
+            ++count;
+        }
     }
     else
     {
-        Levels::iterator it(&_asks, level);
-        ++it;
-        return it.operator->();
+        for (LevelNode* level_ptr = bid ? _best_bid : _best_ask; (level_ptr != nullptr) && (count < TopOfBook::DEPTH); level_ptr = GetNextLevel(level_ptr))
+        {
+            quotes[count].Price = level_ptr->Price;
+            quotes[count].Volume = level_ptr->VisibleVolume;
+            quotes[count].Orders = level_ptr->Orders;
+            ++count;
+        }
     }
+    if (bid)
+        _top.BidLevels = count;
+    else
+        _top.AskLevels = count;
+
+    // Publish the new top of the book
+    ++_top.Sequence;
+    _top_of_book.Write(_top);
 }
 
-inline LevelNode* OrderBook::GetNextStopLevel(LevelNode* level) noexcept
+template <class TTraits>
+inline void OrderBookT<TTraits>::ResetDepthCache(size_t depth)
 {
-    if (level->IsBid())
+    _bid_depth.Reset(depth);
+    _ask_depth.Reset(depth);
+
+    // Fill depth caches with the best price levels
+    for (LevelNode* level_ptr = _best_bid; (level_ptr != nullptr) && !_bid_depth.full(); level_ptr = GetNextLevel(level_ptr))
+        _bid_depth.Append(*level_ptr);
+    for (LevelNode* level_ptr = _best_ask; (level_ptr != nullptr) && !_ask_depth.full(); level_ptr = GetNextLevel(level_ptr))
+        _ask_depth.Append(*level_ptr);
+}
+
+template <class TTraits>
+inline void OrderBookT<TTraits>::UpdateDepthCache(const LevelUpdate& update)
+{
+    DepthCache& cache = update.Update.IsBid() ? _bid_depth : _ask_depth;
+    if (!cache.enabled())
+        return;
+
+    // Append the next price level when the cached one was deleted from the full depth cache
+    if (cache.Update(update.Type, update.Update))
     {
-        Levels::reverse_iterator it(&_sell_stop, level);
-        ++it;
-        return it.operator->();
+        LevelNode* level_ptr = nullptr;
+        if (cache.empty())
+            level_ptr = update.Update.IsBid() ? _best_bid : _best_ask;
+        else
+        {
+            level_ptr = update.Update.IsBid() ? _bids.find(cache.back().Price) : _asks.find(cache.back().Price);
+            if (level_ptr != nullptr)
+                level_ptr = GetNextLevel(level_ptr);
+        }
+        if (level_ptr != nullptr)
+            cache.Append(*level_ptr);
     }
+}
+
+template <class TTraits>
+inline void OrderBookT<TTraits>::UpdateLastPrice(const Order& order, PriceType price) noexcept
+{
+    if (order.IsBuy())
+        _last_bid_price = price;
     else
+        _last_ask_price = price;
+}
+
+template <class TTraits>
+inline void OrderBookT<TTraits>::UpdateMatchingPrice(const Order& order, PriceType price) noexcept
+{
+    if (order.IsBuy())
+        _matching_bid_price = price;
+    else
+        _matching_ask_price = price;
+}
+
+template <class TTraits>
+inline void OrderBookT<TTraits>::ResetMatchingPrice() noexcept
+{
+    _matching_bid_price = 0;
+    _matching_ask_price = std::numeric_limits<PriceType>::max();
+}
+
+template <class TTraits>
+OrderBookT<TTraits>::OrderBookT(LevelPool& level_pool, const Symbol& symbol)
+    : _level_pool(level_pool),
+      _symbol(symbol),
+      _best_bid(nullptr),
+      _best_ask(nullptr),
+      _bids(LevelType::BID),
+      _asks(LevelType::ASK),
+      _level_updates(true),
+      _best_buy_stop(nullptr),
+      _best_sell_stop(nullptr),
+      _buy_stop(LevelType::ASK),
+      _sell_stop(LevelType::BID),
+      _best_trailing_buy_stop(nullptr),
+      _best_trailing_sell_stop(nullptr),
+      _trailing_buy_stop(LevelType::ASK),
+      _trailing_sell_stop(LevelType::BID),
+      _best_trailing_buy_distance(nullptr),
+      _best_trailing_sell_distance(nullptr),
+      _trailing_buy_distance(LevelType::ASK),
+      _trailing_sell_distance(LevelType::ASK),
+      _trailing_buy_reference(std::numeric_limits<PriceType>::max()),
+      _trailing_sell_reference(0),
+      _trailing_references(true),
+      _buy_stop_activation_price(std::numeric_limits<PriceType>::max()),
+      _sell_stop_activation_price(0),
+      _last_bid_price(0),
+      _last_ask_price(std::numeric_limits<PriceType>::max()),
+      _matching_bid_price(0),
+      _matching_ask_price(std::numeric_limits<PriceType>::max()),
+      _trailing_bid_price(0),
+      _trailing_ask_price(std::numeric_limits<PriceType>::max()),
+      _bid_depth(LevelType::BID),
+      _ask_depth(LevelType::ASK),
+      _dirty(false),
+      _prev_dirty(nullptr),
+      _next_dirty(nullptr),
+      _coalesced(false),
+      _coalesced_top(false)
+{
+    // Publish the empty top of the book
+    _top.Sequence = 0;
+    _top.BidLevels = 0;
+    _top.AskLevels = 0;
+    _top_of_book.Write(_top);
+}
+
+template <class TTraits>
+OrderBookT<TTraits>::~OrderBookT()
+{
+    // Release bid price levels
+    while (!_bids.empty())
     {
-        Levels::iterator it(&_buy_stop, level);
-        ++it;
-        return it.operator->();
+        LevelNode* level = &*_bids.begin();
+        _bids.erase(*level);
+        _level_pool.Release(level);
+    }
+
+    // Release ask price levels
+    while (!_asks.empty())
+    {
+        LevelNode* level = &*_asks.begin();
+        _asks.erase(*level);
+        _level_pool.Release(level);
+    }
+
+    // Release buy stop orders levels
+    while (!_buy_stop.empty())
+    {
+        LevelNode* level = &*_buy_stop.begin();
+        _buy_stop.erase(*level);
+        _level_pool.Release(level);
+    }
+
+    // Release sell stop orders levels
+    while (!_sell_stop.empty())
+    {
+        LevelNode* level = &*_sell_stop.begin();
+        _sell_stop.erase(*level);
+        _level_pool.Release(level);
+    }
+
+    // Release trailing buy stop orders levels
+    while (!_trailing_buy_stop.empty())
+    {
+        LevelNode* level = &*_trailing_buy_stop.begin();
+        _trailing_buy_stop.erase(*level);
+        _level_pool.Release(level);
+    }
+
+    // Release trailing sell stop orders levels
+    while (!_trailing_sell_stop.empty())
+    {
+        LevelNode* level = &*_trailing_sell_stop.begin();
+        _trailing_sell_stop.erase(*level);
+        _level_pool.Release(level);
+    }
+
+    // Release trailing buy distance orders levels
+    while (!_trailing_buy_distance.empty())
+    {
+        LevelNode* level = &*_trailing_buy_distance.begin();
+        _trailing_buy_distance.erase(*level);
+        _level_pool.Release(level);
+    }
+
+    // Release trailing sell distance orders levels
+    while (!_trailing_sell_distance.empty())
+    {
+        LevelNode* level = &*_trailing_sell_distance.begin();
+        _trailing_sell_distance.erase(*level);
+        _level_pool.Release(level);
     }
 }
 
-inline LevelNode* OrderBook::GetNextTrailingStopLevel(LevelNode* level) noexcept
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::AddLevel(OrderNode* order_ptr)
 {
-    if (level->IsBid())
+    LevelNode* level_ptr = nullptr;
+
+    if (order_ptr->IsBuy())
     {
-        Levels::reverse_iterator it(&_trailing_sell_stop, level);
-        ++it;
-        return it.operator->();
+        // Create a new price level
+        level_ptr = _level_pool.Create(LevelType::BID, order_ptr->Price);
+
+        // Insert the price level into the bid collection
+        _bids.insert(*level_ptr);
+
+        // Update the best bid price level
+        if ((_best_bid == nullptr) || (level_ptr->Price > _best_bid->Price))
+            _best_bid = level_ptr;
     }
     else
     {
-        Levels::iterator it(&_trailing_buy_stop, level);
-        ++it;
-        return it.operator->();
+        // Create a new price level
+        level_ptr = _level_pool.Create(LevelType::ASK, order_ptr->Price);
+
+        // Insert the price level into the ask collection
+        _asks.insert(*level_ptr);
+
+        // Update the best ask price level
+        if ((_best_ask == nullptr) || (level_ptr->Price < _best_ask->Price))
+            _best_ask = level_ptr;
     }
+
+    return level_ptr;
 }
 
-inline uint64_t OrderBook::GetMarketPriceBid() const noexcept
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::DeleteLevel(OrderNode* order_ptr)
 {
-    uint64_t matching_price = _matching_bid_price;
-    uint64_t best_price = (_best_bid != nullptr) ? _best_bid->Price : 0;
-    return std::max(matching_price, best_price);
+    // Find the price level for the order
+    return DeleteLevel(order_ptr->Level);
 }
 
-inline uint64_t OrderBook::GetMarketPriceAsk() const noexcept
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::DeleteLevel(LevelNode* level_ptr)
 {
-    uint64_t matching_price = _matching_ask_price;
-    uint64_t best_price = (_best_ask != nullptr) ? _best_ask->Price : std::numeric_limits<uint64_t>::max();
-    return std::min(matching_price, best_price);
+    if (level_ptr->IsBid())
+    {
+        // Update the best bid price level
+        if (level_ptr == _best_bid)
+            _best_bid = _bids.lower(*level_ptr);
+
+        // Erase the price level from the bid collection
+        _bids.erase(*level_ptr);
+    }
+    else
+    {
+        // Update the best ask price level
+        if (level_ptr == _best_ask)
+            _best_ask = _asks.higher(*level_ptr);
+
+        // Erase the price level from the ask collection
+        _asks.erase(*level_ptr);
+    }
+
+    // Release the price level
+    _level_pool.Release(level_ptr);
+
+    return nullptr;
 }
 
-inline uint64_t OrderBook::GetMarketTrailingStopPriceBid() const noexcept
+template <class TTraits>
+inline typename OrderBookT<TTraits>::LevelUpdate OrderBookT<TTraits>::GetLevelUpdate(UpdateType type, const LevelNode& level, bool top) const noexcept
 {
-    uint64_t last_price = _last_bid_price;
-    uint64_t best_price = (_best_bid != nullptr) ? _best_bid->Price : 0;
-    return std::min(last_price, best_price);
+    // Price level volumes are copied only for subscribed market handlers and the depth cache
+    if (_level_updates || (level.IsBid() ? _bid_depth : _ask_depth).enabled())
+        return LevelUpdate(type, level, top);
+    else
+        return LevelUpdate(type, Level(level.Type, level.Price), top);
 }
 
-inline uint64_t OrderBook::GetMarketTrailingStopPriceAsk() const noexcept
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelUpdate OrderBookT<TTraits>::AddOrder(OrderNode* order_ptr)
 {
-    uint64_t last_price = _last_ask_price;
-    uint64_t best_price = (_best_ask != nullptr) ? _best_ask->Price : std::numeric_limits<uint64_t>::max();
-    return std::max(last_price, best_price);
+    // Find the price level for the order
+    LevelNode* level_ptr = order_ptr->IsBuy() ? (LevelNode*)GetBid(order_ptr->Price) : (LevelNode*)GetAsk(order_ptr->Price);
+
+    // Create a new price level if no one found
+    UpdateType update = UpdateType::UPDATE;
+    if (level_ptr == nullptr)
+    {
+        level_ptr = AddLevel(order_ptr);
+        update = UpdateType::ADD;
+    }
+
+    // Update the price level volume
+    level_ptr->TotalVolume += order_ptr->LeavesQuantity;
+    level_ptr->HiddenVolume += order_ptr->HiddenQuantity();
+    level_ptr->VisibleVolume += order_ptr->VisibleQuantity();
+
+    // Link the new order to the orders list of the price level
+    level_ptr->OrderList.push_back(*order_ptr);
+    ++level_ptr->Orders;
+
+    // Cache the price level in the given order
+    order_ptr->Level = level_ptr;
+
+    // Price level was changed. Return top of the book modification flag.
+    LevelUpdate result(GetLevelUpdate(update, *order_ptr->Level, (order_ptr->Level == (order_ptr->IsBuy() ? _best_bid : _best_ask))));
+    UpdateDepthCache(result);
+    return result;
+}
+
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelUpdate OrderBookT<TTraits>::ReduceOrder(OrderNode* order_ptr, QuantityType quantity, QuantityType hidden, QuantityType visible)
+{
+    // Find the price level for the order
+    LevelNode* level_ptr = order_ptr->Level;
+
+    // Update the price level volume
+    level_ptr->TotalVolume -= quantity;
+    level_ptr->HiddenVolume -= hidden;
+    level_ptr->VisibleVolume -= visible;
+
+    // Unlink the empty order from the orders list of the price level
+    if (order_ptr->LeavesQuantity == 0)
+    {
+        level_ptr->OrderList.pop_current(*order_ptr);
+        --level_ptr->Orders;
+    }
+
+    // Delete the empty price level
+    if (level_ptr->TotalVolume == 0)
+    {
+        // Empty price level is fully described by its type and price
+        LevelUpdate result(UpdateType::DELETE, Level(level_ptr->Type, level_ptr->Price), true);
+
+        // Clear the price level cache in the given order
+        order_ptr->Level = DeleteLevel(order_ptr);
+
+        UpdateDepthCache(result);
+        return result;
+    }
+
+    // Price level was changed. Return top of the book modification flag.
+    LevelUpdate result(GetLevelUpdate(UpdateType::UPDATE, *level_ptr, (level_ptr == (order_ptr->IsBuy() ? _best_bid : _best_ask))));
+    UpdateDepthCache(result);
+    return result;
 }
 
-inline void OrderBook::UpdateLastPrice(const Order& order, uint64_t price) noexcept
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelUpdate OrderBookT<TTraits>::DeleteOrder(OrderNode* order_ptr)
 {
+    // Find the price level for the order
+    LevelNode* level_ptr = order_ptr->Level;
+
+    // Update the price level volume
+    level_ptr->TotalVolume -= order_ptr->LeavesQuantity;
+    level_ptr->HiddenVolume -= order_ptr->HiddenQuantity();
+    level_ptr->VisibleVolume -= order_ptr->VisibleQuantity();
+
+    // Unlink the empty order from the orders list of the price level
+    level_ptr->OrderList.pop_current(*order_ptr);
+    --level_ptr->Orders;
+
+    // Delete the empty price level
+    if (level_ptr->TotalVolume == 0)
+    {
+        // Empty price level is fully described by its type and price
+        LevelUpdate result(UpdateType::DELETE, Level(level_ptr->Type, level_ptr->Price), true);
+
+        // Clear the price level cache in the given order
+        order_ptr->Level = DeleteLevel(order_ptr);
+
+        UpdateDepthCache(result);
+        return result;
+    }
+
+    // Price level was changed. Return top of the book modification flag.
+    LevelUpdate result(GetLevelUpdate(UpdateType::UPDATE, *level_ptr, (level_ptr == (order_ptr->IsBuy() ? _best_bid : _best_ask))));
+    UpdateDepthCache(result);
+    return result;
+}
+
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelUpdate OrderBookT<TTraits>::SweepLevel(LevelNode* level_ptr)
+{
+    assert(level_ptr->OrderList.empty() && "All orders of the swept price level must be unlinked!");
+    assert((level_ptr->TotalVolume == 0) && (level_ptr->Orders == 0) && "Volume of the swept price level must be reduced!");
+
+    Level level(*level_ptr);
+
+    // Delete the empty price level
+    DeleteLevel(level_ptr);
+
+    // Price level was deleted. Return top of the book modification flag.
+    LevelUpdate result(UpdateType::DELETE, level, true);
+    UpdateDepthCache(result);
+    return result;
+}
+
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::AddStopLevel(OrderNode* order_ptr)
+{
+    LevelNode* level_ptr = nullptr;
+
+    if (order_ptr->IsBuy())
+    {
+        // Create a new price level
+        level_ptr = _level_pool.Create(LevelType::ASK, order_ptr->StopPrice);
+
+        // Insert the price level into the buy stop orders collection
+        _buy_stop.insert(*level_ptr);
+
+        // Update the best buy stop order price level
+        if ((_best_buy_stop == nullptr) || (level_ptr->Price < _best_buy_stop->Price))
+            _best_buy_stop = level_ptr;
+    }
+    else
+    {
+        // Create a new price level
+        level_ptr = _level_pool.Create(LevelType::BID, order_ptr->StopPrice);
+
+        // Insert the price level into the sell stop orders collection
+        _sell_stop.insert(*level_ptr);
+
+        // Update the best sell stop order price level
+        if ((_best_sell_stop == nullptr) || (level_ptr->Price > _best_sell_stop->Price))
+            _best_sell_stop = level_ptr;
+    }
+
+    // Update the stop orders activation price
+    UpdateStopActivationPrice(order_ptr->Side);
+
+    return level_ptr;
+}
+
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::DeleteStopLevel(OrderNode* order_ptr)
+{
+    // Find the price level for the order
+    LevelNode* level_ptr = order_ptr->Level;
+
+    if (order_ptr->IsBuy())
+    {
+        // Update the best buy stop order price level
+        if (level_ptr == _best_buy_stop)
+            _best_buy_stop = _buy_stop.higher(*level_ptr);
+
+        // Erase the price level from the buy stop orders collection
+        _buy_stop.erase(*level_ptr);
+    }
+    else
+    {
+        // Update the best sell stop order price level
+        if (level_ptr == _best_sell_stop)
+            _best_sell_stop = _sell_stop.lower(*level_ptr);
+
+        // Erase the price level from the sell stop orders collection
+        _sell_stop.erase(*level_ptr);
+    }
+
+    // Release the price level
+    _level_pool.Release(level_ptr);
+
+    // Update the stop orders activation price
+    UpdateStopActivationPrice(order_ptr->Side);
+
+    return nullptr;
+}
+
+template <class TTraits>
+void OrderBookT<TTraits>::AddStopOrder(OrderNode* order_ptr)
+{
+    // Find the price level for the order
+    LevelNode* level_ptr = order_ptr->IsBuy() ? (LevelNode*)GetBuyStopLevel(order_ptr->StopPrice) : (LevelNode*)GetSellStopLevel(order_ptr->StopPrice);
+
+    // Create a new price level if no one found
+    if (level_ptr == nullptr)
+        level_ptr = AddStopLevel(order_ptr);
+
+    // Update the price level volume
+    level_ptr->TotalVolume += order_ptr->LeavesQuantity;
+    level_ptr->HiddenVolume += order_ptr->HiddenQuantity();
+    level_ptr->VisibleVolume += order_ptr->VisibleQuantity();
+
+    // Link the new order to the orders list of the price level
+    level_ptr->OrderList.push_back(*order_ptr);
+    ++level_ptr->Orders;
+
+    // Cache the price level in the given order
+    order_ptr->Level = level_ptr;
+}
+
+template <class TTraits>
+void OrderBookT<TTraits>::ReduceStopOrder(OrderNode* order_ptr, QuantityType quantity, QuantityType hidden, QuantityType visible)
+{
+    // Find the price level for the order
+    LevelNode* level_ptr = order_ptr->Level;
+
+    // Update the price level volume
+    level_ptr->TotalVolume -= quantity;
+    level_ptr->HiddenVolume -= hidden;
+    level_ptr->VisibleVolume -= visible;
+
+    // Unlink the empty order from the orders list of the price level
+    if (order_ptr->LeavesQuantity == 0)
+    {
+        level_ptr->OrderList.pop_current(*order_ptr);
+        --level_ptr->Orders;
+    }
+
+    // Delete the empty price level
+    if (level_ptr->TotalVolume == 0)
+    {
+        // Clear the price level cache in the given order
+        order_ptr->Level = DeleteStopLevel(order_ptr);
+    }
+}
+
+template <class TTraits>
+void OrderBookT<TTraits>::DeleteStopOrder(OrderNode* order_ptr)
+{
+    // Find the price level for the order
+    LevelNode* level_ptr = order_ptr->Level;
+
+    // Update the price level volume
+    level_ptr->TotalVolume -= order_ptr->LeavesQuantity;
+    level_ptr->HiddenVolume -= order_ptr->HiddenQuantity();
+    level_ptr->VisibleVolume -= order_ptr->VisibleQuantity();
+
+    // Unlink the empty order from the orders list of the price level
+    level_ptr->OrderList.pop_current(*order_ptr);
+    --level_ptr->Orders;
+
+    // Delete the empty price level
+    if (level_ptr->TotalVolume == 0)
+    {
+        // Clear the price level cache in the given order
+        order_ptr->Level = DeleteStopLevel(order_ptr);
+    }
+}
+
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::AddTrailingStopLevel(OrderNode* order_ptr)
+{
+    LevelNode* level_ptr = nullptr;
+
+    if (order_ptr->IsBuy())
+    {
+        // Create a new price level
+        level_ptr = _level_pool.Create(LevelType::ASK, order_ptr->StopPrice);
+
+        // Insert the price level into the trailing buy stop orders collection
+        _trailing_buy_stop.insert(*level_ptr);
+
+        // Update the best trailing buy stop order price level
+        if ((_best_trailing_buy_stop == nullptr) || (level_ptr->Price < _best_trailing_buy_stop->Price))
+            _best_trailing_buy_stop = level_ptr;
+    }
+    else
+    {
+        // Create a new price level
+        level_ptr = _level_pool.Create(LevelType::BID, order_ptr->StopPrice);
+
+        // Insert the price level into the trailing sell stop orders collection
+        _trailing_sell_stop.insert(*level_ptr);
+
+        // Update the best trailing sell stop order price level
+        if ((_best_trailing_sell_stop == nullptr) || (level_ptr->Price > _best_trailing_sell_stop->Price))
+            _best_trailing_sell_stop = level_ptr;
+    }
+
+    // Update the stop orders activation price
+    UpdateStopActivationPrice(order_ptr->Side);
+
+    return level_ptr;
+}
+
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::DeleteTrailingStopLevel(OrderNode* order_ptr)
+{
+    // Find the price level for the order
+    LevelNode* level_ptr = order_ptr->Level;
+
+    if (order_ptr->IsBuy())
+    {
+        // Update the best trailing buy stop order price level
+        if (level_ptr == _best_trailing_buy_stop)
+            _best_trailing_buy_stop = _trailing_buy_stop.higher(*level_ptr);
+
+        // Erase the price level from the trailing buy stop orders collection
+        _trailing_buy_stop.erase(*level_ptr);
+    }
+    else
+    {
+        // Update the best trailing sell stop order price level
+        if (level_ptr == _best_trailing_sell_stop)
+            _best_trailing_sell_stop = _trailing_sell_stop.lower(*level_ptr);
+
+        // Erase the price level from the trailing sell stop orders collection
+        _trailing_sell_stop.erase(*level_ptr);
+    }
+
+    // Release the price level
+    _level_pool.Release(level_ptr);
+
+    // Update the stop orders activation price
+    UpdateStopActivationPrice(order_ptr->Side);
+
+    return nullptr;
+}
+
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::AddTrailingDistanceLevel(OrderNode* order_ptr)
+{
+    LevelNode* level_ptr = nullptr;
+
+    if (order_ptr->IsBuy())
+    {
+        // Create a new price level of the trailing distance
+        level_ptr = _level_pool.Create(LevelType::ASK, (PriceType)order_ptr->TrailingDistance);
+
+        // Insert the price level into the trailing buy distance orders collection
+        _trailing_buy_distance.insert(*level_ptr);
+
+        // Update the best trailing buy distance order price level
+        if ((_best_trailing_buy_distance == nullptr) || (level_ptr->Price < _best_trailing_buy_distance->Price))
+            _best_trailing_buy_distance = level_ptr;
+    }
+    else
+    {
+        // Create a new price level of the trailing distance
+        level_ptr = _level_pool.Create(LevelType::BID, (PriceType)order_ptr->TrailingDistance);
+
+        // Insert the price level into the trailing sell distance orders collection
+        _trailing_sell_distance.insert(*level_ptr);
+
+        // Update the best trailing sell distance order price level
+        if ((_best_trailing_sell_distance == nullptr) || (level_ptr->Price < _best_trailing_sell_distance->Price))
+            _best_trailing_sell_distance = level_ptr;
+    }
+
+    // Update the stop orders activation price
+    UpdateStopActivationPrice(order_ptr->Side);
+
+    return level_ptr;
+}
+
+template <class TTraits>
+typename OrderBookT<TTraits>::LevelNode* OrderBookT<TTraits>::DeleteTrailingDistanceLevel(OrderNode* order_ptr)
+{
+    // Find the price level for the order
+    LevelNode* level_ptr = order_ptr->Level;
+
+    if (order_ptr->IsBuy())
+    {
+        // Update the best trailing buy distance order price level
+        if (level_ptr == _best_trailing_buy_distance)
+            _best_trailing_buy_distance = _trailing_buy_distance.higher(*level_ptr);
+
+        // Erase the price level from the trailing buy distance orders collection
+        _trailing_buy_distance.erase(*level_ptr);
+    }
+    else
+    {
+        // Update the best trailing sell distance order price level
+        if (level_ptr == _best_trailing_sell_distance)
+            _best_trailing_sell_distance = _trailing_sell_distance.higher(*level_ptr);
+
+        // Erase the price level from the trailing sell distance orders collection
+        _trailing_sell_distance.erase(*level_ptr);
+    }
+
+    // Release the price level
+    _level_pool.Release(level_ptr);
+
+    // Update the stop orders activation price
+    UpdateStopActivationPrice(order_ptr->Side);
+
+    return nullptr;
+}
+
+template <class TTraits>
+bool OrderBookT<TTraits>::IsTrailingDistanceOrder(const OrderNode* order_ptr) const noexcept
+{
+    if ((order_ptr->Level == nullptr) || (order_ptr->TrailingDistance <= 0) || (order_ptr->TrailingStep != 0))
+        return false;
+    if (!order_ptr->IsTrailingStop() && !order_ptr->IsTrailingStopLimit())
+        return false;
+
+    // Check if the order is linked to the price level of its trailing distance
+    const Levels& levels = order_ptr->IsBuy() ? _trailing_buy_distance : _trailing_sell_distance;
+    return (levels.find((uint64_t)order_ptr->TrailingDistance) == order_ptr->Level);
+}
+
+template <class TTraits>
+bool OrderBookT<TTraits>::LinkTrailingDistanceOrder(const Order& order) noexcept
+{
+    // Only absolute trailing distance without trailing step could follow the trailing reference price
+    if (!_trailing_references || (order.TrailingDistance <= 0) || (order.TrailingStep != 0) || ((uint64_t)order.TrailingDistance > std::numeric_limits<PriceType>::max()))
+        return false;
+
+    PriceType distance = (PriceType)order.TrailingDistance;
+
     if (order.IsBuy())
-        _last_bid_price = price;
+    {
+        // Stop price below the trailing distance is not reachable from any reference price
+        if (order.StopPrice < distance)
+            return false;
+
+        // Start the trailing buy reference price with the first order
+        PriceType reference = order.StopPrice - distance;
+        if (_best_trailing_buy_distance == nullptr)
+            _trailing_buy_reference = reference;
+
+        return (reference == _trailing_buy_reference);
+    }
     else
-        _last_ask_price = price;
+    {
+        // Stop price above the maximal price minus the trailing distance is not reachable from any reference price
+        if (order.StopPrice > (std::numeric_limits<PriceType>::max() - distance))
+            return false;
+
+        // Start the trailing sell reference price with the first order
+        PriceType reference = order.StopPrice + distance;
+        if (_best_trailing_sell_distance == nullptr)
+            _trailing_sell_reference = reference;
+
+        return (reference == _trailing_sell_reference);
+    }
+}
+
+template <class TTraits>
+inline typename OrderBookT<TTraits>::PriceType OrderBookT<TTraits>::GetTrailingDistanceStopPrice(OrderSide side, PriceType distance) const noexcept
+{
+    if (side == OrderSide::BUY)
+        return _trailing_buy_reference + distance;
+    else
+        return _trailing_sell_reference - distance;
+}
+
+template <class TTraits>
+void OrderBookT<TTraits>::UpdateTrailingReferencePrice(OrderSide side, PriceType price) noexcept
+{
+    if (side == OrderSide::BUY)
+    {
+        // Trailing buy stop prices follow the market ask price down
+        if ((_best_trailing_buy_distance != nullptr) && (price < _trailing_buy_reference))
+        {
+            _trailing_buy_reference = price;
+            UpdateStopActivationPrice(side);
+        }
+    }
+    else
+    {
+        // Trailing sell stop prices follow the market bid price up
+        if ((_best_trailing_sell_distance != nullptr) && (price > _trailing_sell_reference))
+        {
+            _trailing_sell_reference = price;
+            UpdateStopActivationPrice(side);
+        }
+    }
+}
+
+template <class TTraits>
+void OrderBookT<TTraits>::MaterializeTrailingStopOrder(OrderNode* order_ptr) noexcept
+{
+    if (!IsTrailingDistanceOrder(order_ptr))
+        return;
+
+    // Calculate the stop price from the trailing reference price
+    PriceType stop_price = GetTrailingDistanceStopPrice(order_ptr->Side, (PriceType)order_ptr->TrailingDistance);
+
+    // Move the limit price together with the stop price
+    if (order_ptr->IsTrailingStopLimit())
+        order_ptr->Price = (PriceType)((int64_t)order_ptr->Price + ((int64_t)stop_price - (int64_t)order_ptr->StopPrice));
+
+    order_ptr->StopPrice = stop_price;
+}
+
+template <class TTraits>
+void OrderBookT<TTraits>::AddTrailingStopOrder(OrderNode* order_ptr)
+{
+    LevelNode* level_ptr;
+
+    if (LinkTrailingDistanceOrder(*order_ptr))
+    {
+        // Find the price level of the order trailing distance
+        level_ptr = order_ptr->IsBuy() ? _trailing_buy_distance.find((uint64_t)order_ptr->TrailingDistance) : _trailing_sell_distance.find((uint64_t)order_ptr->TrailingDistance);
+
+        // Create a new price level if no one found
+        if (level_ptr == nullptr)
+            level_ptr = AddTrailingDistanceLevel(order_ptr);
+    }
+    else
+    {
+        // Find the price level for the order
+        level_ptr = order_ptr->IsBuy() ? (LevelNode*)GetTrailingBuyStopLevel(order_ptr->StopPrice) : (LevelNode*)GetTrailingSellStopLevel(order_ptr->StopPrice);
+
+        // Create a new price level if no one found
+        if (level_ptr == nullptr)
+            level_ptr = AddTrailingStopLevel(order_ptr);
+    }
+
+    // Update the price level volume
+    level_ptr->TotalVolume += order_ptr->LeavesQuantity;
+    level_ptr->HiddenVolume += order_ptr->HiddenQuantity();
+    level_ptr->VisibleVolume += order_ptr->VisibleQuantity();
+
+    // Link the new order to the orders list of the price level
+    level_ptr->OrderList.push_back(*order_ptr);
+    ++level_ptr->Orders;
+
+    // Cache the price level in the given order
+    order_ptr->Level = level_ptr;
 }
 
-inline void OrderBook::UpdateMatchingPrice(const Order& order, uint64_t price) noexcept
+template <class TTraits>
+void OrderBookT<TTraits>::ReduceTrailingStopOrder(OrderNode* order_ptr, QuantityType quantity, QuantityType hidden, QuantityType visible)
 {
+    // Find the price level for the order
+    LevelNode* level_ptr = order_ptr->Level;
+    bool distance = IsTrailingDistanceOrder(order_ptr);
+
+    // Update the price level volume
+    level_ptr->TotalVolume -= quantity;
+    level_ptr->HiddenVolume -= hidden;
+    level_ptr->VisibleVolume -= visible;
+
+    // Unlink the empty order from the orders list of the price level
+    if (order_ptr->LeavesQuantity == 0)
+    {
+        level_ptr->OrderList.pop_current(*order_ptr);
+        --level_ptr->Orders;
+    }
+
+    // Delete the empty price level
+    if (level_ptr->TotalVolume == 0)
+    {
+        // Clear the price level cache in the given order
+        order_ptr->Level = distance ? DeleteTrailingDistanceLevel(order_ptr) : DeleteTrailingStopLevel(order_ptr);
+    }
+}
+
+template <class TTraits>
+void OrderBookT<TTraits>::DeleteTrailingStopOrder(OrderNode* order_ptr)
+{
+    // Find the price level for the order
+    LevelNode* level_ptr = order_ptr->Level;
+    bool distance = IsTrailingDistanceOrder(order_ptr);
+
+    // Update the price level volume
+    level_ptr->TotalVolume -= order_ptr->LeavesQuantity;
+    level_ptr->HiddenVolume -= order_ptr->HiddenQuantity();
+    level_ptr->VisibleVolume -= order_ptr->VisibleQuantity();
+
+    // Unlink the empty order from the orders list of the price level
+    level_ptr->OrderList.pop_current(*order_ptr);
+    --level_ptr->Orders;
+
+    // Delete the empty price level
+    if (level_ptr->TotalVolume == 0)
+    {
+        // Clear the price level cache in the given order
+        order_ptr->Level = distance ? DeleteTrailingDistanceLevel(order_ptr) : DeleteTrailingStopLevel(order_ptr);
+    }
+}
+
+template <class TTraits>
+typename OrderBookT<TTraits>::PriceType OrderBookT<TTraits>::CalculateTrailingStopPrice(const Order& order) const noexcept
+{
+    // Get the current market price
+    PriceType market_price = order.IsBuy() ? GetMarketTrailingStopPriceAsk() : GetMarketTrailingStopPriceBid();
+    int64_t trailing_distance = order.TrailingDistance;
+    int64_t trailing_step = order.TrailingStep;
+
+    // Convert percentage trailing values into absolute ones
+    if (trailing_distance < 0)
+    {
+        trailing_distance = (int64_t)((-trailing_distance * market_price) / 10000);
+        trailing_step = (int64_t)((-trailing_step * market_price) / 10000);
+    }
+
+    PriceType old_price = order.StopPrice;
+
     if (order.IsBuy())
-        _matching_bid_price = price;
+    {
+        // Calculate a new stop price
+        PriceType new_price = (market_price < (std::numeric_limits<PriceType>::max() - trailing_distance)) ? (market_price + trailing_distance) : std::numeric_limits<PriceType>::max();
+
+        // If the new price is better and we get through the trailing step
+        if (new_price < old_price)
+            if ((old_price - new_price) >= (uint64_t)trailing_step)
+                return new_price;
+    }
     else
-        _matching_ask_price = price;
+    {
+        // Calculate a new stop price
+        PriceType new_price = (market_price > (uint64_t)trailing_distance) ? (market_price - trailing_distance) : 0;
+
+        // If the new price is better and we get through the trailing step
+        if (new_price > old_price)
+            if ((new_price - old_price) >= (uint64_t)trailing_step)
+                return new_price;
+    }
+
+    return old_price;
 }
 
-inline void OrderBook::ResetMatchingPrice() noexcept
+template <class TTraits>
+inline bool OrderBookT<TTraits>::IsStopActivationRequired(OrderSide side) const noexcept
 {
-    _matching_bid_price = 0;
-    _matching_ask_price = std::numeric_limits<uint64_t>::max();
+    // Check if the market crossed the stop orders activation price. Empty side
+    // of the market has the same price as the empty activation price, so check
+    // that there are stop orders to activate first.
+    if (side == OrderSide::BUY)
+        return ((_best_buy_stop != nullptr) || (_best_trailing_buy_stop != nullptr) || (_best_trailing_buy_distance != nullptr)) && (GetMarketPriceAsk() >= _buy_stop_activation_price);
+    else
+        return ((_best_sell_stop != nullptr) || (_best_trailing_sell_stop != nullptr) || (_best_trailing_sell_distance != nullptr)) && (GetMarketPriceBid() <= _sell_stop_activation_price);
+}
+
+template <class TTraits>
+void OrderBookT<TTraits>::UpdateStopActivationPrice(OrderSide side) noexcept
+{
+    if (side == OrderSide::BUY)
+    {
+        // The lowest buy stop price is activated first
+        PriceType price = std::numeric_limits<PriceType>::max();
+        if (_best_buy_stop != nullptr)
+            price = std::min(price, _best_buy_stop->Price);
+        if (_best_trailing_buy_stop != nullptr)
+            price = std::min(price, _best_trailing_buy_stop->Price);
+        if (_best_trailing_buy_distance != nullptr)
+            price = std::min(price, GetTrailingDistanceStopPrice(side, _best_trailing_buy_distance->Price));
+        _buy_stop_activation_price = price;
+    }
+    else
+    {
+        // The highest sell stop price is activated first
+        PriceType price = 0;
+        if (_best_sell_stop != nullptr)
+            price = std::max(price, _best_sell_stop->Price);
+        if (_best_trailing_sell_stop != nullptr)
+            price = std::max(price, _best_trailing_sell_stop->Price);
+        if (_best_trailing_sell_distance != nullptr)
+            price = std::max(price, GetTrailingDistanceStopPrice(side, _best_trailing_sell_distance->Price));
+        _sell_stop_activation_price = price;
+    }
 }
 
+// Order book with the default market traits is instantiated in the library
+extern template class OrderBookT<MarketTraits<>>;
+
 } // namespace Matching
 } // namespace CppTrader
@@ -0,0 +1,353 @@
+/*!
+    \file order_book_snapshot.h
+    \brief Order book snapshot definition
+    \author Ivan Shynkarenka
+    \date 28.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_ORDER_BOOK_SNAPSHOT_H
+#define CPPTRADER_MATCHING_ORDER_BOOK_SNAPSHOT_H
+
+#include "epoch_manager.h"
+#include "fast_hash.h"
+#include "market_handler.h"
+
+#include "containers/hashmap.h"
+
+#include <memory>
+#include <vector>
+
+namespace CppTrader {
+namespace Matching {
+
+//! Order book snapshot
+/*!
+    Order book snapshot is an immutable compact copy of the order book with
+    flattened price levels and orders. Bid and ask price levels are sorted
+    from the best one. Orders of each price level are kept in their time
+    priority. Stop orders of all kinds are sorted by side, stop price and Id.
+
+    Price levels which were not changed since the previous publication are
+    shared with the previous snapshot.
+
+    Stop prices of trailing stop orders are the ones reported with the last
+    order event.
+
+    Thread-safe.
+*/
+template <class TTraits>
+class OrderBookSnapshotT
+{
+    template <class T>
+    friend class OrderBookSnapshotsT;
+
+public:
+    //! Order type
+    typedef typename TTraits::Order Order;
+    //! Price level type
+    typedef typename TTraits::Level Level;
+
+    OrderBookSnapshotT(const OrderBookSnapshotT&) = delete;
+    OrderBookSnapshotT(OrderBookSnapshotT&&) = delete;
+    ~OrderBookSnapshotT() = default;
+
+    OrderBookSnapshotT& operator=(const OrderBookSnapshotT&) = delete;
+    OrderBookSnapshotT& operator=(OrderBookSnapshotT&&) = delete;
+
+    //! Get the order book symbol
+    const Symbol& symbol() const noexcept { return _symbol; }
+    //! Get the snapshot sequence number (incremented with each publication of the order book)
+    uint64_t sequence() const noexcept { return _sequence; }
+
+    //! Get the count of bid price levels
+    size_t bid_levels() const noexcept { return _bids->size(); }
+    //! Get the count of ask price levels
+    size_t ask_levels() const noexcept { return _asks->size(); }
+
+    //! Get the bid price level
+    /*!
+        \param index - Index of the bid price level from the best one
+        \return Bid price level
+    */
+    const Level& bid(size_t index) const noexcept { return (*_bids)[index]->PriceLevel; }
+    //! Get the ask price level
+    /*!
+        \param index - Index of the ask price level from the best one
+        \return Ask price level
+    */
+    const Level& ask(size_t index) const noexcept { return (*_asks)[index]->PriceLevel; }
+
+    //! Get orders of the bid price level
+    /*!
+        \param index - Index of the bid price level from the best one
+        \return Orders of the bid price level in their time priority
+    */
+    const std::vector<Order>& bid_orders(size_t index) const noexcept { return (*_bids)[index]->LevelOrders; }
+    //! Get orders of the ask price level
+    /*!
+        \param index - Index of the ask price level from the best one
+        \return Orders of the ask price level in their time priority
+    */
+    const std::vector<Order>& ask_orders(size_t index) const noexcept { return (*_asks)[index]->LevelOrders; }
+    //! Get stop orders (buy stop orders first)
+    const std::vector<Order>& stop_orders() const noexcept { return *_stop_orders; }
+
+private:
+    // Price level with its orders in the time priority
+    struct Group
+    {
+        Level PriceLevel;
+        std::vector<Order> LevelOrders;
+    };
+
+    // Price levels and orders shared between snapshots
+    typedef std::shared_ptr<Group> GroupPtr;
+    typedef std::shared_ptr<std::vector<GroupPtr>> Groups;
+    typedef std::shared_ptr<std::vector<Order>> Orders;
+
+    Symbol _symbol;
+    uint64_t _sequence;
+    Groups _bids;
+    Groups _asks;
+    Orders _stop_orders;
+
+    OrderBookSnapshotT(const Symbol& symbol, uint64_t sequence) : _symbol(symbol), _sequence(sequence) {}
+};
+
+//! Order book snapshot with the default market traits
+typedef OrderBookSnapshotT<MarketTraits<>> OrderBookSnapshot;
+
+//! Order book snapshots
+/*!
+    Order book snapshots is a market handler which maintains a compact copy of
+    each order book incrementally from market events and publishes immutable
+    order book snapshots for reader threads. All market events are forwarded
+    to the given market handler:
+    \code{.cpp}
+    MyMarketHandler handler;
+    OrderBookSnapshots snapshots(handler);
+    MarketManager market(snapshots);
+
+    // Matching thread
+    market.AddOrder(...);
+    snapshots.Publish();
+
+    // Reader thread
+    OrderBookSnapshots::Reader reader(snapshots);
+    reader.Lock();
+    const OrderBookSnapshot* snapshot_ptr = reader.GetOrderBook(symbol_id);
+    ...
+    reader.Unlock();
+    \endcode
+
+    Publish() method publishes new snapshots of order books modified since
+    the previous publication, so the owning thread controls the publication
+    frequency (e.g. after each command or each batch of commands). Readers
+    traverse full depth of published snapshots without touching live price
+    levels and orders of the market manager.
+
+    Each price level with its orders and the list of price levels of each
+    side are shared with published snapshots by pointer and copied on the
+    first modification after the publication. The publication itself copies
+    nothing, and a change after the publication copies only the pointers of
+    the changed side and the changed price level.
+
+    Orders of each price level are kept in their time priority: new and
+    modified orders are appended to the end of the price level, reduced and
+    executed orders are updated in place.
+
+    Order book snapshots are maintained from order book, price level, order
+    and execution events, so the market manager always subscribes to all
+    market events when its market handler is order book snapshots.
+
+    Replaced snapshots are reclaimed with the epoch-based reclamation. Reader
+    marks the read-side critical section with Lock() and Unlock() methods,
+    snapshots are valid until the reader leaves the critical section.
+
+    Not thread-safe except the Reader class. Market handler events and
+    Publish() method must be called from the market manager thread.
+*/
+template <class TTraits>
+class OrderBookSnapshotsT : public MarketHandlerT<TTraits>
+{
+public:
+    //! Price type
+    typedef typename TTraits::PriceType PriceType;
+    //! Quantity type
+    typedef typename TTraits::QuantityType QuantityType;
+    //! Order type
+    typedef typename TTraits::Order Order;
+    //! Price level type
+    typedef typename TTraits::Level Level;
+    //! Order book type
+    typedef OrderBookT<TTraits> OrderBook;
+    //! Market handler type
+    typedef MarketHandlerT<TTraits> MarketHandler;
+    //! Order book snapshot type
+    typedef OrderBookSnapshotT<TTraits> OrderBookSnapshot;
+
+    //! Order book snapshots reader
+    /*!
+        Reader registers the reader slot of the epoch manager and must be
+        used by a single reader thread.
+
+        Not thread-safe.
+    */
+    class Reader
+    {
+    public:
+        explicit Reader(OrderBookSnapshotsT& snapshots);
+        Reader(const Reader&) = delete;
+        Reader(Reader&&) = delete;
+        ~Reader();
+
+        Reader& operator=(const Reader&) = delete;
+        Reader& operator=(Reader&&) = delete;
+
+        //! Enter the read-side critical section
+        void Lock() noexcept;
+        //! Leave the read-side critical section
+        void Unlock() noexcept;
+
+        //! Get the last published order book snapshot
+        /*!
+            Must be called in the read-side critical section.
+
+            \param id - Symbol Id of the order book
+            \return Pointer to the order book snapshot or nullptr
+        */
+        const OrderBookSnapshot* GetOrderBook(uint32_t id) const noexcept;
+
+    private:
+        OrderBookSnapshotsT& _snapshots;
+        size_t _slot;
+    };
+
+    //! Initialize order book snapshots with the given market handler
+    /*!
+        \param market_handler - Market handler to forward market events
+        \param capacity - Maximal symbol Id of published order books plus one (default is 65536)
+        \param readers - Maximal count of reader threads (default is 64)
+    */
+    explicit OrderBookSnapshotsT(MarketHandler& market_handler, size_t capacity = 65536, size_t readers = 64);
+    OrderBookSnapshotsT(const OrderBookSnapshotsT&) = delete;
+    OrderBookSnapshotsT(OrderBookSnapshotsT&&) = delete;
+    ~OrderBookSnapshotsT();
+
+    OrderBookSnapshotsT& operator=(const OrderBookSnapshotsT&) = delete;
+    OrderBookSnapshotsT& operator=(OrderBookSnapshotsT&&) = delete;
+
+    //! Get the count of retired snapshots which are not reclaimed yet
+    size_t retired() const noexcept { return _retired.size(); }
+
+    //! Publish snapshots of all order books modified since the previous publication
+    void Publish();
+
+protected:
+    MarketEvents RequiredEvents() const noexcept override { return MarketEvents::ALL; }
+
+    void onAddSymbol(const Symbol& symbol) override { MarketHandler::ForwardAddSymbol(_market_handler, symbol); }
+    void onDeleteSymbol(const Symbol& symbol) override { MarketHandler::ForwardDeleteSymbol(_market_handler, symbol); }
+    void onAddOrderBook(const OrderBook& order_book) override;
+    void onUpdateOrderBook(const OrderBook& order_book, bool top) override { MarketHandler::ForwardUpdateOrderBook(_market_handler, order_book, top); }
+    void onDeleteOrderBook(const OrderBook& order_book) override;
+    void onAddLevel(const OrderBook& order_book, const Level& level, bool top) override;
+    void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) override;
+    void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) override;
+    void onAddOrder(const Order& order) override;
+    void onUpdateOrder(const Order& order) override;
+    void onDeleteOrder(const Order& order) override;
+    void onExecuteOrder(const Order& order, PriceType price, QuantityType quantity) override;
+
+private:
+    // Price levels and orders shared with published snapshots
+    typedef typename OrderBookSnapshot::Group Group;
+    typedef typename OrderBookSnapshot::GroupPtr GroupPtr;
+    typedef typename OrderBookSnapshot::Groups Groups;
+    typedef typename OrderBookSnapshot::Orders Orders;
+
+    // Order book copy maintained from market events
+    struct Book
+    {
+        Symbol BookSymbol;
+        uint64_t Sequence;
+        bool Dirty;
+        Groups Bids;
+        Groups Asks;
+        Orders StopOrders;
+
+        explicit Book(const Symbol& symbol)
+            : BookSymbol(symbol), Sequence(0), Dirty(false),
+              Bids(std::make_shared<std::vector<GroupPtr>>()),
+              Asks(std::make_shared<std::vector<GroupPtr>>()),
+              StopOrders(std::make_shared<std::vector<Order>>())
+        {}
+    };
+
+    // Order location in the order book copy
+    struct Location
+    {
+        uint32_t SymbolId;
+        uint64_t Id;
+        OrderSide Side;
+        bool Stop;
+        // Limit price of limit orders or stop price of stop orders
+        PriceType Price;
+    };
+
+    // Retired snapshot
+    struct Retired
+    {
+        uint64_t Epoch;
+        OrderBookSnapshot* Snapshot;
+    };
+
+    MarketHandler& _market_handler;
+    EpochManager _epochs;
+
+    // Order book copies
+    std::vector<std::unique_ptr<Book>> _books;
+    std::vector<uint32_t> _dirty;
+    CppCommon::HashMap<uint64_t, Location, FastHash> _orders;
+
+    // Id of the executed order which update is not received yet
+    uint64_t _executed;
+
+    // Published snapshots
+    size_t _capacity;
+    std::unique_ptr<std::atomic<OrderBookSnapshot*>[]> _snapshots;
+    std::vector<Retired> _retired;
+
+    // Order book copies management
+    Book* GetBook(uint32_t id) const noexcept;
+    void MarkDirty(Book& book);
+    void UpdateLevel(const OrderBook& order_book, const Level& level, bool erase);
+
+    // Order book copy orders management
+    static bool IsVisible(const Order& order) noexcept { return order.IsLimit() || !order.IsMarket(); }
+    static Location GetLocation(const Order& order) noexcept;
+    static bool IsStopLess(const Location& location1, const Location& location2) noexcept;
+    static bool IsRequeued(const Order& previous, const Order& order, bool executed) noexcept;
+    template <typename T>
+    static T& Modify(std::shared_ptr<T>& shared);
+    static typename std::vector<GroupPtr>::iterator FindGroup(std::vector<GroupPtr>& groups, bool bid, PriceType price);
+    void InsertOrder(Book& book, const Order& order);
+    void EraseOrder(Book& book, const Location& location);
+    Order* FindOrder(Book& book, const Location& location);
+
+    // Snapshots management
+    OrderBookSnapshot* CreateSnapshot(Book& book) const;
+    void Replace(uint32_t id, OrderBookSnapshot* snapshot);
+    void Reclaim();
+};
+
+//! Order book snapshots with the default market traits
+typedef OrderBookSnapshotsT<MarketTraits<>> OrderBookSnapshots;
+
+} // namespace Matching
+} // namespace CppTrader
+
+#include "order_book_snapshot.inl"
+
+#endif // CPPTRADER_MATCHING_ORDER_BOOK_SNAPSHOT_H
@@ -0,0 +1,467 @@
+/*!
+    \file order_book_snapshot.inl
+    \brief Order book snapshot inline implementation
+    \author Ivan Shynkarenka
+    \date 28.08.2017
+    \copyright MIT License
+*/
+
+namespace CppTrader {
+namespace Matching {
+
+template <class TTraits>
+inline OrderBookSnapshotsT<TTraits>::Reader::Reader(OrderBookSnapshotsT& snapshots)
+    : _snapshots(snapshots),
+      _slot(snapshots._epochs.Register())
+{
+}
+
+template <class TTraits>
+inline OrderBookSnapshotsT<TTraits>::Reader::~Reader()
+{
+    _snapshots._epochs.Unregister(_slot);
+}
+
+template <class TTraits>
+inline void OrderBookSnapshotsT<TTraits>::Reader::Lock() noexcept
+{
+    _snapshots._epochs.Enter(_slot);
+}
+
+template <class TTraits>
+inline void OrderBookSnapshotsT<TTraits>::Reader::Unlock() noexcept
+{
+    _snapshots._epochs.Leave(_slot);
+}
+
+template <class TTraits>
+inline const typename OrderBookSnapshotsT<TTraits>::OrderBookSnapshot* OrderBookSnapshotsT<TTraits>::Reader::GetOrderBook(uint32_t id) const noexcept
+{
+    return (id < _snapshots._capacity) ? _snapshots._snapshots[id].load(std::memory_order_seq_cst) : nullptr;
+}
+
+template <class TTraits>
+OrderBookSnapshotsT<TTraits>::OrderBookSnapshotsT(MarketHandler& market_handler, size_t capacity, size_t readers)
+    : _market_handler(market_handler),
+      _epochs(readers),
+      _orders(16384, 0),
+      _executed(0),
+      _capacity(capacity),
+      _snapshots(new std::atomic<OrderBookSnapshot*>[capacity])
+{
+    for (size_t i = 0; i < _capacity; ++i)
+        _snapshots[i].store(nullptr, std::memory_order_relaxed);
+}
+
+template <class TTraits>
+OrderBookSnapshotsT<TTraits>::~OrderBookSnapshotsT()
+{
+    // Release published and retired snapshots
+    for (size_t i = 0; i < _capacity; ++i)
+        delete _snapshots[i].load(std::memory_order_relaxed);
+    for (auto& retired : _retired)
+        delete retired.Snapshot;
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::Publish()
+{
+    for (auto id : _dirty)
+    {
+        // Skip deleted and already published order books
+        Book* book_ptr = GetBook(id);
+        if ((book_ptr == nullptr) || !book_ptr->Dirty)
+            continue;
+
+        Replace(id, CreateSnapshot(*book_ptr));
+    }
+    _dirty.clear();
+
+    // Reclaim snapshots which are not reachable by readers
+    Reclaim();
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::onAddOrderBook(const OrderBook& order_book)
+{
+    uint32_t id = order_book.symbol().Id;
+    if (_books.size() <= id)
+        _books.resize(id + 1);
+    _books[id].reset(new Book(order_book.symbol()));
+
+    // Publish the empty order book
+    MarkDirty(*_books[id]);
+
+    MarketHandler::ForwardAddOrderBook(_market_handler, order_book);
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::onDeleteOrderBook(const OrderBook& order_book)
+{
+    uint32_t id = order_book.symbol().Id;
+    Book* book_ptr = GetBook(id);
+    if (book_ptr != nullptr)
+    {
+        // Forget orders of the deleted order book
+        for (const auto* groups : { book_ptr->Bids.get(), book_ptr->Asks.get() })
+            for (const auto& group : *groups)
+                for (const auto& order : group->LevelOrders)
+                    _orders.erase(order.Id);
+        for (const auto& order : *book_ptr->StopOrders)
+            _orders.erase(order.Id);
+        _books[id].reset();
+
+        // Retire the last published snapshot
+        Replace(id, nullptr);
+    }
+
+    MarketHandler::ForwardDeleteOrderBook(_market_handler, order_book);
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::onAddLevel(const OrderBook& order_book, const Level& level, bool top)
+{
+    UpdateLevel(order_book, level, false);
+    MarketHandler::ForwardAddLevel(_market_handler, order_book, level, top);
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::onUpdateLevel(const OrderBook& order_book, const Level& level, bool top)
+{
+    UpdateLevel(order_book, level, false);
+    MarketHandler::ForwardUpdateLevel(_market_handler, order_book, level, top);
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::onDeleteLevel(const OrderBook& order_book, const Level& level, bool top)
+{
+    UpdateLevel(order_book, level, true);
+    MarketHandler::ForwardDeleteLevel(_market_handler, order_book, level, top);
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::onAddOrder(const Order& order)
+{
+    Book* book_ptr = GetBook(order.SymbolId);
+    if ((book_ptr != nullptr) && IsVisible(order) && (_orders.find(order.Id) == _orders.end()))
+    {
+        _orders.insert(std::make_pair(order.Id, GetLocation(order)));
+        InsertOrder(*book_ptr, order);
+        MarkDirty(*book_ptr);
+    }
+
+    MarketHandler::ForwardAddOrder(_market_handler, order);
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::onUpdateOrder(const Order& order)
+{
+    auto it = _orders.find(order.Id);
+    if (it != _orders.end())
+    {
+        Book* book_ptr = GetBook(it->second.SymbolId);
+        Location location = GetLocation(order);
+        if (IsVisible(order) && (location.Stop == it->second.Stop) && (location.Side == it->second.Side) && (location.Price == it->second.Price))
+        {
+            Order* order_ptr = FindOrder(*book_ptr, location);
+            if ((order_ptr != nullptr) && !location.Stop && IsRequeued(*order_ptr, order, (_executed == order.Id)))
+            {
+                // Move the modified order to the end of its price level
+                EraseOrder(*book_ptr, location);
+                InsertOrder(*book_ptr, order);
+            }
+            else if (order_ptr != nullptr)
+            {
+                // Update the order in place
+                *order_ptr = order;
+            }
+        }
+        else
+        {
+            // Move the order into its new place
+            EraseOrder(*book_ptr, it->second);
+            if (IsVisible(order))
+            {
+                InsertOrder(*book_ptr, order);
+                it->second = location;
+            }
+            else
+                _orders.erase(it);
+        }
+        MarkDirty(*book_ptr);
+    }
+
+    // The update of the executed order is received
+    _executed = 0;
+
+    MarketHandler::ForwardUpdateOrder(_market_handler, order);
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::onDeleteOrder(const Order& order)
+{
+    auto it = _orders.find(order.Id);
+    if (it != _orders.end())
+    {
+        Book* book_ptr = GetBook(it->second.SymbolId);
+        EraseOrder(*book_ptr, it->second);
+        _orders.erase(it);
+        MarkDirty(*book_ptr);
+    }
+
+    MarketHandler::ForwardDeleteOrder(_market_handler, order);
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::onExecuteOrder(const Order& order, PriceType price, QuantityType quantity)
+{
+    // Executions of new orders are not followed by order updates
+    auto it = _orders.find(order.Id);
+    if (it != _orders.end())
+    {
+        Book* book_ptr = GetBook(it->second.SymbolId);
+        Order* order_ptr = FindOrder(*book_ptr, it->second);
+        if (order_ptr != nullptr)
+        {
+            QuantityType executed = std::min(quantity, order_ptr->LeavesQuantity);
+            order_ptr->ExecutedQuantity += executed;
+            order_ptr->LeavesQuantity -= executed;
+        }
+        MarkDirty(*book_ptr);
+
+        // Executed order in the order book is followed by its update
+        _executed = order.Id;
+    }
+
+    MarketHandler::ForwardExecuteOrder(_market_handler, order, price, quantity);
+}
+
+template <class TTraits>
+inline typename OrderBookSnapshotsT<TTraits>::Book* OrderBookSnapshotsT<TTraits>::GetBook(uint32_t id) const noexcept
+{
+    return (id < _books.size()) ? _books[id].get() : nullptr;
+}
+
+template <class TTraits>
+inline void OrderBookSnapshotsT<TTraits>::MarkDirty(Book& book)
+{
+    if (!book.Dirty)
+    {
+        book.Dirty = true;
+        _dirty.push_back(book.BookSymbol.Id);
+    }
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::UpdateLevel(const OrderBook& order_book, const Level& level, bool erase)
+{
+    // Order updates of the price level are already received
+    _executed = 0;
+
+    Book* book_ptr = GetBook(order_book.symbol().Id);
+    if (book_ptr == nullptr)
+        return;
+
+    std::vector<GroupPtr>& groups = Modify(level.IsBid() ? book_ptr->Bids : book_ptr->Asks);
+    auto it = FindGroup(groups, level.IsBid(), level.Price);
+    bool found = (it != groups.end()) && ((*it)->PriceLevel.Price == level.Price);
+    if (erase)
+    {
+        // Keep the deleted price level until its last order is deleted
+        if (found && (*it)->LevelOrders.empty())
+            groups.erase(it);
+        else if (found)
+            Modify(*it).PriceLevel = Level(level.Type, level.Price);
+    }
+    else if (found)
+        Modify(*it).PriceLevel = level;
+    else
+        groups.insert(it, std::make_shared<Group>(Group{ level, std::vector<Order>() }));
+
+    MarkDirty(*book_ptr);
+}
+
+template <class TTraits>
+inline typename OrderBookSnapshotsT<TTraits>::Location OrderBookSnapshotsT<TTraits>::GetLocation(const Order& order) noexcept
+{
+    return order.IsLimit() ? Location{ order.SymbolId, order.Id, order.Side, false, order.Price } : Location{ order.SymbolId, order.Id, order.Side, true, order.StopPrice };
+}
+
+template <class TTraits>
+inline bool OrderBookSnapshotsT<TTraits>::IsStopLess(const Location& location1, const Location& location2) noexcept
+{
+    // Stop orders are sorted by side, stop price and Id
+    if (location1.Side != location2.Side)
+        return (location1.Side == OrderSide::BUY);
+    if (location1.Price != location2.Price)
+        return (location1.Side == OrderSide::BUY) ? (location1.Price < location2.Price) : (location1.Price > location2.Price);
+    return location1.Id < location2.Id;
+}
+
+template <class TTraits>
+inline bool OrderBookSnapshotsT<TTraits>::IsRequeued(const Order& previous, const Order& order, bool executed) noexcept
+{
+    // Reduced order keeps its quantity and the update of the executed order
+    // repeats the already applied execution. Modified order gets the new
+    // quantity and the new leaves quantity and loses its time priority.
+    if (order.Quantity != previous.Quantity)
+        return true;
+    if (order.LeavesQuantity != previous.LeavesQuantity)
+        return (order.LeavesQuantity > previous.LeavesQuantity);
+    return !executed;
+}
+
+template <class TTraits>
+template <typename T>
+inline T& OrderBookSnapshotsT<TTraits>::Modify(std::shared_ptr<T>& shared)
+{
+    // Copy price levels and orders shared with published snapshots before the modification
+    if (shared.use_count() > 1)
+        shared = std::make_shared<T>(*shared);
+    return *shared;
+}
+
+template <class TTraits>
+inline typename std::vector<typename OrderBookSnapshotsT<TTraits>::GroupPtr>::iterator OrderBookSnapshotsT<TTraits>::FindGroup(std::vector<GroupPtr>& groups, bool bid, PriceType price)
+{
+    // Price levels are sorted from the best one
+    return bid
+        ? std::lower_bound(groups.begin(), groups.end(), price, [](const GroupPtr& group, PriceType p) { return group->PriceLevel.Price > p; })
+        : std::lower_bound(groups.begin(), groups.end(), price, [](const GroupPtr& group, PriceType p) { return group->PriceLevel.Price < p; });
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::InsertOrder(Book& book, const Order& order)
+{
+    Location location = GetLocation(order);
+    if (location.Stop)
+    {
+        std::vector<Order>& orders = Modify(book.StopOrders);
+        orders.insert(std::lower_bound(orders.begin(), orders.end(), location, [](const Order& o, const Location& l) { return IsStopLess(GetLocation(o), l); }), order);
+        return;
+    }
+
+    // Create a new price level for the first order. Its volume is received with the price level update.
+    bool bid = (location.Side == OrderSide::BUY);
+    std::vector<GroupPtr>& groups = Modify(bid ? book.Bids : book.Asks);
+    auto it = FindGroup(groups, bid, location.Price);
+    if ((it == groups.end()) || ((*it)->PriceLevel.Price != location.Price))
+        it = groups.insert(it, std::make_shared<Group>(Group{ Level(bid ? LevelType::BID : LevelType::ASK, location.Price), std::vector<Order>() }));
+
+    // Orders of the price level are kept in their time priority
+    Modify(*it).LevelOrders.push_back(order);
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::EraseOrder(Book& book, const Location& location)
+{
+    if (location.Stop)
+    {
+        std::vector<Order>& orders = Modify(book.StopOrders);
+        auto it = std::lower_bound(orders.begin(), orders.end(), location, [](const Order& o, const Location& l) { return IsStopLess(GetLocation(o), l); });
+        if ((it != orders.end()) && (it->Id == location.Id))
+            orders.erase(it);
+        return;
+    }
+
+    bool bid = (location.Side == OrderSide::BUY);
+    std::vector<GroupPtr>& groups = Modify(bid ? book.Bids : book.Asks);
+    auto group = FindGroup(groups, bid, location.Price);
+    if ((group == groups.end()) || ((*group)->PriceLevel.Price != location.Price))
+        return;
+
+    // Delete the last order of the deleted price level with the price level
+    const std::vector<Order>& orders = (*group)->LevelOrders;
+    if ((orders.size() == 1) && (orders.front().Id == location.Id) && ((*group)->PriceLevel.TotalVolume == 0))
+    {
+        groups.erase(group);
+        return;
+    }
+
+    // Erase the order in place keeping the time priority of other orders
+    auto it = std::find_if(orders.begin(), orders.end(), [&location](const Order& o) { return o.Id == location.Id; });
+    if (it != orders.end())
+    {
+        size_t index = it - orders.begin();
+        std::vector<Order>& modified = Modify(*group).LevelOrders;
+        modified.erase(modified.begin() + index);
+    }
+}
+
+template <class TTraits>
+typename OrderBookSnapshotsT<TTraits>::Order* OrderBookSnapshotsT<TTraits>::FindOrder(Book& book, const Location& location)
+{
+    if (location.Stop)
+    {
+        const std::vector<Order>& orders = *book.StopOrders;
+        auto it = std::lower_bound(orders.begin(), orders.end(), location, [](const Order& o, const Location& l) { return IsStopLess(GetLocation(o), l); });
+        if ((it == orders.end()) || (it->Id != location.Id))
+            return nullptr;
+        size_t index = it - orders.begin();
+        return &Modify(book.StopOrders)[index];
+    }
+
+    bool bid = (location.Side == OrderSide::BUY);
+    std::vector<GroupPtr>& groups = Modify(bid ? book.Bids : book.Asks);
+    auto group = FindGroup(groups, bid, location.Price);
+    if ((group == groups.end()) || ((*group)->PriceLevel.Price != location.Price))
+        return nullptr;
+
+    const std::vector<Order>& orders = (*group)->LevelOrders;
+    auto it = std::find_if(orders.begin(), orders.end(), [&location](const Order& o) { return o.Id == location.Id; });
+    if (it == orders.end())
+        return nullptr;
+    size_t index = it - orders.begin();
+    return &Modify(*group).LevelOrders[index];
+}
+
+template <class TTraits>
+typename OrderBookSnapshotsT<TTraits>::OrderBookSnapshot* OrderBookSnapshotsT<TTraits>::CreateSnapshot(Book& book) const
+{
+    // Share price levels, their orders and stop orders with the snapshot.
+    // They will be copied on the next modification.
+    OrderBookSnapshot* snapshot_ptr = new OrderBookSnapshot(book.BookSymbol, ++book.Sequence);
+    snapshot_ptr->_bids = book.Bids;
+    snapshot_ptr->_asks = book.Asks;
+    snapshot_ptr->_stop_orders = book.StopOrders;
+
+    book.Dirty = false;
+    return snapshot_ptr;
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::Replace(uint32_t id, OrderBookSnapshot* snapshot_ptr)
+{
+    assert((id < _capacity) && "Symbol Id is out of the order book snapshots capacity!");
+    if (id >= _capacity)
+    {
+        delete snapshot_ptr;
+        return;
+    }
+
+    // Unlink the previous snapshot and retire it with the current epoch
+    OrderBookSnapshot* previous_ptr = _snapshots[id].exchange(snapshot_ptr, std::memory_order_seq_cst);
+    if (previous_ptr != nullptr)
+        _retired.push_back(Retired{ _epochs.Advance(), previous_ptr });
+}
+
+template <class TTraits>
+void OrderBookSnapshotsT<TTraits>::Reclaim()
+{
+    if (_retired.empty())
+        return;
+
+    uint64_t safe = _epochs.GetSafeEpoch();
+
+    // Retired snapshots are ordered by their retire epochs
+    size_t count = 0;
+    while ((count < _retired.size()) && (_retired[count].Epoch < safe))
+        delete _retired[count++].Snapshot;
+    _retired.erase(_retired.begin(), _retired.begin() + count);
+}
+
+// Order book snapshots with the default market traits are instantiated in the library
+extern template class OrderBookSnapshotsT<MarketTraits<>>;
+
+} // namespace Matching
+} // namespace CppTrader
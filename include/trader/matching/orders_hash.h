@@ -0,0 +1,42 @@
+/*!
+    \file orders_hash.h
+    \brief Orders hash map container definition
+    \author Ivan Shynkarenka
+    \date 20.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_ORDERS_HASH_H
+#define CPPTRADER_MATCHING_ORDERS_HASH_H
+
+#include "fast_hash.h"
+
+#include "containers/hashmap.h"
+
+namespace CppTrader {
+namespace Matching {
+
+//! Orders hash map container
+/*!
+    Orders hash map container maps order Ids to order nodes with the open
+    addressing hash map. It works well with any order Ids distribution.
+
+    Not thread-safe.
+*/
+template <class TOrderNode>
+class OrdersHash : public CppCommon::HashMap<uint64_t, TOrderNode*, FastHash>
+{
+public:
+    OrdersHash() : CppCommon::HashMap<uint64_t, TOrderNode*, FastHash>(16384, 0) {}
+    OrdersHash(const OrdersHash&) = default;
+    OrdersHash(OrdersHash&&) = default;
+    ~OrdersHash() = default;
+
+    OrdersHash& operator=(const OrdersHash&) = default;
+    OrdersHash& operator=(OrdersHash&&) = default;
+};
+
+} // namespace Matching
+} // namespace CppTrader
+
+#endif // CPPTRADER_MATCHING_ORDERS_HASH_H
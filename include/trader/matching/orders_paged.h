@@ -0,0 +1,221 @@
+/*!
+    \file orders_paged.h
+    \brief Orders paged direct array container definition
+    \author Ivan Shynkarenka
+    \date 20.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_ORDERS_PAGED_H
+#define CPPTRADER_MATCHING_ORDERS_PAGED_H
+
+#include "fast_hash.h"
+
+#include "containers/hashmap.h"
+
+#include <cassert>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CppTrader {
+namespace Matching {
+
+template <class TContainer, typename T>
+class OrdersPagedIterator;
+
+//! Orders paged direct array container
+/*!
+    Orders paged direct array container maps order Ids to order nodes with the
+    two-level direct array: the directory of pages indexed by the high bits of
+    the order Id and pages of order node pointers indexed by its low bits. So
+    the order lookup costs two dependent memory loads without any hashing and
+    probing. Pages are allocated on the first order in the page and released
+    when the last order of the page is erased, so the memory is proportional
+    to the range of active order Ids instead of the maximal order Id.
+
+    The directory covers the window of occupied pages which is anchored by the
+    first paged order Id. The window grows only by a few pages at once and is
+    limited by the directory size, so order Ids far outside of the window fall
+    back to the hash map. This keeps the memory bounded for sparse order Ids
+    (e.g. random 32-bit exchange order Ids) which would otherwise allocate a
+    whole page for each order. The window is reset when its last page is
+    released.
+
+    This container is a good choice for exchange feeds with near-dense and
+    monotonically increasing order Ids (e.g. NASDAQ ITCH order reference
+    numbers).
+
+    Not thread-safe.
+*/
+template <class TOrderNode, size_t TPageBits = 12, size_t TDirectoryBits = 20>
+class BasicOrdersPaged
+{
+    friend class OrdersPagedIterator<BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>, std::pair<uint64_t, TOrderNode*>>;
+    friend class OrdersPagedIterator<const BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>, const std::pair<uint64_t, TOrderNode*>>;
+
+    static_assert((TPageBits > 0) && ((TPageBits + TDirectoryBits) < 64), "Invalid paged direct array bits!");
+
+public:
+    //! Fallback orders hash map
+    typedef CppCommon::HashMap<uint64_t, TOrderNode*, FastHash> Hash;
+
+    // Standard container type definitions
+    typedef uint64_t key_type;
+    typedef TOrderNode* mapped_type;
+    typedef std::pair<uint64_t, TOrderNode*> value_type;
+    typedef OrdersPagedIterator<BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>, value_type> iterator;
+    typedef OrdersPagedIterator<const BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>, const value_type> const_iterator;
+
+    BasicOrdersPaged() : _count(0), _pages(0), _base(0), _hash(1024, 0) {}
+    BasicOrdersPaged(const BasicOrdersPaged&) = delete;
+    BasicOrdersPaged(BasicOrdersPaged&&) = delete;
+    ~BasicOrdersPaged() { clear(); }
+
+    BasicOrdersPaged& operator=(const BasicOrdersPaged&) = delete;
+    BasicOrdersPaged& operator=(BasicOrdersPaged&&) = delete;
+
+    //! Check if the container is not empty
+    explicit operator bool() const noexcept { return !empty(); }
+
+    //! Is the container empty?
+    bool empty() const noexcept { return size() == 0; }
+
+    //! Get the container size
+    size_t size() const noexcept { return _count + _hash.size(); }
+
+    //! Get the count of allocated pages
+    size_t pages() const noexcept { return _pages; }
+    //! Get the fallback orders hash map
+    const Hash& fallback() const noexcept { return _hash; }
+
+    //! Get the begin container iterator
+    iterator begin() noexcept { return iterator(this, 0); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    //! Get the end container iterator
+    iterator end() noexcept { return iterator(this, _hash.end()); }
+    const_iterator end() const noexcept { return const_iterator(this, _hash.end()); }
+
+    //! Find the order with the given Id
+    /*!
+        \param id - Order Id
+        \return Iterator to the found order or end iterator
+    */
+    iterator find(uint64_t id) noexcept;
+    const_iterator find(uint64_t id) const noexcept;
+
+    //! Insert a new order into the container
+    /*!
+        \param item - Order Id and order node pair
+        \return Iterator to the inserted or existing order and the insert result flag
+    */
+    std::pair<iterator, bool> insert(const value_type& item);
+
+    //! Erase the order from the container
+    /*!
+        \param it - Iterator to the erased order
+    */
+    void erase(const iterator& it) noexcept;
+
+    //! Clear the container
+    void clear() noexcept;
+
+private:
+    // Page size & directory limits
+    static const size_t PAGE_SIZE = (size_t)1 << TPageBits;
+    static const size_t DIRECTORY_SIZE = (size_t)1 << TDirectoryBits;
+    // Count of pages the directory window may grow by at once
+    static const size_t WINDOW_GROWTH = 4;
+
+    // Page of order node pointers
+    struct Page
+    {
+        size_t count;
+        TOrderNode* slots[PAGE_SIZE];
+    };
+
+    size_t _count;
+    size_t _pages;
+    size_t _base;
+    std::vector<Page*> _directory;
+    Hash _hash;
+
+    // Is the given order Id dense enough to be placed into the direct array?
+    bool IsPaged(uint64_t id) const noexcept;
+    // Get the order node with the given direct array index or nullptr
+    TOrderNode* Get(size_t index) const noexcept;
+    // Get the direct array index of the next order starting from the given one
+    size_t Next(size_t index) const noexcept;
+};
+
+//! Orders paged direct array container with the default page and directory sizes
+template <class TOrderNode>
+using OrdersPaged = BasicOrdersPaged<TOrderNode>;
+
+//! Orders paged direct array container iterator
+/*!
+    Forward iterator over orders in the direct array followed by orders in the fallback hash map.
+
+    Not thread-safe.
+*/
+template <class TContainer, typename T>
+class OrdersPagedIterator
+{
+    friend TContainer;
+
+    typedef typename std::conditional<std::is_const<TContainer>::value, typename TContainer::Hash::const_iterator, typename TContainer::Hash::iterator>::type HashIterator;
+
+public:
+    // Standard iterator type definitions
+    typedef T value_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef std::forward_iterator_tag iterator_category;
+
+    OrdersPagedIterator() noexcept : _container(nullptr), _index(0), _value(0, nullptr) {}
+    explicit OrdersPagedIterator(TContainer* container, size_t index) noexcept;
+    explicit OrdersPagedIterator(TContainer* container, HashIterator it) noexcept;
+    OrdersPagedIterator(const OrdersPagedIterator& it) noexcept = default;
+    OrdersPagedIterator(OrdersPagedIterator&& it) noexcept = default;
+    ~OrdersPagedIterator() noexcept = default;
+
+    OrdersPagedIterator& operator=(const OrdersPagedIterator& it) noexcept = default;
+    OrdersPagedIterator& operator=(OrdersPagedIterator&& it) noexcept = default;
+
+    friend bool operator==(const OrdersPagedIterator& it1, const OrdersPagedIterator& it2) noexcept
+    { return (it1._container == it2._container) && (it1._index == it2._index) && ((it1._index != NPOS) || (it1._hash == it2._hash)); }
+    friend bool operator!=(const OrdersPagedIterator& it1, const OrdersPagedIterator& it2) noexcept
+    { return !(it1 == it2); }
+
+    OrdersPagedIterator& operator++() noexcept;
+    OrdersPagedIterator operator++(int) noexcept { OrdersPagedIterator result(*this); operator++(); return result; }
+
+    reference operator*() noexcept { return _value; }
+    pointer operator->() noexcept { return &_value; }
+
+private:
+    // Invalid direct array index of iterators over the fallback hash map
+    static const size_t NPOS = (size_t)-1;
+
+    TContainer* _container;
+    size_t _index;
+    HashIterator _hash;
+    typename TContainer::value_type _value;
+
+    // Move to the first order starting from the given direct array index
+    void Seek(size_t index) noexcept;
+    // Update the current value from the fallback hash map
+    void Update() noexcept;
+};
+
+} // namespace Matching
+} // namespace CppTrader
+
+#include "orders_paged.inl"
+
+#endif // CPPTRADER_MATCHING_ORDERS_PAGED_H
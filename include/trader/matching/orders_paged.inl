@@ -0,0 +1,218 @@
+/*!
+    \file orders_paged.inl
+    \brief Orders paged direct array container inline implementation
+    \author Ivan Shynkarenka
+    \date 20.08.2017
+    \copyright MIT License
+*/
+
+namespace CppTrader {
+namespace Matching {
+
+template <class TOrderNode, size_t TPageBits, size_t TDirectoryBits>
+inline bool BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>::IsPaged(uint64_t id) const noexcept
+{
+    if ((uint64_t)(size_t)id != id)
+        return false;
+
+    // The first paged order Id anchors the directory window
+    size_t page = (size_t)id >> TPageBits;
+    if (_directory.empty())
+        return true;
+
+    // Order Id should be close to the directory window, which should not exceed the directory size
+    size_t first = (page < _base) ? page : _base;
+    size_t last = (page >= (_base + _directory.size())) ? page : (_base + _directory.size() - 1);
+    return ((page + WINDOW_GROWTH) >= _base) && (page < (_base + _directory.size() + WINDOW_GROWTH)) && ((last - first) < DIRECTORY_SIZE);
+}
+
+template <class TOrderNode, size_t TPageBits, size_t TDirectoryBits>
+inline TOrderNode* BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>::Get(size_t index) const noexcept
+{
+    size_t page = index >> TPageBits;
+    if ((page < _base) || ((page - _base) >= _directory.size()) || (_directory[page - _base] == nullptr))
+        return nullptr;
+    return _directory[page - _base]->slots[index & (PAGE_SIZE - 1)];
+}
+
+template <class TOrderNode, size_t TPageBits, size_t TDirectoryBits>
+inline size_t BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>::Next(size_t index) const noexcept
+{
+    // Start from the first page of the directory window
+    if ((index >> TPageBits) < _base)
+        index = _base << TPageBits;
+
+    for (size_t page = (index >> TPageBits) - _base; page < _directory.size(); ++page)
+    {
+        Page* page_ptr = _directory[page];
+        if (page_ptr != nullptr)
+        {
+            for (size_t slot = ((page == ((index >> TPageBits) - _base)) ? (index & (PAGE_SIZE - 1)) : 0); slot < PAGE_SIZE; ++slot)
+                if (page_ptr->slots[slot] != nullptr)
+                    return ((_base + page) << TPageBits) | slot;
+        }
+    }
+    return (size_t)-1;
+}
+
+template <class TOrderNode, size_t TPageBits, size_t TDirectoryBits>
+inline typename BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>::iterator BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>::find(uint64_t id) noexcept
+{
+    // The directory window moves, so order Ids inside it might be placed into the hash map before
+    if (((uint64_t)(size_t)id == id) && (Get((size_t)id) != nullptr))
+        return iterator(this, (size_t)id);
+    else
+        return _hash.empty() ? end() : iterator(this, _hash.find(id));
+}
+
+template <class TOrderNode, size_t TPageBits, size_t TDirectoryBits>
+inline typename BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>::const_iterator BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>::find(uint64_t id) const noexcept
+{
+    // The directory window moves, so order Ids inside it might be placed into the hash map before
+    if (((uint64_t)(size_t)id == id) && (Get((size_t)id) != nullptr))
+        return const_iterator(this, (size_t)id);
+    else
+        return _hash.empty() ? end() : const_iterator(this, _hash.find(id));
+}
+
+template <class TOrderNode, size_t TPageBits, size_t TDirectoryBits>
+inline std::pair<typename BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>::iterator, bool> BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>::insert(const value_type& item)
+{
+    // Sparse order Ids fall back to the hash map
+    if (!IsPaged(item.first))
+    {
+        auto result = _hash.insert(item);
+        return std::make_pair(iterator(this, result.first), result.second);
+    }
+
+    // Order Id might be placed into the hash map before the directory window moved
+    if (!_hash.empty())
+    {
+        auto it = _hash.find(item.first);
+        if (it != _hash.end())
+            return std::make_pair(iterator(this, it), false);
+    }
+
+    size_t index = (size_t)item.first;
+    size_t page = index >> TPageBits;
+
+    // Anchor or grow the directory window
+    if (_directory.empty())
+        _base = page;
+    if (page < _base)
+    {
+        _directory.insert(_directory.begin(), _base - page, nullptr);
+        _base = page;
+    }
+    if ((page - _base) >= _directory.size())
+        _directory.resize(page - _base + 1, nullptr);
+
+    // Allocate a new page
+    Page* page_ptr = _directory[page - _base];
+    if (page_ptr == nullptr)
+    {
+        page_ptr = new Page();
+        _directory[page - _base] = page_ptr;
+        ++_pages;
+    }
+
+    TOrderNode*& slot = page_ptr->slots[index & (PAGE_SIZE - 1)];
+    if (slot != nullptr)
+        return std::make_pair(iterator(this, index), false);
+
+    slot = item.second;
+    ++page_ptr->count;
+    ++_count;
+    return std::make_pair(iterator(this, index), true);
+}
+
+template <class TOrderNode, size_t TPageBits, size_t TDirectoryBits>
+inline void BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>::erase(const iterator& it) noexcept
+{
+    if (it._index == iterator::NPOS)
+    {
+        _hash.erase(it._hash);
+        return;
+    }
+
+    size_t page = (it._index >> TPageBits) - _base;
+    Page* page_ptr = _directory[page];
+    assert((page_ptr != nullptr) && (page_ptr->slots[it._index & (PAGE_SIZE - 1)] != nullptr) && "Order not found!");
+    page_ptr->slots[it._index & (PAGE_SIZE - 1)] = nullptr;
+    --_count;
+
+    // Release the empty page
+    if (--page_ptr->count == 0)
+    {
+        delete page_ptr;
+        _directory[page] = nullptr;
+        --_pages;
+
+        // Reset the directory window with its last page
+        if (_pages == 0)
+            _directory.clear();
+    }
+}
+
+template <class TOrderNode, size_t TPageBits, size_t TDirectoryBits>
+inline void BasicOrdersPaged<TOrderNode, TPageBits, TDirectoryBits>::clear() noexcept
+{
+    for (auto page_ptr : _directory)
+        delete page_ptr;
+    _directory.clear();
+    _count = 0;
+    _pages = 0;
+    _base = 0;
+    _hash.clear();
+}
+
+template <class TContainer, typename T>
+inline OrdersPagedIterator<TContainer, T>::OrdersPagedIterator(TContainer* container, size_t index) noexcept
+    : _container(container), _index(index), _value(0, nullptr)
+{
+    Seek(index);
+}
+
+template <class TContainer, typename T>
+inline OrdersPagedIterator<TContainer, T>::OrdersPagedIterator(TContainer* container, HashIterator it) noexcept
+    : _container(container), _index(NPOS), _hash(it), _value(0, nullptr)
+{
+    Update();
+}
+
+template <class TContainer, typename T>
+inline void OrdersPagedIterator<TContainer, T>::Seek(size_t index) noexcept
+{
+    _index = _container->Next(index);
+    if (_index != NPOS)
+        _value = std::make_pair((uint64_t)_index, _container->Get(_index));
+    else
+    {
+        // Continue with the fallback hash map
+        _hash = _container->_hash.begin();
+        Update();
+    }
+}
+
+template <class TContainer, typename T>
+inline void OrdersPagedIterator<TContainer, T>::Update() noexcept
+{
+    if (_hash != _container->_hash.end())
+        _value = std::make_pair(_hash->first, _hash->second);
+}
+
+template <class TContainer, typename T>
+inline OrdersPagedIterator<TContainer, T>& OrdersPagedIterator<TContainer, T>::operator++() noexcept
+{
+    if (_index != NPOS)
+        Seek(_index + 1);
+    else
+    {
+        ++_hash;
+        Update();
+    }
+    return *this;
+}
+
+} // namespace Matching
+} // namespace CppTrader
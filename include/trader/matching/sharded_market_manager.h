@@ -0,0 +1,297 @@
+/*!
+    \file sharded_market_manager.h
+    \brief Sharded market manager definition
+    \author Ivan Shynkarenka
+    \date 25.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_SHARDED_MARKET_MANAGER_H
+#define CPPTRADER_MATCHING_SHARDED_MARKET_MANAGER_H
+
+#include "market_command.h"
+
+#include "containers/hashmap.h"
+#include "threads/spsc_ring_queue.h"
+#include "threads/thread.h"
+
+#include <atomic>
+#include <bitset>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace CppTrader {
+namespace Matching {
+
+//! Sharded market manager
+/*!
+    Sharded market manager runs several market managers (shards) in separate
+    threads pinned to CPU cores. Order books never interact with each other,
+    so symbols are routed to shards by their Id (symbol Id modulo shards count)
+    and each shard processes its symbols, order books and orders independently.
+
+    Each shard has its own market handler which is called from the shard
+    thread, so every market handler receives an ordered stream of market
+    events of symbols routed to its shard.
+
+    Commands are passed to shards through lock-free SPSC ring queues. Order
+    commands (reduce, modify, delete, execute, etc.) are routed by order Id
+    with the routing table to the shard which owns the order. Shards report
+    deleted orders back through lock-free SPSC ring queues, so the routing
+    table keeps only alive orders.
+
+    All commands are processed asynchronously. Methods return ErrorCode::OK
+    when the command is enqueued, command processing errors are not reported
+    back to the caller. New orders with Id of an alive order routed to another
+    shard are rejected with ErrorCode::ORDER_DUPLICATE. Use Flush() method to
+    wait until all enqueued commands are processed by shards.
+
+    Not thread-safe. All methods must be called from a single producer thread.
+*/
+template <class TTraits>
+class ShardedMarketManagerT
+{
+public:
+    //! Price type
+    typedef typename TTraits::PriceType PriceType;
+    //! Quantity type
+    typedef typename TTraits::QuantityType QuantityType;
+    //! Order type
+    typedef typename TTraits::Order Order;
+    //! Price level type
+    typedef typename TTraits::Level Level;
+    //! Order book type
+    typedef OrderBookT<TTraits> OrderBook;
+    //! Market manager type
+    typedef MarketManagerT<TTraits> MarketManager;
+    //! Market handler type
+    typedef MarketHandlerT<TTraits> MarketHandler;
+    //! Market command type
+    typedef MarketCommandT<TTraits> MarketCommand;
+
+    //! Initialize sharded market manager with the given market handlers
+    /*!
+        Shards count is equal to the count of the given market handlers.
+        Shard threads are pinned to CPU cores in round-robin order.
+
+        \param market_handlers - Market handlers of shards
+        \param capacity - Shard command queue capacity, must be a power of two (default is 65536)
+        \param affinity - Pin shard threads to CPU cores (default is true)
+    */
+    explicit ShardedMarketManagerT(const std::vector<MarketHandler*>& market_handlers, size_t capacity = 65536, bool affinity = true);
+    ShardedMarketManagerT(const ShardedMarketManagerT&) = delete;
+    ShardedMarketManagerT(ShardedMarketManagerT&&) = delete;
+    ~ShardedMarketManagerT();
+
+    ShardedMarketManagerT& operator=(const ShardedMarketManagerT&) = delete;
+    ShardedMarketManagerT& operator=(ShardedMarketManagerT&&) = delete;
+
+    //! Get the shards count
+    size_t shards() const noexcept { return _shards.size(); }
+    //! Get the market manager of the given shard
+    /*!
+        Market manager of the shard is modified from the shard thread,
+        so it must be accessed only when all commands are flushed.
+
+        \param index - Shard index
+        \return Market manager of the shard
+    */
+    const MarketManager& shard(size_t index) const noexcept { return _shards[index]->manager; }
+    //! Get the count of routed orders
+    size_t routes() const noexcept { return _routes.size(); }
+
+    //! Get the shard index for the given symbol Id
+    /*!
+        \param id - Symbol Id
+        \return Shard index
+    */
+    size_t GetShard(uint32_t id) const noexcept { return id % _shards.size(); }
+
+    //! Add a new symbol
+    /*!
+        \param symbol - Symbol to add
+        \return Error code
+    */
+    ErrorCode AddSymbol(const Symbol& symbol);
+    //! Delete the symbol
+    /*!
+        \param id - Symbol Id
+        \return Error code
+    */
+    ErrorCode DeleteSymbol(uint32_t id);
+
+    //! Add a new order book
+    /*!
+        \param symbol - Symbol of the order book to add
+        \return Error code
+    */
+    ErrorCode AddOrderBook(const Symbol& symbol);
+    //! Delete the order book
+    /*!
+        \param id - Symbol Id of the order book
+        \return Error code
+    */
+    ErrorCode DeleteOrderBook(uint32_t id);
+
+    //! Add a new order
+    /*!
+        \param order - Order to add
+        \return Error code
+    */
+    ErrorCode AddOrder(const Order& order);
+    //! Reduce the order by the given quantity
+    /*!
+        \param id - Order Id
+        \param quantity - Order quantity to reduce
+        \return Error code
+    */
+    ErrorCode ReduceOrder(uint64_t id, QuantityType quantity);
+    //! Modify the order
+    /*!
+        \param id - Order Id
+        \param new_price - Order price to modify
+        \param new_quantity - Order quantity to modify
+        \return Error code
+    */
+    ErrorCode ModifyOrder(uint64_t id, PriceType new_price, QuantityType new_quantity);
+    //! Mitigate the order
+    /*!
+        \param id - Order Id
+        \param new_price - Order price to mitigate
+        \param new_quantity - Order quantity to mitigate
+        \return Error code
+    */
+    ErrorCode MitigateOrder(uint64_t id, PriceType new_price, QuantityType new_quantity);
+    //! Replace the order with a similar order but different Id, price and quantity
+    /*!
+        \param id - Order Id
+        \param new_id - Order Id to replace
+        \param new_price - Order price to replace
+        \param new_quantity - Order quantity to replace
+        \return Error code
+    */
+    ErrorCode ReplaceOrder(uint64_t id, uint64_t new_id, PriceType new_price, QuantityType new_quantity);
+    //! Replace the order with a new one
+    /*!
+        New order must have the same symbol as the replaced one.
+
+        \param id - Order Id
+        \param new_order - Order to replace
+        \return Error code
+    */
+    ErrorCode ReplaceOrder(uint64_t id, const Order& new_order);
+    //! Delete the order
+    /*!
+        \param id - Order Id
+        \return Error code
+    */
+    ErrorCode DeleteOrder(uint64_t id);
+
+    //! Execute the order
+    /*!
+        \param id - Order Id
+        \param quantity - Order executed quantity
+        \return Error code
+    */
+    ErrorCode ExecuteOrder(uint64_t id, QuantityType quantity);
+    //! Execute the order
+    /*!
+        \param id - Order Id
+        \param price - Order executed price
+        \param quantity - Order executed quantity
+        \return Error code
+    */
+    ErrorCode ExecuteOrder(uint64_t id, PriceType price, QuantityType quantity);
+
+    //! Enable automatic matching in all shards
+    void EnableMatching();
+    //! Disable automatic matching in all shards
+    void DisableMatching();
+
+    //! Match crossed orders in all order books of all shards
+    void Match();
+
+    //! Wait until all enqueued commands are processed by shards
+    void Flush();
+
+private:
+    // Shard market handler forwards market events to the given market
+    // handler and reports deleted orders back to the routing table
+    class ShardHandler : public MarketHandler
+    {
+    public:
+        ShardHandler(MarketHandler& market_handler, size_t capacity) : _market_handler(market_handler), _retired(capacity) {}
+
+        // Retire the order Id
+        void Retire(uint64_t id);
+        // Retry pending retired order Ids
+        void Retry();
+        // Dequeue the retired order Id
+        bool Dequeue(uint64_t& id) { return _retired.Dequeue(id); }
+
+    protected:
+        void onAddSymbol(const Symbol& symbol) override { MarketHandler::ForwardAddSymbol(_market_handler, symbol); }
+        void onDeleteSymbol(const Symbol& symbol) override { MarketHandler::ForwardDeleteSymbol(_market_handler, symbol); }
+        void onAddOrderBook(const OrderBook& order_book) override { MarketHandler::ForwardAddOrderBook(_market_handler, order_book); }
+        void onUpdateOrderBook(const OrderBook& order_book, bool top) override { MarketHandler::ForwardUpdateOrderBook(_market_handler, order_book, top); }
+        void onDeleteOrderBook(const OrderBook& order_book) override { MarketHandler::ForwardDeleteOrderBook(_market_handler, order_book); }
+        void onAddLevel(const OrderBook& order_book, const Level& level, bool top) override { MarketHandler::ForwardAddLevel(_market_handler, order_book, level, top); }
+        void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) override { MarketHandler::ForwardUpdateLevel(_market_handler, order_book, level, top); }
+        void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) override { MarketHandler::ForwardDeleteLevel(_market_handler, order_book, level, top); }
+        void onAddOrder(const Order& order) override { MarketHandler::ForwardAddOrder(_market_handler, order); }
+        void onUpdateOrder(const Order& order) override { MarketHandler::ForwardUpdateOrder(_market_handler, order); }
+        void onDeleteOrder(const Order& order) override { MarketHandler::ForwardDeleteOrder(_market_handler, order); Retire(order.Id); }
+        void onExecuteOrder(const Order& order, PriceType price, QuantityType quantity) override { MarketHandler::ForwardExecuteOrder(_market_handler, order, price, quantity); }
+
+    private:
+        MarketHandler& _market_handler;
+        CppCommon::SPSCRingQueue<uint64_t> _retired;
+        std::vector<uint64_t> _pending;
+    };
+
+    // Shard
+    struct Shard
+    {
+        ShardHandler handler;
+        MarketManager manager;
+        CppCommon::SPSCRingQueue<MarketCommand> commands;
+        uint64_t enqueued;
+        std::atomic<uint64_t> processed;
+        std::thread thread;
+
+        Shard(MarketHandler& market_handler, size_t capacity) : handler(market_handler, capacity), manager(handler), commands(capacity), enqueued(0), processed(0) {}
+    };
+
+    // Order route
+    struct Route
+    {
+        size_t Index;
+        size_t Count;
+    };
+
+    std::vector<std::unique_ptr<Shard>> _shards;
+    CppCommon::HashMap<uint64_t, Route, FastHash> _routes;
+    std::atomic<bool> _running;
+
+    // Commands routing
+    void Enqueue(size_t shard, const MarketCommand& command);
+    void EnqueueAll(const MarketCommand& command);
+    ErrorCode EnqueueOrder(uint64_t id, const MarketCommand& command);
+    bool AddRoute(uint64_t id, size_t shard);
+    void Retire();
+
+    // Shard thread
+    void Run(Shard& shard);
+    void Execute(Shard& shard, const MarketCommand& command);
+};
+
+//! Sharded market manager with the default market traits
+typedef ShardedMarketManagerT<MarketTraits<>> ShardedMarketManager;
+
+} // namespace Matching
+} // namespace CppTrader
+
+#include "sharded_market_manager.inl"
+
+#endif // CPPTRADER_MATCHING_SHARDED_MARKET_MANAGER_H
@@ -0,0 +1,340 @@
+/*!
+    \file sharded_market_manager.inl
+    \brief Sharded market manager inline implementation
+    \author Ivan Shynkarenka
+    \date 25.08.2017
+    \copyright MIT License
+*/
+
+namespace CppTrader {
+namespace Matching {
+
+template <class TTraits>
+ShardedMarketManagerT<TTraits>::ShardedMarketManagerT(const std::vector<MarketHandler*>& market_handlers, size_t capacity, bool affinity)
+    : _routes(16384, 0),
+      _running(true)
+{
+    assert(!market_handlers.empty() && "Sharded market manager must have at least one shard!");
+
+    // Create shards
+    for (auto market_handler : market_handlers)
+        _shards.emplace_back(new Shard(*market_handler, capacity));
+
+    // Start shard threads
+    size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t i = 0; i < _shards.size(); ++i)
+    {
+        Shard& shard = *_shards[i];
+        shard.thread = std::thread([this, &shard]() { Run(shard); });
+
+        // Pin the shard thread to the CPU core
+        if (affinity)
+        {
+            std::bitset<64> mask;
+            mask.set((i % cores) % mask.size());
+            CppCommon::Thread::SetAffinity(shard.thread, mask);
+        }
+    }
+}
+
+template <class TTraits>
+ShardedMarketManagerT<TTraits>::~ShardedMarketManagerT()
+{
+    // Process all enqueued commands
+    Flush();
+
+    // Stop shard threads
+    _running.store(false, std::memory_order_release);
+    for (auto& shard : _shards)
+        shard->thread.join();
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::AddSymbol(const Symbol& symbol)
+{
+    Enqueue(GetShard(symbol.Id), MarketCommand::AddSymbol(symbol));
+    return ErrorCode::OK;
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::DeleteSymbol(uint32_t id)
+{
+    Enqueue(GetShard(id), MarketCommand::DeleteSymbol(id));
+    return ErrorCode::OK;
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::AddOrderBook(const Symbol& symbol)
+{
+    Enqueue(GetShard(symbol.Id), MarketCommand::AddOrderBook(symbol));
+    return ErrorCode::OK;
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::DeleteOrderBook(uint32_t id)
+{
+    Enqueue(GetShard(id), MarketCommand::DeleteOrderBook(id));
+    return ErrorCode::OK;
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::AddOrder(const Order& order)
+{
+    // Clean routes of deleted orders
+    Retire();
+
+    // Route the new order to the shard of its symbol
+    size_t shard = GetShard(order.SymbolId);
+    if (!AddRoute(order.Id, shard))
+        return ErrorCode::ORDER_DUPLICATE;
+    Enqueue(shard, MarketCommand::AddOrder(order));
+    return ErrorCode::OK;
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::ReduceOrder(uint64_t id, QuantityType quantity)
+{
+    return EnqueueOrder(id, MarketCommand::ReduceOrder(id, quantity));
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::ModifyOrder(uint64_t id, PriceType new_price, QuantityType new_quantity)
+{
+    return EnqueueOrder(id, MarketCommand::ModifyOrder(id, new_price, new_quantity));
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::MitigateOrder(uint64_t id, PriceType new_price, QuantityType new_quantity)
+{
+    return EnqueueOrder(id, MarketCommand::MitigateOrder(id, new_price, new_quantity));
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::ReplaceOrder(uint64_t id, uint64_t new_id, PriceType new_price, QuantityType new_quantity)
+{
+    // Clean routes of deleted orders
+    Retire();
+
+    auto it = _routes.find(id);
+    if (it == _routes.end())
+        return ErrorCode::ORDER_NOT_FOUND;
+
+    // Route the new order to the shard of the replaced order
+    size_t shard = it->second.Index;
+    if (!AddRoute(new_id, shard))
+        return ErrorCode::ORDER_DUPLICATE;
+    Enqueue(shard, MarketCommand::ReplaceOrder(id, new_id, new_price, new_quantity));
+    return ErrorCode::OK;
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::ReplaceOrder(uint64_t id, const Order& new_order)
+{
+    // Clean routes of deleted orders
+    Retire();
+
+    auto it = _routes.find(id);
+    if (it == _routes.end())
+        return ErrorCode::ORDER_NOT_FOUND;
+
+    // Route the new order to the shard of the replaced order
+    size_t shard = it->second.Index;
+    assert((shard == GetShard(new_order.SymbolId)) && "New order must have the same symbol as the replaced one!");
+    if (!AddRoute(new_order.Id, shard))
+        return ErrorCode::ORDER_DUPLICATE;
+    Enqueue(shard, MarketCommand::ReplaceOrder(id, new_order));
+    return ErrorCode::OK;
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::DeleteOrder(uint64_t id)
+{
+    return EnqueueOrder(id, MarketCommand::DeleteOrder(id));
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::ExecuteOrder(uint64_t id, QuantityType quantity)
+{
+    return EnqueueOrder(id, MarketCommand::ExecuteOrder(id, quantity));
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::ExecuteOrder(uint64_t id, PriceType price, QuantityType quantity)
+{
+    return EnqueueOrder(id, MarketCommand::ExecuteOrder(id, price, quantity));
+}
+
+template <class TTraits>
+void ShardedMarketManagerT<TTraits>::EnableMatching()
+{
+    EnqueueAll(MarketCommand::EnableMatching());
+}
+
+template <class TTraits>
+void ShardedMarketManagerT<TTraits>::DisableMatching()
+{
+    EnqueueAll(MarketCommand::DisableMatching());
+}
+
+template <class TTraits>
+void ShardedMarketManagerT<TTraits>::Match()
+{
+    EnqueueAll(MarketCommand::Match());
+}
+
+template <class TTraits>
+void ShardedMarketManagerT<TTraits>::Flush()
+{
+    // Wait for all shards to process enqueued commands
+    for (auto& shard : _shards)
+    {
+        while (shard->processed.load(std::memory_order_acquire) != shard->enqueued)
+        {
+            Retire();
+            CppCommon::Thread::Yield();
+        }
+    }
+
+    // Clean routes of deleted orders
+    Retire();
+}
+
+template <class TTraits>
+void ShardedMarketManagerT<TTraits>::Enqueue(size_t shard, const MarketCommand& command)
+{
+    Shard& shard_ref = *_shards[shard];
+
+    // Wait for the free space in the shard command queue
+    while (!shard_ref.commands.Enqueue(command))
+    {
+        Retire();
+        CppCommon::Thread::Yield();
+    }
+
+    ++shard_ref.enqueued;
+}
+
+template <class TTraits>
+void ShardedMarketManagerT<TTraits>::EnqueueAll(const MarketCommand& command)
+{
+    for (size_t shard = 0; shard < _shards.size(); ++shard)
+        Enqueue(shard, command);
+}
+
+template <class TTraits>
+ErrorCode ShardedMarketManagerT<TTraits>::EnqueueOrder(uint64_t id, const MarketCommand& command)
+{
+    // Clean routes of deleted orders
+    Retire();
+
+    auto it = _routes.find(id);
+    if (it == _routes.end())
+        return ErrorCode::ORDER_NOT_FOUND;
+
+    Enqueue(it->second.Index, command);
+    return ErrorCode::OK;
+}
+
+template <class TTraits>
+bool ShardedMarketManagerT<TTraits>::AddRoute(uint64_t id, size_t shard)
+{
+    auto it = _routes.find(id);
+    if (it != _routes.end())
+    {
+        // Order Id which is alive on another shard cannot be routed
+        if (it->second.Index != shard)
+            return false;
+
+        // The same order Id may be reused on the same shard before the previous
+        // order is retired, so the route keeps the count of its orders
+        ++it->second.Count;
+    }
+    else
+        _routes.insert(std::make_pair(id, Route{ shard, 1 }));
+
+    return true;
+}
+
+template <class TTraits>
+void ShardedMarketManagerT<TTraits>::Retire()
+{
+    uint64_t id;
+    for (auto& shard : _shards)
+    {
+        while (shard->handler.Dequeue(id))
+        {
+            auto it = _routes.find(id);
+            if ((it != _routes.end()) && (--it->second.Count == 0))
+                _routes.erase(it);
+        }
+    }
+}
+
+template <class TTraits>
+void ShardedMarketManagerT<TTraits>::Run(Shard& shard)
+{
+    MarketCommand command;
+
+    while (_running.load(std::memory_order_acquire))
+    {
+        bool idle = true;
+
+        // Process all enqueued commands
+        while (shard.commands.Dequeue(command))
+        {
+            Execute(shard, command);
+            shard.processed.fetch_add(1, std::memory_order_release);
+            idle = false;
+        }
+
+        // Retry retired orders which did not fit into the full queue
+        shard.handler.Retry();
+
+        if (idle)
+            CppCommon::Thread::Yield();
+    }
+}
+
+template <class TTraits>
+void ShardedMarketManagerT<TTraits>::Execute(Shard& shard, const MarketCommand& command)
+{
+    if (command.Execute(shard.manager) == ErrorCode::OK)
+        return;
+
+    // Retire the route of the rejected new order
+    switch (command.Type)
+    {
+        case MarketCommandType::ADD_ORDER:
+        case MarketCommandType::REPLACE_NEW_ORDER:
+            shard.handler.Retire(command.OrderData.Id);
+            break;
+        case MarketCommandType::REPLACE_ORDER:
+            shard.handler.Retire(command.NewId);
+            break;
+        default:
+            break;
+    }
+}
+
+template <class TTraits>
+void ShardedMarketManagerT<TTraits>::ShardHandler::Retire(uint64_t id)
+{
+    // Keep the order of retired orders if the queue is full
+    if (!_pending.empty() || !_retired.Enqueue(id))
+        _pending.push_back(id);
+}
+
+template <class TTraits>
+void ShardedMarketManagerT<TTraits>::ShardHandler::Retry()
+{
+    size_t count = 0;
+    while ((count < _pending.size()) && _retired.Enqueue(_pending[count]))
+        ++count;
+    _pending.erase(_pending.begin(), _pending.begin() + count);
+}
+
+// Sharded market manager with the default market traits is instantiated in the library
+extern template class ShardedMarketManagerT<MarketTraits<>>;
+
+} // namespace Matching
+} // namespace CppTrader
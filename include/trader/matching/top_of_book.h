@@ -0,0 +1,72 @@
+/*!
+    \file top_of_book.h
+    \brief Top of the order book definition
+    \author Ivan Shynkarenka
+    \date 27.08.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_MATCHING_TOP_OF_BOOK_H
+#define CPPTRADER_MATCHING_TOP_OF_BOOK_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CppTrader {
+namespace Matching {
+
+//! Price level quote
+/*!
+    Price level quote is a plain copy of the published price level.
+*/
+template <typename TPrice, typename TQuantity>
+struct QuoteT
+{
+    //! Level price
+    TPrice Price;
+    //! Level visible volume
+    TQuantity Volume;
+    //! Level orders
+    size_t Orders;
+};
+
+//! Top of the order book
+/*!
+    Top of the order book is a plain record with the best price levels of the
+    order book (level 1 is the best bid/ask). It is published by the market
+    manager after each modification of the best price levels and could be
+    polled by any number of reader threads with OrderBook::top_of_book().
+
+    The record is aligned to the cache line, so records of different order
+    books never share cache lines.
+*/
+template <typename TPrice, typename TQuantity, size_t TDepth = 5>
+struct alignas(64) TopOfBookT
+{
+    //! Price level quote type
+    typedef QuoteT<TPrice, TQuantity> Quote;
+
+    //! Count of published price levels of each side
+    static constexpr size_t DEPTH = TDepth;
+
+    //! Publication sequence number (incremented with each publication)
+    uint64_t Sequence;
+    //! Count of published bid price levels
+    size_t BidLevels;
+    //! Count of published ask price levels
+    size_t AskLevels;
+    //! Bid price levels from the best one
+    Quote Bids[TDepth];
+    //! Ask price levels from the best one
+    Quote Asks[TDepth];
+
+    //! Get the best bid price level quote or nullptr
+    const Quote* best_bid() const noexcept { return (BidLevels > 0) ? &Bids[0] : nullptr; }
+    //! Get the best ask price level quote or nullptr
+    const Quote* best_ask() const noexcept { return (AskLevels > 0) ? &Asks[0] : nullptr; }
+};
+
+} // namespace Matching
+} // namespace CppTrader
+
+#endif // CPPTRADER_MATCHING_TOP_OF_BOOK_H
@@ -0,0 +1,88 @@
+/*!
+    \file itch_file.h
+    \brief NASDAQ ITCH memory-mapped file definition
+    \author Ivan Shynkarenka
+    \date 08.09.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_ITCH_FILE_H
+#define CPPTRADER_ITCH_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace CppTrader {
+namespace ITCH {
+
+//! NASDAQ ITCH memory-mapped file class
+/*!
+    NASDAQ ITCH memory-mapped file maps the whole ITCH capture into the memory
+    with the sequential access advice, so the capture could be passed to the
+    ITCH handler or parser as one contiguous span without any copies and
+    without messages straddling read chunk boundaries:
+    \code
+    ITCHFile file;
+    if (file.Open("capture.itch"))
+        file.Process(itch_handler);
+    \endcode
+
+    Optional hints are applied where the platform supports them and ignored
+    otherwise:
+    - populate - prefault all pages of the capture at open time;
+    - hugepages - advise transparent huge pages for the mapping. This is
+      best-effort only: the kernel backs a file mapping with huge pages only
+      for tmpfs or with read-only THP support for file systems, and may not
+      do it at all, so the mapping works the same without them.
+
+    Not thread-safe.
+*/
+class ITCHFile
+{
+public:
+    ITCHFile() noexcept : _data(nullptr), _size(0), _opened(false) {}
+    ITCHFile(const ITCHFile&) = delete;
+    ITCHFile(ITCHFile&&) = delete;
+    ~ITCHFile() { Close(); }
+
+    ITCHFile& operator=(const ITCHFile&) = delete;
+    ITCHFile& operator=(ITCHFile&&) = delete;
+
+    //! Is the file opened?
+    bool IsOpened() const noexcept { return _opened; }
+
+    //! Get the mapped file data
+    const uint8_t* data() const noexcept { return _data; }
+    //! Get the mapped file size
+    size_t size() const noexcept { return _size; }
+
+    //! Open and map the ITCH file
+    /*!
+        \param filename - ITCH file name
+        \param populate - Prefault all pages of the mapped file (default is false)
+        \param hugepages - Advise transparent huge pages for the mapped file, best-effort (default is false)
+        \return 'true' if the file was successfully opened and mapped, 'false' if the file open or map was failed
+    */
+    bool Open(const std::string& filename, bool populate = false, bool hugepages = false);
+    //! Unmap and close the ITCH file
+    void Close();
+
+    //! Process the whole mapped file with the given ITCH handler or parser
+    /*!
+        \param parser - ITCH handler or parser
+        \return 'true' if the file was successfully processed, 'false' if the file process was failed
+    */
+    template <class TParser>
+    bool Process(TParser& parser) const { return parser.Process(_data, _size); }
+
+private:
+    const uint8_t* _data;
+    size_t _size;
+    bool _opened;
+};
+
+} // namespace ITCH
+} // namespace CppTrader
+
+#endif // CPPTRADER_ITCH_FILE_H
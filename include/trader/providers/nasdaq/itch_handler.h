@@ -12,6 +12,8 @@
 #include "utility/endian.h"
 #include "utility/iostream.h"
 
+#include <array>
+#include <cassert>
 #include <vector>
 
 namespace CppTrader {
@@ -371,11 +373,529 @@ struct UnknownMessage
     friend TOutputStream& operator<<(TOutputStream& stream, const UnknownMessage& message);
 };
 
+//! ITCH message view
+/*!
+    ITCH message view is a lightweight wrapper over the raw ITCH message
+    buffer. Its accessors read fields directly from the buffer and convert
+    them from the big-endian byte order on each call, so fields which are
+    never read cost nothing. Message view is valid only during the handler
+    call, because the underlying buffer is reused for next messages.
+*/
+class MessageView
+{
+public:
+    //! Fixed size string field type
+    template <size_t N>
+    using String = char[N];
+
+    MessageView(const void* buffer, size_t size) noexcept : _data((const uint8_t*)buffer), _size(size) {}
+    MessageView(const MessageView&) noexcept = default;
+    MessageView(MessageView&&) noexcept = default;
+    ~MessageView() noexcept = default;
+
+    MessageView& operator=(const MessageView&) noexcept = default;
+    MessageView& operator=(MessageView&&) noexcept = default;
+
+    //! Get the raw message data
+    const uint8_t* data() const noexcept { return _data; }
+    //! Get the raw message size
+    size_t size() const noexcept { return _size; }
+
+    char Type() const noexcept { return ReadChar(0); }
+    uint16_t StockLocate() const noexcept { return Read<uint16_t>(1); }
+    uint16_t TrackingNumber() const noexcept { return Read<uint16_t>(3); }
+    //! Get the message timestamp (nanoseconds since midnight)
+    uint64_t Timestamp() const noexcept;
+
+protected:
+    const uint8_t* _data;
+    size_t _size;
+
+    char ReadChar(size_t offset) const noexcept { return (char)_data[offset]; }
+    template <typename T>
+    T Read(size_t offset) const noexcept;
+    template <size_t N>
+    const String<N>& ReadString(size_t offset) const noexcept { return *(const String<N>*)(_data + offset); }
+};
+
+//! System Event Message view
+class SystemEventMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'S';
+    //! Message size
+    static constexpr size_t SIZE = 12;
+
+    using MessageView::MessageView;
+
+    char EventCode() const noexcept { return ReadChar(11); }
+};
+
+//! Stock Directory Message view
+class StockDirectoryMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'R';
+    //! Message size
+    static constexpr size_t SIZE = 39;
+
+    using MessageView::MessageView;
+
+    const String<8>& Stock() const noexcept { return ReadString<8>(11); }
+    char MarketCategory() const noexcept { return ReadChar(19); }
+    char FinancialStatusIndicator() const noexcept { return ReadChar(20); }
+    uint32_t RoundLotSize() const noexcept { return Read<uint32_t>(21); }
+    char RoundLotsOnly() const noexcept { return ReadChar(25); }
+    char IssueClassification() const noexcept { return ReadChar(26); }
+    const String<2>& IssueSubType() const noexcept { return ReadString<2>(27); }
+    char Authenticity() const noexcept { return ReadChar(29); }
+    char ShortSaleThresholdIndicator() const noexcept { return ReadChar(30); }
+    char IPOFlag() const noexcept { return ReadChar(31); }
+    char LULDReferencePriceTier() const noexcept { return ReadChar(32); }
+    char ETPFlag() const noexcept { return ReadChar(33); }
+    uint32_t ETPLeverageFactor() const noexcept { return Read<uint32_t>(34); }
+    char InverseIndicator() const noexcept { return ReadChar(38); }
+};
+
+//! Stock Trading Action Message view
+class StockTradingActionMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'H';
+    //! Message size
+    static constexpr size_t SIZE = 25;
+
+    using MessageView::MessageView;
+
+    const String<8>& Stock() const noexcept { return ReadString<8>(11); }
+    char TradingState() const noexcept { return ReadChar(19); }
+    char Reserved() const noexcept { return ReadChar(20); }
+    char Reason() const noexcept { return ReadChar(21); }
+};
+
+//! Reg SHO Short Sale Price Test Restricted Indicator Message view
+class RegSHOMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'Y';
+    //! Message size
+    static constexpr size_t SIZE = 20;
+
+    using MessageView::MessageView;
+
+    const String<8>& Stock() const noexcept { return ReadString<8>(11); }
+    char RegSHOAction() const noexcept { return ReadChar(19); }
+};
+
+//! Market Participant Position Message view
+class MarketParticipantPositionMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'L';
+    //! Message size
+    static constexpr size_t SIZE = 26;
+
+    using MessageView::MessageView;
+
+    const String<4>& MPID() const noexcept { return ReadString<4>(11); }
+    const String<8>& Stock() const noexcept { return ReadString<8>(15); }
+    char PrimaryMarketMaker() const noexcept { return ReadChar(23); }
+    char MarketMakerMode() const noexcept { return ReadChar(24); }
+    char MarketParticipantState() const noexcept { return ReadChar(25); }
+};
+
+//! MWCB Decline Level Message view
+class MWCBDeclineMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'V';
+    //! Message size
+    static constexpr size_t SIZE = 35;
+
+    using MessageView::MessageView;
+
+    uint64_t Level1() const noexcept { return Read<uint64_t>(11); }
+    uint64_t Level2() const noexcept { return Read<uint64_t>(19); }
+    uint64_t Level3() const noexcept { return Read<uint64_t>(27); }
+};
+
+//! MWCB Status Message view
+class MWCBStatusMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'W';
+    //! Message size
+    static constexpr size_t SIZE = 12;
+
+    using MessageView::MessageView;
+
+    char BreachedLevel() const noexcept { return ReadChar(11); }
+};
+
+//! IPO Quoting Period Update Message view
+class IPOQuotingMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'K';
+    //! Message size
+    static constexpr size_t SIZE = 28;
+
+    using MessageView::MessageView;
+
+    const String<8>& Stock() const noexcept { return ReadString<8>(11); }
+    uint32_t IPOReleaseTime() const noexcept { return Read<uint32_t>(19); }
+    char IPOReleaseQualifier() const noexcept { return ReadChar(23); }
+    uint32_t IPOPrice() const noexcept { return Read<uint32_t>(24); }
+};
+
+//! Add Order Message view
+class AddOrderMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'A';
+    //! Message size
+    static constexpr size_t SIZE = 36;
+
+    using MessageView::MessageView;
+
+    uint64_t OrderReferenceNumber() const noexcept { return Read<uint64_t>(11); }
+    char BuySellIndicator() const noexcept { return ReadChar(19); }
+    uint32_t Shares() const noexcept { return Read<uint32_t>(20); }
+    const String<8>& Stock() const noexcept { return ReadString<8>(24); }
+    uint32_t Price() const noexcept { return Read<uint32_t>(32); }
+};
+
+//! Add Order with MPID Attribution Message view
+class AddOrderMPIDMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'F';
+    //! Message size
+    static constexpr size_t SIZE = 40;
+
+    using MessageView::MessageView;
+
+    uint64_t OrderReferenceNumber() const noexcept { return Read<uint64_t>(11); }
+    char BuySellIndicator() const noexcept { return ReadChar(19); }
+    uint32_t Shares() const noexcept { return Read<uint32_t>(20); }
+    const String<8>& Stock() const noexcept { return ReadString<8>(24); }
+    uint32_t Price() const noexcept { return Read<uint32_t>(32); }
+    char Attribution() const noexcept { return ReadChar(36); }
+};
+
+//! Order Executed Message view
+class OrderExecutedMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'E';
+    //! Message size
+    static constexpr size_t SIZE = 31;
+
+    using MessageView::MessageView;
+
+    uint64_t OrderReferenceNumber() const noexcept { return Read<uint64_t>(11); }
+    uint32_t ExecutedShares() const noexcept { return Read<uint32_t>(19); }
+    uint64_t MatchNumber() const noexcept { return Read<uint64_t>(23); }
+};
+
+//! Order Executed With Price Message view
+class OrderExecutedWithPriceMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'C';
+    //! Message size
+    static constexpr size_t SIZE = 36;
+
+    using MessageView::MessageView;
+
+    uint64_t OrderReferenceNumber() const noexcept { return Read<uint64_t>(11); }
+    uint32_t ExecutedShares() const noexcept { return Read<uint32_t>(19); }
+    uint64_t MatchNumber() const noexcept { return Read<uint64_t>(23); }
+    char Printable() const noexcept { return ReadChar(31); }
+    uint32_t ExecutionPrice() const noexcept { return Read<uint32_t>(32); }
+};
+
+//! Order Cancel Message view
+class OrderCancelMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'X';
+    //! Message size
+    static constexpr size_t SIZE = 23;
+
+    using MessageView::MessageView;
+
+    uint64_t OrderReferenceNumber() const noexcept { return Read<uint64_t>(11); }
+    uint32_t CanceledShares() const noexcept { return Read<uint32_t>(19); }
+};
+
+//! Order Delete Message view
+class OrderDeleteMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'D';
+    //! Message size
+    static constexpr size_t SIZE = 19;
+
+    using MessageView::MessageView;
+
+    uint64_t OrderReferenceNumber() const noexcept { return Read<uint64_t>(11); }
+};
+
+//! Order Replace Message view
+class OrderReplaceMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'U';
+    //! Message size
+    static constexpr size_t SIZE = 35;
+
+    using MessageView::MessageView;
+
+    uint64_t OriginalOrderReferenceNumber() const noexcept { return Read<uint64_t>(11); }
+    uint64_t NewOrderReferenceNumber() const noexcept { return Read<uint64_t>(19); }
+    uint32_t Shares() const noexcept { return Read<uint32_t>(27); }
+    uint32_t Price() const noexcept { return Read<uint32_t>(31); }
+};
+
+//! Trade Message view
+class TradeMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'P';
+    //! Message size
+    static constexpr size_t SIZE = 44;
+
+    using MessageView::MessageView;
+
+    uint64_t OrderReferenceNumber() const noexcept { return Read<uint64_t>(11); }
+    char BuySellIndicator() const noexcept { return ReadChar(19); }
+    uint32_t Shares() const noexcept { return Read<uint32_t>(20); }
+    const String<8>& Stock() const noexcept { return ReadString<8>(24); }
+    uint32_t Price() const noexcept { return Read<uint32_t>(32); }
+    uint64_t MatchNumber() const noexcept { return Read<uint64_t>(36); }
+};
+
+//! Cross Trade Message view
+class CrossTradeMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'Q';
+    //! Message size
+    static constexpr size_t SIZE = 40;
+
+    using MessageView::MessageView;
+
+    uint64_t Shares() const noexcept { return Read<uint64_t>(11); }
+    const String<8>& Stock() const noexcept { return ReadString<8>(19); }
+    uint32_t CrossPrice() const noexcept { return Read<uint32_t>(27); }
+    uint64_t MatchNumber() const noexcept { return Read<uint64_t>(31); }
+    char CrossType() const noexcept { return ReadChar(39); }
+};
+
+//! Broken Trade Message view
+class BrokenTradeMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'B';
+    //! Message size
+    static constexpr size_t SIZE = 19;
+
+    using MessageView::MessageView;
+
+    uint64_t MatchNumber() const noexcept { return Read<uint64_t>(11); }
+};
+
+//! Net Order Imbalance Indicator (NOII) Message view
+class NOIIMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'I';
+    //! Message size
+    static constexpr size_t SIZE = 50;
+
+    using MessageView::MessageView;
+
+    uint64_t PairedShares() const noexcept { return Read<uint64_t>(11); }
+    uint64_t ImbalanceShares() const noexcept { return Read<uint64_t>(19); }
+    char ImbalanceDirection() const noexcept { return ReadChar(27); }
+    const String<8>& Stock() const noexcept { return ReadString<8>(28); }
+    uint32_t FarPrice() const noexcept { return Read<uint32_t>(36); }
+    uint32_t NearPrice() const noexcept { return Read<uint32_t>(40); }
+    uint32_t CurrentReferencePrice() const noexcept { return Read<uint32_t>(44); }
+    char CrossType() const noexcept { return ReadChar(48); }
+    char PriceVariationIndicator() const noexcept { return ReadChar(49); }
+};
+
+//! Retail Price Improvement Indicator (RPII) Message view
+class RPIIMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'N';
+    //! Message size
+    static constexpr size_t SIZE = 20;
+
+    using MessageView::MessageView;
+
+    const String<8>& Stock() const noexcept { return ReadString<8>(11); }
+    char InterestFlag() const noexcept { return ReadChar(19); }
+};
+
+//! Limit Up – Limit Down (LULD) Auction Collar Message view
+class LULDAuctionCollarMessageView : public MessageView
+{
+public:
+    //! Message type
+    static constexpr char TYPE = 'J';
+    //! Message size
+    static constexpr size_t SIZE = 35;
+
+    using MessageView::MessageView;
+
+    const String<8>& Stock() const noexcept { return ReadString<8>(11); }
+    uint32_t AuctionCollarReferencePrice() const noexcept { return Read<uint32_t>(19); }
+    uint32_t UpperAuctionCollarPrice() const noexcept { return Read<uint32_t>(23); }
+    uint32_t LowerAuctionCollarPrice() const noexcept { return Read<uint32_t>(27); }
+    uint32_t AuctionCollarExtension() const noexcept { return Read<uint32_t>(31); }
+};
+
+//! Unknown message view
+class UnknownMessageView : public MessageView
+{
+public:
+    using MessageView::MessageView;
+};
+
+//! ITCH stock locate filter
+/*!
+    ITCH stock locate filter is the bitmap of all 65536 stock locates. It is
+    used to skip messages of not interesting symbols before their decoding:
+    the filter peeks only the two bytes stock locate field at the fixed offset
+    of the raw message. Order messages without the symbol (executed, cancel,
+    delete, replace) still carry the stock locate of their order book, so
+    they are filtered the same way.
+
+    Market wide messages (stock locate is zero) always pass the filter.
+
+    Not thread-safe.
+*/
+class StockLocateFilter
+{
+public:
+    StockLocateFilter() noexcept { Clear(); }
+    StockLocateFilter(const StockLocateFilter&) noexcept = default;
+    StockLocateFilter(StockLocateFilter&&) noexcept = default;
+    ~StockLocateFilter() noexcept = default;
+
+    StockLocateFilter& operator=(const StockLocateFilter&) noexcept = default;
+    StockLocateFilter& operator=(StockLocateFilter&&) noexcept = default;
+
+    //! Check if the filter is empty
+    bool empty() const noexcept { return _size == 0; }
+    //! Get the filter size
+    size_t size() const noexcept { return _size; }
+
+    //! Is the given stock locate passed?
+    bool Contains(uint16_t stock_locate) const noexcept
+    { return (stock_locate == 0) || ((_bitmap[stock_locate >> 6] >> (stock_locate & 63)) & 1); }
+
+    //! Is the given raw ITCH message passed?
+    /*!
+        Messages too short to contain the stock locate field are passed to be
+        validated by the message parser.
+
+        \param data - Raw ITCH message data
+        \param size - Raw ITCH message size
+        \return 'true' if the message passes the filter, 'false' if the message should be skipped
+    */
+    bool Match(const uint8_t* data, size_t size) const noexcept
+    { return (size < 3) || Contains((uint16_t)((data[1] << 8) | data[2])); }
+
+    //! Add the given stock locate into the filter
+    void Add(uint16_t stock_locate) noexcept;
+    //! Remove the given stock locate from the filter
+    void Remove(uint16_t stock_locate) noexcept;
+    //! Clear the filter
+    void Clear() noexcept;
+
+private:
+    std::array<uint64_t, 65536 / 64> _bitmap;
+    size_t _size;
+};
+
+//! NASDAQ ITCH framer class
+/*!
+    NASDAQ ITCH framer splits the stream of ITCH messages prefixed with their
+    big-endian 16-bit sizes into separate messages. Message sizes and messages
+    split across processed buffers are collected into the internal cache.
+
+    Not thread-safe.
+*/
+class ITCHFramer
+{
+public:
+    ITCHFramer() : _size(0) {}
+    ITCHFramer(const ITCHFramer&) = delete;
+    ITCHFramer(ITCHFramer&&) = delete;
+    ~ITCHFramer() = default;
+
+    ITCHFramer& operator=(const ITCHFramer&) = delete;
+    ITCHFramer& operator=(ITCHFramer&&) = delete;
+
+    //! Process all messages from the given buffer in ITCH format and call the given message processor
+    /*!
+        Message processor is called with each complete message:
+        bool process(const uint8_t* data, size_t size)
+
+        \param buffer - Buffer to process
+        \param size - Buffer size
+        \param process - Message processor
+        \return 'true' if the given buffer was successfully processed, 'false' if the given buffer process was failed
+    */
+    template <class TProcess>
+    bool Process(const void* buffer, size_t size, TProcess&& process);
+
+    //! Reset ITCH framer
+    void Reset() { _size = 0; _cache.clear(); }
+
+private:
+    size_t _size;
+    std::vector<uint8_t> _cache;
+};
+
 //! NASDAQ ITCH handler class
 /*!
     NASDAQ ITCH handler is used to parse NASDAQ ITCH protocol and handle its
     messages in special handlers.
 
+    By default each message is decoded into the corresponding message structure
+    and passed to onMessage() handler. In view mode messages are not decoded,
+    instead onMessageView() handler receives the lightweight message view over
+    the raw message buffer which reads only accessed fields.
+
+    In filter mode messages of stock locates not passed by the stock locate
+    filter are skipped without any decoding.
+
     NASDAQ ITCH protocol specification:
     http://www.nasdaqtrader.com/content/technicalsupport/specifications/dataproducts/NQTVITCHSpecification.pdf
 
@@ -387,7 +907,7 @@ struct UnknownMessage
 class ITCHHandler
 {
 public:
-    ITCHHandler() { Reset(); }
+    ITCHHandler() : _views(false), _filtered(false) { Reset(); }
     ITCHHandler(const ITCHHandler&) = delete;
     ITCHHandler(ITCHHandler&&) = delete;
     virtual ~ITCHHandler() = default;
@@ -401,18 +921,34 @@ public:
         \param size - Buffer size
         \return 'true' if the given buffer was successfully processed, 'false' if the given buffer process was failed
     */
-    bool Process(void* buffer, size_t size);
+    bool Process(const void* buffer, size_t size);
     //! Process a single message from the given buffer in ITCH format and call corresponding handlers
     /*!
         \param buffer - Buffer to process
         \param size - Buffer size
         \return 'true' if the given buffer was successfully processed, 'false' if the given buffer process was failed
     */
-    bool ProcessMessage(void* buffer, size_t size);
+    bool ProcessMessage(const void* buffer, size_t size);
 
     //! Reset ITCH handler
     void Reset();
 
+    //! Is view mode enabled?
+    bool IsViewModeEnabled() const noexcept { return _views; }
+    //! Enable view mode (call onMessageView() handlers with message views instead of decoded messages)
+    void EnableViewMode() noexcept { _views = true; }
+    //! Disable view mode (call onMessage() handlers with decoded messages)
+    void DisableViewMode() noexcept { _views = false; }
+
+    //! Get the stock locate filter
+    const StockLocateFilter& filter() const noexcept { return _filter; }
+    //! Is filter mode enabled?
+    bool IsFilterModeEnabled() const noexcept { return _filtered; }
+    //! Enable filter mode (skip messages of stock locates not passed by the given filter)
+    void EnableFilterMode(const StockLocateFilter& filter) noexcept { _filter = filter; _filtered = true; }
+    //! Disable filter mode (handle messages of all stock locates)
+    void DisableFilterMode() noexcept { _filtered = false; }
+
 protected:
     // Message handlers
     virtual bool onMessage(const SystemEventMessage& message) { return true; }
@@ -438,32 +974,62 @@ protected:
     virtual bool onMessage(const LULDAuctionCollarMessage& message) { return true; }
     virtual bool onMessage(const UnknownMessage& message) { return true; }
 
-private:
-    size_t _size;
-    std::vector<uint8_t> _cache;
+    // Message view handlers
+    virtual bool onMessageView(const SystemEventMessageView& message) { return true; }
+    virtual bool onMessageView(const StockDirectoryMessageView& message) { return true; }
+    virtual bool onMessageView(const StockTradingActionMessageView& message) { return true; }
+    virtual bool onMessageView(const RegSHOMessageView& message) { return true; }
+    virtual bool onMessageView(const MarketParticipantPositionMessageView& message) { return true; }
+    virtual bool onMessageView(const MWCBDeclineMessageView& message) { return true; }
+    virtual bool onMessageView(const MWCBStatusMessageView& message) { return true; }
+    virtual bool onMessageView(const IPOQuotingMessageView& message) { return true; }
+    virtual bool onMessageView(const AddOrderMessageView& message) { return true; }
+    virtual bool onMessageView(const AddOrderMPIDMessageView& message) { return true; }
+    virtual bool onMessageView(const OrderExecutedMessageView& message) { return true; }
+    virtual bool onMessageView(const OrderExecutedWithPriceMessageView& message) { return true; }
+    virtual bool onMessageView(const OrderCancelMessageView& message) { return true; }
+    virtual bool onMessageView(const OrderDeleteMessageView& message) { return true; }
+    virtual bool onMessageView(const OrderReplaceMessageView& message) { return true; }
+    virtual bool onMessageView(const TradeMessageView& message) { return true; }
+    virtual bool onMessageView(const CrossTradeMessageView& message) { return true; }
+    virtual bool onMessageView(const BrokenTradeMessageView& message) { return true; }
+    virtual bool onMessageView(const NOIIMessageView& message) { return true; }
+    virtual bool onMessageView(const RPIIMessageView& message) { return true; }
+    virtual bool onMessageView(const LULDAuctionCollarMessageView& message) { return true; }
+    virtual bool onMessageView(const UnknownMessageView& message) { return true; }
 
-    bool ProcessSystemEventMessage(void* buffer, size_t size);
-    bool ProcessStockDirectoryMessage(void* buffer, size_t size);
-    bool ProcessStockTradingActionMessage(void* buffer, size_t size);
-    bool ProcessRegSHOMessage(void* buffer, size_t size);
-    bool ProcessMarketParticipantPositionMessage(void* buffer, size_t size);
-    bool ProcessMWCBDeclineMessage(void* buffer, size_t size);
-    bool ProcessMWCBStatusMessage(void* buffer, size_t size);
-    bool ProcessIPOQuotingMessage(void* buffer, size_t size);
-    bool ProcessAddOrderMessage(void* buffer, size_t size);
-    bool ProcessAddOrderMPIDMessage(void* buffer, size_t size);
-    bool ProcessOrderExecutedMessage(void* buffer, size_t size);
-    bool ProcessOrderExecutedWithPriceMessage(void* buffer, size_t size);
-    bool ProcessOrderCancelMessage(void* buffer, size_t size);
-    bool ProcessOrderDeleteMessage(void* buffer, size_t size);
-    bool ProcessOrderReplaceMessage(void* buffer, size_t size);
-    bool ProcessTradeMessage(void* buffer, size_t size);
-    bool ProcessCrossTradeMessage(void* buffer, size_t size);
-    bool ProcessBrokenTradeMessage(void* buffer, size_t size);
-    bool ProcessNOIIMessage(void* buffer, size_t size);
-    bool ProcessRPIIMessage(void* buffer, size_t size);
-    bool ProcessLULDAuctionCollarMessage(void* buffer, size_t size);
-    bool ProcessUnknownMessage(void* buffer, size_t size);
+private:
+    ITCHFramer _framer;
+    bool _views;
+    bool _filtered;
+    StockLocateFilter _filter;
+
+    bool ProcessMessageView(const uint8_t* data, size_t size);
+    template <class TMessageView>
+    bool ProcessMessageView(const uint8_t* data, size_t size);
+
+    bool ProcessSystemEventMessage(const void* buffer, size_t size);
+    bool ProcessStockDirectoryMessage(const void* buffer, size_t size);
+    bool ProcessStockTradingActionMessage(const void* buffer, size_t size);
+    bool ProcessRegSHOMessage(const void* buffer, size_t size);
+    bool ProcessMarketParticipantPositionMessage(const void* buffer, size_t size);
+    bool ProcessMWCBDeclineMessage(const void* buffer, size_t size);
+    bool ProcessMWCBStatusMessage(const void* buffer, size_t size);
+    bool ProcessIPOQuotingMessage(const void* buffer, size_t size);
+    bool ProcessAddOrderMessage(const void* buffer, size_t size);
+    bool ProcessAddOrderMPIDMessage(const void* buffer, size_t size);
+    bool ProcessOrderExecutedMessage(const void* buffer, size_t size);
+    bool ProcessOrderExecutedWithPriceMessage(const void* buffer, size_t size);
+    bool ProcessOrderCancelMessage(const void* buffer, size_t size);
+    bool ProcessOrderDeleteMessage(const void* buffer, size_t size);
+    bool ProcessOrderReplaceMessage(const void* buffer, size_t size);
+    bool ProcessTradeMessage(const void* buffer, size_t size);
+    bool ProcessCrossTradeMessage(const void* buffer, size_t size);
+    bool ProcessBrokenTradeMessage(const void* buffer, size_t size);
+    bool ProcessNOIIMessage(const void* buffer, size_t size);
+    bool ProcessRPIIMessage(const void* buffer, size_t size);
+    bool ProcessLULDAuctionCollarMessage(const void* buffer, size_t size);
+    bool ProcessUnknownMessage(const void* buffer, size_t size);
 
     template <size_t N>
     size_t ReadString(const void* buffer, char (&str)[N]);
@@ -9,6 +9,93 @@
 namespace CppTrader {
 namespace ITCH {
 
+template <class TProcess>
+inline bool ITCHFramer::Process(const void* buffer, size_t size, TProcess&& process)
+{
+    size_t index = 0;
+    const uint8_t* data = (const uint8_t*)buffer;
+
+    while (index < size)
+    {
+        if (_size == 0)
+        {
+            size_t remaining = size - index;
+
+            // Collect message size into the cache
+            if (((_cache.size() == 0) && (remaining < 3)) || (_cache.size() == 1))
+            {
+                _cache.push_back(data[index++]);
+                continue;
+            }
+
+            // Read a new message size
+            uint16_t message_size;
+            if (_cache.empty())
+            {
+                // Read the message size directly from the input buffer
+                index += CppCommon::Endian::ReadBigEndian(&data[index], message_size);
+            }
+            else
+            {
+                // Read the message size from the cache
+                CppCommon::Endian::ReadBigEndian(_cache.data(), message_size);
+
+                // Clear the cache
+                _cache.clear();
+            }
+            _size = message_size;
+        }
+
+        // Read a new message
+        if (_size > 0)
+        {
+            size_t remaining = size - index;
+
+            // Complete or place the message into the cache
+            if (!_cache.empty())
+            {
+                size_t tail = _size - _cache.size();
+                if (tail > remaining)
+                    tail = remaining;
+                _cache.insert(_cache.end(), &data[index], &data[index + tail]);
+                index += tail;
+                if (_cache.size() < _size)
+                    continue;
+            }
+            else if (_size > remaining)
+            {
+                _cache.reserve(_size);
+                _cache.insert(_cache.end(), &data[index], &data[index + remaining]);
+                index += remaining;
+                continue;
+            }
+
+            // Process the current message
+            if (_cache.empty())
+            {
+                // Process the current message size directly from the input buffer
+                if (!process(&data[index], _size))
+                    return false;
+                index += _size;
+            }
+            else
+            {
+                // Process the current message size directly from the cache
+                if (!process(_cache.data(), _size))
+                    return false;
+
+                // Clear the cache
+                _cache.clear();
+            }
+
+            // Process the next message
+            _size = 0;
+        }
+    }
+
+    return true;
+}
+
 template <class TOutputStream>
 inline TOutputStream& operator<<(TOutputStream& stream, const SystemEventMessage& message)
 {
@@ -335,6 +422,33 @@ inline TOutputStream& operator<<(TOutputStream& stream, const UnknownMessage& me
     return stream;
 }
 
+inline uint64_t MessageView::Timestamp() const noexcept
+{
+    // Timestamp is a 6 bytes big-endian integer
+    uint64_t value = 0;
+    for (size_t i = 5; i < 11; ++i)
+        value = (value << 8) | _data[i];
+    return value;
+}
+
+template <typename T>
+inline T MessageView::Read(size_t offset) const noexcept
+{
+    T value;
+    CppCommon::Endian::ReadBigEndian(_data + offset, value);
+    return value;
+}
+
+template <class TMessageView>
+inline bool ITCHHandler::ProcessMessageView(const uint8_t* data, size_t size)
+{
+    assert((size == TMessageView::SIZE) && "Invalid size of the ITCH message view!");
+    if (size != TMessageView::SIZE)
+        return false;
+
+    return onMessageView(TMessageView(data, size));
+}
+
 template <size_t N>
 inline size_t ITCHHandler::ReadString(const void* buffer, char (&str)[N])
 {
@@ -345,29 +459,10 @@ inline size_t ITCHHandler::ReadString(const void* buffer, char (&str)[N])
 
 inline size_t ITCHHandler::ReadTimestamp(const void* buffer, uint64_t& value)
 {
-    if (CppCommon::Endian::IsBigEndian())
-    {
-        ((uint8_t*)&value)[0] = 0;
-        ((uint8_t*)&value)[1] = 0;
-        ((uint8_t*)&value)[2] = 0;
-        ((uint8_t*)&value)[3] = 0;
-        ((uint8_t*)&value)[4] = 0;
-        ((uint8_t*)&value)[5] = ((const uint8_t*)buffer)[0];
-        ((uint8_t*)&value)[6] = ((const uint8_t*)buffer)[1];
-        ((uint8_t*)&value)[7] = ((const uint8_t*)buffer)[2];
-    }
-    else
-    {
-        ((uint8_t*)&value)[0] = ((const uint8_t*)buffer)[2];
-        ((uint8_t*)&value)[1] = ((const uint8_t*)buffer)[1];
-        ((uint8_t*)&value)[2] = ((const uint8_t*)buffer)[0];
-        ((uint8_t*)&value)[3] = 0;
-        ((uint8_t*)&value)[4] = 0;
-        ((uint8_t*)&value)[5] = 0;
-        ((uint8_t*)&value)[6] = 0;
-        ((uint8_t*)&value)[7] = 0;
-
-    }
+    // Timestamp is a 6 bytes big-endian integer
+    value = 0;
+    for (size_t i = 0; i < 6; ++i)
+        value = (value << 8) | ((const uint8_t*)buffer)[i];
 
     return 6;
 }
@@ -0,0 +1,176 @@
+/*!
+    \file itch_index.h
+    \brief NASDAQ ITCH message index definition
+    \author Ivan Shynkarenka
+    \date 09.09.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_ITCH_INDEX_H
+#define CPPTRADER_ITCH_INDEX_H
+
+#include "itch_handler.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CppTrader {
+namespace ITCH {
+
+//! NASDAQ ITCH message index entry
+/*!
+    Compact 16 bytes record of the single ITCH message boundary in the capture:
+    - message offset (40 bits), message type (8 bits), message size (16 bits);
+    - message timestamp (48 bits), message stock locate (16 bits).
+*/
+class ITCHIndexEntry
+{
+public:
+    //! Maximal message offset in the indexed capture
+    static constexpr uint64_t MAX_OFFSET = (1ull << 40) - 1;
+
+    ITCHIndexEntry() noexcept : _position(0), _time(0) {}
+    ITCHIndexEntry(uint64_t offset, char type, uint16_t size, uint64_t timestamp, uint16_t stock_locate) noexcept
+        : _position((offset << 24) | ((uint64_t)(uint8_t)type << 16) | size),
+          _time((timestamp << 16) | stock_locate)
+    {}
+    ITCHIndexEntry(const ITCHIndexEntry&) noexcept = default;
+    ITCHIndexEntry(ITCHIndexEntry&&) noexcept = default;
+    ~ITCHIndexEntry() noexcept = default;
+
+    ITCHIndexEntry& operator=(const ITCHIndexEntry&) noexcept = default;
+    ITCHIndexEntry& operator=(ITCHIndexEntry&&) noexcept = default;
+
+    //! Get the message offset in the capture (first byte after the message size)
+    uint64_t Offset() const noexcept { return _position >> 24; }
+    //! Get the message type
+    char Type() const noexcept { return (char)(uint8_t)(_position >> 16); }
+    //! Get the message size
+    uint16_t Size() const noexcept { return (uint16_t)_position; }
+    //! Get the message timestamp (nanoseconds since midnight)
+    uint64_t Timestamp() const noexcept { return _time >> 16; }
+    //! Get the message stock locate (zero for market wide messages)
+    uint16_t StockLocate() const noexcept { return (uint16_t)_time; }
+
+private:
+    uint64_t _position;
+    uint64_t _time;
+};
+
+//! NASDAQ ITCH message index class
+/*!
+    NASDAQ ITCH message index records boundaries, types, timestamps and stock
+    locates of all messages in the ITCH capture with one pass over it. Index
+    could be saved into the compact side file and loaded next time instead of
+    scanning the capture again.
+
+    Symbols never interact in ITCH, so the indexed capture could be replayed
+    in parallel: messages are partitioned by their stock locates across worker
+    threads and each worker processes messages of its stock locates in the
+    capture order with its own ITCH handler (e.g. feeding its own market
+    manager). Market wide messages (stock locate is zero) are passed to all
+    workers.
+
+    Not thread-safe.
+*/
+class ITCHIndex
+{
+public:
+    ITCHIndex() : _capture(0) {}
+    ITCHIndex(const ITCHIndex&) = delete;
+    ITCHIndex(ITCHIndex&&) = default;
+    ~ITCHIndex() = default;
+
+    ITCHIndex& operator=(const ITCHIndex&) = delete;
+    ITCHIndex& operator=(ITCHIndex&&) = default;
+
+    //! Check if the index is empty
+    bool empty() const noexcept { return _entries.empty(); }
+    //! Get the index size
+    size_t size() const noexcept { return _entries.size(); }
+    //! Get the indexed capture size
+    uint64_t capture() const noexcept { return _capture; }
+    //! Get the index entries
+    const std::vector<ITCHIndexEntry>& entries() const noexcept { return _entries; }
+
+    //! Get the index entry by the given index
+    const ITCHIndexEntry& operator[](size_t index) const noexcept { return _entries[index]; }
+
+    //! Build the index of all messages in the given ITCH capture
+    /*!
+        \param buffer - ITCH capture buffer
+        \param size - ITCH capture size
+        \return 'true' if the given capture was successfully indexed, 'false' if the capture is malformed or truncated
+    */
+    bool Build(const void* buffer, size_t size);
+    //! Clear the index
+    void Clear();
+
+    //! Save the index into the given side file
+    /*!
+        Index file is stored in the native byte order.
+
+        \param filename - Index file name
+        \return 'true' if the index was successfully saved, 'false' if the index file write was failed
+    */
+    bool Save(const std::string& filename) const;
+    //! Load the index from the given side file
+    /*!
+        Loaded index entries are validated: each message must lie within the
+        indexed capture after the previous message.
+
+        \param filename - Index file name
+        \return 'true' if the index was successfully loaded, 'false' if the index file is invalid, truncated or corrupted
+    */
+    bool Load(const std::string& filename);
+
+    //! Partition stock locates across the given count of workers
+    /*!
+        Stock locates are assigned to workers balancing the count of indexed
+        messages, the most active stock locates are assigned first.
+
+        \param workers - Count of workers
+        \return Worker of each stock locate (table of 65536 entries)
+    */
+    std::vector<uint16_t> Partition(size_t workers) const;
+
+    //! Split indexed messages between workers of the given partition
+    /*!
+        Messages are split in one pass over the index. Market wide messages
+        are added to every worker.
+
+        \param partition - Worker of each stock locate (table of 65536 entries)
+        \param workers - Count of workers
+        \return Positions of indexed messages of each worker in the capture order
+    */
+    std::vector<std::vector<size_t>> Split(const std::vector<uint16_t>& partition, size_t workers) const;
+
+    //! Replay the indexed ITCH capture in parallel with the given handlers
+    /*!
+        Each handler is called from its own worker thread with messages of its
+        stock locates partition. Messages are split between workers in one pass
+        before the worker threads are started, so each worker reads only its
+        own messages. Handler should provide ProcessMessage() method like
+        ITCHHandler or ITCHParser do.
+
+        \param buffer - Indexed ITCH capture buffer
+        \param size - Indexed ITCH capture size
+        \param handlers - ITCH handlers of workers
+        \return 'true' if all messages were successfully processed, 'false' if the capture does not match the index or some message process was failed
+    */
+    template <class THandler>
+    bool Replay(const void* buffer, size_t size, const std::vector<THandler*>& handlers) const;
+
+private:
+    std::vector<ITCHIndexEntry> _entries;
+    uint64_t _capture;
+};
+
+} // namespace ITCH
+} // namespace CppTrader
+
+#include "itch_index.inl"
+
+#endif // CPPTRADER_ITCH_INDEX_H
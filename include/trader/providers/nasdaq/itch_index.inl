@@ -0,0 +1,53 @@
+/*!
+    \file itch_index.inl
+    \brief NASDAQ ITCH message index inline implementation
+    \author Ivan Shynkarenka
+    \date 09.09.2017
+    \copyright MIT License
+*/
+
+namespace CppTrader {
+namespace ITCH {
+
+template <class THandler>
+inline bool ITCHIndex::Replay(const void* buffer, size_t size, const std::vector<THandler*>& handlers) const
+{
+    // Capture should be the same as indexed one
+    if ((size != _capture) || handlers.empty())
+        return false;
+
+    const uint8_t* data = (const uint8_t*)buffer;
+    std::vector<std::vector<size_t>> messages = Split(Partition(handlers.size()), handlers.size());
+    std::atomic<bool> result(true);
+
+    // Start worker threads
+    std::vector<std::thread> workers;
+    workers.reserve(handlers.size());
+    for (size_t worker = 0; worker < handlers.size(); ++worker)
+    {
+        workers.emplace_back([this, data, worker, &handlers, &messages, &result]()
+        {
+            THandler& handler = *handlers[worker];
+
+            // Process messages of the worker stock locates and market wide messages in the capture order
+            for (size_t position : messages[worker])
+            {
+                const ITCHIndexEntry& entry = _entries[position];
+                if (!handler.ProcessMessage(data + entry.Offset(), entry.Size()) || !result.load(std::memory_order_relaxed))
+                {
+                    result.store(false, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        });
+    }
+
+    // Wait for all worker threads
+    for (auto& worker : workers)
+        worker.join();
+
+    return result;
+}
+
+} // namespace ITCH
+} // namespace CppTrader
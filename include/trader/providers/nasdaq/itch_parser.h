@@ -0,0 +1,122 @@
+/*!
+    \file itch_parser.h
+    \brief NASDAQ ITCH parser definition
+    \author Ivan Shynkarenka
+    \date 07.09.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPTRADER_ITCH_PARSER_H
+#define CPPTRADER_ITCH_PARSER_H
+
+#include "itch_handler.h"
+
+#include <array>
+#include <type_traits>
+#include <utility>
+
+namespace CppTrader {
+namespace ITCH {
+
+//! NASDAQ ITCH parser class
+/*!
+    NASDAQ ITCH parser is used to parse NASDAQ ITCH protocol and pass message
+    views to the handler bound at compile time. Unlike ITCHHandler there are
+    no virtual calls: the message type is dispatched with the dense table of
+    parse functions indexed by the message type byte, and each of them calls
+    the handler overload directly.
+
+    Handler should provide public overloads for required message views:
+    \code
+    struct MyHandler
+    {
+        bool onMessage(const AddOrderMessageView& message) { ... return true; }
+        bool onMessage(const OrderDeleteMessageView& message) { ... return true; }
+    };
+
+    MyHandler handler;
+    ITCHParser<MyHandler> parser(handler);
+    parser.Process(buffer, size);
+    \endcode
+
+    Messages without the handler overload are skipped by their size without
+    any parsing. In filter mode messages of stock locates not passed by the
+    stock locate filter are skipped the same way. Handler result 'false'
+    stops the processing.
+
+    Not thread-safe.
+*/
+template <class THandler>
+class ITCHParser
+{
+public:
+    explicit ITCHParser(THandler& handler) : _handler(handler), _filtered(false) { Reset(); }
+    ITCHParser(const ITCHParser&) = delete;
+    ITCHParser(ITCHParser&&) = delete;
+    ~ITCHParser() = default;
+
+    ITCHParser& operator=(const ITCHParser&) = delete;
+    ITCHParser& operator=(ITCHParser&&) = delete;
+
+    //! Get the ITCH handler
+    THandler& handler() noexcept { return _handler; }
+
+    //! Is the given message view handled?
+    template <class TMessageView>
+    static constexpr bool IsHandled() noexcept { return HasHandler<TMessageView>::value; }
+
+    //! Process all messages from the given buffer in ITCH format and call corresponding handlers
+    /*!
+        \param buffer - Buffer to process
+        \param size - Buffer size
+        \return 'true' if the given buffer was successfully processed, 'false' if the given buffer process was failed
+    */
+    bool Process(const void* buffer, size_t size);
+    //! Process a single message from the given buffer in ITCH format and call corresponding handler
+    /*!
+        \param buffer - Buffer to process
+        \param size - Buffer size
+        \return 'true' if the given buffer was successfully processed, 'false' if the given buffer process was failed
+    */
+    bool ProcessMessage(const void* buffer, size_t size);
+
+    //! Reset ITCH parser
+    void Reset();
+
+    //! Get the stock locate filter
+    const StockLocateFilter& filter() const noexcept { return _filter; }
+    //! Is filter mode enabled?
+    bool IsFilterModeEnabled() const noexcept { return _filtered; }
+    //! Enable filter mode (skip messages of stock locates not passed by the given filter)
+    void EnableFilterMode(const StockLocateFilter& filter) noexcept { _filter = filter; _filtered = true; }
+    //! Disable filter mode (handle messages of all stock locates)
+    void DisableFilterMode() noexcept { _filtered = false; }
+
+private:
+    THandler& _handler;
+    ITCHFramer _framer;
+    bool _filtered;
+    StockLocateFilter _filter;
+
+    // Handler overload detection
+    template <class TMessageView, class = void>
+    struct HasHandler : std::false_type {};
+    template <class TMessageView>
+    struct HasHandler<TMessageView, decltype((void)std::declval<THandler&>().onMessage(std::declval<const TMessageView&>()))> : std::true_type {};
+
+    // Message type dispatch table
+    typedef bool (*ParseFunction)(THandler& handler, const uint8_t* data, size_t size);
+    static constexpr std::array<ParseFunction, 256> CreateDispatchTable();
+    static const std::array<ParseFunction, 256> _dispatch;
+
+    template <class TMessageView>
+    static bool ParseMessage(THandler& handler, const uint8_t* data, size_t size);
+    static bool ParseUnknownMessage(THandler& handler, const uint8_t* data, size_t size);
+};
+
+} // namespace ITCH
+} // namespace CppTrader
+
+#include "itch_parser.inl"
+
+#endif // CPPTRADER_ITCH_PARSER_H
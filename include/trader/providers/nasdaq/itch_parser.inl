@@ -0,0 +1,104 @@
+/*!
+    \file itch_parser.inl
+    \brief NASDAQ ITCH parser inline implementation
+    \author Ivan Shynkarenka
+    \date 07.09.2017
+    \copyright MIT License
+*/
+
+namespace CppTrader {
+namespace ITCH {
+
+template <class THandler>
+const std::array<typename ITCHParser<THandler>::ParseFunction, 256> ITCHParser<THandler>::_dispatch = ITCHParser<THandler>::CreateDispatchTable();
+
+template <class THandler>
+inline bool ITCHParser<THandler>::Process(const void* buffer, size_t size)
+{
+    return _framer.Process(buffer, size, [this](const uint8_t* message, size_t message_size) { return ProcessMessage(message, message_size); });
+}
+
+template <class THandler>
+inline bool ITCHParser<THandler>::ProcessMessage(const void* buffer, size_t size)
+{
+    // Message is empty
+    if (size == 0)
+        return false;
+
+    const uint8_t* data = (const uint8_t*)buffer;
+
+    // Skip the message of the filtered stock locate without parsing
+    if (_filtered && !_filter.Match(data, size))
+        return true;
+
+    return _dispatch[*data](_handler, data, size);
+}
+
+template <class THandler>
+inline void ITCHParser<THandler>::Reset()
+{
+    _framer.Reset();
+}
+
+template <class THandler>
+constexpr std::array<typename ITCHParser<THandler>::ParseFunction, 256> ITCHParser<THandler>::CreateDispatchTable()
+{
+    std::array<ParseFunction, 256> table{};
+    for (size_t i = 0; i < table.size(); ++i)
+        table[i] = &ParseUnknownMessage;
+
+    table[(uint8_t)SystemEventMessageView::TYPE] = &ParseMessage<SystemEventMessageView>;
+    table[(uint8_t)StockDirectoryMessageView::TYPE] = &ParseMessage<StockDirectoryMessageView>;
+    table[(uint8_t)StockTradingActionMessageView::TYPE] = &ParseMessage<StockTradingActionMessageView>;
+    table[(uint8_t)RegSHOMessageView::TYPE] = &ParseMessage<RegSHOMessageView>;
+    table[(uint8_t)MarketParticipantPositionMessageView::TYPE] = &ParseMessage<MarketParticipantPositionMessageView>;
+    table[(uint8_t)MWCBDeclineMessageView::TYPE] = &ParseMessage<MWCBDeclineMessageView>;
+    table[(uint8_t)MWCBStatusMessageView::TYPE] = &ParseMessage<MWCBStatusMessageView>;
+    table[(uint8_t)IPOQuotingMessageView::TYPE] = &ParseMessage<IPOQuotingMessageView>;
+    table[(uint8_t)AddOrderMessageView::TYPE] = &ParseMessage<AddOrderMessageView>;
+    table[(uint8_t)AddOrderMPIDMessageView::TYPE] = &ParseMessage<AddOrderMPIDMessageView>;
+    table[(uint8_t)OrderExecutedMessageView::TYPE] = &ParseMessage<OrderExecutedMessageView>;
+    table[(uint8_t)OrderExecutedWithPriceMessageView::TYPE] = &ParseMessage<OrderExecutedWithPriceMessageView>;
+    table[(uint8_t)OrderCancelMessageView::TYPE] = &ParseMessage<OrderCancelMessageView>;
+    table[(uint8_t)OrderDeleteMessageView::TYPE] = &ParseMessage<OrderDeleteMessageView>;
+    table[(uint8_t)OrderReplaceMessageView::TYPE] = &ParseMessage<OrderReplaceMessageView>;
+    table[(uint8_t)TradeMessageView::TYPE] = &ParseMessage<TradeMessageView>;
+    table[(uint8_t)CrossTradeMessageView::TYPE] = &ParseMessage<CrossTradeMessageView>;
+    table[(uint8_t)BrokenTradeMessageView::TYPE] = &ParseMessage<BrokenTradeMessageView>;
+    table[(uint8_t)NOIIMessageView::TYPE] = &ParseMessage<NOIIMessageView>;
+    table[(uint8_t)RPIIMessageView::TYPE] = &ParseMessage<RPIIMessageView>;
+    table[(uint8_t)LULDAuctionCollarMessageView::TYPE] = &ParseMessage<LULDAuctionCollarMessageView>;
+
+    return table;
+}
+
+template <class THandler>
+template <class TMessageView>
+inline bool ITCHParser<THandler>::ParseMessage(THandler& handler, const uint8_t* data, size_t size)
+{
+    if constexpr (HasHandler<TMessageView>::value)
+    {
+        assert((size == TMessageView::SIZE) && "Invalid size of the ITCH message view!");
+        if (size != TMessageView::SIZE)
+            return false;
+
+        return handler.onMessage(TMessageView(data, size));
+    }
+    else
+    {
+        // Skip the message without the handler
+        return true;
+    }
+}
+
+template <class THandler>
+inline bool ITCHParser<THandler>::ParseUnknownMessage(THandler& handler, const uint8_t* data, size_t size)
+{
+    if constexpr (HasHandler<UnknownMessageView>::value)
+        return handler.onMessage(UnknownMessageView(data, size));
+    else
+        return true;
+}
+
+} // namespace ITCH
+} // namespace CppTrader
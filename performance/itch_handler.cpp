@@ -2,7 +2,8 @@
 // Created by Ivan Shynkarenka on 24.07.2017
 //
 
-#include "trader/providers/nasdaq/itch_handler.h"
+#include "trader/providers/nasdaq/itch_file.h"
+#include "trader/providers/nasdaq/itch_parser.h"
 
 #include "benchmark/reporter_console.h"
 #include "filesystem/file.h"
@@ -49,6 +50,49 @@ protected:
     bool onMessage(const LULDAuctionCollarMessage& message) override { ++_messages; return true; }
     bool onMessage(const UnknownMessage& message) override { ++_errors; return true; }
 
+    bool onMessageView(const SystemEventMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const StockDirectoryMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const StockTradingActionMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const RegSHOMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const MarketParticipantPositionMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const MWCBDeclineMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const MWCBStatusMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const IPOQuotingMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const AddOrderMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const AddOrderMPIDMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const OrderExecutedMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const OrderExecutedWithPriceMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const OrderCancelMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const OrderDeleteMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const OrderReplaceMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const TradeMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const CrossTradeMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const BrokenTradeMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const NOIIMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const RPIIMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const LULDAuctionCollarMessageView& message) override { ++_messages; return true; }
+    bool onMessageView(const UnknownMessageView& message) override { ++_errors; return true; }
+
+private:
+    size_t _messages;
+    size_t _errors;
+};
+
+class MyITCHParserHandler
+{
+public:
+    MyITCHParserHandler()
+        : _messages(0),
+          _errors(0)
+    {}
+
+    size_t messages() const { return _messages; }
+    size_t errors() const { return _errors; }
+
+    template <class TMessageView>
+    bool onMessage(const TMessageView& message) { ++_messages; return true; }
+    bool onMessage(const UnknownMessageView& message) { ++_errors; return true; }
+
 private:
     size_t _messages;
     size_t _errors;
@@ -59,6 +103,9 @@ int main(int argc, char** argv)
     auto parser = optparse::OptionParser().version("1.0.0.0");
 
     parser.add_option("-i", "--input").dest("input").help("Input file name");
+    parser.add_option("-s", "--source").dest("source").help("Input file source: read (buffered reads), mmap (memory-mapped file), populate (prefaulted memory-mapped file), hugepages (memory-mapped file with huge pages)").set_default("read");
+    parser.add_option("-m", "--mode").dest("mode").help("Message processing mode: decode (decoded messages), view (zero-copy message views), parser (statically dispatched message views)").set_default("decode");
+    parser.add_option("-f", "--filter").dest("filter").help("Filter mode: process only messages of the given count of first stock locates (0 to process all messages)").set_default("0");
 
     optparse::Values options = parser.parse_args(argc, argv);
 
@@ -69,15 +116,46 @@ int main(int argc, char** argv)
         return 0;
     }
 
+    std::string mode(options.get("mode"));
+
     MyITCHHandler itch_handler;
+    if (mode == "view")
+        itch_handler.EnableViewMode();
+    MyITCHParserHandler parser_handler;
+    ITCHParser<MyITCHParserHandler> itch_parser(parser_handler);
+    bool parse = (mode == "parser");
+
+    // Setup the stock locate filter
+    int filtered = std::min(std::max((int)options.get("filter"), 0), 65535);
+    if (filtered > 0)
+    {
+        StockLocateFilter filter;
+        for (int i = 1; i <= filtered; ++i)
+            filter.Add((uint16_t)i);
+        itch_handler.EnableFilterMode(filter);
+        itch_parser.EnableFilterMode(filter);
+    }
 
-    // Open the input file or stdin
+    // Open or map the input file or stdin
+    std::string source(options.get("source"));
     std::unique_ptr<Reader> input(new StdInput());
+    ITCHFile mapped;
     if (options.is_set("input"))
     {
-        File* file = new File(Path(options.get("input")));
-        file->Open(true, false);
-        input.reset(file);
+        if (source != "read")
+        {
+            if (!mapped.Open(std::string(options.get("input")), (source == "populate"), (source == "hugepages")))
+            {
+                std::cerr << "Failed to map the input file!" << std::endl;
+                return -1;
+            }
+        }
+        else
+        {
+            File* file = new File(Path(options.get("input")));
+            file->Open(true, false);
+            input.reset(file);
+        }
     }
 
     // Perform input
@@ -85,21 +163,37 @@ int main(int argc, char** argv)
     uint8_t buffer[8192];
     std::cout << "ITCH processing...";
     uint64_t timestamp_start = Timestamp::nano();
-    while ((size = input->Read(buffer, sizeof(buffer))) > 0)
+    if (mapped.IsOpened())
+    {
+        // Process the whole mapped input file
+        if (parse)
+            mapped.Process(itch_parser);
+        else
+            mapped.Process(itch_handler);
+    }
+    else
     {
-        // Process the buffer
-        itch_handler.Process(buffer, size);
+        while ((size = input->Read(buffer, sizeof(buffer))) > 0)
+        {
+            // Process the buffer
+            if (parse)
+                itch_parser.Process(buffer, size);
+            else
+                itch_handler.Process(buffer, size);
+        }
     }
     uint64_t timestamp_stop = Timestamp::nano();
     std::cout << "Done!" << std::endl;
 
     std::cout << std::endl;
 
-    std::cout << "Errors: " << itch_handler.errors() << std::endl;
+    std::cout << "Mode: " << mode << std::endl;
+    std::cout << "Filtered stock locates: " << filtered << std::endl;
+    std::cout << "Errors: " << (parse ? parser_handler.errors() : itch_handler.errors()) << std::endl;
 
     std::cout << std::endl;
 
-    size_t total_messages = itch_handler.messages();
+    size_t total_messages = parse ? parser_handler.messages() : itch_handler.messages();
 
     std::cout << "Processing time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_stop - timestamp_start) << std::endl;
     std::cout << "Total ITCH messages: " << total_messages << std::endl;
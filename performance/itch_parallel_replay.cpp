@@ -0,0 +1,218 @@
+//
+// Created by Ivan Shynkarenka on 09.09.2017
+//
+
+#include "trader/matching/market_manager.h"
+#include "trader/providers/nasdaq/itch_file.h"
+#include "trader/providers/nasdaq/itch_index.h"
+#include "trader/providers/nasdaq/itch_parser.h"
+
+#include "benchmark/reporter_console.h"
+#include "time/timestamp.h"
+
+#include <OptionParser.h>
+
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace CppCommon;
+using namespace CppTrader::ITCH;
+using namespace CppTrader::Matching;
+
+class MyMarketHandler : public MarketHandler
+{
+public:
+    MyMarketHandler()
+        : _updates(0),
+          _orders(0),
+          _max_orders(0),
+          _add_orders(0),
+          _update_orders(0),
+          _delete_orders(0),
+          _execute_orders(0)
+    {}
+
+    size_t updates() const { return _updates; }
+    size_t max_orders() const { return _max_orders; }
+    size_t add_orders() const { return _add_orders; }
+    size_t update_orders() const { return _update_orders; }
+    size_t delete_orders() const { return _delete_orders; }
+    size_t execute_orders() const { return _execute_orders; }
+
+protected:
+    void onAddSymbol(const Symbol& symbol) override { ++_updates; }
+    void onDeleteSymbol(const Symbol& symbol) override { ++_updates; }
+    void onAddOrderBook(const OrderBook& order_book) override { ++_updates; }
+    void onDeleteOrderBook(const OrderBook& order_book) override { ++_updates; }
+    void onAddLevel(const OrderBook& order_book, const Level& level, bool top) override { ++_updates; }
+    void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) override { ++_updates; }
+    void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) override { ++_updates; }
+    void onAddOrder(const Order& order) override { ++_updates; ++_orders; _max_orders = std::max(_orders, _max_orders); ++_add_orders; }
+    void onUpdateOrder(const Order& order) override { ++_updates; ++_update_orders; }
+    void onDeleteOrder(const Order& order) override { ++_updates; --_orders; ++_delete_orders; }
+    void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { ++_updates; ++_execute_orders; }
+
+private:
+    size_t _updates;
+    size_t _orders;
+    size_t _max_orders;
+    size_t _add_orders;
+    size_t _update_orders;
+    size_t _delete_orders;
+    size_t _execute_orders;
+};
+
+class MyITCHHandler
+{
+public:
+    MyITCHHandler(MarketManager& market)
+        : _market(market),
+          _messages(0),
+          _errors(0)
+    {}
+
+    size_t messages() const { return _messages; }
+    size_t errors() const { return _errors; }
+
+    bool onMessage(const StockDirectoryMessageView& message) { ++_messages; Symbol symbol(message.StockLocate(), message.Stock()); _market.AddSymbol(symbol); _market.AddOrderBook(symbol); return true; }
+    bool onMessage(const AddOrderMessageView& message) { ++_messages; _market.AddOrder(Order::Limit(message.OrderReferenceNumber(), message.StockLocate(), (message.BuySellIndicator() == 'B') ? OrderSide::BUY : OrderSide::SELL, message.Price(), message.Shares())); return true; }
+    bool onMessage(const AddOrderMPIDMessageView& message) { ++_messages; _market.AddOrder(Order::Limit(message.OrderReferenceNumber(), message.StockLocate(), (message.BuySellIndicator() == 'B') ? OrderSide::BUY : OrderSide::SELL, message.Price(), message.Shares())); return true; }
+    bool onMessage(const OrderExecutedMessageView& message) { ++_messages; _market.ExecuteOrder(message.OrderReferenceNumber(), message.ExecutedShares()); return true; }
+    bool onMessage(const OrderExecutedWithPriceMessageView& message) { ++_messages; _market.ExecuteOrder(message.OrderReferenceNumber(), message.ExecutionPrice(), message.ExecutedShares()); return true; }
+    bool onMessage(const OrderCancelMessageView& message) { ++_messages; _market.ReduceOrder(message.OrderReferenceNumber(), message.CanceledShares()); return true; }
+    bool onMessage(const OrderDeleteMessageView& message) { ++_messages; _market.DeleteOrder(message.OrderReferenceNumber()); return true; }
+    bool onMessage(const OrderReplaceMessageView& message) { ++_messages; _market.ReplaceOrder(message.OriginalOrderReferenceNumber(), message.NewOrderReferenceNumber(), message.Price(), message.Shares()); return true; }
+    template <class TMessageView>
+    bool onMessage(const TMessageView& message) { ++_messages; return true; }
+    bool onMessage(const UnknownMessageView& message) { ++_errors; return true; }
+
+private:
+    MarketManager& _market;
+    size_t _messages;
+    size_t _errors;
+};
+
+// Replay worker owns its market manager
+struct Worker
+{
+    MyMarketHandler market_handler;
+    MarketManager market;
+    MyITCHHandler itch_handler;
+    ITCHParser<MyITCHHandler> itch_parser;
+
+    Worker() : market(market_handler), itch_handler(market), itch_parser(itch_handler) {}
+};
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-i", "--input").dest("input").help("Input file name");
+    parser.add_option("-x", "--index").dest("index").help("Index file name (default is the input file name with '.idx' suffix)");
+    parser.add_option("-w", "--workers").dest("workers").help("Workers count (default is the count of CPU cores)");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help") || !options.is_set("input"))
+    {
+        parser.print_help();
+        return 0;
+    }
+
+    // Map the input file
+    std::string input(options.get("input"));
+    ITCHFile mapped;
+    if (!mapped.Open(input))
+    {
+        std::cerr << "Failed to map the input file!" << std::endl;
+        return -1;
+    }
+
+    // Load the index file or build and save it
+    std::string index_file = options.is_set("index") ? std::string(options.get("index")) : (input + ".idx");
+    ITCHIndex index;
+    uint64_t timestamp_index = Timestamp::nano();
+    if (!index.Load(index_file) || (index.capture() != mapped.size()))
+    {
+        std::cout << "ITCH indexing...";
+        if (!index.Build(mapped.data(), mapped.size()))
+        {
+            std::cerr << "Failed to index the input file!" << std::endl;
+            return -1;
+        }
+        if (!index.Save(index_file))
+            std::cerr << "Failed to save the index file!" << std::endl;
+        std::cout << "Done!" << std::endl;
+    }
+    timestamp_index = Timestamp::nano() - timestamp_index;
+
+    // Create replay workers
+    size_t workers_count = options.is_set("workers") ? (size_t)std::max((int)options.get("workers"), 1) : (size_t)std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<ITCHParser<MyITCHHandler>*> parsers;
+    for (size_t i = 0; i < workers_count; ++i)
+    {
+        workers.emplace_back(new Worker());
+        parsers.push_back(&workers.back()->itch_parser);
+    }
+
+    // Perform parallel replay
+    std::cout << "ITCH parallel replay...";
+    uint64_t timestamp_start = Timestamp::nano();
+    bool result = index.Replay(mapped.data(), mapped.size(), parsers);
+    uint64_t timestamp_stop = Timestamp::nano();
+    std::cout << (result ? "Done!" : "Failed!") << std::endl;
+
+    std::cout << std::endl;
+
+    size_t errors = 0;
+    size_t total_updates = 0;
+    size_t max_orders = 0;
+    size_t add_orders = 0;
+    size_t update_orders = 0;
+    size_t delete_orders = 0;
+    size_t execute_orders = 0;
+    for (const auto& worker : workers)
+    {
+        errors += worker->itch_handler.errors();
+        total_updates += worker->market_handler.updates();
+        max_orders += worker->market_handler.max_orders();
+        add_orders += worker->market_handler.add_orders();
+        update_orders += worker->market_handler.update_orders();
+        delete_orders += worker->market_handler.delete_orders();
+        execute_orders += worker->market_handler.execute_orders();
+    }
+
+    std::cout << "Errors: " << errors << std::endl;
+
+    std::cout << std::endl;
+
+    size_t total_messages = index.size();
+
+    std::cout << "Workers: " << workers_count << std::endl;
+    std::cout << "Index time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_index) << std::endl;
+    std::cout << "Processing time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_stop - timestamp_start) << std::endl;
+    std::cout << "Total ITCH messages: " << total_messages << std::endl;
+    std::cout << "ITCH message latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod((timestamp_stop - timestamp_start) / total_messages) << std::endl;
+    std::cout << "ITCH message throughput: " << total_messages * 1000000000 / (timestamp_stop - timestamp_start) << " msg/s" << std::endl;
+    std::cout << "Total market updates: " << total_updates << std::endl;
+    std::cout << "Market update latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod((timestamp_stop - timestamp_start) / total_updates) << std::endl;
+    std::cout << "Market update throughput: " << total_updates * 1000000000 / (timestamp_stop - timestamp_start) << " upd/s" << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Market statistics: " << std::endl;
+    std::cout << "Max orders (sum of workers): " << max_orders << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Order statistics: " << std::endl;
+    std::cout << "Add order operations: " << add_orders << std::endl;
+    std::cout << "Update order operations: " << update_orders << std::endl;
+    std::cout << "Delete order operations: " << delete_orders << std::endl;
+    std::cout << "Execute order operations: " << execute_orders << std::endl;
+
+    return result ? 0 : -1;
+}
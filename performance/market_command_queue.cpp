@@ -0,0 +1,240 @@
+//
+// Created by Ivan Shynkarenka on 26.08.2017
+//
+
+#include "trader/matching/market_command.h"
+#include "trader/providers/nasdaq/itch_handler.h"
+
+#include "benchmark/reporter_console.h"
+#include "filesystem/file.h"
+#include "system/stream.h"
+#include "threads/thread.h"
+#include "time/timestamp.h"
+
+#include <OptionParser.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace CppCommon;
+using namespace CppTrader::ITCH;
+using namespace CppTrader::Matching;
+
+class MyMarketHandler : public MarketHandler
+{
+public:
+    MyMarketHandler()
+        : _updates(0),
+          _orders(0),
+          _max_orders(0),
+          _add_orders(0),
+          _update_orders(0),
+          _delete_orders(0),
+          _execute_orders(0)
+    {}
+
+    size_t updates() const { return _updates; }
+    size_t max_orders() const { return _max_orders; }
+    size_t add_orders() const { return _add_orders; }
+    size_t update_orders() const { return _update_orders; }
+    size_t delete_orders() const { return _delete_orders; }
+    size_t execute_orders() const { return _execute_orders; }
+
+protected:
+    void onAddSymbol(const Symbol& symbol) override { ++_updates; }
+    void onDeleteSymbol(const Symbol& symbol) override { ++_updates; }
+    void onAddOrderBook(const OrderBook& order_book) override { ++_updates; }
+    void onDeleteOrderBook(const OrderBook& order_book) override { ++_updates; }
+    void onAddLevel(const OrderBook& order_book, const Level& level, bool top) override { ++_updates; }
+    void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) override { ++_updates; }
+    void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) override { ++_updates; }
+    void onAddOrder(const Order& order) override { ++_updates; ++_orders; _max_orders = std::max(_orders, _max_orders); ++_add_orders; }
+    void onUpdateOrder(const Order& order) override { ++_updates; ++_update_orders; }
+    void onDeleteOrder(const Order& order) override { ++_updates; --_orders; ++_delete_orders; }
+    void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { ++_updates; ++_execute_orders; }
+
+private:
+    size_t _updates;
+    size_t _orders;
+    size_t _max_orders;
+    size_t _add_orders;
+    size_t _update_orders;
+    size_t _delete_orders;
+    size_t _execute_orders;
+};
+
+class MyITCHHandler : public ITCHHandler
+{
+public:
+    MyITCHHandler(MarketCommandQueue& queue)
+        : _queue(queue),
+          _messages(0),
+          _errors(0)
+    {}
+
+    size_t messages() const { return _messages; }
+    size_t errors() const { return _errors; }
+
+protected:
+    bool onMessage(const SystemEventMessage& message) override { ++_messages; return true; }
+    bool onMessage(const StockDirectoryMessage& message) override { ++_messages; Symbol symbol(message.StockLocate, message.Stock); Enqueue(MarketCommand::AddSymbol(symbol)); Enqueue(MarketCommand::AddOrderBook(symbol)); return true; }
+    bool onMessage(const StockTradingActionMessage& message) override { ++_messages; return true; }
+    bool onMessage(const RegSHOMessage& message) override { ++_messages; return true; }
+    bool onMessage(const MarketParticipantPositionMessage& message) override { ++_messages; return true; }
+    bool onMessage(const MWCBDeclineMessage& message) override { ++_messages; return true; }
+    bool onMessage(const MWCBStatusMessage& message) override { ++_messages; return true; }
+    bool onMessage(const IPOQuotingMessage& message) override { ++_messages; return true; }
+    bool onMessage(const AddOrderMessage& message) override { ++_messages; Enqueue(MarketCommand::AddOrder(Order::Limit(message.OrderReferenceNumber, message.StockLocate, (message.BuySellIndicator == 'B') ? OrderSide::BUY : OrderSide::SELL, message.Price, message.Shares))); return true; }
+    bool onMessage(const AddOrderMPIDMessage& message) override { ++_messages; Enqueue(MarketCommand::AddOrder(Order::Limit(message.OrderReferenceNumber, message.StockLocate, (message.BuySellIndicator == 'B') ? OrderSide::BUY : OrderSide::SELL, message.Price, message.Shares))); return true; }
+    bool onMessage(const OrderExecutedMessage& message) override { ++_messages; Enqueue(MarketCommand::ExecuteOrder(message.OrderReferenceNumber, message.ExecutedShares)); return true; }
+    bool onMessage(const OrderExecutedWithPriceMessage& message) override { ++_messages; Enqueue(MarketCommand::ExecuteOrder(message.OrderReferenceNumber, message.ExecutionPrice, message.ExecutedShares)); return true; }
+    bool onMessage(const OrderCancelMessage& message) override { ++_messages; Enqueue(MarketCommand::ReduceOrder(message.OrderReferenceNumber, message.CanceledShares)); return true; }
+    bool onMessage(const OrderDeleteMessage& message) override { ++_messages; Enqueue(MarketCommand::DeleteOrder(message.OrderReferenceNumber)); return true; }
+    bool onMessage(const OrderReplaceMessage& message) override { ++_messages; Enqueue(MarketCommand::ReplaceOrder(message.OriginalOrderReferenceNumber, message.NewOrderReferenceNumber, message.Price, message.Shares)); return true; }
+    bool onMessage(const TradeMessage& message) override { ++_messages; return true; }
+    bool onMessage(const CrossTradeMessage& message) override { ++_messages; return true; }
+    bool onMessage(const BrokenTradeMessage& message) override { ++_messages; return true; }
+    bool onMessage(const NOIIMessage& message) override { ++_messages; return true; }
+    bool onMessage(const RPIIMessage& message) override { ++_messages; return true; }
+    bool onMessage(const LULDAuctionCollarMessage& message) override { ++_messages; return true; }
+    bool onMessage(const UnknownMessage& message) override { ++_errors; return true; }
+
+private:
+    MarketCommandQueue& _queue;
+    size_t _messages;
+    size_t _errors;
+
+    void Enqueue(const MarketCommand& command)
+    {
+        // Wait for the free space in the market command queue
+        while (!_queue.Enqueue(command))
+            Thread::Yield();
+    }
+};
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-i", "--input").dest("input").help("Input file name");
+    parser.add_option("-b", "--batch").dest("batch").help("Batch limit").set_default("1024");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help"))
+    {
+        parser.print_help();
+        return 0;
+    }
+
+    // Open the input file or stdin
+    std::unique_ptr<Reader> input(new StdInput());
+    if (options.is_set("input"))
+    {
+        File* file = new File(Path(options.get("input")));
+        file->Open(true, false);
+        input.reset(file);
+    }
+
+    size_t limit = (size_t)std::max((int)options.get("batch"), 1);
+
+    MyMarketHandler market_handler;
+    MarketManager market(market_handler);
+    MarketCommandQueue queue;
+    MyITCHHandler itch_handler(queue);
+
+    size_t batches = 0;
+    size_t commands = 0;
+    size_t errors = 0;
+    uint64_t batch_time = 0;
+    uint64_t max_batch_time = 0;
+    uint64_t total_latency = 0;
+    uint64_t max_latency = 0;
+
+    // Perform input in the producer thread
+    std::atomic<bool> done(false);
+    std::cout << "ITCH processing...";
+    uint64_t timestamp_start = Timestamp::nano();
+    std::thread producer([&input, &itch_handler, &done]()
+    {
+        size_t size;
+        uint8_t buffer[8192];
+        while ((size = input->Read(buffer, sizeof(buffer))) > 0)
+        {
+            // Process the buffer
+            itch_handler.Process(buffer, size);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    // Drain market commands in the market manager thread
+    for (;;)
+    {
+        bool finished = done.load(std::memory_order_acquire);
+
+        MarketCommandBatch batch = queue.Drain(market, limit);
+        if (batch.Commands > 0)
+        {
+            ++batches;
+            commands += batch.Commands;
+            errors += batch.Errors;
+            batch_time += batch.Time;
+            max_batch_time = std::max(max_batch_time, batch.Time);
+            total_latency += batch.TotalLatency;
+            max_latency = std::max(max_latency, batch.MaxLatency);
+        }
+        else if (finished)
+            break;
+        else
+            Thread::Yield();
+    }
+    producer.join();
+    uint64_t timestamp_stop = Timestamp::nano();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Errors: " << itch_handler.errors() << std::endl;
+
+    std::cout << std::endl;
+
+    size_t total_messages = itch_handler.messages();
+    size_t total_updates = market_handler.updates();
+
+    std::cout << "Processing time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_stop - timestamp_start) << std::endl;
+    std::cout << "Total ITCH messages: " << total_messages << std::endl;
+    std::cout << "ITCH message latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod((timestamp_stop - timestamp_start) / total_messages) << std::endl;
+    std::cout << "ITCH message throughput: " << total_messages * 1000000000 / (timestamp_stop - timestamp_start) << " msg/s" << std::endl;
+    std::cout << "Total market updates: " << total_updates << std::endl;
+    std::cout << "Market update latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod((timestamp_stop - timestamp_start) / total_updates) << std::endl;
+    std::cout << "Market update throughput: " << total_updates * 1000000000 / (timestamp_stop - timestamp_start) << " upd/s" << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Command queue statistics: " << std::endl;
+    std::cout << "Total commands: " << commands << std::endl;
+    std::cout << "Failed commands: " << errors << std::endl;
+    std::cout << "Total batches: " << batches << std::endl;
+    std::cout << "Average batch size: " << (batches > 0 ? commands / batches : 0) << std::endl;
+    std::cout << "Average batch time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(batches > 0 ? batch_time / batches : 0) << std::endl;
+    std::cout << "Max batch time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(max_batch_time) << std::endl;
+    std::cout << "Command execution latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(commands > 0 ? batch_time / commands : 0) << std::endl;
+    std::cout << "Average queueing latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(commands > 0 ? total_latency / commands : 0) << std::endl;
+    std::cout << "Max queueing latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(max_latency) << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Market statistics: " << std::endl;
+    std::cout << "Max orders: " << market_handler.max_orders() << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Order statistics: " << std::endl;
+    std::cout << "Add order operations: " << market_handler.add_orders() << std::endl;
+    std::cout << "Update order operations: " << market_handler.update_orders() << std::endl;
+    std::cout << "Delete order operations: " << market_handler.delete_orders() << std::endl;
+    std::cout << "Execute order operations: " << market_handler.execute_orders() << std::endl;
+
+    return 0;
+}
@@ -2,7 +2,9 @@
 // Created by Ivan Shynkarenka on 05.08.2017
 //
 
+#include "trader/matching/market_event_buffer.h"
 #include "trader/matching/market_manager.h"
+#include "trader/providers/nasdaq/itch_file.h"
 #include "trader/providers/nasdaq/itch_handler.h"
 
 #include "benchmark/reporter_console.h"
@@ -12,12 +14,30 @@
 
 #include <OptionParser.h>
 
+#include <algorithm>
+
 using namespace CppCommon;
 using namespace CppTrader::ITCH;
 using namespace CppTrader::Matching;
 
-class MyMarketHandler : public MarketHandler
+// ITCH prices have four decimal places, so one cent tick is 100
+template <class TLevelNode>
+using LevelsLadderCent = BasicLevelsLadder<TLevelNode, 100>;
+
+// Counting market handler is dispatched virtually with MarketHandlerT base
+// and statically with NullMarketHandlerT base
+template <class TTraits, class TBase = MarketHandlerT<TTraits>>
+class MyMarketHandler : public TBase
 {
+    template <class, class>
+    friend class CppTrader::Matching::MarketManagerT;
+
+    typedef typename TBase::PriceType PriceType;
+    typedef typename TBase::QuantityType QuantityType;
+    typedef typename TBase::Order Order;
+    typedef typename TBase::Level Level;
+    typedef OrderBookT<TTraits> OrderBook;
+
 public:
     MyMarketHandler()
         : _updates(0),
@@ -47,18 +67,18 @@ public:
     size_t execute_orders() const { return _execute_orders; }
 
 protected:
-    void onAddSymbol(const Symbol& symbol) override { ++_updates; ++_symbols; _max_symbols = std::max(_symbols, _max_symbols); }
-    void onDeleteSymbol(const Symbol& symbol) override { ++_updates; --_symbols; }
-    void onAddOrderBook(const OrderBook& order_book) override { ++_updates; ++_order_books; _max_order_books = std::max(_order_books, _max_order_books); }
-    void onUpdateOrderBook(const OrderBook& order_book, bool top) override { _max_order_book_levels = std::max(std::max(order_book.bids().size(), order_book.asks().size()), _max_order_book_levels); }
-    void onDeleteOrderBook(const OrderBook& order_book) override { ++_updates; --_order_books; }
-    void onAddLevel(const OrderBook& order_book, const Level& level, bool top) override { ++_updates; }
-    void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) override { ++_updates; _max_order_book_orders = std::max(level.Orders, _max_order_book_orders); }
-    void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) override { ++_updates; }
-    void onAddOrder(const Order& order) override { ++_updates; ++_orders; _max_orders = std::max(_orders, _max_orders); ++_add_orders; }
-    void onUpdateOrder(const Order& order) override { ++_updates; ++_update_orders; }
-    void onDeleteOrder(const Order& order) override { ++_updates; --_orders; ++_delete_orders; }
-    void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { ++_updates; ++_execute_orders; }
+    void onAddSymbol(const Symbol& symbol) { ++_updates; ++_symbols; _max_symbols = std::max(_symbols, _max_symbols); }
+    void onDeleteSymbol(const Symbol& symbol) { ++_updates; --_symbols; }
+    void onAddOrderBook(const OrderBook& order_book) { ++_updates; ++_order_books; _max_order_books = std::max(_order_books, _max_order_books); }
+    void onUpdateOrderBook(const OrderBook& order_book, bool top) { _max_order_book_levels = std::max(std::max(order_book.bids().size(), order_book.asks().size()), _max_order_book_levels); }
+    void onDeleteOrderBook(const OrderBook& order_book) { ++_updates; --_order_books; }
+    void onAddLevel(const OrderBook& order_book, const Level& level, bool top) { ++_updates; }
+    void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) { ++_updates; _max_order_book_orders = std::max(level.Orders, _max_order_book_orders); }
+    void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) { ++_updates; }
+    void onAddOrder(const Order& order) { ++_updates; ++_orders; _max_orders = std::max(_orders, _max_orders); ++_add_orders; }
+    void onUpdateOrder(const Order& order) { ++_updates; ++_update_orders; }
+    void onDeleteOrder(const Order& order) { ++_updates; --_orders; ++_delete_orders; }
+    void onExecuteOrder(const Order& order, PriceType price, QuantityType quantity) { ++_updates; ++_execute_orders; }
 
 private:
     size_t _updates;
@@ -76,10 +96,42 @@ private:
     size_t _execute_orders;
 };
 
+// Market event buffer is drained after each input chunk
+template <class TTraits>
+class MyMarketEventBuffer : public MarketEventBufferT<TTraits>
+{
+public:
+    MyMarketEventBuffer()
+        : MarketEventBufferT<TTraits>(_arena, sizeof(_arena)),
+          _updates(0),
+          _lost(0)
+    {}
+
+    size_t updates() const { return _updates; }
+    size_t lost() const { return _lost; }
+
+    void Flush()
+    {
+        _lost += this->lost();
+        _updates += this->Drain([](const MarketEvent& event) {});
+    }
+
+private:
+    alignas(8) static uint8_t _arena[1024 * 1024];
+    size_t _updates;
+    size_t _lost;
+};
+
+template <class TTraits>
+alignas(8) uint8_t MyMarketEventBuffer<TTraits>::_arena[1024 * 1024];
+
+template <class TTraits, class THandler>
 class MyITCHHandler : public ITCHHandler
 {
+    typedef typename MarketManagerT<TTraits, THandler>::Order Order;
+
 public:
-    MyITCHHandler(MarketManager& market)
+    MyITCHHandler(MarketManagerT<TTraits, THandler>& market)
         : _market(market),
           _messages(0),
           _errors(0)
@@ -113,48 +165,114 @@ protected:
     bool onMessage(const UnknownMessage& message) override { ++_errors; return true; }
 
 private:
-    MarketManager& _market;
+    MarketManagerT<TTraits, THandler>& _market;
     size_t _messages;
     size_t _errors;
 };
 
-int main(int argc, char** argv)
+template <class TTraits, class TBase>
+void PrintStatistics(const MyMarketHandler<TTraits, TBase>& market_handler, uint64_t duration)
 {
-    auto parser = optparse::OptionParser().version("1.0.0.0");
+    size_t total_updates = market_handler.updates();
 
-    parser.add_option("-i", "--input").dest("input").help("Input file name");
+    std::cout << "Total market updates: " << total_updates << std::endl;
+    std::cout << "Market update latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(duration / total_updates) << std::endl;
+    std::cout << "Market update throughput: " << total_updates * 1000000000 / duration << " upd/s" << std::endl;
 
-    optparse::Values options = parser.parse_args(argc, argv);
+    std::cout << std::endl;
 
-    // Print help
-    if (options.get("help"))
-    {
-        parser.print_help();
-        return 0;
-    }
+    std::cout << "Market statistics: " << std::endl;
+    std::cout << "Max symbols: " << market_handler.max_symbols() << std::endl;
+    std::cout << "Max order books: " << market_handler.max_order_books() << std::endl;
+    std::cout << "Max order book levels: " << market_handler.max_order_book_levels() << std::endl;
+    std::cout << "Max order book orders: " << market_handler.max_order_book_orders() << std::endl;
+    std::cout << "Max orders: " << market_handler.max_orders() << std::endl;
 
-    MyMarketHandler market_handler;
-    MarketManager market(market_handler);
-    MyITCHHandler itch_handler(market);
+    std::cout << std::endl;
 
-    // Open the input file or stdin
-    std::unique_ptr<Reader> input(new StdInput());
-    if (options.is_set("input"))
-    {
-        File* file = new File(Path(options.get("input")));
-        file->Open(true, false);
-        input.reset(file);
-    }
+    std::cout << "Order statistics: " << std::endl;
+    std::cout << "Add order operations: " << market_handler.add_orders() << std::endl;
+    std::cout << "Update order operations: " << market_handler.update_orders() << std::endl;
+    std::cout << "Delete order operations: " << market_handler.delete_orders() << std::endl;
+    std::cout << "Execute order operations: " << market_handler.execute_orders() << std::endl;
+}
+
+template <class TTraits>
+void PrintStatistics(const NullMarketHandlerT<TTraits>& market_handler, uint64_t duration)
+{
+    // No-op market handler does not collect market statistics
+}
+
+template <class TTraits>
+void PrintStatistics(const MyMarketEventBuffer<TTraits>& market_handler, uint64_t duration)
+{
+    size_t total_updates = market_handler.updates();
+
+    std::cout << "Total market updates: " << total_updates << std::endl;
+    std::cout << "Lost market updates: " << market_handler.lost() << std::endl;
+    std::cout << "Market update latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(duration / total_updates) << std::endl;
+    std::cout << "Market update throughput: " << total_updates * 1000000000 / duration << " upd/s" << std::endl;
+}
+
+template <class THandler>
+void Flush(THandler& market_handler)
+{
+    // Market handlers are notified with per-event callbacks
+}
+
+template <class TTraits>
+void Flush(MyMarketEventBuffer<TTraits>& market_handler)
+{
+    market_handler.Flush();
+}
+
+// Mapped input file is processed at once unless market events are buffered
+template <class THandler>
+size_t ChunkSize(const THandler& market_handler, size_t size)
+{
+    return size;
+}
+
+template <class TTraits>
+size_t ChunkSize(const MyMarketEventBuffer<TTraits>& market_handler, size_t size)
+{
+    return 8192;
+}
+
+template <class TTraits, class THandler, class TMarketHandler = THandler>
+void Process(Reader& input, const ITCHFile& mapped)
+{
+    THandler market_handler;
+    MarketManagerT<TTraits, TMarketHandler> market(market_handler);
+    MyITCHHandler<TTraits, TMarketHandler> itch_handler(market);
 
     // Perform input
     size_t size;
     uint8_t buffer[8192];
     std::cout << "ITCH processing...";
     uint64_t timestamp_start = Timestamp::nano();
-    while ((size = input->Read(buffer, sizeof(buffer))) > 0)
+    if (mapped.IsOpened())
+    {
+        // Process the mapped input file directly from the memory
+        size_t chunk = ChunkSize(market_handler, mapped.size());
+        for (size_t offset = 0; offset < mapped.size(); offset += chunk)
+        {
+            itch_handler.Process(mapped.data() + offset, std::min(chunk, mapped.size() - offset));
+
+            // Flush buffered market events
+            Flush(market_handler);
+        }
+    }
+    else
     {
-        // Process the buffer
-        itch_handler.Process(buffer, size);
+        while ((size = input.Read(buffer, sizeof(buffer))) > 0)
+        {
+            // Process the buffer
+            itch_handler.Process(buffer, size);
+
+            // Flush buffered market events
+            Flush(market_handler);
+        }
     }
     uint64_t timestamp_stop = Timestamp::nano();
     std::cout << "Done!" << std::endl;
@@ -166,32 +284,102 @@ int main(int argc, char** argv)
     std::cout << std::endl;
 
     size_t total_messages = itch_handler.messages();
-    size_t total_updates = market_handler.updates();
 
     std::cout << "Processing time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_stop - timestamp_start) << std::endl;
     std::cout << "Total ITCH messages: " << total_messages << std::endl;
     std::cout << "ITCH message latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod((timestamp_stop - timestamp_start) / total_messages) << std::endl;
     std::cout << "ITCH message throughput: " << total_messages * 1000000000 / (timestamp_stop - timestamp_start) << " msg/s" << std::endl;
-    std::cout << "Total market updates: " << total_updates << std::endl;
-    std::cout << "Market update latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod((timestamp_stop - timestamp_start) / total_updates) << std::endl;
-    std::cout << "Market update throughput: " << total_updates * 1000000000 / (timestamp_stop - timestamp_start) << " upd/s" << std::endl;
 
-    std::cout << std::endl;
+    PrintStatistics(market_handler, timestamp_stop - timestamp_start);
+}
 
-    std::cout << "Market statistics: " << std::endl;
-    std::cout << "Max symbols: " << market_handler.max_symbols() << std::endl;
-    std::cout << "Max order books: " << market_handler.max_order_books() << std::endl;
-    std::cout << "Max order book levels: " << market_handler.max_order_book_levels() << std::endl;
-    std::cout << "Max order book orders: " << market_handler.max_order_book_orders() << std::endl;
-    std::cout << "Max orders: " << market_handler.max_orders() << std::endl;
+template <class TTraits>
+void ProcessHandler(Reader& input, const ITCHFile& mapped, const std::string& handler)
+{
+    if (handler == "static")
+        Process<TTraits, MyMarketHandler<TTraits, NullMarketHandlerT<TTraits>>>(input, mapped);
+    else if (handler == "null")
+        Process<TTraits, NullMarketHandlerT<TTraits>>(input, mapped);
+    else if (handler == "buffer")
+        Process<TTraits, MyMarketEventBuffer<TTraits>>(input, mapped);
+    else
+        Process<TTraits, MyMarketHandler<TTraits>, MarketHandlerT<TTraits>>(input, mapped);
+}
 
-    std::cout << std::endl;
+template <template <class> class TLevels, typename TPrice, typename TQuantity>
+void ProcessLevels(Reader& input, const ITCHFile& mapped, const std::string& orders, const std::string& handler)
+{
+    if (orders == "paged")
+        ProcessHandler<MarketTraits<TLevels, OrdersPaged, TPrice, TQuantity>>(input, mapped, handler);
+    else
+        ProcessHandler<MarketTraits<TLevels, OrdersHash, TPrice, TQuantity>>(input, mapped, handler);
+}
 
-    std::cout << "Order statistics: " << std::endl;
-    std::cout << "Add order operations: " << market_handler.add_orders() << std::endl;
-    std::cout << "Update order operations: " << market_handler.update_orders() << std::endl;
-    std::cout << "Delete order operations: " << market_handler.delete_orders() << std::endl;
-    std::cout << "Execute order operations: " << market_handler.execute_orders() << std::endl;
+template <typename TPrice, typename TQuantity>
+void ProcessWidth(Reader& input, const ITCHFile& mapped, const std::string& levels, const std::string& orders, const std::string& handler)
+{
+    if (levels == "vector")
+        ProcessLevels<LevelsVector, TPrice, TQuantity>(input, mapped, orders, handler);
+    else if (levels == "ladder")
+        ProcessLevels<LevelsLadderCent, TPrice, TQuantity>(input, mapped, orders, handler);
+    else if (levels == "btree")
+        ProcessLevels<LevelsBTree, TPrice, TQuantity>(input, mapped, orders, handler);
+    else
+        ProcessLevels<LevelsAVL, TPrice, TQuantity>(input, mapped, orders, handler);
+}
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-i", "--input").dest("input").help("Input file name");
+    parser.add_option("-s", "--source").dest("source").help("Input file source: read (buffered reads), mmap (memory-mapped file), populate (prefaulted memory-mapped file), hugepages (memory-mapped file with huge pages)").set_default("read");
+    parser.add_option("-l", "--levels").dest("levels").help("Price levels container: avl, vector, ladder, btree").set_default("avl");
+    parser.add_option("-o", "--orders").dest("orders").help("Orders container: hash, paged").set_default("hash");
+    parser.add_option("-w", "--width").dest("width").help("Price and quantity width in bits: 64, 32").set_default("64");
+    parser.add_option("-m", "--handler").dest("handler").help("Market handler: virtual (counting), static (counting), null (no-op), buffer (batched events)").set_default("virtual");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help"))
+    {
+        parser.print_help();
+        return 0;
+    }
+
+    // Open or map the input file or stdin
+    std::string source(options.get("source"));
+    std::unique_ptr<Reader> input(new StdInput());
+    ITCHFile mapped;
+    if (options.is_set("input"))
+    {
+        if (source != "read")
+        {
+            if (!mapped.Open(std::string(options.get("input")), (source == "populate"), (source == "hugepages")))
+            {
+                std::cerr << "Failed to map the input file!" << std::endl;
+                return -1;
+            }
+        }
+        else
+        {
+            File* file = new File(Path(options.get("input")));
+            file->Open(true, false);
+            input.reset(file);
+        }
+    }
+
+    // Process the input with the selected price levels and orders containers.
+    // ITCH prices and shares are 32-bit, so narrow prices and quantities are enough.
+    std::string levels(options.get("levels"));
+    std::string orders(options.get("orders"));
+    std::string width(options.get("width"));
+    std::string handler(options.get("handler"));
+    if (width == "32")
+        ProcessWidth<uint32_t, uint32_t>(*input, mapped, levels, orders, handler);
+    else
+        ProcessWidth<uint64_t, uint64_t>(*input, mapped, levels, orders, handler);
 
     return 0;
 }
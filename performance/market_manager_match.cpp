@@ -0,0 +1,103 @@
+//
+// Created by Ivan Shynkarenka on 03.09.2017
+//
+
+#include "trader/matching/market_manager.h"
+
+#include "benchmark/reporter_console.h"
+#include "time/timestamp.h"
+
+#include <OptionParser.h>
+
+#include <iostream>
+
+using namespace CppCommon;
+using namespace CppTrader::Matching;
+
+class MyMarketHandler : public MarketHandler
+{
+public:
+    MyMarketHandler()
+        : _execute_orders(0)
+    {}
+
+    size_t execute_orders() const { return _execute_orders; }
+
+protected:
+    void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { ++_execute_orders; }
+
+private:
+    size_t _execute_orders;
+};
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-b", "--books").dest("books").help("Count of order books").set_default("100000");
+    parser.add_option("-a", "--active").dest("active").help("Count of active order books between manual matchings").set_default("16");
+    parser.add_option("-r", "--rounds").dest("rounds").help("Count of manual matching rounds").set_default("100000");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help"))
+    {
+        parser.print_help();
+        return 0;
+    }
+
+    uint32_t books = (uint32_t)std::max((int)options.get("books"), 1);
+    size_t active = (size_t)std::max((int)options.get("active"), 1);
+    size_t rounds = (size_t)std::max((int)options.get("rounds"), 1);
+
+    MyMarketHandler market_handler;
+    MarketManager market(market_handler);
+
+    // Prepare symbols & order books
+    std::cout << "Order books preparing...";
+    const char name[8] = "test";
+    for (uint32_t i = 0; i < books; ++i)
+    {
+        Symbol symbol = { i, name };
+        market.AddSymbol(symbol);
+        market.AddOrderBook(symbol);
+    }
+    std::cout << "Done!" << std::endl;
+
+    uint64_t seed = 1;
+    auto random = [&seed](uint64_t range) { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return (seed >> 33) % range; };
+
+    // Cross few random order books and match them manually in each round
+    uint64_t id = 0;
+    uint64_t match_time = 0;
+    std::cout << "Manual matching...";
+    uint64_t timestamp_start = Timestamp::nano();
+    for (size_t i = 0; i < rounds; ++i)
+    {
+        for (size_t j = 0; j < active; ++j)
+        {
+            uint32_t book = (uint32_t)random(books);
+            market.AddOrder(Order::BuyLimit(++id, book, 100, 10));
+            market.AddOrder(Order::SellLimit(++id, book, 100, 10));
+        }
+
+        uint64_t timestamp = Timestamp::nano();
+        market.Match();
+        match_time += Timestamp::nano() - timestamp;
+    }
+    uint64_t timestamp_stop = Timestamp::nano();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Order books: " << books << std::endl;
+    std::cout << "Active order books per round: " << active << std::endl;
+    std::cout << "Processing time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_stop - timestamp_start) << std::endl;
+    std::cout << "Total manual matchings: " << rounds << std::endl;
+    std::cout << "Manual matching latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(match_time / rounds) << std::endl;
+    std::cout << "Manual matching throughput: " << rounds * 1000000000 / std::max(match_time, (uint64_t)1) << " ops/s" << std::endl;
+    std::cout << "Execute order operations: " << market_handler.execute_orders() << std::endl;
+
+    return 0;
+}
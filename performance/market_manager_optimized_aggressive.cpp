@@ -2,6 +2,7 @@
 // Created by Ivan Shynkarenka on 12.08.2017
 //
 
+#include "trader/providers/nasdaq/itch_file.h"
 #include "trader/providers/nasdaq/itch_handler.h"
 
 #include "benchmark/reporter_console.h"
@@ -407,6 +408,7 @@ int main(int argc, char** argv)
     auto parser = optparse::OptionParser().version("1.0.0.0");
 
     parser.add_option("-i", "--input").dest("input").help("Input file name");
+    parser.add_option("-s", "--source").dest("source").help("Input file source: read (buffered reads), mmap (memory-mapped file), populate (prefaulted memory-mapped file), hugepages (memory-mapped file with huge pages)").set_default("read");
 
     optparse::Values options = parser.parse_args(argc, argv);
 
@@ -420,13 +422,26 @@ int main(int argc, char** argv)
     MarketManagerOptimized market;
     MyITCHHandler itch_handler(market);
 
-    // Open the input file or stdin
+    // Open or map the input file or stdin
+    std::string source(options.get("source"));
     std::unique_ptr<Reader> input(new StdInput());
+    ITCHFile mapped;
     if (options.is_set("input"))
     {
-        File* file = new File(Path(options.get("input")));
-        file->Open(true, false);
-        input.reset(file);
+        if (source != "read")
+        {
+            if (!mapped.Open(std::string(options.get("input")), (source == "populate"), (source == "hugepages")))
+            {
+                std::cerr << "Failed to map the input file!" << std::endl;
+                return -1;
+            }
+        }
+        else
+        {
+            File* file = new File(Path(options.get("input")));
+            file->Open(true, false);
+            input.reset(file);
+        }
     }
 
     // Perform input
@@ -434,10 +449,18 @@ int main(int argc, char** argv)
     uint8_t buffer[8192];
     std::cout << "ITCH processing...";
     uint64_t timestamp_start = Timestamp::nano();
-    while ((size = input->Read(buffer, sizeof(buffer))) > 0)
+    if (mapped.IsOpened())
+    {
+        // Process the whole mapped input file
+        mapped.Process(itch_handler);
+    }
+    else
     {
-        // Process the buffer
-        itch_handler.Process(buffer, size);
+        while ((size = input->Read(buffer, sizeof(buffer))) > 0)
+        {
+            // Process the buffer
+            itch_handler.Process(buffer, size);
+        }
     }
     uint64_t timestamp_stop = Timestamp::nano();
     std::cout << "Done!" << std::endl;
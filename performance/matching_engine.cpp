@@ -2,7 +2,7 @@
 // Created by Ivan Shynkarenka on 16.08.2017
 //
 
-#include "trader/matching/market_manager.h"
+#include "trader/matching/market_command.h"
 #include "trader/providers/nasdaq/itch_handler.h"
 
 #include "benchmark/reporter_console.h"
@@ -12,6 +12,8 @@
 
 #include <OptionParser.h>
 
+#include <vector>
+
 using namespace CppCommon;
 using namespace CppTrader::ITCH;
 using namespace CppTrader::Matching;
@@ -79,31 +81,41 @@ private:
 class MyITCHHandler : public ITCHHandler
 {
 public:
-    explicit MyITCHHandler(MarketManager& market)
+    MyITCHHandler(MarketManager& market, size_t batch)
         : _market(market),
+          _batch(batch),
           _messages(0),
           _errors(0)
-    {}
+    {
+        _commands.reserve(batch);
+    }
 
     size_t messages() const { return _messages; }
     size_t errors() const { return _errors; }
 
+    // Apply the pending batch of market commands
+    void Flush()
+    {
+        _market.ApplyBatch(_commands.data(), _commands.size());
+        _commands.clear();
+    }
+
 protected:
     bool onMessage(const SystemEventMessage& message) override { ++_messages; return true; }
-    bool onMessage(const StockDirectoryMessage& message) override { ++_messages; Symbol symbol(message.StockLocate, message.Stock); _market.AddSymbol(symbol); _market.AddOrderBook(symbol); return true; }
+    bool onMessage(const StockDirectoryMessage& message) override { ++_messages; Symbol symbol(message.StockLocate, message.Stock); Apply(MarketCommand::AddSymbol(symbol)); Apply(MarketCommand::AddOrderBook(symbol)); return true; }
     bool onMessage(const StockTradingActionMessage& message) override { ++_messages; return true; }
     bool onMessage(const RegSHOMessage& message) override { ++_messages; return true; }
     bool onMessage(const MarketParticipantPositionMessage& message) override { ++_messages; return true; }
     bool onMessage(const MWCBDeclineMessage& message) override { ++_messages; return true; }
     bool onMessage(const MWCBStatusMessage& message) override { ++_messages; return true; }
     bool onMessage(const IPOQuotingMessage& message) override { ++_messages; return true; }
-    bool onMessage(const AddOrderMessage& message) override { ++_messages; _market.AddOrder(Order::Limit(message.OrderReferenceNumber, message.StockLocate, (message.BuySellIndicator == 'B') ? OrderSide::BUY : OrderSide::SELL, message.Price, message.Shares)); return true; }
-    bool onMessage(const AddOrderMPIDMessage& message) override { ++_messages; _market.AddOrder(Order::Limit(message.OrderReferenceNumber, message.StockLocate, (message.BuySellIndicator == 'B') ? OrderSide::BUY : OrderSide::SELL, message.Price, message.Shares)); return true; }
+    bool onMessage(const AddOrderMessage& message) override { ++_messages; Apply(MarketCommand::AddOrder(Order::Limit(message.OrderReferenceNumber, message.StockLocate, (message.BuySellIndicator == 'B') ? OrderSide::BUY : OrderSide::SELL, message.Price, message.Shares))); return true; }
+    bool onMessage(const AddOrderMPIDMessage& message) override { ++_messages; Apply(MarketCommand::AddOrder(Order::Limit(message.OrderReferenceNumber, message.StockLocate, (message.BuySellIndicator == 'B') ? OrderSide::BUY : OrderSide::SELL, message.Price, message.Shares))); return true; }
     bool onMessage(const OrderExecutedMessage& message) override { ++_messages; return true; }
     bool onMessage(const OrderExecutedWithPriceMessage& message) override { ++_messages; return true; }
-    bool onMessage(const OrderCancelMessage& message) override { ++_messages; _market.ReduceOrder(message.OrderReferenceNumber, message.CanceledShares); return true; }
-    bool onMessage(const OrderDeleteMessage& message) override { ++_messages; _market.DeleteOrder(message.OrderReferenceNumber); return true; }
-    bool onMessage(const OrderReplaceMessage& message) override { ++_messages; _market.ReplaceOrder(message.OriginalOrderReferenceNumber, message.NewOrderReferenceNumber, message.Price, message.Shares); return true; }
+    bool onMessage(const OrderCancelMessage& message) override { ++_messages; Apply(MarketCommand::ReduceOrder(message.OrderReferenceNumber, message.CanceledShares)); return true; }
+    bool onMessage(const OrderDeleteMessage& message) override { ++_messages; Apply(MarketCommand::DeleteOrder(message.OrderReferenceNumber)); return true; }
+    bool onMessage(const OrderReplaceMessage& message) override { ++_messages; Apply(MarketCommand::ReplaceOrder(message.OriginalOrderReferenceNumber, message.NewOrderReferenceNumber, message.Price, message.Shares)); return true; }
     bool onMessage(const TradeMessage& message) override { ++_messages; return true; }
     bool onMessage(const CrossTradeMessage& message) override { ++_messages; return true; }
     bool onMessage(const BrokenTradeMessage& message) override { ++_messages; return true; }
@@ -114,8 +126,25 @@ protected:
 
 private:
     MarketManager& _market;
+    size_t _batch;
+    std::vector<MarketCommand> _commands;
     size_t _messages;
     size_t _errors;
+
+    void Apply(const MarketCommand& command)
+    {
+        // Apply the market command immediately without batching
+        if (_batch == 0)
+        {
+            command.Execute(_market);
+            return;
+        }
+
+        // Apply market commands with deferred matching in batches
+        _commands.push_back(command);
+        if (_commands.size() >= _batch)
+            Flush();
+    }
 };
 
 int main(int argc, char** argv)
@@ -123,6 +152,7 @@ int main(int argc, char** argv)
     auto parser = optparse::OptionParser().version("1.0.0.0");
 
     parser.add_option("-i", "--input").dest("input").help("Input file name");
+    parser.add_option("-b", "--batch").dest("batch").help("Market commands batch size with deferred matching (0 - no batching)").set_default("0");
 
     optparse::Values options = parser.parse_args(argc, argv);
 
@@ -135,7 +165,7 @@ int main(int argc, char** argv)
 
     MyMarketHandler market_handler;
     MarketManager market(market_handler);
-    MyITCHHandler itch_handler(market);
+    MyITCHHandler itch_handler(market, (size_t)std::max((int)options.get("batch"), 0));
 
     // Enable automatic matching
     market.EnableMatching();
@@ -159,6 +189,7 @@ int main(int argc, char** argv)
         // Process the buffer
         itch_handler.Process(buffer, size);
     }
+    itch_handler.Flush();
     uint64_t timestamp_stop = Timestamp::nano();
     std::cout << "Done!" << std::endl;
 
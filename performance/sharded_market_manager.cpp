@@ -0,0 +1,199 @@
+//
+// Created by Ivan Shynkarenka on 25.08.2017
+//
+
+#include "trader/matching/sharded_market_manager.h"
+#include "trader/providers/nasdaq/itch_handler.h"
+
+#include "benchmark/reporter_console.h"
+#include "filesystem/file.h"
+#include "system/stream.h"
+#include "time/timestamp.h"
+
+#include <OptionParser.h>
+
+using namespace CppCommon;
+using namespace CppTrader::ITCH;
+using namespace CppTrader::Matching;
+
+class MyMarketHandler : public MarketHandler
+{
+public:
+    MyMarketHandler()
+        : _updates(0),
+          _orders(0),
+          _max_orders(0),
+          _add_orders(0),
+          _update_orders(0),
+          _delete_orders(0),
+          _execute_orders(0)
+    {}
+
+    size_t updates() const { return _updates; }
+    size_t max_orders() const { return _max_orders; }
+    size_t add_orders() const { return _add_orders; }
+    size_t update_orders() const { return _update_orders; }
+    size_t delete_orders() const { return _delete_orders; }
+    size_t execute_orders() const { return _execute_orders; }
+
+protected:
+    void onAddSymbol(const Symbol& symbol) override { ++_updates; }
+    void onDeleteSymbol(const Symbol& symbol) override { ++_updates; }
+    void onAddOrderBook(const OrderBook& order_book) override { ++_updates; }
+    void onDeleteOrderBook(const OrderBook& order_book) override { ++_updates; }
+    void onAddLevel(const OrderBook& order_book, const Level& level, bool top) override { ++_updates; }
+    void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) override { ++_updates; }
+    void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) override { ++_updates; }
+    void onAddOrder(const Order& order) override { ++_updates; ++_orders; _max_orders = std::max(_orders, _max_orders); ++_add_orders; }
+    void onUpdateOrder(const Order& order) override { ++_updates; ++_update_orders; }
+    void onDeleteOrder(const Order& order) override { ++_updates; --_orders; ++_delete_orders; }
+    void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { ++_updates; ++_execute_orders; }
+
+private:
+    size_t _updates;
+    size_t _orders;
+    size_t _max_orders;
+    size_t _add_orders;
+    size_t _update_orders;
+    size_t _delete_orders;
+    size_t _execute_orders;
+};
+
+class MyITCHHandler : public ITCHHandler
+{
+public:
+    MyITCHHandler(ShardedMarketManager& market)
+        : _market(market),
+          _messages(0),
+          _errors(0)
+    {}
+
+    size_t messages() const { return _messages; }
+    size_t errors() const { return _errors; }
+
+protected:
+    bool onMessage(const SystemEventMessage& message) override { ++_messages; return true; }
+    bool onMessage(const StockDirectoryMessage& message) override { ++_messages; Symbol symbol(message.StockLocate, message.Stock); _market.AddSymbol(symbol); _market.AddOrderBook(symbol); return true; }
+    bool onMessage(const StockTradingActionMessage& message) override { ++_messages; return true; }
+    bool onMessage(const RegSHOMessage& message) override { ++_messages; return true; }
+    bool onMessage(const MarketParticipantPositionMessage& message) override { ++_messages; return true; }
+    bool onMessage(const MWCBDeclineMessage& message) override { ++_messages; return true; }
+    bool onMessage(const MWCBStatusMessage& message) override { ++_messages; return true; }
+    bool onMessage(const IPOQuotingMessage& message) override { ++_messages; return true; }
+    bool onMessage(const AddOrderMessage& message) override { ++_messages; _market.AddOrder(Order::Limit(message.OrderReferenceNumber, message.StockLocate, (message.BuySellIndicator == 'B') ? OrderSide::BUY : OrderSide::SELL, message.Price, message.Shares)); return true; }
+    bool onMessage(const AddOrderMPIDMessage& message) override { ++_messages; _market.AddOrder(Order::Limit(message.OrderReferenceNumber, message.StockLocate, (message.BuySellIndicator == 'B') ? OrderSide::BUY : OrderSide::SELL, message.Price, message.Shares)); return true; }
+    bool onMessage(const OrderExecutedMessage& message) override { ++_messages; _market.ExecuteOrder(message.OrderReferenceNumber, message.ExecutedShares); return true; }
+    bool onMessage(const OrderExecutedWithPriceMessage& message) override { ++_messages; _market.ExecuteOrder(message.OrderReferenceNumber, message.ExecutionPrice, message.ExecutedShares); return true; }
+    bool onMessage(const OrderCancelMessage& message) override { ++_messages; _market.ReduceOrder(message.OrderReferenceNumber, message.CanceledShares); return true; }
+    bool onMessage(const OrderDeleteMessage& message) override { ++_messages; _market.DeleteOrder(message.OrderReferenceNumber); return true; }
+    bool onMessage(const OrderReplaceMessage& message) override { ++_messages; _market.ReplaceOrder(message.OriginalOrderReferenceNumber, message.NewOrderReferenceNumber, message.Price, message.Shares); return true; }
+    bool onMessage(const TradeMessage& message) override { ++_messages; return true; }
+    bool onMessage(const CrossTradeMessage& message) override { ++_messages; return true; }
+    bool onMessage(const BrokenTradeMessage& message) override { ++_messages; return true; }
+    bool onMessage(const NOIIMessage& message) override { ++_messages; return true; }
+    bool onMessage(const RPIIMessage& message) override { ++_messages; return true; }
+    bool onMessage(const LULDAuctionCollarMessage& message) override { ++_messages; return true; }
+    bool onMessage(const UnknownMessage& message) override { ++_errors; return true; }
+
+private:
+    ShardedMarketManager& _market;
+    size_t _messages;
+    size_t _errors;
+};
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-i", "--input").dest("input").help("Input file name");
+    parser.add_option("-s", "--shards").dest("shards").help("Shards count").set_default("4");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help"))
+    {
+        parser.print_help();
+        return 0;
+    }
+
+    // Open the input file or stdin
+    std::unique_ptr<Reader> input(new StdInput());
+    if (options.is_set("input"))
+    {
+        File* file = new File(Path(options.get("input")));
+        file->Open(true, false);
+        input.reset(file);
+    }
+
+    // Create market handlers for all shards
+    size_t shards = (size_t)std::max((int)options.get("shards"), 1);
+    std::vector<MyMarketHandler> market_handlers(shards);
+    std::vector<MarketHandler*> shard_handlers;
+    for (auto& market_handler : market_handlers)
+        shard_handlers.push_back(&market_handler);
+
+    ShardedMarketManager market(shard_handlers);
+    MyITCHHandler itch_handler(market);
+
+    // Perform input
+    size_t size;
+    uint8_t buffer[8192];
+    std::cout << "ITCH processing...";
+    uint64_t timestamp_start = Timestamp::nano();
+    while ((size = input->Read(buffer, sizeof(buffer))) > 0)
+    {
+        // Process the buffer
+        itch_handler.Process(buffer, size);
+    }
+    market.Flush();
+    uint64_t timestamp_stop = Timestamp::nano();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Errors: " << itch_handler.errors() << std::endl;
+
+    std::cout << std::endl;
+
+    size_t total_messages = itch_handler.messages();
+    size_t total_updates = 0;
+    size_t max_orders = 0;
+    size_t add_orders = 0;
+    size_t update_orders = 0;
+    size_t delete_orders = 0;
+    size_t execute_orders = 0;
+    for (const auto& market_handler : market_handlers)
+    {
+        total_updates += market_handler.updates();
+        max_orders += market_handler.max_orders();
+        add_orders += market_handler.add_orders();
+        update_orders += market_handler.update_orders();
+        delete_orders += market_handler.delete_orders();
+        execute_orders += market_handler.execute_orders();
+    }
+
+    std::cout << "Shards: " << shards << std::endl;
+    std::cout << "Processing time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_stop - timestamp_start) << std::endl;
+    std::cout << "Total ITCH messages: " << total_messages << std::endl;
+    std::cout << "ITCH message latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod((timestamp_stop - timestamp_start) / total_messages) << std::endl;
+    std::cout << "ITCH message throughput: " << total_messages * 1000000000 / (timestamp_stop - timestamp_start) << " msg/s" << std::endl;
+    std::cout << "Total market updates: " << total_updates << std::endl;
+    std::cout << "Market update latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod((timestamp_stop - timestamp_start) / total_updates) << std::endl;
+    std::cout << "Market update throughput: " << total_updates * 1000000000 / (timestamp_stop - timestamp_start) << " upd/s" << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Market statistics: " << std::endl;
+    std::cout << "Max orders (sum of shards): " << max_orders << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Order statistics: " << std::endl;
+    std::cout << "Add order operations: " << add_orders << std::endl;
+    std::cout << "Update order operations: " << update_orders << std::endl;
+    std::cout << "Delete order operations: " << delete_orders << std::endl;
+    std::cout << "Execute order operations: " << execute_orders << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+/*!
+    \file market_command.cpp
+    \brief Market command implementation
+    \author Ivan Shynkarenka
+    \date 26.08.2017
+    \copyright MIT License
+*/
+
+#include "trader/matching/market_command.h"
+
+namespace CppTrader {
+namespace Matching {
+
+// Market command & queue with the default market traits
+template struct MarketCommandT<MarketTraits<>>;
+template class MarketCommandQueueT<MarketTraits<>>;
+
+} // namespace Matching
+} // namespace CppTrader
@@ -0,0 +1,18 @@
+/*!
+    \file market_event_buffer.cpp
+    \brief Market event buffer implementation
+    \author Ivan Shynkarenka
+    \date 01.09.2017
+    \copyright MIT License
+*/
+
+#include "trader/matching/market_event_buffer.h"
+
+namespace CppTrader {
+namespace Matching {
+
+// Market event buffer with the default market traits
+template class MarketEventBufferT<MarketTraits<>>;
+
+} // namespace Matching
+} // namespace CppTrader
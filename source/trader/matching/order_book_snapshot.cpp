@@ -0,0 +1,18 @@
+/*!
+    \file order_book_snapshot.cpp
+    \brief Order book snapshot implementation
+    \author Ivan Shynkarenka
+    \date 28.08.2017
+    \copyright MIT License
+*/
+
+#include "trader/matching/order_book_snapshot.h"
+
+namespace CppTrader {
+namespace Matching {
+
+// Order book snapshots with the default market traits
+template class OrderBookSnapshotsT<MarketTraits<>>;
+
+} // namespace Matching
+} // namespace CppTrader
@@ -0,0 +1,18 @@
+/*!
+    \file sharded_market_manager.cpp
+    \brief Sharded market manager implementation
+    \author Ivan Shynkarenka
+    \date 25.08.2017
+    \copyright MIT License
+*/
+
+#include "trader/matching/sharded_market_manager.h"
+
+namespace CppTrader {
+namespace Matching {
+
+// Sharded market manager with the default market traits
+template class ShardedMarketManagerT<MarketTraits<>>;
+
+} // namespace Matching
+} // namespace CppTrader
@@ -0,0 +1,141 @@
+/*!
+    \file itch_file.cpp
+    \brief NASDAQ ITCH memory-mapped file implementation
+    \author Ivan Shynkarenka
+    \date 08.09.2017
+    \copyright MIT License
+*/
+
+#include "trader/providers/nasdaq/itch_file.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CppTrader {
+namespace ITCH {
+
+bool ITCHFile::Open(const std::string& filename, bool populate, bool hugepages)
+{
+    Close();
+
+#if defined(_WIN32) || defined(_WIN64)
+    // Populate and huge pages hints are not supported
+    (void)populate;
+    (void)hugepages;
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // Empty file cannot be mapped
+    if (size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        // Mapped view keeps the file mapping alive after handles are closed
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (data == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        _data = (const uint8_t*)data;
+        _size = (size_t)size.QuadPart;
+    }
+
+    CloseHandle(file);
+#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+    int file = open(filename.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat status;
+    if (fstat(file, &status) != 0)
+    {
+        close(file);
+        return false;
+    }
+
+    // Empty file cannot be mapped
+    if (status.st_size > 0)
+    {
+        int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+        if (populate)
+            flags |= MAP_POPULATE;
+#endif
+
+        // Mapping keeps the file referenced after the descriptor is closed
+        void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ, flags, file, 0);
+        if (data == MAP_FAILED)
+        {
+            close(file);
+            return false;
+        }
+
+        // Advise the kernel about the sequential access to read ahead aggressively
+        madvise(data, (size_t)status.st_size, MADV_SEQUENTIAL);
+#if !defined(MAP_POPULATE)
+        if (populate)
+            madvise(data, (size_t)status.st_size, MADV_WILLNEED);
+#endif
+#if defined(MADV_HUGEPAGE)
+        // Huge pages advice is best-effort: page cache backed mappings get huge pages
+        // only from tmpfs or kernels with read-only THP for file systems, and usually
+        // only after khugepaged collapses them, so the result is deliberately ignored
+        if (hugepages)
+            madvise(data, (size_t)status.st_size, MADV_HUGEPAGE);
+#endif
+
+        _data = (const uint8_t*)data;
+        _size = (size_t)status.st_size;
+    }
+
+    close(file);
+#endif
+
+    _opened = true;
+    return true;
+}
+
+void ITCHFile::Close()
+{
+    if (!_opened)
+        return;
+
+    if (_data != nullptr)
+    {
+#if defined(_WIN32) || defined(_WIN64)
+        UnmapViewOfFile(_data);
+#elif defined(unix) || defined(__unix) || defined(__unix__) || defined(__APPLE__)
+        munmap((void*)_data, _size);
+#endif
+    }
+
+    _data = nullptr;
+    _size = 0;
+    _opened = false;
+}
+
+} // namespace ITCH
+} // namespace CppTrader
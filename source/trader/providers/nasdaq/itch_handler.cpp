@@ -13,99 +13,58 @@
 namespace CppTrader {
 namespace ITCH {
 
-bool ITCHHandler::Process(void* buffer, size_t size)
+void StockLocateFilter::Add(uint16_t stock_locate) noexcept
 {
-    size_t index = 0;
-    uint8_t* data = (uint8_t*)buffer;
+    assert((stock_locate != 0) && "Market wide stock locate always passes the filter!");
+    if (stock_locate == 0)
+        return;
 
-    while (index < size)
+    uint64_t mask = 1ull << (stock_locate & 63);
+    uint64_t& word = _bitmap[stock_locate >> 6];
+    if ((word & mask) == 0)
     {
-        if (_size == 0)
-        {
-            size_t remaining = size - index;
-
-            // Collect message size into the cache
-            if (((_cache.size() == 0) && (remaining < 3)) || (_cache.size() == 1))
-            {
-                _cache.push_back(data[index++]);
-                continue;
-            }
-
-            // Read a new message size
-            uint16_t message_size;
-            if (_cache.empty())
-            {
-                // Read the message size directly from the input buffer
-                index += CppCommon::Endian::ReadBigEndian(&data[index], message_size);
-            }
-            else
-            {
-                // Read the message size from the cache
-                CppCommon::Endian::ReadBigEndian(_cache.data(), message_size);
-
-                // Clear the cache
-                _cache.clear();
-            }
-            _size = message_size;
-        }
-
-        // Read a new message
-        if (_size > 0)
-        {
-            size_t remaining = size - index;
-
-            // Complete or place the message into the cache
-            if (!_cache.empty())
-            {
-                size_t tail = _size - _cache.size();
-                if (tail > remaining)
-                    tail = remaining;
-                _cache.insert(_cache.end(), &data[index], &data[index + tail]);
-                index += tail;
-                if (_cache.size() < _size)
-                    continue;
-            }
-            else if (_size > remaining)
-            {
-                _cache.reserve(_size);
-                _cache.insert(_cache.end(), &data[index], &data[index + remaining]);
-                index += remaining;
-                continue;
-            }
-
-            // Process the current message
-            if (_cache.empty())
-            {
-                // Process the current message size directly from the input buffer
-                if (!ProcessMessage(&data[index], _size))
-                    return false;
-                index += _size;
-            }
-            else
-            {
-                // Process the current message size directly from the cache
-                if (!ProcessMessage(_cache.data(), _size))
-                    return false;
-
-                // Clear the cache
-                _cache.clear();
-            }
-
-            // Process the next message
-            _size = 0;
-        }
+        word |= mask;
+        ++_size;
     }
+}
+
+void StockLocateFilter::Remove(uint16_t stock_locate) noexcept
+{
+    uint64_t mask = 1ull << (stock_locate & 63);
+    uint64_t& word = _bitmap[stock_locate >> 6];
+    if ((word & mask) != 0)
+    {
+        word &= ~mask;
+        --_size;
+    }
+}
 
-    return true;
+void StockLocateFilter::Clear() noexcept
+{
+    _bitmap.fill(0);
+    _size = 0;
+}
+
+bool ITCHHandler::Process(const void* buffer, size_t size)
+{
+    return _framer.Process(buffer, size, [this](const uint8_t* message, size_t message_size) { return ProcessMessage(message, message_size); });
 }
 
-bool ITCHHandler::ProcessMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessMessage(const void* buffer, size_t size)
 {
     // Message is empty
     if (size == 0)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
+
+    // Skip the message of the filtered stock locate without decoding
+    if (_filtered && !_filter.Match(data, size))
+        return true;
+
+    // Process the message view without decoding
+    if (_views)
+        return ProcessMessageView(data, size);
 
     switch (*data)
     {
@@ -156,19 +115,69 @@ bool ITCHHandler::ProcessMessage(void* buffer, size_t size)
     }
 }
 
+bool ITCHHandler::ProcessMessageView(const uint8_t* data, size_t size)
+{
+    switch (*data)
+    {
+        case SystemEventMessageView::TYPE:
+            return ProcessMessageView<SystemEventMessageView>(data, size);
+        case StockDirectoryMessageView::TYPE:
+            return ProcessMessageView<StockDirectoryMessageView>(data, size);
+        case StockTradingActionMessageView::TYPE:
+            return ProcessMessageView<StockTradingActionMessageView>(data, size);
+        case RegSHOMessageView::TYPE:
+            return ProcessMessageView<RegSHOMessageView>(data, size);
+        case MarketParticipantPositionMessageView::TYPE:
+            return ProcessMessageView<MarketParticipantPositionMessageView>(data, size);
+        case MWCBDeclineMessageView::TYPE:
+            return ProcessMessageView<MWCBDeclineMessageView>(data, size);
+        case MWCBStatusMessageView::TYPE:
+            return ProcessMessageView<MWCBStatusMessageView>(data, size);
+        case IPOQuotingMessageView::TYPE:
+            return ProcessMessageView<IPOQuotingMessageView>(data, size);
+        case AddOrderMessageView::TYPE:
+            return ProcessMessageView<AddOrderMessageView>(data, size);
+        case AddOrderMPIDMessageView::TYPE:
+            return ProcessMessageView<AddOrderMPIDMessageView>(data, size);
+        case OrderExecutedMessageView::TYPE:
+            return ProcessMessageView<OrderExecutedMessageView>(data, size);
+        case OrderExecutedWithPriceMessageView::TYPE:
+            return ProcessMessageView<OrderExecutedWithPriceMessageView>(data, size);
+        case OrderCancelMessageView::TYPE:
+            return ProcessMessageView<OrderCancelMessageView>(data, size);
+        case OrderDeleteMessageView::TYPE:
+            return ProcessMessageView<OrderDeleteMessageView>(data, size);
+        case OrderReplaceMessageView::TYPE:
+            return ProcessMessageView<OrderReplaceMessageView>(data, size);
+        case TradeMessageView::TYPE:
+            return ProcessMessageView<TradeMessageView>(data, size);
+        case CrossTradeMessageView::TYPE:
+            return ProcessMessageView<CrossTradeMessageView>(data, size);
+        case BrokenTradeMessageView::TYPE:
+            return ProcessMessageView<BrokenTradeMessageView>(data, size);
+        case NOIIMessageView::TYPE:
+            return ProcessMessageView<NOIIMessageView>(data, size);
+        case RPIIMessageView::TYPE:
+            return ProcessMessageView<RPIIMessageView>(data, size);
+        case LULDAuctionCollarMessageView::TYPE:
+            return ProcessMessageView<LULDAuctionCollarMessageView>(data, size);
+        default:
+            return onMessageView(UnknownMessageView(data, size));
+    }
+}
+
 void ITCHHandler::Reset()
 {
-    _size = 0;
-    _cache.clear();
+    _framer.Reset();
 }
 
-bool ITCHHandler::ProcessSystemEventMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessSystemEventMessage(const void* buffer, size_t size)
 {
     assert((size == 12) && "Invalid size of the ITCH message type 'S'");
     if (size != 12)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     SystemEventMessage message;
     message.Type = *data++;
@@ -180,13 +189,13 @@ bool ITCHHandler::ProcessSystemEventMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessStockDirectoryMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessStockDirectoryMessage(const void* buffer, size_t size)
 {
     assert((size == 39) && "Invalid size of the ITCH message type 'R'");
     if (size != 39)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     StockDirectoryMessage message;
     message.Type = *data++;
@@ -211,13 +220,13 @@ bool ITCHHandler::ProcessStockDirectoryMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessStockTradingActionMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessStockTradingActionMessage(const void* buffer, size_t size)
 {
     assert((size == 25) && "Invalid size of the ITCH message type 'H'");
     if (size != 25)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     StockTradingActionMessage message;
     message.Type = *data++;
@@ -232,13 +241,13 @@ bool ITCHHandler::ProcessStockTradingActionMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessRegSHOMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessRegSHOMessage(const void* buffer, size_t size)
 {
     assert((size == 20) && "Invalid size of the ITCH message type 'Y'");
     if (size != 20)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     RegSHOMessage message;
     message.Type = *data++;
@@ -251,13 +260,13 @@ bool ITCHHandler::ProcessRegSHOMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessMarketParticipantPositionMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessMarketParticipantPositionMessage(const void* buffer, size_t size)
 {
     assert((size == 26) && "Invalid size of the ITCH message type 'L'");
     if (size != 26)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     MarketParticipantPositionMessage message;
     message.Type = *data++;
@@ -273,13 +282,13 @@ bool ITCHHandler::ProcessMarketParticipantPositionMessage(void* buffer, size_t s
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessMWCBDeclineMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessMWCBDeclineMessage(const void* buffer, size_t size)
 {
     assert((size == 35) && "Invalid size of the ITCH message type 'V'");
     if (size != 35)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     MWCBDeclineMessage message;
     message.Type = *data++;
@@ -293,13 +302,13 @@ bool ITCHHandler::ProcessMWCBDeclineMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessMWCBStatusMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessMWCBStatusMessage(const void* buffer, size_t size)
 {
     assert((size == 12) && "Invalid size of the ITCH message type 'W'");
     if (size != 12)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     MWCBStatusMessage message;
     message.Type = *data++;
@@ -311,13 +320,13 @@ bool ITCHHandler::ProcessMWCBStatusMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessIPOQuotingMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessIPOQuotingMessage(const void* buffer, size_t size)
 {
     assert((size == 28) && "Invalid size of the ITCH message type 'W'");
     if (size != 28)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     IPOQuotingMessage message;
     message.Type = *data++;
@@ -332,13 +341,13 @@ bool ITCHHandler::ProcessIPOQuotingMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessAddOrderMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessAddOrderMessage(const void* buffer, size_t size)
 {
     assert((size == 36) && "Invalid size of the ITCH message type 'A'");
     if (size != 36)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     AddOrderMessage message;
     message.Type = *data++;
@@ -354,13 +363,13 @@ bool ITCHHandler::ProcessAddOrderMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessAddOrderMPIDMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessAddOrderMPIDMessage(const void* buffer, size_t size)
 {
     assert((size == 40) && "Invalid size of the ITCH message type 'F'");
     if (size != 40)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     AddOrderMPIDMessage message;
     message.Type = *data++;
@@ -377,13 +386,13 @@ bool ITCHHandler::ProcessAddOrderMPIDMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessOrderExecutedMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessOrderExecutedMessage(const void* buffer, size_t size)
 {
     assert((size == 31) && "Invalid size of the ITCH message type 'E'");
     if (size != 31)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     OrderExecutedMessage message;
     message.Type = *data++;
@@ -397,13 +406,13 @@ bool ITCHHandler::ProcessOrderExecutedMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessOrderExecutedWithPriceMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessOrderExecutedWithPriceMessage(const void* buffer, size_t size)
 {
     assert((size == 36) && "Invalid size of the ITCH message type 'C'");
     if (size != 36)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     OrderExecutedWithPriceMessage message;
     message.Type = *data++;
@@ -419,13 +428,13 @@ bool ITCHHandler::ProcessOrderExecutedWithPriceMessage(void* buffer, size_t size
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessOrderCancelMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessOrderCancelMessage(const void* buffer, size_t size)
 {
     assert((size == 23) && "Invalid size of the ITCH message type 'X'");
     if (size != 23)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     OrderCancelMessage message;
     message.Type = *data++;
@@ -438,13 +447,13 @@ bool ITCHHandler::ProcessOrderCancelMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessOrderDeleteMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessOrderDeleteMessage(const void* buffer, size_t size)
 {
     assert((size == 19) && "Invalid size of the ITCH message type 'D'");
     if (size != 19)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     OrderDeleteMessage message;
     message.Type = *data++;
@@ -456,13 +465,13 @@ bool ITCHHandler::ProcessOrderDeleteMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessOrderReplaceMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessOrderReplaceMessage(const void* buffer, size_t size)
 {
     assert((size == 35) && "Invalid size of the ITCH message type 'U'");
     if (size != 35)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     OrderReplaceMessage message;
     message.Type = *data++;
@@ -477,13 +486,13 @@ bool ITCHHandler::ProcessOrderReplaceMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessTradeMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessTradeMessage(const void* buffer, size_t size)
 {
     assert((size == 44) && "Invalid size of the ITCH message type 'P'");
     if (size != 44)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     TradeMessage message;
     message.Type = *data++;
@@ -500,13 +509,13 @@ bool ITCHHandler::ProcessTradeMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessCrossTradeMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessCrossTradeMessage(const void* buffer, size_t size)
 {
     assert((size == 40) && "Invalid size of the ITCH message type 'Q'");
     if (size != 40)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     CrossTradeMessage message;
     message.Type = *data++;
@@ -522,13 +531,13 @@ bool ITCHHandler::ProcessCrossTradeMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessBrokenTradeMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessBrokenTradeMessage(const void* buffer, size_t size)
 {
     assert((size == 19) && "Invalid size of the ITCH message type 'B'");
     if (size != 19)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     BrokenTradeMessage message;
     message.Type = *data++;
@@ -540,13 +549,13 @@ bool ITCHHandler::ProcessBrokenTradeMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessNOIIMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessNOIIMessage(const void* buffer, size_t size)
 {
     assert((size == 50) && "Invalid size of the ITCH message type 'I'");
     if (size != 50)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     NOIIMessage message;
     message.Type = *data++;
@@ -566,13 +575,13 @@ bool ITCHHandler::ProcessNOIIMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessRPIIMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessRPIIMessage(const void* buffer, size_t size)
 {
     assert((size == 20) && "Invalid size of the ITCH message type 'N'");
     if (size != 20)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     RPIIMessage message;
     message.Type = *data++;
@@ -585,13 +594,13 @@ bool ITCHHandler::ProcessRPIIMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessLULDAuctionCollarMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessLULDAuctionCollarMessage(const void* buffer, size_t size)
 {
     assert((size == 35) && "Invalid size of the ITCH message type 'J'");
     if (size != 35)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     LULDAuctionCollarMessage message;
     message.Type = *data++;
@@ -607,13 +616,13 @@ bool ITCHHandler::ProcessLULDAuctionCollarMessage(void* buffer, size_t size)
     return onMessage(message);
 }
 
-bool ITCHHandler::ProcessUnknownMessage(void* buffer, size_t size)
+bool ITCHHandler::ProcessUnknownMessage(const void* buffer, size_t size)
 {
     assert((size > 0) && "Invalid size of the unknown ITCH message!");
     if (size == 0)
         return false;
 
-    uint8_t* data = (uint8_t*)buffer;
+    const uint8_t* data = (const uint8_t*)buffer;
 
     UnknownMessage message;
     message.Type = *data;
@@ -0,0 +1,213 @@
+/*!
+    \file itch_index.cpp
+    \brief NASDAQ ITCH message index implementation
+    \author Ivan Shynkarenka
+    \date 09.09.2017
+    \copyright MIT License
+*/
+
+#include "trader/providers/nasdaq/itch_index.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace CppTrader {
+namespace ITCH {
+
+namespace {
+
+// Index file header
+struct ITCHIndexHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t EntrySize;
+    uint64_t Entries;
+    uint64_t Capture;
+};
+
+const char INDEX_MAGIC[8] = { 'I', 'T', 'C', 'H', 'I', 'D', 'X', 0 };
+const uint32_t INDEX_VERSION = 1;
+
+} // namespace
+
+bool ITCHIndex::Build(const void* buffer, size_t size)
+{
+    Clear();
+
+    const uint8_t* data = (const uint8_t*)buffer;
+
+    assert((size <= ITCHIndexEntry::MAX_OFFSET) && "ITCH capture is too large to be indexed!");
+    if (size > ITCHIndexEntry::MAX_OFFSET)
+        return false;
+
+    // Average ITCH message with its size takes about 30 bytes
+    _entries.reserve(size / 30);
+
+    size_t offset = 0;
+    while (offset < size)
+    {
+        // Check the message size is available
+        if ((size - offset) < 2)
+            break;
+
+        uint16_t message_size;
+        offset += CppCommon::Endian::ReadBigEndian(&data[offset], message_size);
+
+        // Check the whole message is available
+        if ((message_size == 0) || ((size - offset) < message_size))
+            break;
+
+        // Market wide and short messages have no stock locate and timestamp
+        MessageView message(&data[offset], message_size);
+        uint16_t stock_locate = (message_size >= 3) ? message.StockLocate() : 0;
+        uint64_t timestamp = (message_size >= 11) ? message.Timestamp() : 0;
+
+        _entries.emplace_back(offset, message.Type(), message_size, timestamp, stock_locate);
+
+        offset += message_size;
+    }
+
+    // Malformed or truncated capture
+    if (offset != size)
+    {
+        Clear();
+        return false;
+    }
+
+    _capture = size;
+    return true;
+}
+
+void ITCHIndex::Clear()
+{
+    _entries.clear();
+    _capture = 0;
+}
+
+bool ITCHIndex::Save(const std::string& filename) const
+{
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    ITCHIndexHeader header;
+    std::memcpy(header.Magic, INDEX_MAGIC, sizeof(header.Magic));
+    header.Version = INDEX_VERSION;
+    header.EntrySize = sizeof(ITCHIndexEntry);
+    header.Entries = _entries.size();
+    header.Capture = _capture;
+
+    bool result = (std::fwrite(&header, sizeof(header), 1, file) == 1);
+    if (result && !_entries.empty())
+        result = (std::fwrite(_entries.data(), sizeof(ITCHIndexEntry), _entries.size(), file) == _entries.size());
+
+    return (std::fclose(file) == 0) && result;
+}
+
+bool ITCHIndex::Load(const std::string& filename)
+{
+    Clear();
+
+    FILE* file = std::fopen(filename.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    // Validate the index file header
+    ITCHIndexHeader header;
+    bool result = (std::fread(&header, sizeof(header), 1, file) == 1) &&
+                  (std::memcmp(header.Magic, INDEX_MAGIC, sizeof(header.Magic)) == 0) &&
+                  (header.Version == INDEX_VERSION) &&
+                  (header.EntrySize == sizeof(ITCHIndexEntry));
+
+    // Each indexed message takes at least 3 bytes with its size
+    result = result && (header.Capture <= ITCHIndexEntry::MAX_OFFSET) && (header.Entries <= (header.Capture / 3));
+
+    if (result)
+    {
+        _entries.resize((size_t)header.Entries);
+        if (!_entries.empty())
+            result = (std::fread(_entries.data(), sizeof(ITCHIndexEntry), _entries.size(), file) == _entries.size());
+        _capture = header.Capture;
+    }
+
+    std::fclose(file);
+
+    // Validate index entries: messages must follow each other within the capture
+    uint64_t offset = 0;
+    for (size_t i = 0; result && (i < _entries.size()); ++i)
+    {
+        const ITCHIndexEntry& entry = _entries[i];
+        result = (entry.Size() > 0) && (entry.Offset() >= (offset + 2)) && ((entry.Offset() + entry.Size()) <= _capture);
+        offset = entry.Offset() + entry.Size();
+    }
+
+    if (!result)
+        Clear();
+
+    return result;
+}
+
+std::vector<uint16_t> ITCHIndex::Partition(size_t workers) const
+{
+    assert((workers > 0) && "Count of workers must be greater than zero!");
+    assert((workers <= 65536) && "Count of workers must not exceed the count of stock locates!");
+
+    std::vector<uint16_t> partition(65536, 0);
+    if (workers <= 1)
+        return partition;
+
+    // Count indexed messages of each stock locate
+    std::vector<uint64_t> messages(65536, 0);
+    for (const auto& entry : _entries)
+        ++messages[entry.StockLocate()];
+
+    // Sort stock locates by the count of messages (the most active first)
+    std::vector<uint16_t> stock_locates;
+    for (size_t i = 1; i < messages.size(); ++i)
+        if (messages[i] > 0)
+            stock_locates.push_back((uint16_t)i);
+    std::stable_sort(stock_locates.begin(), stock_locates.end(), [&messages](uint16_t a, uint16_t b) { return messages[a] > messages[b]; });
+
+    // Assign each stock locate to the least loaded worker
+    std::vector<uint64_t> loads(workers, 0);
+    for (uint16_t stock_locate : stock_locates)
+    {
+        size_t worker = (size_t)(std::min_element(loads.begin(), loads.end()) - loads.begin());
+        partition[stock_locate] = (uint16_t)worker;
+        loads[worker] += messages[stock_locate];
+    }
+
+    return partition;
+}
+
+std::vector<std::vector<size_t>> ITCHIndex::Split(const std::vector<uint16_t>& partition, size_t workers) const
+{
+    assert((partition.size() == 65536) && "Partition must contain the worker of each stock locate!");
+
+    std::vector<std::vector<size_t>> messages(workers);
+    for (auto& worker_messages : messages)
+        worker_messages.reserve(_entries.size() / workers);
+
+    for (size_t i = 0; i < _entries.size(); ++i)
+    {
+        uint16_t stock_locate = _entries[i].StockLocate();
+        if (stock_locate != 0)
+        {
+            assert((partition[stock_locate] < workers) && "Stock locate is assigned to the invalid worker!");
+            messages[partition[stock_locate]].push_back(i);
+        }
+        else
+        {
+            // Market wide messages are replayed by all workers
+            for (auto& worker_messages : messages)
+                worker_messages.push_back(i);
+        }
+    }
+
+    return messages;
+}
+
+} // namespace ITCH
+} // namespace CppTrader
@@ -0,0 +1,173 @@
+//
+// Created by Ivan Shynkarenka on 29.08.2017
+//
+
+#include "test.h"
+
+#include "trader/matching/market_manager.h"
+
+using namespace CppTrader::Matching;
+
+namespace {
+
+// Check the depth cache with the order book price levels
+template <class TOrderBook>
+void CheckDepthCache(const TOrderBook& order_book)
+{
+    auto bids = order_book.bid_depth();
+    size_t bid = 0;
+    for (auto level_ptr = order_book.best_bid(); (level_ptr != nullptr) && (bid < order_book.depth()); level_ptr = order_book.bids().lower(*level_ptr), ++bid)
+    {
+        REQUIRE(bid < bids.size());
+        REQUIRE(bids[bid].Price == level_ptr->Price);
+        REQUIRE(bids[bid].VisibleVolume == level_ptr->VisibleVolume);
+        REQUIRE(bids[bid].HiddenVolume == level_ptr->HiddenVolume);
+        REQUIRE(bids[bid].Orders == level_ptr->Orders);
+    }
+    REQUIRE(bids.size() == bid);
+
+    auto asks = order_book.ask_depth();
+    size_t ask = 0;
+    for (auto level_ptr = order_book.best_ask(); (level_ptr != nullptr) && (ask < order_book.depth()); level_ptr = order_book.asks().higher(*level_ptr), ++ask)
+    {
+        REQUIRE(ask < asks.size());
+        REQUIRE(asks[ask].Price == level_ptr->Price);
+        REQUIRE(asks[ask].VisibleVolume == level_ptr->VisibleVolume);
+        REQUIRE(asks[ask].HiddenVolume == level_ptr->HiddenVolume);
+        REQUIRE(asks[ask].Orders == level_ptr->Orders);
+    }
+    REQUIRE(asks.size() == ask);
+}
+
+} // namespace
+
+TEST_CASE("Depth cache", "[CppTrader][Matching]")
+{
+    MarketHandler market_handler;
+    MarketManager market(market_handler);
+
+    Symbol symbol = { 0, "test" };
+    REQUIRE(market.AddSymbol(symbol) == ErrorCode::OK);
+    REQUIRE(market.AddOrderBook(symbol) == ErrorCode::OK);
+    const OrderBook* order_book_ptr = market.GetOrderBook(0);
+
+    // Depth cache is disabled by default
+    REQUIRE(order_book_ptr->depth() == 0);
+    REQUIRE(market.AddOrder(Order::BuyLimit(1, 0, 10, 10)) == ErrorCode::OK);
+    REQUIRE(order_book_ptr->bid_depth().empty());
+
+    // Enabled depth cache is filled with the existing price levels
+    REQUIRE(market.EnableDepthCache(0, 3) == ErrorCode::OK);
+    REQUIRE(order_book_ptr->depth() == 3);
+    REQUIRE(order_book_ptr->bid_depth().size() == 1);
+    REQUIRE(order_book_ptr->bid_depth()[0].Price == 10);
+    REQUIRE(order_book_ptr->bid_depth()[0].VisibleVolume == 10);
+
+    // Better price levels are inserted, worse ones beyond the depth are ignored
+    REQUIRE(market.AddOrder(Order::BuyLimit(2, 0, 12, 20)) == ErrorCode::OK);
+    REQUIRE(market.AddOrder(Order::BuyLimit(3, 0, 8, 30)) == ErrorCode::OK);
+    REQUIRE(market.AddOrder(Order::BuyLimit(4, 0, 11, 40)) == ErrorCode::OK);
+    REQUIRE(order_book_ptr->bid_depth().size() == 3);
+    REQUIRE(order_book_ptr->bid_depth()[0].Price == 12);
+    REQUIRE(order_book_ptr->bid_depth()[1].Price == 11);
+    REQUIRE(order_book_ptr->bid_depth()[2].Price == 10);
+    CheckDepthCache(*order_book_ptr);
+
+    // Price levels are updated in place
+    REQUIRE(market.AddOrder(Order::Limit(5, 0, OrderSide::BUY, 11, 50, OrderTimeInForce::GTC, 5)) == ErrorCode::OK);
+    REQUIRE(order_book_ptr->bid_depth()[1].VisibleVolume == 45);
+    REQUIRE(order_book_ptr->bid_depth()[1].HiddenVolume == 45);
+    REQUIRE(order_book_ptr->bid_depth()[1].Orders == 2);
+    CheckDepthCache(*order_book_ptr);
+
+    // Deleted price level is replaced with the next one
+    REQUIRE(market.DeleteOrder(2) == ErrorCode::OK);
+    REQUIRE(order_book_ptr->bid_depth().size() == 3);
+    REQUIRE(order_book_ptr->bid_depth()[0].Price == 11);
+    REQUIRE(order_book_ptr->bid_depth()[2].Price == 8);
+    CheckDepthCache(*order_book_ptr);
+
+    // Asks are sorted from the lowest price
+    REQUIRE(market.AddOrder(Order::SellLimit(6, 0, 20, 10)) == ErrorCode::OK);
+    REQUIRE(market.AddOrder(Order::SellLimit(7, 0, 15, 10)) == ErrorCode::OK);
+    REQUIRE(order_book_ptr->ask_depth().size() == 2);
+    REQUIRE(order_book_ptr->ask_depth()[0].Price == 15);
+    REQUIRE(order_book_ptr->ask_depth()[1].Price == 20);
+    CheckDepthCache(*order_book_ptr);
+
+    // Disabled depth cache is empty
+    REQUIRE(market.DisableDepthCache(0) == ErrorCode::OK);
+    REQUIRE(order_book_ptr->depth() == 0);
+    REQUIRE(order_book_ptr->bid_depth().empty());
+    REQUIRE(order_book_ptr->ask_depth().empty());
+    REQUIRE(market.AddOrder(Order::BuyLimit(8, 0, 13, 10)) == ErrorCode::OK);
+    REQUIRE(order_book_ptr->bid_depth().empty());
+}
+
+TEMPLATE_TEST_CASE("Depth cache (random)", "[CppTrader][Matching]", MarketTraits<LevelsAVL>, MarketTraits<LevelsVector>, MarketTraits<LevelsLadder>, MarketTraits<LevelsBTree>)
+{
+    MarketManagerT<TestType> market;
+
+    // Order books with different depths
+    const size_t depths[] = { 1, 3, 10 };
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        Symbol symbol = { i, "test" };
+        market.AddSymbol(symbol);
+        market.AddOrderBook(symbol);
+        market.EnableDepthCache(i, depths[i]);
+    }
+    market.EnableMatching();
+
+    uint64_t seed = 7;
+    auto random = [&seed](uint64_t range) { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return (seed >> 33) % range; };
+
+    uint64_t id = 1;
+    for (int i = 0; i < 10000; ++i)
+    {
+        uint32_t symbol = (uint32_t)random(3);
+        uint64_t victim = 1 + random(id);
+        auto order_ptr = market.GetOrder(victim);
+
+        switch (random(6))
+        {
+            case 0:
+                market.AddOrder(OrderT<uint64_t, uint64_t>::BuyLimit(id++, symbol, 90 + random(20), 1 + random(50)));
+                break;
+            case 1:
+                market.AddOrder(OrderT<uint64_t, uint64_t>::SellLimit(id++, symbol, 100 + random(20), 1 + random(50)));
+                break;
+            case 2:
+                market.AddOrder(OrderT<uint64_t, uint64_t>::Limit(id++, symbol, random(2) ? OrderSide::BUY : OrderSide::SELL, 95 + random(10), 100, OrderTimeInForce::GTC, 10));
+                break;
+            case 3:
+                if (order_ptr != nullptr)
+                    market.ReduceOrder(victim, 1 + random(order_ptr->LeavesQuantity));
+                break;
+            case 4:
+                if (order_ptr != nullptr)
+                    market.ModifyOrder(victim, 95 + random(10), 1 + random(50));
+                break;
+            default:
+                if (order_ptr != nullptr)
+                    market.DeleteOrder(victim);
+                break;
+        }
+
+        CheckDepthCache(*market.GetOrderBook(symbol));
+
+        // Top of the book is copied from the deep enough depth cache
+        auto top = market.GetOrderBook(symbol)->top_of_book();
+        size_t bids = 0;
+        for (auto level_ptr = market.GetOrderBook(symbol)->best_bid(); (level_ptr != nullptr) && (bids < top.DEPTH); level_ptr = market.GetOrderBook(symbol)->bids().lower(*level_ptr), ++bids)
+            REQUIRE(top.Bids[bids].Price == level_ptr->Price);
+        REQUIRE(top.BidLevels == bids);
+
+        // Depth cache re-enabled in the middle of the stream is refilled
+        if ((i % 1000) == 999)
+        {
+            market.EnableDepthCache(symbol, 1 + random(12));
+            CheckDepthCache(*market.GetOrderBook(symbol));
+        }
+    }
+}
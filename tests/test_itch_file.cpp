@@ -0,0 +1,77 @@
+//
+// Created by Ivan Shynkarenka on 08.09.2017
+//
+
+#include "test.h"
+
+#include "trader/providers/nasdaq/itch_file.h"
+#include "trader/providers/nasdaq/itch_parser.h"
+
+#include "filesystem/file.h"
+
+using namespace CppCommon;
+using namespace CppTrader::ITCH;
+
+namespace {
+
+// ITCH parser handler counts messages and shares of added orders
+struct MyHandler
+{
+    size_t messages = 0;
+    uint64_t shares = 0;
+
+    template <class TMessageView>
+    bool onMessage(const TMessageView& message) { ++messages; return true; }
+    bool onMessage(const AddOrderMessageView& message) { ++messages; shares += message.Shares(); return true; }
+    bool onMessage(const UnknownMessageView& message) { return false; }
+};
+
+} // namespace
+
+TEST_CASE("ITCHFile", "[CppTrader][Providers][NASDAQ]")
+{
+    // Not existing file cannot be mapped
+    ITCHFile mapped;
+    REQUIRE(!mapped.Open("not-existing.itch"));
+    REQUIRE(!mapped.IsOpened());
+
+    // Map the input file
+    std::string filename = "../../tools/itch/sample.itch";
+    if (!File(filename).IsExists())
+        filename = "../tools/itch/sample.itch";
+    REQUIRE(mapped.Open(filename, true, true));
+    REQUIRE(mapped.IsOpened());
+    REQUIRE(mapped.data() != nullptr);
+    REQUIRE(mapped.size() > 0);
+
+    // Process the whole mapped file at once
+    MyHandler mapped_handler;
+    ITCHParser<MyHandler> mapped_parser(mapped_handler);
+    REQUIRE(mapped.Process(mapped_parser));
+
+    // Process the same file with buffered reads
+    File input(filename);
+    input.Open(true, false);
+    size_t size;
+    size_t total = 0;
+    uint8_t buffer[8192];
+    MyHandler handler;
+    ITCHParser<MyHandler> parser(handler);
+    while ((size = input.Read(buffer, sizeof(buffer))) > 0)
+    {
+        REQUIRE(parser.Process(buffer, size));
+        total += size;
+    }
+
+    // Check results
+    REQUIRE(mapped.size() == total);
+    REQUIRE(mapped_handler.messages > 0);
+    REQUIRE(mapped_handler.messages == handler.messages);
+    REQUIRE(mapped_handler.shares == handler.shares);
+
+    // Closed file is unmapped
+    mapped.Close();
+    REQUIRE(!mapped.IsOpened());
+    REQUIRE(mapped.data() == nullptr);
+    REQUIRE(mapped.size() == 0);
+}
@@ -8,6 +8,10 @@
 
 #include "filesystem/file.h"
 
+#include <algorithm>
+#include <cstring>
+#include <map>
+
 using namespace CppCommon;
 using namespace CppTrader::ITCH;
 
@@ -53,6 +57,74 @@ private:
     size_t _errors;
 };
 
+// ITCH handler accumulates the same order fields from decoded messages and message views
+class MyITCHViewHandler : public ITCHHandler
+{
+public:
+    size_t messages = 0;
+    uint64_t checksum = 0;
+
+protected:
+    bool onMessage(const AddOrderMessage& message) override { return Add(message.Timestamp, message.StockLocate, message.OrderReferenceNumber, message.Shares, message.Price, message.Stock); }
+    bool onMessage(const OrderExecutedMessage& message) override { return Add(message.Timestamp, message.StockLocate, message.OrderReferenceNumber, message.ExecutedShares, message.MatchNumber); }
+    bool onMessage(const OrderCancelMessage& message) override { return Add(message.Timestamp, message.StockLocate, message.OrderReferenceNumber, message.CanceledShares); }
+    bool onMessage(const OrderDeleteMessage& message) override { return Add(message.Timestamp, message.StockLocate, message.OrderReferenceNumber); }
+    bool onMessage(const OrderReplaceMessage& message) override { return Add(message.Timestamp, message.StockLocate, message.OriginalOrderReferenceNumber, message.NewOrderReferenceNumber, message.Shares, message.Price); }
+    bool onMessage(const UnknownMessage& message) override { return false; }
+
+    bool onMessageView(const AddOrderMessageView& message) override { return Add(message.Timestamp(), message.StockLocate(), message.OrderReferenceNumber(), message.Shares(), message.Price(), message.Stock()); }
+    bool onMessageView(const OrderExecutedMessageView& message) override { return Add(message.Timestamp(), message.StockLocate(), message.OrderReferenceNumber(), message.ExecutedShares(), message.MatchNumber()); }
+    bool onMessageView(const OrderCancelMessageView& message) override { return Add(message.Timestamp(), message.StockLocate(), message.OrderReferenceNumber(), message.CanceledShares()); }
+    bool onMessageView(const OrderDeleteMessageView& message) override { return Add(message.Timestamp(), message.StockLocate(), message.OrderReferenceNumber()); }
+    bool onMessageView(const OrderReplaceMessageView& message) override { return Add(message.Timestamp(), message.StockLocate(), message.OriginalOrderReferenceNumber(), message.NewOrderReferenceNumber(), message.Shares(), message.Price()); }
+    bool onMessageView(const UnknownMessageView& message) override { return false; }
+
+private:
+    bool Add(uint64_t timestamp, uint64_t a, uint64_t b, uint64_t c = 0, uint64_t d = 0, uint64_t e = 0, const char* stock = "")
+    {
+        for (uint64_t value : { timestamp, a, b, c, d, e, (uint64_t)stock[0] })
+            checksum = checksum * 1099511628211ull + value;
+        ++messages;
+        return true;
+    }
+    bool Add(uint64_t timestamp, uint64_t a, uint64_t b, uint64_t c, uint64_t d, const char (&stock)[8]) { return Add(timestamp, a, b, c, d, 0, stock); }
+};
+
+// ITCH handler counts messages of each stock locate in both modes
+class MyITCHLocateHandler : public ITCHHandler
+{
+public:
+    std::map<uint16_t, size_t> locates;
+
+protected:
+    bool onMessage(const SystemEventMessage& message) override { return Count(message.StockLocate); }
+    bool onMessage(const StockDirectoryMessage& message) override { return Count(message.StockLocate); }
+    bool onMessage(const AddOrderMessage& message) override { return Count(message.StockLocate); }
+    bool onMessage(const AddOrderMPIDMessage& message) override { return Count(message.StockLocate); }
+    bool onMessage(const OrderExecutedMessage& message) override { return Count(message.StockLocate); }
+    bool onMessage(const OrderExecutedWithPriceMessage& message) override { return Count(message.StockLocate); }
+    bool onMessage(const OrderCancelMessage& message) override { return Count(message.StockLocate); }
+    bool onMessage(const OrderDeleteMessage& message) override { return Count(message.StockLocate); }
+    bool onMessage(const OrderReplaceMessage& message) override { return Count(message.StockLocate); }
+    bool onMessage(const TradeMessage& message) override { return Count(message.StockLocate); }
+    bool onMessage(const UnknownMessage& message) override { return false; }
+
+    bool onMessageView(const SystemEventMessageView& message) override { return Count(message.StockLocate()); }
+    bool onMessageView(const StockDirectoryMessageView& message) override { return Count(message.StockLocate()); }
+    bool onMessageView(const AddOrderMessageView& message) override { return Count(message.StockLocate()); }
+    bool onMessageView(const AddOrderMPIDMessageView& message) override { return Count(message.StockLocate()); }
+    bool onMessageView(const OrderExecutedMessageView& message) override { return Count(message.StockLocate()); }
+    bool onMessageView(const OrderExecutedWithPriceMessageView& message) override { return Count(message.StockLocate()); }
+    bool onMessageView(const OrderCancelMessageView& message) override { return Count(message.StockLocate()); }
+    bool onMessageView(const OrderDeleteMessageView& message) override { return Count(message.StockLocate()); }
+    bool onMessageView(const OrderReplaceMessageView& message) override { return Count(message.StockLocate()); }
+    bool onMessageView(const TradeMessageView& message) override { return Count(message.StockLocate()); }
+    bool onMessageView(const UnknownMessageView& message) override { return false; }
+
+private:
+    bool Count(uint16_t stock_locate) { ++locates[stock_locate]; return true; }
+};
+
 } // namespace
 
 TEST_CASE("ITCHHandler", "[CppTrader][Providers][NASDAQ]")
@@ -79,3 +151,150 @@ TEST_CASE("ITCHHandler", "[CppTrader][Providers][NASDAQ]")
     REQUIRE(itch_handler.errors() == 0);
     REQUIRE(itch_handler.messages() == 1563071);
 }
+
+TEST_CASE("ITCHHandler message views", "[CppTrader][Providers][NASDAQ]")
+{
+    // Add Order Message in ITCH format
+    uint8_t buffer[2 + AddOrderMessageView::SIZE] = { 0 };
+    uint8_t* data = buffer;
+    data += Endian::WriteBigEndian(data, (uint16_t)AddOrderMessageView::SIZE);
+    *data++ = AddOrderMessageView::TYPE;
+    data += Endian::WriteBigEndian(data, (uint16_t)7);
+    data += Endian::WriteBigEndian(data, (uint16_t)0);
+    data += 2;
+    data += Endian::WriteBigEndian(data, (uint32_t)123456789);
+    data += Endian::WriteBigEndian(data, (uint64_t)1000000000001ull);
+    *data++ = 'S';
+    data += Endian::WriteBigEndian(data, (uint32_t)300);
+    std::memcpy(data, "MSFT    ", 8);
+    data += 8;
+    data += Endian::WriteBigEndian(data, (uint32_t)1234500);
+
+    // Message view reads fields directly from the message buffer
+    AddOrderMessageView view(buffer + 2, AddOrderMessageView::SIZE);
+    REQUIRE(view.Type() == 'A');
+    REQUIRE(view.StockLocate() == 7);
+    REQUIRE(view.Timestamp() == 123456789);
+    REQUIRE(view.OrderReferenceNumber() == 1000000000001ull);
+    REQUIRE(view.BuySellIndicator() == 'S');
+    REQUIRE(view.Shares() == 300);
+    REQUIRE(std::memcmp(view.Stock(), "MSFT    ", 8) == 0);
+    REQUIRE(view.Price() == 1234500);
+
+    // Decoded messages and message views have the same fields
+    MyITCHViewHandler decode_handler;
+    REQUIRE(!decode_handler.IsViewModeEnabled());
+    REQUIRE(decode_handler.Process(buffer, sizeof(buffer)));
+    MyITCHViewHandler view_handler;
+    view_handler.EnableViewMode();
+    REQUIRE(view_handler.IsViewModeEnabled());
+    REQUIRE(view_handler.Process(buffer, sizeof(buffer)));
+    REQUIRE(view_handler.messages == 1);
+    REQUIRE(view_handler.checksum == decode_handler.checksum);
+
+    // Open the input file
+    File input("../../tools/itch/sample.itch");
+    if (!input.IsExists())
+        input = File("../tools/itch/sample.itch");
+    REQUIRE(input.IsExists());
+
+    // Process the input file in both modes
+    for (auto* itch_handler : { &decode_handler, &view_handler })
+    {
+        input.Open(true, false);
+        size_t size;
+        uint8_t chunk[8192];
+        while ((size = input.Read(chunk, sizeof(chunk))) > 0)
+            REQUIRE(itch_handler->Process(chunk, size));
+        input.Close();
+    }
+
+    // Check results
+    REQUIRE(view_handler.messages > 1);
+    REQUIRE(view_handler.messages == decode_handler.messages);
+    REQUIRE(view_handler.checksum == decode_handler.checksum);
+}
+
+TEST_CASE("ITCHHandler stock locate filter", "[CppTrader][Providers][NASDAQ]")
+{
+    // Stock locate filter is a bitmap, market wide messages always pass
+    StockLocateFilter filter;
+    REQUIRE(filter.empty());
+    filter.Add(7);
+    filter.Add(7);
+    filter.Add(65535);
+    REQUIRE(filter.size() == 2);
+    REQUIRE(filter.Contains(0));
+    REQUIRE(filter.Contains(7));
+    REQUIRE(filter.Contains(65535));
+    REQUIRE(!filter.Contains(8));
+    filter.Remove(65535);
+    filter.Remove(8);
+    REQUIRE(filter.size() == 1);
+
+    // Order Delete Message has no symbol, but its stock locate is filtered
+    uint8_t buffer[2 + OrderDeleteMessageView::SIZE] = { 0 };
+    uint8_t* data = buffer;
+    data += Endian::WriteBigEndian(data, (uint16_t)OrderDeleteMessageView::SIZE);
+    *data++ = OrderDeleteMessageView::TYPE;
+    data += Endian::WriteBigEndian(data, (uint16_t)8);
+    REQUIRE(filter.Match(buffer + 2, OrderDeleteMessageView::SIZE) == false);
+    MyITCHLocateHandler delete_handler;
+    delete_handler.EnableFilterMode(filter);
+    REQUIRE(delete_handler.IsFilterModeEnabled());
+    REQUIRE(delete_handler.Process(buffer, sizeof(buffer)));
+    REQUIRE(delete_handler.locates.empty());
+    delete_handler.DisableFilterMode();
+    REQUIRE(delete_handler.Process(buffer, sizeof(buffer)));
+    REQUIRE(delete_handler.locates[8] == 1);
+
+    // Open the input file
+    File input("../../tools/itch/sample.itch");
+    if (!input.IsExists())
+        input = File("../tools/itch/sample.itch");
+    REQUIRE(input.IsExists());
+
+    // Process the input file without the filter
+    MyITCHLocateHandler all_handler;
+    input.Open(true, false);
+    size_t size;
+    uint8_t chunk[8192];
+    while ((size = input.Read(chunk, sizeof(chunk))) > 0)
+        REQUIRE(all_handler.Process(chunk, size));
+    input.Close();
+
+    // Filter the most active stock locates
+    std::vector<std::pair<size_t, uint16_t>> active;
+    for (const auto& locate : all_handler.locates)
+        if (locate.first != 0)
+            active.emplace_back(locate.second, locate.first);
+    std::sort(active.rbegin(), active.rend());
+    REQUIRE(active.size() > 3);
+    filter.Clear();
+    for (size_t i = 0; i < 3; ++i)
+        filter.Add(active[i].second);
+
+    // Process the input file with the filter in both modes
+    MyITCHLocateHandler decode_handler;
+    decode_handler.EnableFilterMode(filter);
+    MyITCHLocateHandler view_handler;
+    view_handler.EnableViewMode();
+    view_handler.EnableFilterMode(filter);
+    for (auto* itch_handler : { &decode_handler, &view_handler })
+    {
+        input.Open(true, false);
+        while ((size = input.Read(chunk, sizeof(chunk))) > 0)
+            REQUIRE(itch_handler->Process(chunk, size));
+        input.Close();
+
+        // Check results
+        REQUIRE(itch_handler->locates.size() <= 4);
+        for (const auto& locate : itch_handler->locates)
+        {
+            REQUIRE(filter.Contains(locate.first));
+            REQUIRE(locate.second == all_handler.locates[locate.first]);
+        }
+        for (size_t i = 0; i < 3; ++i)
+            REQUIRE(itch_handler->locates[active[i].second] == active[i].first);
+    }
+}
@@ -0,0 +1,234 @@
+//
+// Created by Ivan Shynkarenka on 09.09.2017
+//
+
+#include "test.h"
+
+#include "trader/providers/nasdaq/itch_file.h"
+#include "trader/providers/nasdaq/itch_index.h"
+#include "trader/providers/nasdaq/itch_parser.h"
+
+#include "filesystem/file.h"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+
+using namespace CppCommon;
+using namespace CppTrader::ITCH;
+
+namespace {
+
+// ITCH parser handler records messages of each stock locate
+struct MyHandler
+{
+    size_t messages = 0;
+    size_t market = 0;
+    std::map<uint16_t, std::vector<uint64_t>> stocks;
+
+    template <class TMessageView>
+    bool onMessage(const TMessageView& message)
+    {
+        ++messages;
+        if (message.StockLocate() == 0)
+            ++market;
+        else
+            stocks[message.StockLocate()].push_back(message.Timestamp() ^ message.TrackingNumber());
+        return true;
+    }
+    bool onMessage(const UnknownMessageView& message) { return false; }
+};
+
+} // namespace
+
+TEST_CASE("ITCHIndex", "[CppTrader][Providers][NASDAQ]")
+{
+    // Index entry is compact
+    REQUIRE(sizeof(ITCHIndexEntry) == 16);
+    ITCHIndexEntry entry(ITCHIndexEntry::MAX_OFFSET, 'A', 36, 0xFFFFFFFFFFFFull, 65535);
+    REQUIRE(entry.Offset() == ITCHIndexEntry::MAX_OFFSET);
+    REQUIRE(entry.Type() == 'A');
+    REQUIRE(entry.Size() == 36);
+    REQUIRE(entry.Timestamp() == 0xFFFFFFFFFFFFull);
+    REQUIRE(entry.StockLocate() == 65535);
+
+    // Truncated capture cannot be indexed
+    ITCHIndex index;
+    uint8_t truncated[] = { 0, 19, 'D', 0, 1 };
+    REQUIRE(!index.Build(truncated, sizeof(truncated)));
+    REQUIRE(index.empty());
+
+    // Map the input file
+    std::string filename = "../../tools/itch/sample.itch";
+    if (!File(filename).IsExists())
+        filename = "../tools/itch/sample.itch";
+    ITCHFile mapped;
+    REQUIRE(mapped.Open(filename));
+
+    // Process the whole mapped file sequentially
+    MyHandler handler;
+    ITCHParser<MyHandler> parser(handler);
+    REQUIRE(mapped.Process(parser));
+
+    // Index the mapped file
+    REQUIRE(index.Build(mapped.data(), mapped.size()));
+    REQUIRE(index.size() == handler.messages);
+    REQUIRE(index.capture() == mapped.size());
+    size_t mismatches = 0;
+    for (size_t i = 0; i < index.size(); ++i)
+    {
+        MessageView message(mapped.data() + index[i].Offset(), index[i].Size());
+        if ((index[i].Type() != message.Type()) || (index[i].StockLocate() != message.StockLocate()) || (index[i].Timestamp() != message.Timestamp()))
+            ++mismatches;
+    }
+    REQUIRE(mismatches == 0);
+
+    // Save and load the index
+    std::string index_filename = "test_itch_index.idx";
+    REQUIRE(index.Save(index_filename));
+    ITCHIndex loaded;
+    REQUIRE(loaded.Load(index_filename));
+    std::remove(index_filename.c_str());
+    REQUIRE(loaded.size() == index.size());
+    REQUIRE(loaded.capture() == index.capture());
+    REQUIRE(std::memcmp(loaded.entries().data(), index.entries().data(), index.size() * sizeof(ITCHIndexEntry)) == 0);
+    REQUIRE(!loaded.Load("not-existing.idx"));
+    REQUIRE(loaded.empty());
+
+    // Stock locates are partitioned across all workers
+    const size_t workers = 4;
+    std::vector<uint16_t> partition = index.Partition(workers);
+    REQUIRE(partition.size() == 65536);
+    for (const auto& stock : handler.stocks)
+        REQUIRE(partition[stock.first] < workers);
+
+    // Replay the mapped file in parallel
+    std::vector<MyHandler> worker_handlers(workers);
+    std::vector<std::unique_ptr<ITCHParser<MyHandler>>> worker_parsers;
+    std::vector<ITCHParser<MyHandler>*> parsers;
+    for (auto& worker_handler : worker_handlers)
+    {
+        worker_parsers.emplace_back(new ITCHParser<MyHandler>(worker_handler));
+        parsers.push_back(worker_parsers.back().get());
+    }
+    REQUIRE(!index.Replay(mapped.data(), mapped.size() - 1, parsers));
+    REQUIRE(index.Replay(mapped.data(), mapped.size(), parsers));
+
+    // Each stock locate is replayed by its worker in the capture order,
+    // market wide messages are replayed by all workers
+    size_t messages = 0;
+    for (size_t i = 0; i < workers; ++i)
+    {
+        REQUIRE(worker_handlers[i].market == handler.market);
+        messages += worker_handlers[i].messages - worker_handlers[i].market;
+        for (const auto& stock : worker_handlers[i].stocks)
+        {
+            REQUIRE(partition[stock.first] == i);
+            REQUIRE(stock.second == handler.stocks[stock.first]);
+        }
+    }
+    REQUIRE(messages == handler.messages - handler.market);
+}
+
+TEST_CASE("ITCHIndex split", "[CppTrader][Providers][NASDAQ]")
+{
+    // Index a small capture of market wide and order delete messages
+    std::vector<uint8_t> capture;
+    for (uint16_t stock_locate : { 0, 1, 2, 1, 0, 3 })
+    {
+        uint8_t message[21] = { 0, 19, (uint8_t)((stock_locate == 0) ? 'S' : 'D'), 0, (uint8_t)stock_locate };
+        capture.insert(capture.end(), message, message + sizeof(message));
+    }
+    ITCHIndex index;
+    REQUIRE(index.Build(capture.data(), capture.size()));
+
+    // Messages of each worker are split in the capture order, market wide messages are split to all workers
+    std::vector<uint16_t> partition(65536, 0);
+    partition[2] = 1;
+    partition[3] = 1;
+    std::vector<std::vector<size_t>> messages = index.Split(partition, 2);
+    REQUIRE(messages.size() == 2);
+    REQUIRE(messages[0] == std::vector<size_t>({ 0, 1, 3, 4 }));
+    REQUIRE(messages[1] == std::vector<size_t>({ 0, 2, 4, 5 }));
+
+    // Replay the capture with workers of the same partition
+    struct LocateHandler
+    {
+        std::vector<uint16_t> locates;
+        bool ProcessMessage(const void* buffer, size_t size) { locates.push_back(MessageView(buffer, size).StockLocate()); return true; }
+    };
+    std::vector<LocateHandler> handlers(2);
+    std::vector<LocateHandler*> workers({ &handlers[0], &handlers[1] });
+    REQUIRE(index.Replay(capture.data(), capture.size(), workers));
+    REQUIRE(handlers[0].locates.size() + handlers[1].locates.size() == 8);
+    partition = index.Partition(2);
+    for (size_t i = 0; i < handlers.size(); ++i)
+        for (uint16_t stock_locate : handlers[i].locates)
+            REQUIRE(((stock_locate == 0) || (partition[stock_locate] == i)));
+}
+
+TEST_CASE("ITCHIndex corrupted index file", "[CppTrader][Providers][NASDAQ]")
+{
+    // Index a small capture of order delete messages
+    std::vector<uint8_t> capture;
+    for (uint16_t stock_locate = 1; stock_locate <= 4; ++stock_locate)
+    {
+        uint8_t message[21] = { 0, 19, 'D', 0, (uint8_t)stock_locate };
+        capture.insert(capture.end(), message, message + sizeof(message));
+    }
+    ITCHIndex index;
+    REQUIRE(index.Build(capture.data(), capture.size()));
+    REQUIRE(index.size() == 4);
+
+    std::string index_filename = "test_itch_index_corrupted.idx";
+    REQUIRE(index.Save(index_filename));
+
+    // Read the saved index file
+    std::vector<uint8_t> saved;
+    FILE* file = std::fopen(index_filename.c_str(), "rb");
+    REQUIRE(file != nullptr);
+    uint8_t buffer[256];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+        saved.insert(saved.end(), buffer, buffer + read);
+    std::fclose(file);
+    const size_t header_size = saved.size() - index.size() * sizeof(ITCHIndexEntry);
+
+    // Write the index file with the given bytes and try to load it
+    auto load = [&index_filename](const std::vector<uint8_t>& bytes)
+    {
+        FILE* output = std::fopen(index_filename.c_str(), "wb");
+        REQUIRE(output != nullptr);
+        REQUIRE(std::fwrite(bytes.data(), 1, bytes.size(), output) == bytes.size());
+        std::fclose(output);
+        ITCHIndex loaded;
+        bool result = loaded.Load(index_filename);
+        REQUIRE(result != loaded.empty());
+        return result;
+    };
+    auto corrupt = [&saved, header_size](size_t i, const ITCHIndexEntry& entry)
+    {
+        std::vector<uint8_t> bytes(saved);
+        std::memcpy(bytes.data() + header_size + i * sizeof(ITCHIndexEntry), &entry, sizeof(entry));
+        return bytes;
+    };
+
+    // Valid index file is loaded
+    REQUIRE(load(saved));
+
+    // Truncated index file is rejected
+    REQUIRE(!load(std::vector<uint8_t>(saved.begin(), saved.end() - 1)));
+    REQUIRE(!load(std::vector<uint8_t>(saved.begin(), saved.begin() + header_size)));
+
+    // Message outside of the capture is rejected
+    REQUIRE(!load(corrupt(3, ITCHIndexEntry(index[3].Offset(), 'D', 20, 0, 4))));
+    REQUIRE(!load(corrupt(3, ITCHIndexEntry(capture.size(), 'D', 19, 0, 4))));
+
+    // Empty, overlapping and non-monotonic messages are rejected
+    REQUIRE(!load(corrupt(1, ITCHIndexEntry(index[1].Offset(), 'D', 0, 0, 2))));
+    REQUIRE(!load(corrupt(1, ITCHIndexEntry(index[1].Offset() - 1, 'D', 19, 0, 2))));
+    REQUIRE(!load(corrupt(1, index[2])));
+
+    std::remove(index_filename.c_str());
+}
@@ -0,0 +1,137 @@
+//
+// Created by Ivan Shynkarenka on 07.09.2017
+//
+
+#include "test.h"
+
+#include "trader/providers/nasdaq/itch_parser.h"
+
+#include "filesystem/file.h"
+
+using namespace CppCommon;
+using namespace CppTrader::ITCH;
+
+namespace {
+
+// ITCH handler counts all messages
+class MyITCHHandler : public ITCHHandler
+{
+public:
+    size_t messages = 0;
+    size_t orders = 0;
+    uint64_t shares = 0;
+
+protected:
+    bool onMessageView(const SystemEventMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const StockDirectoryMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const StockTradingActionMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const RegSHOMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const MarketParticipantPositionMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const MWCBDeclineMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const MWCBStatusMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const IPOQuotingMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const AddOrderMessageView& message) override { ++messages; ++orders; shares += message.Shares(); return true; }
+    bool onMessageView(const AddOrderMPIDMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const OrderExecutedMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const OrderExecutedWithPriceMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const OrderCancelMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const OrderDeleteMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const OrderReplaceMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const TradeMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const CrossTradeMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const BrokenTradeMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const NOIIMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const RPIIMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const LULDAuctionCollarMessageView& message) override { ++messages; return true; }
+    bool onMessageView(const UnknownMessageView& message) override { return false; }
+};
+
+// ITCH parser handler counts all messages with the generic overload
+struct AllMessagesHandler
+{
+    size_t messages = 0;
+    size_t unknown = 0;
+
+    template <class TMessageView>
+    bool onMessage(const TMessageView& message) { ++messages; return true; }
+    bool onMessage(const UnknownMessageView& message) { ++unknown; return false; }
+};
+
+// ITCH parser handler handles only add order messages, others are skipped
+struct AddOrderHandler
+{
+    size_t orders = 0;
+    uint64_t shares = 0;
+
+    bool onMessage(const AddOrderMessageView& message) { ++orders; shares += message.Shares(); return true; }
+};
+
+} // namespace
+
+TEST_CASE("ITCHParser", "[CppTrader][Providers][NASDAQ]")
+{
+    // Handler overloads are detected at compile time
+    REQUIRE(ITCHParser<AllMessagesHandler>::IsHandled<OrderDeleteMessageView>());
+    REQUIRE(ITCHParser<AddOrderHandler>::IsHandled<AddOrderMessageView>());
+    REQUIRE(!ITCHParser<AddOrderHandler>::IsHandled<OrderDeleteMessageView>());
+    REQUIRE(!ITCHParser<AddOrderHandler>::IsHandled<UnknownMessageView>());
+
+    MyITCHHandler itch_handler;
+    itch_handler.EnableViewMode();
+    AllMessagesHandler all_handler;
+    ITCHParser<AllMessagesHandler> all_parser(all_handler);
+    AddOrderHandler add_handler;
+    ITCHParser<AddOrderHandler> add_parser(add_handler);
+
+    // Unknown message stops the processing only when it is handled
+    uint8_t unknown[] = { 0, 3, 'Z', 0, 0 };
+    REQUIRE(!all_parser.Process(unknown, sizeof(unknown)));
+    REQUIRE(all_handler.unknown == 1);
+    REQUIRE(add_parser.Process(unknown, sizeof(unknown)));
+    all_parser.Reset();
+
+    // Open the input file
+    File input("../../tools/itch/sample.itch");
+    if (!input.IsExists())
+        input = File("../tools/itch/sample.itch");
+    REQUIRE(input.IsExists());
+    input.Open(true, false);
+
+    // Perform input
+    size_t size;
+    uint8_t buffer[8192];
+    while ((size = input.Read(buffer, sizeof(buffer))) > 0)
+    {
+        // Process the buffer
+        REQUIRE(itch_handler.Process(buffer, size));
+        REQUIRE(all_parser.Process(buffer, size));
+        REQUIRE(add_parser.Process(buffer, size));
+    }
+
+    // Check results
+    REQUIRE(itch_handler.orders > 0);
+    REQUIRE(all_handler.messages == itch_handler.messages);
+    REQUIRE(add_handler.orders == itch_handler.orders);
+    REQUIRE(add_handler.shares == itch_handler.shares);
+
+    // Filter mode skips messages of other stock locates without parsing
+    StockLocateFilter filter;
+    MyITCHHandler filtered_handler;
+    filtered_handler.EnableViewMode();
+    filtered_handler.EnableFilterMode(filter);
+    AllMessagesHandler filtered_all_handler;
+    ITCHParser<AllMessagesHandler> filtered_parser(filtered_all_handler);
+    filtered_parser.EnableFilterMode(filter);
+    REQUIRE(filtered_parser.IsFilterModeEnabled());
+    input.Close();
+    input.Open(true, false);
+    while ((size = input.Read(buffer, sizeof(buffer))) > 0)
+    {
+        REQUIRE(filtered_handler.Process(buffer, size));
+        REQUIRE(filtered_parser.Process(buffer, size));
+    }
+    REQUIRE(filtered_handler.messages > 0);
+    REQUIRE(filtered_handler.messages < itch_handler.messages);
+    REQUIRE(filtered_handler.orders == 0);
+    REQUIRE(filtered_all_handler.messages == filtered_handler.messages);
+}
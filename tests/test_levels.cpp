@@ -0,0 +1,330 @@
+//
+// Created by Ivan Shynkarenka on 17.08.2017
+//
+
+#include "test.h"
+
+#include "trader/matching/market_manager.h"
+
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace CppTrader::Matching;
+
+template <class TLevelNode>
+using LevelsLadderTick10 = BasicLevelsLadder<TLevelNode, 10, 128>;
+
+template <class TLevelNode>
+using LevelsBTreeSmall = BasicLevelsBTree<TLevelNode, 4>;
+
+TEMPLATE_TEST_CASE("Price levels container", "[CppTrader][Matching]", LevelsAVL<LevelNode>, LevelsVector<LevelNode>, LevelsLadder<LevelNode>, LevelsLadderTick10<LevelNode>, LevelsBTree<LevelNode>, LevelsBTreeSmall<LevelNode>)
+{
+    for (auto type : { LevelType::BID, LevelType::ASK })
+    {
+        std::vector<LevelNode> nodes;
+        nodes.reserve(5);
+        for (uint64_t price : { 30, 10, 50, 20, 40 })
+            nodes.emplace_back(type, price);
+
+        TestType levels(type);
+        REQUIRE(levels.empty());
+        for (auto& node : nodes)
+            levels.insert(node);
+        REQUIRE(levels.size() == 5);
+
+        // Price levels should be iterated in the ascending price order
+        uint64_t expected = 10;
+        for (const auto& level : levels)
+        {
+            REQUIRE(level.Price == expected);
+            expected += 10;
+        }
+
+        // Find price levels
+        REQUIRE(levels.find(30) == &nodes[0]);
+        REQUIRE(levels.find(10) == &nodes[1]);
+        REQUIRE(levels.find(50) == &nodes[2]);
+        REQUIRE(levels.find(35) == nullptr);
+        REQUIRE(levels.find(60) == nullptr);
+
+        // Find neighbour price levels
+        REQUIRE(levels.lower(nodes[0]) == &nodes[3]);
+        REQUIRE(levels.higher(nodes[0]) == &nodes[4]);
+        REQUIRE(levels.lower(nodes[1]) == nullptr);
+        REQUIRE(levels.higher(nodes[2]) == nullptr);
+
+        // Erase price levels
+        levels.erase(nodes[0]);
+        REQUIRE(levels.size() == 4);
+        REQUIRE(levels.find(30) == nullptr);
+        REQUIRE(levels.lower(nodes[4]) == &nodes[3]);
+        REQUIRE(levels.higher(nodes[3]) == &nodes[4]);
+        levels.erase(nodes[1]);
+        levels.erase(nodes[2]);
+        REQUIRE(levels.size() == 2);
+        REQUIRE(levels.lower(nodes[3]) == nullptr);
+        REQUIRE(levels.higher(nodes[4]) == nullptr);
+
+        levels.clear();
+        REQUIRE(levels.empty());
+    }
+}
+
+TEMPLATE_TEST_CASE("Price levels container - order book", "[CppTrader][Matching]", MarketTraits<LevelsAVL>, MarketTraits<LevelsVector>, MarketTraits<LevelsLadder>, MarketTraits<LevelsLadderTick10>, MarketTraits<LevelsBTree>)
+{
+    MarketManagerT<TestType> market;
+
+    // Prepare symbol & order book
+    const char name[8] = "test";
+    Symbol symbol = { 0, name };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+    auto order_book_ptr = market.GetOrderBook(0);
+
+    // Add buy and sell limit orders
+    for (uint64_t i = 0; i < 10; ++i)
+    {
+        market.AddOrder(Order::BuyLimit(1 + i, 0, 100 - i * 10, 10));
+        market.AddOrder(Order::SellLimit(11 + i, 0, 110 + i * 10, 10));
+    }
+    REQUIRE(order_book_ptr->bids().size() == 10);
+    REQUIRE(order_book_ptr->asks().size() == 10);
+    REQUIRE(order_book_ptr->best_bid()->Price == 100);
+    REQUIRE(order_book_ptr->best_ask()->Price == 110);
+
+    // Delete the best price levels
+    market.DeleteOrder(1);
+    market.DeleteOrder(11);
+    REQUIRE(order_book_ptr->best_bid()->Price == 90);
+    REQUIRE(order_book_ptr->best_ask()->Price == 120);
+
+    // Automatic matching should sweep price levels from the top of the book
+    market.EnableMatching();
+    market.AddOrder(Order::BuyLimit(21, 0, 135, 25));
+    REQUIRE(order_book_ptr->asks().size() == 7);
+    REQUIRE(order_book_ptr->best_ask()->Price == 140);
+    REQUIRE(order_book_ptr->best_bid()->Price == 135);
+    REQUIRE(order_book_ptr->best_bid()->TotalVolume == 5);
+    market.AddOrder(Order::SellMarket(22, 0, 1000));
+    REQUIRE(order_book_ptr->bids().empty());
+    REQUIRE(order_book_ptr->best_bid() == nullptr);
+}
+
+TEST_CASE("Price levels tick ladder", "[CppTrader][Matching]")
+{
+    std::vector<LevelNode> nodes;
+    nodes.reserve(7);
+    for (uint64_t price : { 1000, 1010, 1005, 3000, 5, 1700, 2500 })
+        nodes.emplace_back(LevelType::ASK, price);
+
+    LevelsLadderTick10<LevelNode> levels(LevelType::ASK);
+
+    // The first price level should center the window
+    levels.insert(nodes[0]);
+    REQUIRE(levels.window() == 64);
+    REQUIRE(levels.find(1000) == &nodes[0]);
+    REQUIRE(levels.fallback().empty());
+
+    // Price levels not aligned to the tick size or out of the window capacity should fall back to the tree
+    levels.insert(nodes[1]);
+    levels.insert(nodes[2]);
+    levels.insert(nodes[3]);
+    levels.insert(nodes[4]);
+    REQUIRE(levels.size() == 5);
+    REQUIRE(levels.fallback().size() == 3);
+    REQUIRE(levels.find(1005) == &nodes[2]);
+    REQUIRE(levels.find(3000) == &nodes[3]);
+    REQUIRE(levels.find(5) == &nodes[4]);
+
+    // Window and fallback price levels should be merged in the ascending price order
+    std::vector<uint64_t> prices;
+    for (const auto& level : levels)
+        prices.push_back(level.Price);
+    REQUIRE(prices == std::vector<uint64_t>({ 5, 1000, 1005, 1010, 3000 }));
+    prices.clear();
+    for (auto it = levels.rbegin(); it != levels.rend(); ++it)
+        prices.push_back(it->Price);
+    REQUIRE(prices == std::vector<uint64_t>({ 3000, 1010, 1005, 1000, 5 }));
+    REQUIRE(levels.lower(nodes[1]) == &nodes[2]);
+    REQUIRE(levels.higher(nodes[0]) == &nodes[2]);
+    REQUIRE(levels.higher(nodes[1]) == &nodes[3]);
+
+    // The window should grow to cover the new price level
+    levels.insert(nodes[5]);
+    REQUIRE(levels.window() == 128);
+    REQUIRE(levels.find(1700) == &nodes[5]);
+    REQUIRE(levels.fallback().size() == 3);
+
+    // The empty window should recenter and migrate fallback price levels
+    levels.erase(nodes[0]);
+    levels.erase(nodes[1]);
+    levels.erase(nodes[5]);
+    levels.erase(nodes[2]);
+    levels.insert(nodes[0]);
+    REQUIRE(levels.fallback().size() == 2);
+    levels.erase(nodes[0]);
+    levels.erase(nodes[4]);
+    levels.insert(nodes[1]);
+    REQUIRE(levels.base() <= 1010);
+    REQUIRE(levels.find(3000) == &nodes[3]);
+    REQUIRE(levels.fallback().size() == 1);
+    levels.erase(nodes[1]);
+    levels.insert(nodes[6]);
+    REQUIRE(levels.fallback().empty());
+    REQUIRE(levels.lower(nodes[3]) == &nodes[6]);
+    REQUIRE(levels.higher(nodes[6]) == &nodes[3]);
+
+    // The empty window should not be laid out on the price not aligned to the tick size
+    LevelsLadderTick10<LevelNode> unaligned(LevelType::ASK);
+    unaligned.insert(nodes[2]);
+    REQUIRE(unaligned.window() == 0);
+    REQUIRE(unaligned.fallback().size() == 1);
+    unaligned.insert(nodes[0]);
+    REQUIRE(unaligned.window() == 64);
+    REQUIRE((unaligned.base() % 10) == 0);
+    REQUIRE(unaligned.find(1000) == &nodes[0]);
+    REQUIRE(unaligned.find(1005) == &nodes[2]);
+    REQUIRE(unaligned.fallback().size() == 1);
+}
+
+TEST_CASE("Price levels tick ladder recentering", "[CppTrader][Matching]")
+{
+    std::vector<LevelNode> asks;
+    asks.reserve(5);
+    for (uint64_t price : { 3000, 2990, 1000, 1500, 4000 })
+        asks.emplace_back(LevelType::ASK, price);
+
+    LevelsLadderTick10<LevelNode> ask_levels(LevelType::ASK);
+    ask_levels.insert(asks[0]);
+    ask_levels.insert(asks[1]);
+    REQUIRE(ask_levels.fallback().empty());
+
+    // The window should follow the new best ask price and demote far price levels to the tree
+    ask_levels.insert(asks[2]);
+    REQUIRE(ask_levels.window() == 128);
+    REQUIRE(ask_levels.base() == 680);
+    REQUIRE(ask_levels.fallback().size() == 2);
+    REQUIRE(ask_levels.find(1000) == &asks[2]);
+    REQUIRE(ask_levels.find(2990) == &asks[1]);
+
+    // Worse price levels out of the window should fall back to the tree
+    ask_levels.insert(asks[3]);
+    ask_levels.insert(asks[4]);
+    REQUIRE(ask_levels.size() == 5);
+    REQUIRE(ask_levels.fallback().size() == 3);
+    std::vector<uint64_t> prices;
+    for (const auto& level : ask_levels)
+        prices.push_back(level.Price);
+    REQUIRE(prices == std::vector<uint64_t>({ 1000, 1500, 2990, 3000, 4000 }));
+    REQUIRE(ask_levels.higher(asks[3]) == &asks[1]);
+    REQUIRE(ask_levels.lower(asks[1]) == &asks[3]);
+    ask_levels.erase(asks[1]);
+    ask_levels.erase(asks[2]);
+    REQUIRE(ask_levels.fallback().size() == 2);
+    REQUIRE(ask_levels.higher(asks[3]) == &asks[0]);
+
+    std::vector<LevelNode> bids;
+    bids.reserve(3);
+    for (uint64_t price : { 1000, 1010, 3000 })
+        bids.emplace_back(LevelType::BID, price);
+
+    LevelsLadderTick10<LevelNode> bid_levels(LevelType::BID);
+    bid_levels.insert(bids[0]);
+    bid_levels.insert(bids[1]);
+
+    // The window should follow the new best bid price and keep more space for worse prices
+    bid_levels.insert(bids[2]);
+    REQUIRE(bid_levels.base() == 2050);
+    REQUIRE(bid_levels.fallback().size() == 2);
+    prices.clear();
+    for (auto it = bid_levels.rbegin(); it != bid_levels.rend(); ++it)
+        prices.push_back(it->Price);
+    REQUIRE(prices == std::vector<uint64_t>({ 3000, 1010, 1000 }));
+}
+
+TEST_CASE("Price levels B+tree", "[CppTrader][Matching]")
+{
+    const size_t count = 1000;
+
+    std::vector<LevelNode> nodes;
+    nodes.reserve(count);
+    for (uint64_t i = 0; i < count; ++i)
+        nodes.emplace_back(LevelType::BID, 10 + i * 10);
+
+    LevelsBTreeSmall<LevelNode> levels(LevelType::BID);
+    std::set<uint64_t> prices;
+
+    // Random inserts and erases should split and merge nodes keeping the container ordered
+    std::mt19937 generator(0);
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        LevelNode& node = nodes[generator() % count];
+        if (prices.count(node.Price) > 0)
+        {
+            levels.erase(node);
+            prices.erase(node.Price);
+        }
+        else
+        {
+            levels.insert(node);
+            prices.insert(node.Price);
+        }
+    }
+    REQUIRE(levels.size() == prices.size());
+    REQUIRE(levels.depth() > 1);
+
+    auto it = prices.begin();
+    for (const auto& level : levels)
+        REQUIRE(level.Price == *it++);
+    REQUIRE(it == prices.end());
+
+    for (const auto& node : nodes)
+    {
+        auto level = levels.find(node.Price);
+        if (prices.count(node.Price) == 0)
+        {
+            REQUIRE(level == nullptr);
+            continue;
+        }
+        REQUIRE(level == &node);
+
+        auto next = prices.upper_bound(node.Price);
+        auto higher = levels.higher(node);
+        REQUIRE(((next == prices.end()) ? (higher == nullptr) : (higher->Price == *next)));
+        auto prev = prices.find(node.Price);
+        auto lower = levels.lower(node);
+        REQUIRE(((prev == prices.begin()) ? (lower == nullptr) : (lower->Price == *--prev)));
+    }
+
+    // Depth walks should step through the linked leaves in both directions
+    std::vector<uint64_t> walk;
+    for (const LevelNode* level = &*levels.begin(); level != nullptr; level = levels.higher(*level))
+        walk.push_back(level->Price);
+    REQUIRE(walk == std::vector<uint64_t>(prices.begin(), prices.end()));
+    walk.clear();
+    for (const LevelNode* level = &*levels.rbegin(); level != nullptr; level = levels.lower(*level))
+        walk.push_back(level->Price);
+    REQUIRE(walk == std::vector<uint64_t>(prices.rbegin(), prices.rend()));
+
+    // Sweep should erase visited price levels while walking to the next ones
+    std::set<uint64_t> swept;
+    for (LevelNode* level = &*levels.begin(); (level != nullptr) && (swept.size() < 100);)
+    {
+        LevelNode* next = levels.higher(*level);
+        swept.insert(level->Price);
+        prices.erase(level->Price);
+        levels.erase(*level);
+        level = next;
+    }
+    REQUIRE(levels.size() == prices.size());
+    REQUIRE(levels.begin()->Price == *prices.begin());
+    REQUIRE(levels.begin()->Price > *swept.rbegin());
+
+    // Erase all price levels
+    for (auto price : prices)
+        levels.erase(nodes[price / 10 - 1]);
+    REQUIRE(levels.empty());
+    REQUIRE(levels.depth() == 0);
+    REQUIRE(levels.begin() == levels.end());
+}
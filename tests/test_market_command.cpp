@@ -0,0 +1,330 @@
+//
+// Created by Ivan Shynkarenka on 26.08.2017
+//
+
+#include "test.h"
+
+#include "trader/matching/market_command.h"
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CppTrader::Matching;
+
+namespace {
+
+// Market handler records order and execution events
+class RecordingMarketHandler : public MarketHandler
+{
+public:
+    std::vector<std::string> events;
+
+protected:
+    void onAddOrder(const Order& order) override { Record("AddOrder", order.Id, order.LeavesQuantity); }
+    void onUpdateOrder(const Order& order) override { Record("UpdateOrder", order.Id, order.LeavesQuantity); }
+    void onDeleteOrder(const Order& order) override { Record("DeleteOrder", order.Id, order.LeavesQuantity); }
+    void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { Record("ExecuteOrder", order.Id, price, quantity); }
+
+private:
+    void Record(const char* event, uint64_t a = 0, uint64_t b = 0, uint64_t c = 0)
+    {
+        events.push_back(std::string(event) + " " + std::to_string(a) + " " + std::to_string(b) + " " + std::to_string(c));
+    }
+};
+
+// Prepare the market with two order books and enabled matching
+void Prepare(MarketManager& market)
+{
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        market.AddSymbol(Symbol(i, "test"));
+        market.AddOrderBook(Symbol(i, "test"));
+    }
+    market.EnableMatching();
+}
+
+// Generate random order commands for two order books and execute them with the given market
+std::vector<MarketCommand> Generate(MarketManager& market, size_t count, bool crossing, bool modify)
+{
+    std::vector<MarketCommand> commands;
+
+    uint64_t seed = 7;
+    auto random = [&seed](uint64_t range) { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return (seed >> 33) % range; };
+
+    uint64_t id = 1;
+    while (commands.size() < count)
+    {
+        uint32_t symbol = (uint32_t)random(2);
+        uint64_t victim = 1 + random(id);
+        uint64_t quantity = 1 + random(50);
+        uint64_t bid = crossing ? (95 + random(10)) : (90 + random(10));
+        uint64_t ask = crossing ? (95 + random(10)) : (100 + random(10));
+
+        uint64_t operation = random(6);
+        if ((operation >= 2) && (operation != 4) && (!modify || (market.GetOrder(victim) == nullptr)))
+            continue;
+
+        switch (operation)
+        {
+            case 0:
+                commands.push_back(MarketCommand::AddOrder(Order::BuyLimit(id++, symbol, bid, quantity)));
+                break;
+            case 1:
+                commands.push_back(MarketCommand::AddOrder(Order::SellLimit(id++, symbol, ask, quantity)));
+                break;
+            case 2:
+                commands.push_back(MarketCommand::ReduceOrder(victim, 1));
+                break;
+            case 3:
+                commands.push_back(MarketCommand::MitigateOrder(victim, market.GetOrder(victim)->Price, quantity));
+                break;
+            case 4:
+                commands.push_back(MarketCommand::AddOrder(Order::BuyLimit(id++, symbol, ask, quantity, OrderTimeInForce::IOC)));
+                break;
+            default:
+                commands.push_back(MarketCommand::DeleteOrder(victim));
+                break;
+        }
+        REQUIRE(commands.back().Execute(market) == ErrorCode::OK);
+    }
+
+    return commands;
+}
+
+} // namespace
+TEST_CASE("Market command", "[CppTrader][Matching]")
+{
+    MarketHandler handler;
+    MarketManager market(handler);
+    MarketManager expected(handler);
+
+    // The same commands applied through market commands and directly
+    REQUIRE(MarketCommand::AddSymbol(Symbol(0, "test")).Execute(market) == ErrorCode::OK);
+    REQUIRE(MarketCommand::AddOrderBook(Symbol(0, "test")).Execute(market) == ErrorCode::OK);
+    REQUIRE(MarketCommand::AddOrder(Order::BuyLimit(1, 0, 10, 100)).Execute(market) == ErrorCode::OK);
+    REQUIRE(MarketCommand::AddOrder(Order::SellLimit(2, 0, 20, 100)).Execute(market) == ErrorCode::OK);
+    REQUIRE(MarketCommand::ReduceOrder(1, 10).Execute(market) == ErrorCode::OK);
+    REQUIRE(MarketCommand::ModifyOrder(2, 30, 50).Execute(market) == ErrorCode::OK);
+    REQUIRE(MarketCommand::ReplaceOrder(1, 3, 15, 40).Execute(market) == ErrorCode::OK);
+    REQUIRE(MarketCommand::ExecuteOrder(3, 5).Execute(market) == ErrorCode::OK);
+    REQUIRE(MarketCommand::AddOrder(Order::BuyLimit(4, 1, 10, 100)).Execute(market) == ErrorCode::ORDER_BOOK_NOT_FOUND);
+
+    expected.AddSymbol(Symbol(0, "test"));
+    expected.AddOrderBook(Symbol(0, "test"));
+    expected.AddOrder(Order::BuyLimit(1, 0, 10, 100));
+    expected.AddOrder(Order::SellLimit(2, 0, 20, 100));
+    expected.ReduceOrder(1, 10);
+    expected.ModifyOrder(2, 30, 50);
+    expected.ReplaceOrder(1, 3, 15, 40);
+    expected.ExecuteOrder(3, 5);
+
+    REQUIRE(market.orders().size() == expected.orders().size());
+    for (const auto& order : expected.orders())
+    {
+        const Order* actual = market.GetOrder(order.first);
+        REQUIRE(actual != nullptr);
+        REQUIRE(actual->Price == order.second->Price);
+        REQUIRE(actual->LeavesQuantity == order.second->LeavesQuantity);
+    }
+}
+
+TEST_CASE("Market command queue", "[CppTrader][Matching]")
+{
+    MarketHandler handler;
+    MarketManager market(handler);
+    MarketCommandQueue queue(16);
+
+    REQUIRE(queue.capacity() == 16);
+    REQUIRE(queue.empty());
+
+    // Fill the queue
+    REQUIRE(queue.Enqueue(MarketCommand::AddSymbol(Symbol(0, "test"))));
+    REQUIRE(queue.Enqueue(MarketCommand::AddOrderBook(Symbol(0, "test"))));
+    for (uint64_t id = 1; id <= 14; ++id)
+        REQUIRE(queue.Enqueue(MarketCommand::AddOrder(Order::BuyLimit(id, 0, 10 + id, 10))));
+    REQUIRE(queue.size() == 16);
+    REQUIRE(!queue.Enqueue(MarketCommand::DeleteOrder(1)));
+
+    // Drain the queue in limited batches
+    MarketCommandBatch batch = queue.Drain(market, 10);
+    REQUIRE(batch.Commands == 10);
+    REQUIRE(batch.Errors == 0);
+    REQUIRE(batch.MaxLatency >= batch.AvgLatency());
+    REQUIRE(queue.size() == 6);
+
+    // Rejected commands are reported as batch errors
+    REQUIRE(queue.Enqueue(MarketCommand::AddOrder(Order::BuyLimit(1000, 1, 10, 10))));
+    batch = queue.Drain(market);
+    REQUIRE(batch.Commands == 7);
+    REQUIRE(batch.Errors == 1);
+    REQUIRE(queue.empty());
+    REQUIRE(market.orders().size() == 14);
+
+    // Empty batch
+    batch = queue.Drain(market);
+    REQUIRE(batch.Commands == 0);
+    REQUIRE(batch.Time == 0);
+
+    // Drain into the market manager with the statically dispatched market handler
+    NullMarketHandler null_handler;
+    MarketManagerT<MarketTraits<>, NullMarketHandler> null_market(null_handler);
+    REQUIRE(queue.Enqueue(MarketCommand::AddSymbol(Symbol(0, "test"))));
+    REQUIRE(queue.Enqueue(MarketCommand::AddOrderBook(Symbol(0, "test"))));
+    REQUIRE(queue.Enqueue(MarketCommand::AddOrder(Order::BuyLimit(1, 0, 10, 10))));
+    batch = queue.Drain(null_market);
+    REQUIRE(batch.Commands == 3);
+    REQUIRE(batch.Errors == 0);
+    REQUIRE(null_market.orders().size() == 1);
+}
+
+TEST_CASE("Market command queue with multiple producers", "[CppTrader][Matching]")
+{
+    MarketHandler handler;
+    MarketManager market(handler);
+    MarketCommandQueue queue(256);
+
+    const uint32_t producers = 4;
+    const uint64_t orders = 10000;
+
+    for (uint32_t i = 0; i < producers; ++i)
+    {
+        market.AddSymbol(Symbol(i, "test"));
+        market.AddOrderBook(Symbol(i, "test"));
+    }
+
+    // Each producer adds orders into its own order book
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < producers; ++i)
+    {
+        threads.emplace_back([&queue, i, orders]()
+        {
+            for (uint64_t j = 0; j < orders; ++j)
+            {
+                MarketCommand command = MarketCommand::AddOrder(Order::BuyLimit(i * orders + j + 1, i, 100 + (j % 10), 1));
+                while (!queue.Enqueue(command))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // Drain commands on the market manager thread
+    size_t commands = 0;
+    size_t errors = 0;
+    size_t batches = 0;
+    while (commands < (producers * orders))
+    {
+        MarketCommandBatch batch = queue.Drain(market, 64);
+        REQUIRE(batch.Commands <= 64);
+        commands += batch.Commands;
+        errors += batch.Errors;
+        if (batch.Commands > 0)
+            ++batches;
+        else
+            std::this_thread::yield();
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    REQUIRE(queue.empty());
+    REQUIRE(errors == 0);
+    REQUIRE(batches >= (producers * orders) / 64);
+    REQUIRE(market.orders().size() == (producers * orders));
+    for (uint32_t i = 0; i < producers; ++i)
+    {
+        REQUIRE(market.GetOrderBook(i)->bids().size() == 10);
+        REQUIRE(market.GetOrderBook(i)->best_bid()->TotalVolume == orders / 10);
+    }
+}
+
+TEST_CASE("Market commands batch", "[CppTrader][Matching]")
+{
+    // Non-crossing order commands
+    RecordingMarketHandler expected_handler;
+    MarketManager expected(expected_handler);
+    Prepare(expected);
+    std::vector<MarketCommand> commands = Generate(expected, 5000, false, true);
+
+    // Deferred matching does not change the result of non-crossing commands
+    RecordingMarketHandler handler;
+    MarketManager market(handler);
+    Prepare(market);
+    size_t errors = 0;
+    for (size_t i = 0; i < commands.size(); i += 100)
+        errors += market.ApplyBatch(commands.data() + i, std::min<size_t>(100, commands.size() - i));
+    REQUIRE(market.IsMatchingEnabled());
+    REQUIRE(errors == 0);
+    REQUIRE(handler.events.size() > 5000);
+    REQUIRE(handler.events == expected_handler.events);
+
+    // Strict mode keeps the sequential semantics of crossing commands
+    RecordingMarketHandler sequential_handler;
+    MarketManager sequential(sequential_handler);
+    Prepare(sequential);
+    commands = Generate(sequential, 5000, true, true);
+
+    RecordingMarketHandler strict_handler;
+    MarketManager strict(strict_handler);
+    Prepare(strict);
+    REQUIRE(strict.ApplyBatch(commands.data(), commands.size(), true) == 0);
+    REQUIRE(strict_handler.events == sequential_handler.events);
+
+    // Deferred matching leaves all dirty order books uncrossed
+    MarketManager reference;
+    Prepare(reference);
+    commands = Generate(reference, 5000, true, false);
+
+    MarketManager deferred;
+    Prepare(deferred);
+    for (size_t i = 0; i < commands.size(); i += 100)
+        REQUIRE(deferred.ApplyBatch(commands.data() + i, std::min<size_t>(100, commands.size() - i)) == 0);
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        const OrderBook* order_book_ptr = deferred.GetOrderBook(i);
+        REQUIRE(order_book_ptr->best_bid() != nullptr);
+        REQUIRE(order_book_ptr->best_ask() != nullptr);
+        REQUIRE(order_book_ptr->best_bid()->Price < order_book_ptr->best_ask()->Price);
+    }
+}
+
+TEST_CASE("Market commands batch with immediate orders", "[CppTrader][Matching]")
+{
+    RecordingMarketHandler handler;
+    MarketManager market(handler);
+    Prepare(market);
+
+    // Crossing limit orders are matched at the end of the batch, but the
+    // 'Immediate-Or-Cancel' order is matched with the order book in place
+    std::vector<MarketCommand> commands;
+    commands.push_back(MarketCommand::AddOrder(Order::SellLimit(1, 0, 100, 10)));
+    commands.push_back(MarketCommand::AddOrder(Order::BuyLimit(2, 0, 100, 4)));
+    commands.push_back(MarketCommand::AddOrder(Order::BuyLimit(3, 0, 100, 5, OrderTimeInForce::IOC)));
+    commands.push_back(MarketCommand::AddOrder(Order::BuyLimit(4, 1, 100, 5)));
+    commands.push_back(MarketCommand::AddOrder(Order::SellLimit(5, 1, 90, 5)));
+    commands.push_back(MarketCommand::AddOrder(Order::BuyLimit(100, 5, 100, 5)));
+    REQUIRE(market.ApplyBatch(commands.data(), commands.size()) == 1);
+
+    REQUIRE(market.GetOrder(1) != nullptr);
+    REQUIRE(market.GetOrder(1)->LeavesQuantity == 1);
+    REQUIRE(market.GetOrder(2) == nullptr);
+    REQUIRE(market.GetOrder(3) == nullptr);
+    REQUIRE(market.GetOrder(4) == nullptr);
+    REQUIRE(market.GetOrder(5) == nullptr);
+    REQUIRE(market.GetOrderBook(0)->best_bid() == nullptr);
+    REQUIRE(market.GetOrderBook(1)->best_bid() == nullptr);
+    REQUIRE(market.GetOrderBook(1)->best_ask() == nullptr);
+
+    // Disabled matching is not affected by the batch
+    market.DisableMatching();
+    commands.clear();
+    commands.push_back(MarketCommand::AddOrder(Order::BuyLimit(6, 0, 100, 5)));
+    commands.push_back(MarketCommand::EnableMatching());
+    commands.push_back(MarketCommand::AddOrder(Order::BuyLimit(7, 0, 100, 5)));
+    REQUIRE(market.ApplyBatch(commands.data(), commands.size()) == 0);
+    REQUIRE(market.IsMatchingEnabled());
+    REQUIRE(market.GetOrder(1) == nullptr);
+    REQUIRE(market.GetOrder(6)->LeavesQuantity == 4);
+    REQUIRE(market.GetOrder(7)->LeavesQuantity == 5);
+}
@@ -0,0 +1,187 @@
+//
+// Created by Ivan Shynkarenka on 01.09.2017
+//
+
+#include "test.h"
+
+#include "trader/matching/market_event_buffer.h"
+
+#include <string>
+#include <vector>
+
+using namespace CppTrader::Matching;
+
+namespace {
+
+std::string Format(MarketEventType type, uint64_t a = 0, uint64_t b = 0, uint64_t c = 0)
+{
+    return std::to_string((int)type) + " " + std::to_string(a) + " " + std::to_string(b) + " " + std::to_string(c);
+}
+
+// Market handler formats market events with per-event callbacks
+class MyMarketHandler : public MarketHandler
+{
+public:
+    std::vector<std::string> events;
+
+protected:
+    void onAddSymbol(const Symbol& symbol) override { events.push_back(Format(MarketEventType::ADD_SYMBOL, symbol.Id)); }
+    void onDeleteSymbol(const Symbol& symbol) override { events.push_back(Format(MarketEventType::DELETE_SYMBOL, symbol.Id)); }
+    void onAddOrderBook(const OrderBook& order_book) override { events.push_back(Format(MarketEventType::ADD_ORDER_BOOK, order_book.symbol().Id)); }
+    void onDeleteOrderBook(const OrderBook& order_book) override { events.push_back(Format(MarketEventType::DELETE_ORDER_BOOK, order_book.symbol().Id)); }
+    void onAddLevel(const OrderBook& order_book, const Level& level, bool top) override { events.push_back(Format(MarketEventType::ADD_LEVEL, level.Price, level.TotalVolume, top)); }
+    void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) override { events.push_back(Format(MarketEventType::UPDATE_LEVEL, level.Price, level.TotalVolume, top)); }
+    void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) override { events.push_back(Format(MarketEventType::DELETE_LEVEL, level.Price, level.TotalVolume, top)); }
+    void onAddOrder(const Order& order) override { events.push_back(Format(MarketEventType::ADD_ORDER, order.Id, order.LeavesQuantity, order.ExecutedQuantity)); }
+    void onUpdateOrder(const Order& order) override { events.push_back(Format(MarketEventType::UPDATE_ORDER, order.Id, order.LeavesQuantity, order.ExecutedQuantity)); }
+    void onDeleteOrder(const Order& order) override { events.push_back(Format(MarketEventType::DELETE_ORDER, order.Id, order.LeavesQuantity, order.ExecutedQuantity)); }
+    void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { events.push_back(Format(MarketEventType::EXECUTE_ORDER, order.Id, price, quantity)); }
+};
+
+// Format drained market events
+void Drain(MarketEventBuffer& buffer, std::vector<std::string>& events)
+{
+    buffer.Drain([&events](const MarketEvent& event)
+    {
+        switch (event.Type)
+        {
+            case MarketEventType::ADD_LEVEL:
+            case MarketEventType::UPDATE_LEVEL:
+            case MarketEventType::DELETE_LEVEL:
+            {
+                const auto& level = static_cast<const MarketEventBuffer::LevelEvent&>(event);
+                events.push_back(Format(event.Type, level.Price, level.TotalVolume, level.Top));
+                break;
+            }
+            case MarketEventType::ADD_ORDER:
+            case MarketEventType::UPDATE_ORDER:
+            case MarketEventType::DELETE_ORDER:
+            {
+                const auto& order = static_cast<const MarketEventBuffer::OrderEvent&>(event);
+                events.push_back(Format(event.Type, order.Id, order.LeavesQuantity, order.ExecutedQuantity));
+                break;
+            }
+            case MarketEventType::EXECUTE_ORDER:
+            {
+                const auto& execution = static_cast<const MarketEventBuffer::ExecutionEvent&>(event);
+                events.push_back(Format(event.Type, execution.Id, execution.Price, execution.Quantity));
+                break;
+            }
+            default:
+                events.push_back(Format(event.Type, event.SymbolId));
+                break;
+        }
+    });
+}
+
+} // namespace
+
+TEST_CASE("Market event buffer", "[CppTrader][Matching]")
+{
+    MyMarketHandler market_handler;
+    MarketManager market(market_handler);
+
+    alignas(8) static uint8_t arena[64 * 1024];
+    MarketEventBuffer buffer(arena, sizeof(arena));
+    MarketManagerT<MarketTraits<>, MarketEventBuffer> buffered_market(buffer);
+
+    std::vector<std::string> events;
+
+    Symbol symbol = { 0, "test" };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+    market.EnableMatching();
+    buffered_market.AddSymbol(symbol);
+    buffered_market.AddOrderBook(symbol);
+    buffered_market.EnableMatching();
+    REQUIRE(buffer.count() == 2);
+    Drain(buffer, events);
+    REQUIRE(buffer.empty());
+
+    uint64_t seed = 5;
+    auto random = [&seed](uint64_t range) { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return (seed >> 33) % range; };
+
+    uint64_t id = 1;
+    for (int i = 0; i < 5000; ++i)
+    {
+        uint64_t victim = 1 + random(id);
+        const Order* order_ptr = market.GetOrder(victim);
+        uint64_t operation = random(5);
+        uint64_t price = 95 + random(10);
+        uint64_t quantity = 1 + random(50);
+
+        // Perform the same operation with both market managers
+        auto perform = [&](auto& manager)
+        {
+            switch (operation)
+            {
+                case 0:
+                    manager.AddOrder(Order::BuyLimit(id, 0, price, quantity));
+                    break;
+                case 1:
+                    manager.AddOrder(Order::SellLimit(id, 0, price, quantity));
+                    break;
+                case 2:
+                    if (order_ptr != nullptr)
+                        manager.ReduceOrder(victim, 1 + (quantity % order_ptr->LeavesQuantity));
+                    break;
+                case 3:
+                    if (order_ptr != nullptr)
+                        manager.ModifyOrder(victim, price, quantity);
+                    break;
+                default:
+                    if (order_ptr != nullptr)
+                        manager.DeleteOrder(victim);
+                    break;
+            }
+        };
+        perform(buffered_market);
+        perform(market);
+        if (operation < 2)
+            ++id;
+
+        // Drain events after several operations
+        if ((i % 10) == 9)
+            Drain(buffer, events);
+    }
+    Drain(buffer, events);
+
+    REQUIRE(buffer.lost() == 0);
+    REQUIRE(events.size() > 5000);
+    REQUIRE(events == market_handler.events);
+}
+
+TEST_CASE("Market event buffer overflow", "[CppTrader][Matching]")
+{
+    alignas(8) uint8_t arena[128];
+    MarketEventBuffer buffer(arena, sizeof(arena));
+    MarketManagerT<MarketTraits<>, MarketEventBuffer> market(buffer);
+
+    Symbol symbol = { 0, "test" };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+    REQUIRE(buffer.size() == 2 * sizeof(MarketEvent));
+
+    // Events which do not fit into the arena are lost
+    market.AddOrder(Order::BuyLimit(1, 0, 10, 10));
+    market.AddOrder(Order::BuyLimit(2, 0, 10, 10));
+    REQUIRE(buffer.lost() > 0);
+    REQUIRE(buffer.size() <= buffer.capacity());
+
+    // Drained buffer records new events again
+    size_t count = buffer.count();
+    REQUIRE(buffer.Drain([](const MarketEvent&) {}) == count);
+    REQUIRE(buffer.lost() == 0);
+    market.DeleteOrder(1);
+    REQUIRE(buffer.count() == 2);
+    REQUIRE(buffer.lost() == 0);
+
+    // Overflow handler drains the full buffer without losing events
+    std::vector<std::string> events;
+    buffer.SetOverflowHandler([](MarketEventBuffer& full, void* context) { Drain(full, *(std::vector<std::string>*)context); }, &events);
+    for (uint64_t i = 3; i < 13; ++i)
+        market.AddOrder(Order::SellLimit(i, 0, 20 + i, 10));
+    Drain(buffer, events);
+    REQUIRE(buffer.lost() == 0);
+    REQUIRE(events.size() == 2 + 10 * 2);
+}
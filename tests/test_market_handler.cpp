@@ -0,0 +1,317 @@
+//
+// Created by Ivan Shynkarenka on 30.08.2017
+//
+
+#include "test.h"
+
+#include "trader/matching/market_manager.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace CppTrader::Matching;
+
+namespace {
+
+// Recording market handler is dispatched virtually with MarketHandler base
+// and statically with NullMarketHandler base
+template <class TBase>
+class RecordingMarketHandler : public TBase
+{
+    template <class, class>
+    friend class CppTrader::Matching::MarketManagerT;
+
+public:
+    std::vector<std::string> events;
+
+protected:
+    void onAddSymbol(const Symbol& symbol) { Record("AddSymbol", symbol.Id); }
+    void onDeleteSymbol(const Symbol& symbol) { Record("DeleteSymbol", symbol.Id); }
+    void onAddOrderBook(const OrderBook& order_book) { Record("AddOrderBook", order_book.symbol().Id); }
+    void onUpdateOrderBook(const OrderBook& order_book, bool top) { Record("UpdateOrderBook", order_book.symbol().Id, top); }
+    void onDeleteOrderBook(const OrderBook& order_book) { Record("DeleteOrderBook", order_book.symbol().Id); }
+    void onAddLevel(const OrderBook& order_book, const Level& level, bool top) { Record("AddLevel", level.Price, level.TotalVolume); }
+    void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) { Record("UpdateLevel", level.Price, level.TotalVolume); }
+    void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) { Record("DeleteLevel", level.Price, level.TotalVolume); }
+    void onAddOrder(const Order& order) { Record("AddOrder", order.Id, order.LeavesQuantity); }
+    void onUpdateOrder(const Order& order) { Record("UpdateOrder", order.Id, order.LeavesQuantity); }
+    void onDeleteOrder(const Order& order) { Record("DeleteOrder", order.Id, order.LeavesQuantity); }
+    void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) { Record("ExecuteOrder", order.Id, price, quantity); }
+
+private:
+    void Record(const char* event, uint64_t a = 0, uint64_t b = 0, uint64_t c = 0)
+    {
+        events.push_back(std::string(event) + " " + std::to_string(a) + " " + std::to_string(b) + " " + std::to_string(c));
+    }
+};
+
+// Level book market handler replicates price levels from price level updates
+class LevelBookMarketHandler : public MarketHandler
+{
+public:
+    size_t updates = 0;
+    size_t executions = 0;
+    size_t checks = 0;
+    bool coalesced = false;
+
+protected:
+    void onUpdateOrderBook(const OrderBook& order_book, bool top) override { _touched.clear(); }
+    void onDeleteOrderBook(const OrderBook& order_book) override
+    {
+        // Replicated price levels are the same as order book price levels
+        std::map<std::pair<int, uint64_t>, uint64_t> levels;
+        for (const auto& bid : order_book.bids())
+            levels[std::make_pair((int)bid.Type, bid.Price)] = bid.TotalVolume;
+        for (const auto& ask : order_book.asks())
+            levels[std::make_pair((int)ask.Type, ask.Price)] = ask.TotalVolume;
+        REQUIRE(levels == _levels);
+        ++checks;
+    }
+    void onAddLevel(const OrderBook& order_book, const Level& level, bool top) override { REQUIRE(_levels.emplace(Touch(level), level.TotalVolume).second); }
+    void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) override { auto it = _levels.find(Touch(level)); REQUIRE(it != _levels.end()); it->second = level.TotalVolume; }
+    void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) override { REQUIRE(_levels.erase(Touch(level)) == 1); }
+    void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { ++executions; }
+
+private:
+    std::map<std::pair<int, uint64_t>, uint64_t> _levels;
+    std::set<std::pair<int, uint64_t>> _touched;
+
+    std::pair<int, uint64_t> Touch(const Level& level)
+    {
+        ++updates;
+        auto key = std::make_pair((int)level.Type, level.Price);
+
+        // Coalesced price level is updated once between order book updates
+        bool unique = _touched.insert(key).second;
+        if (coalesced)
+            REQUIRE(unique);
+
+        return key;
+    }
+};
+
+// Consistent market handler checks price levels of executed orders
+class ConsistentMarketHandler : public MarketHandler
+{
+public:
+    const MarketManager* market = nullptr;
+    size_t checks = 0;
+
+protected:
+    void onDeleteOrder(const Order& order) override { Check(order); }
+    void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { Check(order); }
+
+private:
+    void Check(const Order& order)
+    {
+        const OrderBook* order_book_ptr = market->GetOrderBook(order.SymbolId);
+        if ((order_book_ptr == nullptr) || (order_book_ptr->best_ask() == nullptr))
+            return;
+
+        // Price level volume is the sum of its linked orders
+        const LevelNode* level_ptr = order_book_ptr->best_ask();
+        uint64_t volume = 0;
+        size_t orders = 0;
+        for (const auto& level_order : level_ptr->OrderList)
+        {
+            volume += level_order.LeavesQuantity;
+            ++orders;
+        }
+        REQUIRE(level_ptr->TotalVolume == volume);
+        REQUIRE(level_ptr->Orders == orders);
+        ++checks;
+    }
+};
+
+// Perform the same market operations with the given market manager
+template <class TMarketManager>
+void Run(TMarketManager& market)
+{
+    Symbol symbol = { 0, "test" };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+    market.EnableMatching();
+
+    uint64_t seed = 11;
+    auto random = [&seed](uint64_t range) { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return (seed >> 33) % range; };
+
+    uint64_t id = 1;
+    for (int i = 0; i < 2000; ++i)
+    {
+        uint64_t victim = 1 + random(id);
+        const Order* order_ptr = market.GetOrder(victim);
+
+        switch (random(5))
+        {
+            case 0:
+                market.AddOrder(Order::BuyLimit(id++, 0, 95 + random(10), 1 + random(50)));
+                break;
+            case 1:
+                market.AddOrder(Order::SellLimit(id++, 0, 95 + random(10), 1 + random(50)));
+                break;
+            case 2:
+                market.AddOrder(random(2) ? Order::BuyStop(id++, 0, 100 + random(10), 1 + random(50)) : Order::SellStop(id++, 0, 90 + random(10), 1 + random(50)));
+                break;
+            case 3:
+                if ((order_ptr != nullptr) && order_ptr->IsLimit())
+                    market.ModifyOrder(victim, 95 + random(10), 1 + random(50));
+                break;
+            default:
+                if (order_ptr != nullptr)
+                    market.DeleteOrder(victim);
+                break;
+        }
+    }
+
+    market.DeleteOrderBook(0);
+    market.DeleteSymbol(0);
+}
+
+} // namespace
+
+TEST_CASE("Market handler static dispatch", "[CppTrader][Matching]")
+{
+    // Virtual market handler
+    RecordingMarketHandler<MarketHandler> virtual_handler;
+    MarketManager virtual_market(virtual_handler);
+    Run(virtual_market);
+
+    // Statically dispatched market handler
+    RecordingMarketHandler<NullMarketHandler> static_handler;
+    MarketManagerT<MarketTraits<>, RecordingMarketHandler<NullMarketHandler>> static_market(static_handler);
+    Run(static_market);
+
+    // No-op market handler
+    NullMarketHandler null_handler;
+    MarketManagerT<MarketTraits<>, NullMarketHandler> null_market(null_handler);
+    Run(null_market);
+
+    // All market managers perform the same operations
+    REQUIRE(virtual_handler.events.size() > 2000);
+    REQUIRE(static_handler.events == virtual_handler.events);
+    REQUIRE(null_market.orders().size() == virtual_market.orders().size());
+}
+
+TEST_CASE("Market events subscription", "[CppTrader][Matching]")
+{
+    // Market handler subscribed to all market events
+    RecordingMarketHandler<MarketHandler> all_handler;
+    MarketManager all_market(all_handler);
+    REQUIRE(all_market.events() == MarketEvents::ALL);
+    Run(all_market);
+
+    // Market handler subscribed only to executions and symbols
+    RecordingMarketHandler<MarketHandler> handler;
+    MarketManager market(handler);
+    market.Subscribe(MarketEvents::EXECUTIONS | MarketEvents::SYMBOLS);
+    REQUIRE(market.IsSubscribed(MarketEvents::EXECUTIONS));
+    REQUIRE(!market.IsSubscribed(MarketEvents::ORDERS | MarketEvents::LEVELS));
+    REQUIRE((~market.events() & MarketEvents::SYMBOLS) == MarketEvents::NONE);
+    Run(market);
+
+    // Unsubscribed market events are skipped
+    std::vector<std::string> expected;
+    for (const auto& event : all_handler.events)
+        if ((event.compare(0, 12, "ExecuteOrder") == 0) || (event.find("Symbol") != std::string::npos))
+            expected.push_back(event);
+    REQUIRE(expected.size() > 2);
+    REQUIRE(handler.events == expected);
+
+    // Market state does not depend on the subscription
+    REQUIRE(market.orders().size() == all_market.orders().size());
+
+    // Top of the book is published without price level updates subscription
+    market.AddSymbol(Symbol(1, "top"));
+    market.AddOrderBook(Symbol(1, "top"));
+    market.AddOrder(Order::BuyLimit(1, 1, 10, 10));
+    market.AddOrder(Order::BuyLimit(2, 1, 20, 10));
+    market.AddOrder(Order::BuyLimit(3, 1, 20, 5));
+    market.ReduceOrder(3, 2);
+    auto top = market.GetOrderBook(1)->top_of_book();
+    REQUIRE(top.BidLevels == 2);
+    REQUIRE(top.best_bid()->Price == 20);
+    REQUIRE(top.best_bid()->Volume == 13);
+    market.DeleteOrder(2);
+    market.DeleteOrder(3);
+    top = market.GetOrderBook(1)->top_of_book();
+    REQUIRE(top.BidLevels == 1);
+    REQUIRE(top.best_bid()->Price == 10);
+    REQUIRE(top.best_bid()->Volume == 10);
+}
+
+TEST_CASE("Market price level updates coalescing", "[CppTrader][Matching]")
+{
+    // Price level updates after each change
+    LevelBookMarketHandler handler;
+    MarketManager market(handler);
+    REQUIRE(!market.IsLevelCoalescingEnabled());
+    Run(market);
+
+    // Coalesced price level updates
+    LevelBookMarketHandler coalesced_handler;
+    MarketManager coalesced_market(coalesced_handler);
+    coalesced_handler.coalesced = true;
+    coalesced_market.EnableLevelCoalescing();
+    REQUIRE(coalesced_market.IsLevelCoalescingEnabled());
+    Run(coalesced_market);
+
+    // Both market handlers replicate the same price levels with less updates
+    REQUIRE(handler.checks == 1);
+    REQUIRE(coalesced_handler.checks == 1);
+    REQUIRE(coalesced_handler.executions == handler.executions);
+    REQUIRE(coalesced_handler.updates < handler.updates);
+
+    // Sweep of several price levels is reported with one update for each level
+    LevelBookMarketHandler sweep_handler;
+    sweep_handler.coalesced = true;
+    MarketManager sweep_market(sweep_handler);
+    sweep_market.EnableLevelCoalescing();
+    sweep_market.DisableLevelCoalescing();
+    REQUIRE(!sweep_market.IsLevelCoalescingEnabled());
+    sweep_market.EnableLevelCoalescing();
+    sweep_market.AddSymbol(Symbol(0, "test"));
+    sweep_market.AddOrderBook(Symbol(0, "test"));
+    sweep_market.EnableMatching();
+    sweep_market.AddOrder(Order::SellLimit(1, 0, 10, 10));
+    sweep_market.AddOrder(Order::SellLimit(2, 0, 10, 10));
+    sweep_market.AddOrder(Order::SellLimit(3, 0, 20, 10, OrderTimeInForce::AON));
+    sweep_market.AddOrder(Order::SellLimit(4, 0, 20, 10));
+    sweep_market.AddOrder(Order::SellLimit(5, 0, 30, 10));
+    sweep_market.AddOrder(Order::SellLimit(6, 0, 30, 10));
+    size_t updates = sweep_handler.updates;
+    sweep_market.AddOrder(Order::BuyLimit(7, 0, 30, 45, OrderTimeInForce::IOC, 5));
+    REQUIRE(sweep_handler.updates - updates == 3);
+    REQUIRE(sweep_market.GetOrder(4) == nullptr);
+    REQUIRE(sweep_market.GetOrder(5)->LeavesQuantity == 5);
+
+    // Replace with the rejected new order still reports the deleted order price level
+    Order unsupported = Order::SellLimit(8, 0, 30, 10);
+    unsupported.Type = (OrderType)0xFF;
+    updates = sweep_handler.updates;
+    REQUIRE(sweep_market.ReplaceOrder(6, unsupported) == ErrorCode::ORDER_TYPE_INVALID);
+    REQUIRE(sweep_handler.updates - updates == 1);
+    sweep_market.DeleteOrderBook(0);
+    REQUIRE(sweep_handler.checks == 1);
+}
+
+TEST_CASE("Market price level sweep", "[CppTrader][Matching]")
+{
+    ConsistentMarketHandler handler;
+    MarketManager market(handler);
+    handler.market = &market;
+    market.AddSymbol(Symbol(0, "test"));
+    market.AddOrderBook(Symbol(0, "test"));
+    market.EnableMatching();
+    market.AddOrder(Order::SellLimit(1, 0, 10, 10));
+    market.AddOrder(Order::SellLimit(2, 0, 10, 20));
+    market.AddOrder(Order::SellLimit(3, 0, 10, 30));
+    market.AddOrder(Order::SellLimit(4, 0, 20, 10));
+
+    // Handlers called during the sweep see the rest of the swept price level
+    market.AddOrder(Order::BuyLimit(5, 0, 10, 100));
+    REQUIRE(handler.checks > 6);
+    REQUIRE(market.GetOrderBook(0)->best_ask()->Price == 20);
+    REQUIRE(market.GetOrderBook(0)->best_bid()->TotalVolume == 40);
+}
@@ -69,12 +69,16 @@ std::pair<int, int> BookStopOrders(const OrderBook* order_book_ptr)
         buy_orders += (int)buy.Orders;
     for (const auto& buy : order_book_ptr->trailing_buy_stop())
         buy_orders += (int)buy.Orders;
+    for (const auto& buy : order_book_ptr->trailing_buy_distance())
+        buy_orders += (int)buy.Orders;
 
     int sell_orders = 0;
     for (const auto& sell : order_book_ptr->sell_stop())
         sell_orders += (int)sell.Orders;
     for (const auto& sell : order_book_ptr->trailing_sell_stop())
         sell_orders += (int)sell.Orders;
+    for (const auto& sell : order_book_ptr->trailing_sell_distance())
+        sell_orders += (int)sell.Orders;
 
     return std::make_pair(buy_orders, sell_orders);
 }
@@ -89,16 +93,30 @@ std::pair<int, int> BookStopVolume(const OrderBook* order_book_ptr)
         buy_volume += (int)buy.TotalVolume;
     for (const auto& buy : order_book_ptr->trailing_buy_stop())
         buy_volume += (int)buy.TotalVolume;
+    for (const auto& buy : order_book_ptr->trailing_buy_distance())
+        buy_volume += (int)buy.TotalVolume;
 
     int sell_volume = 0;
     for (const auto& sell : order_book_ptr->sell_stop())
         sell_volume += (int)sell.TotalVolume;
     for (const auto& sell : order_book_ptr->trailing_sell_stop())
         sell_volume += (int)sell.TotalVolume;
+    for (const auto& sell : order_book_ptr->trailing_sell_distance())
+        sell_volume += (int)sell.TotalVolume;
 
     return std::make_pair(buy_volume, sell_volume);
 }
 
+std::vector<uint64_t> TrailingStopOrders(const OrderBook::Levels& levels)
+{
+    std::vector<uint64_t> orders;
+    for (const auto& level : levels)
+        for (const auto& order : level.OrderList)
+            orders.push_back(order.Id);
+
+    return orders;
+}
+
 }
 
 TEST_CASE("Automatic matching - market order", "[CppTrader][Matching]")
@@ -228,6 +246,55 @@ TEST_CASE("Automatic matching - limit order", "[CppTrader][Matching]")
     REQUIRE(BookVolume(market.GetOrderBook(0)) == std::make_pair(0, 0));
 }
 
+TEST_CASE("Automatic matching - price level sweep", "[CppTrader][Matching]")
+{
+    // Market handler counts price level updates and executions
+    class SweepMarketHandler : public MarketHandler
+    {
+    public:
+        int updates = 0;
+        int deletes = 0;
+        int executions = 0;
+
+    protected:
+        void onUpdateLevel(const OrderBook& order_book, const Level& level, bool top) override { ++updates; }
+        void onDeleteLevel(const OrderBook& order_book, const Level& level, bool top) override { ++deletes; REQUIRE(level.TotalVolume == 0); REQUIRE(level.Orders == 0); }
+        void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { ++executions; }
+    } handler;
+
+    MarketManager market(handler);
+
+    // Prepare symbol & order book
+    const char name[8] = "test";
+    Symbol symbol = { 0, name };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+
+    // Enable automatic matching
+    market.EnableMatching();
+
+    // Add sell limit orders
+    market.AddOrder(Order::SellLimit(1, 0, 10, 10));
+    market.AddOrder(Order::SellLimit(2, 0, 10, 20, OrderTimeInForce::AON));
+    market.AddOrder(Order::SellLimit(3, 0, 10, 30, OrderTimeInForce::GTC, 5));
+    market.AddOrder(Order::SellLimit(4, 0, 20, 10));
+    market.AddOrder(Order::SellLimit(5, 0, 20, 20));
+    market.AddOrder(Order::SellLimit(6, 0, 30, 30));
+    REQUIRE(BookOrders(market.GetOrderBook(0)) == std::make_pair(0, 6));
+    REQUIRE(BookVolume(market.GetOrderBook(0)) == std::make_pair(0, 120));
+    handler.updates = 0;
+
+    // Sweep two price levels and partially fill the third one
+    market.AddOrder(Order::BuyMarket(7, 0, 100));
+    REQUIRE(BookOrders(market.GetOrderBook(0)) == std::make_pair(0, 1));
+    REQUIRE(BookVolume(market.GetOrderBook(0)) == std::make_pair(0, 20));
+    REQUIRE(handler.deletes == 2);
+    REQUIRE(handler.updates == 1);
+    REQUIRE(handler.executions == 12);
+    REQUIRE(market.GetOrder(1) == nullptr);
+    REQUIRE(market.GetOrder(6)->ExecutedQuantity == 10);
+}
+
 TEST_CASE("Automatic matching - 'Immediate-Or-Cancel' limit order", "[CppTrader][Matching]")
 {
     MarketManager market;
@@ -630,6 +697,400 @@ TEST_CASE("Automatic matching - trailing stop order", "[CppTrader][Matching]")
     REQUIRE(market.GetOrder(5)->StopPrice == 190);
 }
 
+TEST_CASE("Automatic matching - trailing stop orders recalculation", "[CppTrader][Matching]")
+{
+    // Market handler counts trailing stop orders updates
+    class TrailingMarketHandler : public MarketHandler
+    {
+    public:
+        int updates = 0;
+
+    protected:
+        void onUpdateOrder(const Order& order) override { if (order.IsTrailingStop()) ++updates; }
+    } handler;
+
+    MarketManager market(handler);
+
+    // Prepare symbol & order book
+    const char name[8] = "test";
+    Symbol symbol = { 0, name };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+
+    // Enable automatic matching
+    market.EnableMatching();
+
+    // Create the market with last prices
+    market.AddOrder(Order::BuyLimit(1, 0, 100, 20));
+    market.AddOrder(Order::SellLimit(2, 0, 200, 20));
+    market.AddOrder(Order::SellMarket(3, 0, 10));
+    market.AddOrder(Order::BuyMarket(4, 0, 10));
+
+    // Add absolute, stepped and percentage trailing stop orders
+    market.AddOrder(Order::TrailingSellStop(5, 0, 0, 10, 10, 0));
+    market.AddOrder(Order::TrailingSellStop(6, 0, 0, 10, 20, 0));
+    market.AddOrder(Order::TrailingSellStop(7, 0, 0, 10, 10, 5));
+    market.AddOrder(Order::TrailingSellStop(8, 0, 0, 10, -1000, 0));
+    REQUIRE(TrailingStopOrders(market.GetOrderBook(0)->trailing_sell_stop()) == std::vector<uint64_t>({ 6, 5, 7, 8 }));
+    REQUIRE(market.GetOrderBook(0)->trailing_sell_stop().size() == 2);
+
+    // Move the market best bid price level. All trailing stop orders are recalculated in a single pass
+    market.ModifyOrder(1, 120, 20);
+    REQUIRE(handler.updates == 4);
+    REQUIRE(market.GetOrder(5)->StopPrice == 110);
+    REQUIRE(market.GetOrder(6)->StopPrice == 100);
+    REQUIRE(market.GetOrder(7)->StopPrice == 110);
+    REQUIRE(market.GetOrder(8)->StopPrice == 108);
+    REQUIRE(TrailingStopOrders(market.GetOrderBook(0)->trailing_sell_stop()) == std::vector<uint64_t>({ 6, 8, 5, 7 }));
+    REQUIRE(market.GetOrderBook(0)->trailing_sell_stop().size() == 3);
+
+    // Move the market best bid price level below the trailing step. Recalculated orders keep their time priority
+    market.ModifyOrder(1, 122, 20);
+    REQUIRE(handler.updates == 7);
+    REQUIRE(market.GetOrder(5)->StopPrice == 112);
+    REQUIRE(market.GetOrder(6)->StopPrice == 102);
+    REQUIRE(market.GetOrder(7)->StopPrice == 110);
+    REQUIRE(market.GetOrder(8)->StopPrice == 110);
+    REQUIRE(TrailingStopOrders(market.GetOrderBook(0)->trailing_sell_stop()) == std::vector<uint64_t>({ 6, 7, 8, 5 }));
+    REQUIRE(market.GetOrderBook(0)->trailing_sell_stop().size() == 3);
+    REQUIRE(BookStopOrders(market.GetOrderBook(0)) == std::make_pair(0, 4));
+    REQUIRE(BookStopVolume(market.GetOrderBook(0)) == std::make_pair(0, 40));
+
+    // Move the market best bid price level to the wrong direction
+    market.ModifyOrder(1, 115, 20);
+    REQUIRE(handler.updates == 7);
+    REQUIRE(market.GetOrder(5)->StopPrice == 112);
+}
+
+TEST_CASE("Automatic matching - trailing stop orders reference price", "[CppTrader][Matching]")
+{
+    // Market handler keeps the order of trailing stop orders executions
+    class TrailingMarketHandler : public MarketHandler
+    {
+    public:
+        std::vector<uint64_t> executions;
+
+    protected:
+        void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { if (order.Id >= 10) executions.push_back(order.Id); }
+    } handler;
+
+    MarketManager market(handler);
+
+    // Trailing stop orders follow the trailing reference price without subscribed order updates
+    market.Subscribe(~MarketEvents::ORDERS);
+
+    // Prepare symbol & order book
+    const char name[8] = "test";
+    Symbol symbol = { 0, name };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+
+    // Enable automatic matching
+    market.EnableMatching();
+
+    // Create the market with last prices
+    market.AddOrder(Order::BuyLimit(1, 0, 100, 20));
+    market.AddOrder(Order::SellLimit(2, 0, 200, 20));
+    market.AddOrder(Order::SellMarket(3, 0, 10));
+    market.AddOrder(Order::BuyMarket(4, 0, 10));
+    market.AddOrder(Order::BuyLimit(5, 0, 50, 1000));
+
+    // Add trailing sell stop orders which follow the trailing reference price
+    for (uint64_t id = 10; id < 20; ++id)
+        market.AddOrder(Order::TrailingSellStop(id, 0, 0, 1, (int64_t)(id - 9) * 5, 0));
+    market.AddOrder(Order::TrailingSellStopLimit(20, 0, 90, 25, 2, 10, 0));
+    REQUIRE(market.GetOrderBook(0)->trailing_sell_distance().size() == 10);
+    REQUIRE(market.GetOrderBook(0)->trailing_sell_stop().empty());
+    REQUIRE(market.GetOrderBook(0)->trailing_sell_reference() == 100);
+    REQUIRE(market.GetOrderBook(0)->sell_stop_activation_price() == 95);
+
+    // Move the market best bid price level. Only the trailing reference price is updated
+    market.ModifyOrder(1, 120, 20);
+    REQUIRE(market.GetOrderBook(0)->trailing_sell_reference() == 120);
+    REQUIRE(market.GetOrderBook(0)->sell_stop_activation_price() == 115);
+    REQUIRE(market.GetOrder(10)->StopPrice == 95);
+
+    // Stop price of the trailing stop order is calculated when the order is changed
+    market.ReduceOrder(20, 1);
+    REQUIRE(market.GetOrder(20)->StopPrice == 110);
+    REQUIRE(market.GetOrder(20)->Price == 45);
+
+    // Trailing stop order with another reference price is recalculated until it reaches the trailing reference price
+    market.AddOrder(Order::TrailingSellStop(21, 0, 111, 1, 10, 0));
+    REQUIRE(TrailingStopOrders(market.GetOrderBook(0)->trailing_sell_stop()) == std::vector<uint64_t>({ 21 }));
+    market.ModifyOrder(1, 125, 20);
+    REQUIRE(market.GetOrderBook(0)->trailing_sell_stop().empty());
+    REQUIRE(market.GetOrder(21)->StopPrice == 115);
+    REQUIRE(BookStopOrders(market.GetOrderBook(0)) == std::make_pair(0, 12));
+
+    // Delete the market best bid price level. Trailing stop orders are activated from the highest stop price
+    market.DeleteOrder(1);
+    REQUIRE(handler.executions == std::vector<uint64_t>({ 10, 11, 20, 21, 12, 13, 14, 15, 16, 17, 18, 19 }));
+    REQUIRE(BookStopOrders(market.GetOrderBook(0)) == std::make_pair(0, 0));
+    REQUIRE(market.GetOrderBook(0)->trailing_sell_distance().empty());
+}
+
+TEST_CASE("Automatic matching - trailing stop orders subscription", "[CppTrader][Matching]")
+{
+    // Market handler counts trailing stop orders updates
+    class TrailingMarketHandler : public MarketHandler
+    {
+    public:
+        int updates = 0;
+
+    protected:
+        void onUpdateOrder(const Order& order) override { if (order.IsTrailingStop()) ++updates; }
+    } handler;
+
+    MarketManager market(handler);
+    market.Subscribe(~MarketEvents::ORDERS);
+
+    // Prepare symbol & order book
+    const char name[8] = "test";
+    Symbol symbol = { 0, name };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+
+    // Enable automatic matching
+    market.EnableMatching();
+
+    // Create the market with last prices
+    market.AddOrder(Order::BuyLimit(1, 0, 100, 20));
+    market.AddOrder(Order::SellLimit(2, 0, 200, 20));
+    market.AddOrder(Order::SellMarket(3, 0, 10));
+    market.AddOrder(Order::BuyMarket(4, 0, 10));
+
+    // Add trailing stop orders which follow the trailing reference price
+    market.AddOrder(Order::TrailingSellStop(5, 0, 0, 10, 10, 0));
+    market.AddOrder(Order::TrailingSellStop(6, 0, 0, 10, 20, 0));
+    market.ModifyOrder(1, 120, 20);
+    REQUIRE(TrailingStopOrders(market.GetOrderBook(0)->trailing_sell_distance()) == std::vector<uint64_t>({ 5, 6 }));
+    REQUIRE(market.GetOrder(5)->StopPrice == 90);
+    REQUIRE(handler.updates == 0);
+
+    // Subscribe to order updates. Trailing stop orders are moved to their actual stop prices
+    market.Subscribe(MarketEvents::ALL);
+    REQUIRE(handler.updates == 2);
+    REQUIRE(market.GetOrderBook(0)->trailing_sell_distance().empty());
+    REQUIRE(market.GetOrderBook(0)->trailing_sell_stop().size() == 2);
+    REQUIRE(market.GetOrder(5)->StopPrice == 110);
+    REQUIRE(market.GetOrder(6)->StopPrice == 100);
+    REQUIRE(market.GetOrderBook(0)->sell_stop_activation_price() == 110);
+
+    // Move the market best bid price level. All trailing stop orders are updated
+    market.ModifyOrder(1, 130, 20);
+    REQUIRE(handler.updates == 4);
+    REQUIRE(market.GetOrder(5)->StopPrice == 120);
+    REQUIRE(market.GetOrder(6)->StopPrice == 110);
+}
+
+TEST_CASE("Automatic matching - stop orders activation price", "[CppTrader][Matching]")
+{
+    MarketManager market;
+
+    // Prepare symbol & order book
+    const char name[8] = "test";
+    Symbol symbol = { 0, name };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+
+    // Enable automatic matching
+    market.EnableMatching();
+
+    // Empty order book has no stop orders to activate
+    REQUIRE(market.GetOrderBook(0)->buy_stop_activation_price() == std::numeric_limits<uint64_t>::max());
+    REQUIRE(market.GetOrderBook(0)->sell_stop_activation_price() == 0);
+
+    // Create the market with last prices
+    market.AddOrder(Order::BuyLimit(1, 0, 100, 10));
+    market.AddOrder(Order::SellLimit(2, 0, 200, 20));
+    market.AddOrder(Order::SellLimit(3, 0, 210, 10));
+    market.AddOrder(Order::SellLimit(4, 0, 220, 10));
+    market.AddOrder(Order::SellLimit(5, 0, 300, 100));
+    market.AddOrder(Order::BuyMarket(13, 0, 10));
+
+    // Add stop orders
+    market.AddOrder(Order::BuyStop(6, 0, 220, 10));
+    market.AddOrder(Order::BuyStop(7, 0, 210, 10));
+    market.AddOrder(Order::TrailingBuyStop(8, 0, 1000, 10, 15));
+    market.AddOrder(Order::SellStop(9, 0, 90, 10));
+    market.AddOrder(Order::SellStop(10, 0, 80, 10));
+    REQUIRE(market.GetOrderBook(0)->buy_stop_activation_price() == 210);
+    REQUIRE(market.GetOrderBook(0)->sell_stop_activation_price() == 90);
+    REQUIRE(BookStopOrders(market.GetOrderBook(0)) == std::make_pair(3, 2));
+
+    // Delete the best buy stop order
+    market.DeleteOrder(7);
+    REQUIRE(market.GetOrderBook(0)->buy_stop_activation_price() == 215);
+
+    // Trades which do not cross the activation price keep stop orders
+    market.AddOrder(Order::SellMarket(11, 0, 5));
+    REQUIRE(market.GetOrderBook(0)->sell_stop_activation_price() == 90);
+    REQUIRE(BookStopOrders(market.GetOrderBook(0)) == std::make_pair(2, 2));
+
+    // Sweep the ask side to activate all crossed buy stop orders as one batch
+    market.AddOrder(Order::BuyMarket(12, 0, 20));
+    REQUIRE(BookStopOrders(market.GetOrderBook(0)) == std::make_pair(0, 2));
+    REQUIRE(market.GetOrderBook(0)->buy_stop_activation_price() == std::numeric_limits<uint64_t>::max());
+    REQUIRE(BookOrders(market.GetOrderBook(0)) == std::make_pair(1, 1));
+    REQUIRE(BookVolume(market.GetOrderBook(0)) == std::make_pair(5, 90));
+}
+
+TEST_CASE("Automatic matching - stop orders activation price (random)", "[CppTrader][Matching]")
+{
+    MarketManager market;
+
+    // Prepare symbol & order book
+    const char name[8] = "test";
+    Symbol symbol = { 0, name };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+
+    // Enable automatic matching
+    market.EnableMatching();
+
+    uint64_t seed = 54321;
+    auto random = [&seed](uint64_t range) { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return (seed >> 33) % range; };
+
+    const OrderBook* order_book_ptr = market.GetOrderBook(0);
+    for (uint64_t id = 1; id <= 5000; ++id)
+    {
+        uint64_t price = 900 + random(200);
+        uint64_t quantity = 1 + random(10);
+        switch (random(10))
+        {
+            case 0:
+            case 1:
+                market.AddOrder(Order::BuyLimit(id, 0, price, quantity));
+                break;
+            case 2:
+            case 3:
+                market.AddOrder(Order::SellLimit(id, 0, price, quantity));
+                break;
+            case 4:
+                market.AddOrder(Order::BuyStop(id, 0, price, quantity));
+                break;
+            case 5:
+                market.AddOrder(Order::SellStop(id, 0, price, quantity));
+                break;
+            case 6:
+                market.AddOrder(Order::TrailingBuyStopLimit(id, 0, 2000, 2000, quantity, 2 + random(20), random(2)));
+                break;
+            case 7:
+                market.AddOrder(Order::TrailingSellStopLimit(id, 0, 0, 0, quantity, 2 + random(20), random(2)));
+                break;
+            default:
+            {
+                uint64_t victim = 1 + random(id);
+                if (market.GetOrder(victim) != nullptr)
+                    market.DeleteOrder(victim);
+                break;
+            }
+        }
+
+        // The activation price is the best stop price of all stop orders
+        uint64_t buy_price = std::numeric_limits<uint64_t>::max();
+        uint64_t sell_price = 0;
+        for (const auto& order : market.orders())
+        {
+            const Order* order_ptr = market.GetOrder(order.first);
+            if (order_ptr->IsStop() || order_ptr->IsStopLimit() || order_ptr->IsTrailingStop() || order_ptr->IsTrailingStopLimit())
+            {
+                if (order_ptr->IsBuy())
+                    buy_price = std::min(buy_price, order_ptr->StopPrice);
+                else
+                    sell_price = std::max(sell_price, order_ptr->StopPrice);
+            }
+        }
+        REQUIRE(order_book_ptr->buy_stop_activation_price() == buy_price);
+        REQUIRE(order_book_ptr->sell_stop_activation_price() == sell_price);
+
+        // Stop orders crossed by the market are activated
+        if (order_book_ptr->best_ask() != nullptr)
+            REQUIRE(order_book_ptr->best_ask()->Price < buy_price);
+        if (order_book_ptr->best_bid() != nullptr)
+            REQUIRE(order_book_ptr->best_bid()->Price > sell_price);
+    }
+}
+
+TEST_CASE("Automatic matching - cascading stop orders activation", "[CppTrader][Matching]")
+{
+    // Market handler keeps the order of executions
+    class ExecutionMarketHandler : public MarketHandler
+    {
+    public:
+        std::vector<std::tuple<uint64_t, uint64_t, uint64_t>> executions;
+
+    protected:
+        void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { executions.emplace_back(order.Id, price, quantity); }
+    } handler;
+
+    MarketManager market(handler);
+
+    // Prepare symbol & order book
+    const char name[8] = "test";
+    Symbol symbol = { 0, name };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+
+    // Enable automatic matching
+    market.EnableMatching();
+
+    // Create the market with last prices
+    for (uint64_t i = 0; i < 5; ++i)
+    {
+        market.AddOrder(Order::BuyLimit(1 + i, 0, 100 - i, (i < 4) ? 10 : 50));
+        market.AddOrder(Order::SellLimit(6 + i, 0, 101 + i, (i < 4) ? 10 : 50));
+    }
+    market.AddOrder(Order::SellMarket(11, 0, 1));
+    market.AddOrder(Order::BuyMarket(12, 0, 1));
+    handler.executions.clear();
+
+    // Add stop, stop-limit and trailing stop orders on both sides
+    market.AddOrder(Order::SellStop(20, 0, 99, 15));
+    market.AddOrder(Order::SellStopLimit(21, 0, 98, 97, 12));
+    market.AddOrder(Order::TrailingSellStop(22, 0, 0, 10, 3, 0));
+    market.AddOrder(Order::TrailingSellStop(23, 0, 0, 5, 2, 1));
+    market.AddOrder(Order::TrailingSellStopLimit(24, 0, 95, 94, 5, 5, 0));
+    market.AddOrder(Order::BuyStop(30, 0, 102, 15));
+    market.AddOrder(Order::TrailingBuyStop(31, 0, 1000, 10, 2, 0));
+    market.AddOrder(Order::BuyStopLimit(32, 0, 103, 104, 12));
+    market.AddOrder(Order::TrailingBuyStop(33, 0, 1000, 5, 3, 1));
+    REQUIRE(handler.executions.empty());
+
+    // Cross both sides of the market at once. Executions must follow the order
+    // of one stop price level activation per pass.
+    market.DisableMatching();
+    market.DeleteOrder(1);
+    market.DeleteOrder(6);
+    market.EnableMatching();
+    REQUIRE(handler.executions == std::vector<std::tuple<uint64_t, uint64_t, uint64_t>>({
+        { 7, 102, 10 }, { 30, 102, 10 },
+        { 8, 103, 5 }, { 30, 103, 5 },
+        { 8, 103, 5 }, { 32, 103, 5 },
+        { 9, 104, 7 }, { 32, 104, 7 },
+        { 9, 104, 3 }, { 31, 104, 3 },
+        { 10, 105, 7 }, { 31, 105, 7 },
+        { 10, 105, 5 }, { 33, 105, 5 }
+    }));
+    handler.executions.clear();
+
+    // Cascade sell stop orders activations down the bids
+    market.AddOrder(Order::SellMarket(42, 0, 1));
+    REQUIRE(handler.executions == std::vector<std::tuple<uint64_t, uint64_t, uint64_t>>({
+        { 2, 99, 1 }, { 42, 99, 1 },
+        { 2, 99, 9 }, { 20, 99, 9 },
+        { 3, 98, 6 }, { 20, 98, 6 },
+        { 3, 98, 4 }, { 21, 98, 4 },
+        { 4, 97, 8 }, { 21, 97, 8 },
+        { 4, 97, 2 }, { 23, 97, 2 },
+        { 5, 96, 3 }, { 23, 96, 3 },
+        { 5, 96, 10 }, { 22, 96, 10 }
+    }));
+    REQUIRE(BookStopOrders(market.GetOrderBook(0)) == std::make_pair(0, 1));
+    REQUIRE(market.GetOrder(24) != nullptr);
+}
+
 TEST_CASE("In-Flight Mitigation", "[CppTrader][Matching]")
 {
     MarketManager market;
@@ -713,3 +1174,93 @@ TEST_CASE("Manual matching", "[CppTrader][Matching]")
     REQUIRE(BookOrders(market.GetOrderBook(0)) == std::make_pair(3, 4));
     REQUIRE(BookVolume(market.GetOrderBook(0)) == std::make_pair(60, 65));
 }
+
+TEST_CASE("Manual matching of dirty order books", "[CppTrader][Matching]")
+{
+    MarketManager market;
+
+    // Prepare symbols & order books
+    const char name[8] = "test";
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        Symbol symbol = { i, name };
+        market.AddSymbol(symbol);
+        market.AddOrderBook(symbol);
+        market.AddOrder(Order::BuyLimit(1000 + i, i, 10, 10));
+        market.AddOrder(Order::SellLimit(2000 + i, i, 20, 10));
+    }
+
+    // Cross several order books
+    market.AddOrder(Order::SellLimit(1, 3, 10, 5));
+    market.AddOrder(Order::BuyLimit(2, 7, 20, 15));
+    market.AddOrder(Order::SellLimit(3, 9, 10, 10));
+    market.AddOrder(Order::BuyStop(4, 11, 15, 10));
+    market.ExecuteOrder(1011, 20, 5);
+    REQUIRE(BookOrders(market.GetOrderBook(3)) == std::make_pair(1, 2));
+    REQUIRE(BookStopOrders(market.GetOrderBook(11)) == std::make_pair(1, 0));
+
+    // Delete the dirty order book
+    market.DeleteOrderBook(9);
+
+    // Perform manual matching
+    market.Match();
+    REQUIRE(BookVolume(market.GetOrderBook(3)) == std::make_pair(5, 10));
+    REQUIRE(BookVolume(market.GetOrderBook(7)) == std::make_pair(15, 0));
+    REQUIRE(BookStopOrders(market.GetOrderBook(11)) == std::make_pair(0, 0));
+    REQUIRE(BookVolume(market.GetOrderBook(11)) == std::make_pair(5, 0));
+    for (uint32_t i = 0; i < 100; ++i)
+        if ((i != 3) && (i != 7) && (i != 9) && (i != 11))
+            REQUIRE(BookVolume(market.GetOrderBook(i)) == std::make_pair(10, 10));
+
+    // Enable automatic matching with dirty order books
+    market.AddOrder(Order::SellLimit(5, 0, 5, 10));
+    market.EnableMatching();
+    REQUIRE(BookVolume(market.GetOrderBook(0)) == std::make_pair(0, 10));
+}
+
+TEST_CASE("Automatic matching - 32-bit prices and quantities", "[CppTrader][Matching]")
+{
+    typedef MarketTraits<LevelsAVL, OrdersHash, uint32_t, uint32_t> MarketTraits32;
+    typedef MarketManagerT<MarketTraits32>::Order Order32;
+
+    // Narrow orders and price levels
+    REQUIRE(sizeof(Order32) < sizeof(Order));
+    REQUIRE(sizeof(MarketTraits32::OrderNode) < sizeof(OrderNode));
+    REQUIRE(sizeof(MarketTraits32::LevelNode) < sizeof(LevelNode));
+
+    MarketManagerT<MarketTraits32> market;
+
+    // Prepare symbol & order book
+    const char name[8] = "test";
+    Symbol symbol = { 0, name };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+
+    // Enable automatic matching
+    market.EnableMatching();
+
+    // Prices and quantities near the 32-bit limit
+    const uint32_t max = std::numeric_limits<uint32_t>::max();
+    market.AddOrder(Order32::BuyLimit(1, 0, max - 20, 10));
+    market.AddOrder(Order32::BuyLimit(2, 0, max - 10, max - 1));
+    market.AddOrder(Order32::SellLimit(3, 0, max - 5, 30));
+    REQUIRE(market.GetOrderBook(0)->best_bid()->Price == (max - 10));
+    REQUIRE(market.GetOrderBook(0)->best_bid()->TotalVolume == (max - 1));
+    REQUIRE(market.GetOrderBook(0)->best_ask()->Price == (max - 5));
+
+    // Match the sell limit order with the best bid price level
+    market.AddOrder(Order32::SellLimit(4, 0, max - 15, 20));
+    REQUIRE(market.GetOrder(4) == nullptr);
+    REQUIRE(market.GetOrder(2)->LeavesQuantity == (max - 21));
+    REQUIRE(market.GetOrder(2)->ExecutedQuantity == 20);
+
+    // Market order without slippage should not overflow the price
+    market.AddOrder(Order32::BuyMarket(5, 0, 10));
+    REQUIRE(market.GetOrder(3)->LeavesQuantity == 20);
+
+    // Trailing stop price near the 32-bit limit
+    market.AddOrder(Order32::TrailingBuyStop(6, 0, max, 10, 100, 5));
+    REQUIRE(market.GetOrder(6)->StopPrice == max);
+    market.AddOrder(Order32::TrailingSellStop(7, 0, 0, 10, 100, 5));
+    REQUIRE(market.GetOrder(7)->StopPrice == (max - 110));
+}
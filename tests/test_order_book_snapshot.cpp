@@ -0,0 +1,383 @@
+//
+// Created by Ivan Shynkarenka on 28.08.2017
+//
+
+#include "test.h"
+
+#include "trader/matching/market_manager.h"
+#include "trader/matching/order_book_snapshot.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace CppTrader::Matching;
+
+namespace {
+
+// Check price levels and their orders of the snapshot
+bool IsConsistent(const OrderBookSnapshot& snapshot, bool bids)
+{
+    size_t levels = bids ? snapshot.bid_levels() : snapshot.ask_levels();
+    for (size_t i = 0; i < levels; ++i)
+    {
+        const Level& level = bids ? snapshot.bid(i) : snapshot.ask(i);
+        const std::vector<Order>& orders = bids ? snapshot.bid_orders(i) : snapshot.ask_orders(i);
+        if ((orders.size() != level.Orders) || ((i > 0) && ((bids ? snapshot.bid(i - 1) : snapshot.ask(i - 1)).Price == level.Price)))
+            return false;
+
+        uint64_t volume = 0;
+        for (const auto& order : orders)
+        {
+            if (order.Price != level.Price)
+                return false;
+            volume += order.LeavesQuantity;
+        }
+        if (volume != level.TotalVolume)
+            return false;
+    }
+    return true;
+}
+
+// Count all orders of the snapshot
+size_t CountOrders(const OrderBookSnapshot& snapshot)
+{
+    size_t count = snapshot.stop_orders().size();
+    for (size_t i = 0; i < snapshot.bid_levels(); ++i)
+        count += snapshot.bid_orders(i).size();
+    for (size_t i = 0; i < snapshot.ask_levels(); ++i)
+        count += snapshot.ask_orders(i).size();
+    return count;
+}
+
+// Compare the snapshot with the order book
+void CheckSnapshot(const MarketManager& market, const OrderBook& order_book, const OrderBookSnapshot& snapshot)
+{
+    REQUIRE(snapshot.symbol().Id == order_book.symbol().Id);
+
+    size_t bids = 0;
+    for (auto level_ptr = order_book.best_bid(); level_ptr != nullptr; level_ptr = order_book.bids().lower(*level_ptr), ++bids)
+    {
+        REQUIRE(bids < snapshot.bid_levels());
+        REQUIRE(snapshot.bid(bids).Price == level_ptr->Price);
+        REQUIRE(snapshot.bid(bids).TotalVolume == level_ptr->TotalVolume);
+        REQUIRE(snapshot.bid(bids).VisibleVolume == level_ptr->VisibleVolume);
+        REQUIRE(snapshot.bid(bids).Orders == level_ptr->Orders);
+
+        // Orders of the price level are in their time priority
+        size_t index = 0;
+        for (const auto& order : level_ptr->OrderList)
+            REQUIRE(snapshot.bid_orders(bids)[index++].Id == order.Id);
+    }
+    REQUIRE(snapshot.bid_levels() == bids);
+
+    size_t asks = 0;
+    for (auto level_ptr = order_book.best_ask(); level_ptr != nullptr; level_ptr = order_book.asks().higher(*level_ptr), ++asks)
+    {
+        REQUIRE(asks < snapshot.ask_levels());
+        REQUIRE(snapshot.ask(asks).Price == level_ptr->Price);
+        REQUIRE(snapshot.ask(asks).TotalVolume == level_ptr->TotalVolume);
+        REQUIRE(snapshot.ask(asks).VisibleVolume == level_ptr->VisibleVolume);
+        REQUIRE(snapshot.ask(asks).Orders == level_ptr->Orders);
+
+        // Orders of the price level are in their time priority
+        size_t index = 0;
+        for (const auto& order : level_ptr->OrderList)
+            REQUIRE(snapshot.ask_orders(asks)[index++].Id == order.Id);
+    }
+    REQUIRE(snapshot.ask_levels() == asks);
+
+    REQUIRE(IsConsistent(snapshot, true));
+    REQUIRE(IsConsistent(snapshot, false));
+
+    // Compare orders
+    std::vector<const std::vector<Order>*> groups = { &snapshot.stop_orders() };
+    for (size_t i = 0; i < snapshot.bid_levels(); ++i)
+        groups.push_back(&snapshot.bid_orders(i));
+    for (size_t i = 0; i < snapshot.ask_levels(); ++i)
+        groups.push_back(&snapshot.ask_orders(i));
+    for (const auto* group : groups)
+    {
+        for (const auto& order : *group)
+        {
+            const Order* order_ptr = market.GetOrder(order.Id);
+            REQUIRE(order_ptr != nullptr);
+            REQUIRE(order.Type == order_ptr->Type);
+            REQUIRE(order.Price == order_ptr->Price);
+            REQUIRE(order.ExecutedQuantity == order_ptr->ExecutedQuantity);
+            REQUIRE(order.LeavesQuantity == order_ptr->LeavesQuantity);
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("Order book snapshot", "[CppTrader][Matching]")
+{
+    MarketHandler market_handler;
+    OrderBookSnapshots snapshots(market_handler, 16);
+    MarketManager market(snapshots);
+    OrderBookSnapshots::Reader reader(snapshots);
+
+    Symbol symbol = { 0, "test" };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+
+    // Order book is not published yet
+    reader.Lock();
+    REQUIRE(reader.GetOrderBook(0) == nullptr);
+    reader.Unlock();
+
+    // Publish the empty order book
+    snapshots.Publish();
+    reader.Lock();
+    const OrderBookSnapshot* empty_ptr = reader.GetOrderBook(0);
+    REQUIRE(empty_ptr != nullptr);
+    REQUIRE(empty_ptr->sequence() == 1);
+    REQUIRE(empty_ptr->bid_levels() == 0);
+    REQUIRE(empty_ptr->ask_levels() == 0);
+
+    // Modify the order book while the reader holds the previous snapshot
+    market.EnableMatching();
+    market.AddOrder(Order::BuyLimit(1, 0, 10, 10));
+    market.AddOrder(Order::BuyLimit(2, 0, 10, 20));
+    market.AddOrder(Order::BuyLimit(3, 0, 9, 30));
+    market.AddOrder(Order::SellLimit(4, 0, 12, 40));
+    market.AddOrder(Order::BuyStop(5, 0, 15, 10));
+    market.AddOrder(Order::SellLimit(6, 0, 10, 15));
+    snapshots.Publish();
+
+    // The previous snapshot is retired but not reclaimed
+    REQUIRE(snapshots.retired() == 1);
+    REQUIRE(empty_ptr->bid_levels() == 0);
+    reader.Unlock();
+
+    reader.Lock();
+    const OrderBookSnapshot* snapshot_ptr = reader.GetOrderBook(0);
+    REQUIRE(snapshot_ptr->sequence() == 2);
+    CheckSnapshot(market, *market.GetOrderBook(0), *snapshot_ptr);
+    REQUIRE(CountOrders(*snapshot_ptr) == market.orders().size());
+    REQUIRE(snapshot_ptr->bid_levels() == 2);
+    REQUIRE(snapshot_ptr->bid(0).Price == 10);
+    REQUIRE(snapshot_ptr->bid(0).TotalVolume == 15);
+    REQUIRE(snapshot_ptr->bid_orders(0).size() == 1);
+    REQUIRE(snapshot_ptr->bid_orders(0)[0].Id == 2);
+    REQUIRE(snapshot_ptr->bid_orders(0)[0].ExecutedQuantity == 5);
+    REQUIRE(snapshot_ptr->bid_orders(1).size() == 1);
+    REQUIRE(snapshot_ptr->bid_orders(1)[0].Id == 3);
+    REQUIRE(snapshot_ptr->ask_levels() == 1);
+    REQUIRE(snapshot_ptr->ask_orders(0).size() == 1);
+    REQUIRE(snapshot_ptr->stop_orders().size() == 1);
+    reader.Unlock();
+
+    // Retired snapshots are reclaimed when readers leave
+    snapshots.Publish();
+    REQUIRE(snapshots.retired() == 0);
+
+    // Publication without changes keeps the snapshot
+    reader.Lock();
+    REQUIRE(reader.GetOrderBook(0) == snapshot_ptr);
+
+    // Orders of unchanged price levels are shared with the previous snapshot
+    market.AddOrder(Order::BuyLimit(7, 0, 10, 5));
+    snapshots.Publish();
+    const OrderBookSnapshot* shared_ptr = reader.GetOrderBook(0);
+    REQUIRE(shared_ptr->sequence() == 3);
+    CheckSnapshot(market, *market.GetOrderBook(0), *shared_ptr);
+    REQUIRE(shared_ptr->bid_orders(0).size() == 2);
+    REQUIRE(snapshot_ptr->bid_orders(0).size() == 1);
+    REQUIRE(&shared_ptr->bid(1) == &snapshot_ptr->bid(1));
+    REQUIRE(&shared_ptr->bid_orders(1) == &snapshot_ptr->bid_orders(1));
+    REQUIRE(&shared_ptr->ask(0) == &snapshot_ptr->ask(0));
+    REQUIRE(&shared_ptr->ask_orders(0) == &snapshot_ptr->ask_orders(0));
+    REQUIRE(&shared_ptr->stop_orders() == &snapshot_ptr->stop_orders());
+
+    // Orders keep their time priority in the price level
+    market.AddOrder(Order::BuyLimit(8, 0, 10, 5));
+    market.ReduceOrder(2, 1);
+    market.ModifyOrder(7, 10, 5);
+    snapshots.Publish();
+    const OrderBookSnapshot* queue_ptr = reader.GetOrderBook(0);
+    CheckSnapshot(market, *market.GetOrderBook(0), *queue_ptr);
+    REQUIRE(queue_ptr->bid_orders(0).size() == 3);
+    REQUIRE(queue_ptr->bid_orders(0)[0].Id == 2);
+    REQUIRE(queue_ptr->bid_orders(0)[1].Id == 8);
+    REQUIRE(queue_ptr->bid_orders(0)[2].Id == 7);
+    reader.Unlock();
+
+    // Deleted order book is unpublished
+    market.DeleteOrderBook(0);
+    reader.Lock();
+    REQUIRE(reader.GetOrderBook(0) == nullptr);
+    reader.Unlock();
+    snapshots.Publish();
+    REQUIRE(snapshots.retired() == 0);
+}
+
+TEST_CASE("Order book snapshot with market events subscription", "[CppTrader][Matching]")
+{
+    MarketHandler market_handler;
+    OrderBookSnapshots snapshots(market_handler, 16);
+    MarketManager market(snapshots);
+    OrderBookSnapshots::Reader reader(snapshots);
+
+    // Order book snapshots keep all market events subscribed
+    market.Subscribe(MarketEvents::EXECUTIONS);
+    REQUIRE(market.events() == MarketEvents::ALL);
+
+    Symbol symbol = { 0, "test" };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+    market.EnableMatching();
+    market.AddOrder(Order::BuyLimit(1, 0, 10, 10));
+    market.AddOrder(Order::BuyLimit(2, 0, 9, 10));
+    market.AddOrder(Order::SellLimit(3, 0, 12, 20));
+    market.AddOrder(Order::SellLimit(4, 0, 10, 5));
+    market.AddOrder(Order::BuyStop(5, 0, 15, 10));
+    market.DeleteOrder(2);
+    snapshots.Publish();
+
+    reader.Lock();
+    const OrderBookSnapshot* snapshot_ptr = reader.GetOrderBook(0);
+    REQUIRE(snapshot_ptr != nullptr);
+    CheckSnapshot(market, *market.GetOrderBook(0), *snapshot_ptr);
+    REQUIRE(CountOrders(*snapshot_ptr) == market.orders().size());
+    REQUIRE(snapshot_ptr->bid_orders(0)[0].ExecutedQuantity == 5);
+    reader.Unlock();
+}
+
+TEST_CASE("Order book snapshot (random)", "[CppTrader][Matching]")
+{
+    MarketHandler market_handler;
+    OrderBookSnapshots snapshots(market_handler, 16);
+    MarketManager market(snapshots);
+    OrderBookSnapshots::Reader reader(snapshots);
+
+    const uint32_t symbols = 4;
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        Symbol symbol = { i, "test" };
+        market.AddSymbol(symbol);
+        market.AddOrderBook(symbol);
+    }
+    market.EnableMatching();
+
+    uint64_t seed = 123;
+    auto random = [&seed](uint64_t range) { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return (seed >> 33) % range; };
+
+    uint64_t id = 1;
+    for (int i = 0; i < 5000; ++i)
+    {
+        uint32_t symbol = (uint32_t)random(symbols);
+        uint64_t victim = 1 + random(id);
+        const Order* order_ptr = market.GetOrder(victim);
+
+        switch (random(8))
+        {
+            case 0:
+                market.AddOrder(Order::BuyLimit(id++, symbol, 90 + random(20), 1 + random(50)));
+                break;
+            case 1:
+                market.AddOrder(Order::SellLimit(id++, symbol, 100 + random(20), 1 + random(50)));
+                break;
+            case 2:
+                market.AddOrder(Order::Limit(id++, symbol, random(2) ? OrderSide::BUY : OrderSide::SELL, 95 + random(10), 100, OrderTimeInForce::GTC, 10));
+                break;
+            case 3:
+                market.AddOrder(random(2) ? Order::BuyStop(id++, symbol, 100 + random(20), 1 + random(50)) : Order::SellStop(id++, symbol, 90 + random(20), 1 + random(50)));
+                break;
+            case 4:
+                if (order_ptr != nullptr)
+                    market.ReduceOrder(victim, 1 + random(order_ptr->LeavesQuantity));
+                break;
+            case 5:
+                if ((order_ptr != nullptr) && order_ptr->IsLimit())
+                    market.ModifyOrder(victim, 95 + random(10), 1 + random(50));
+                break;
+            default:
+                if (order_ptr != nullptr)
+                    market.DeleteOrder(victim);
+                break;
+        }
+
+        snapshots.Publish();
+
+        reader.Lock();
+        for (uint32_t j = 0; j < symbols; ++j)
+        {
+            const OrderBookSnapshot* snapshot_ptr = reader.GetOrderBook(j);
+            REQUIRE(snapshot_ptr != nullptr);
+            REQUIRE(IsConsistent(*snapshot_ptr, true));
+            REQUIRE(IsConsistent(*snapshot_ptr, false));
+        }
+        reader.Unlock();
+    }
+
+    // Compare all orders of all snapshots
+    reader.Lock();
+    size_t orders = 0;
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        const OrderBookSnapshot* snapshot_ptr = reader.GetOrderBook(i);
+        CheckSnapshot(market, *market.GetOrderBook(i), *snapshot_ptr);
+        orders += CountOrders(*snapshot_ptr);
+    }
+    REQUIRE(orders == market.orders().size());
+    reader.Unlock();
+}
+
+TEST_CASE("Order book snapshot concurrent readers", "[CppTrader][Matching]")
+{
+    MarketHandler market_handler;
+    OrderBookSnapshots snapshots(market_handler, 16);
+    MarketManager market(snapshots);
+
+    Symbol symbol = { 0, "test" };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+    snapshots.Publish();
+
+    // Readers traverse full depth of published snapshots
+    std::atomic<bool> running(true);
+    std::atomic<size_t> errors(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i)
+    {
+        readers.emplace_back([&snapshots, &running, &errors]()
+        {
+            OrderBookSnapshots::Reader reader(snapshots);
+            uint64_t sequence = 0;
+            while (running.load(std::memory_order_acquire))
+            {
+                reader.Lock();
+                const OrderBookSnapshot* snapshot_ptr = reader.GetOrderBook(0);
+                if ((snapshot_ptr == nullptr) || (snapshot_ptr->sequence() < sequence) || !IsConsistent(*snapshot_ptr, true))
+                    ++errors;
+                else
+                    sequence = snapshot_ptr->sequence();
+                reader.Unlock();
+            }
+        });
+    }
+
+    // Writer modifies the order book and publishes snapshots
+    uint64_t id = 1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        market.AddOrder(Order::BuyLimit(id, 0, 100 + (id % 50), 10));
+        if (id > 200)
+            market.DeleteOrder(id - 200);
+        ++id;
+        snapshots.Publish();
+    }
+
+    running.store(false, std::memory_order_release);
+    for (auto& reader : readers)
+        reader.join();
+
+    REQUIRE(errors == 0);
+
+    // All retired snapshots are reclaimed without readers
+    snapshots.Publish();
+    REQUIRE(snapshots.retired() == 0);
+}
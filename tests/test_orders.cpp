@@ -0,0 +1,194 @@
+//
+// Created by Ivan Shynkarenka on 20.08.2017
+//
+
+#include "test.h"
+
+#include "trader/matching/market_manager.h"
+
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace CppTrader::Matching;
+
+template <class TOrderNode>
+using OrdersPagedSmall = BasicOrdersPaged<TOrderNode, 4, 4>;
+
+TEMPLATE_TEST_CASE("Orders container", "[CppTrader][Matching]", OrdersHash<OrderNode>, OrdersPaged<OrderNode>, OrdersPagedSmall<OrderNode>)
+{
+    std::vector<OrderNode> nodes;
+    for (uint64_t id : std::vector<uint64_t>({ 1, 2, 3, 17, 100, 1000000, 0xFFFFFFFFFFFFull }))
+        nodes.emplace_back(Order::BuyLimit(id, 0, 10, 10));
+
+    TestType orders;
+    REQUIRE(orders.empty());
+    for (auto& node : nodes)
+        REQUIRE(orders.insert(std::make_pair(node.Id, &node)).second);
+    REQUIRE(orders.size() == nodes.size());
+
+    // Duplicate order Ids should be rejected
+    REQUIRE(!orders.insert(std::make_pair(nodes[0].Id, &nodes[1])).second);
+    REQUIRE(orders.size() == nodes.size());
+
+    // Find orders
+    for (auto& node : nodes)
+    {
+        auto it = orders.find(node.Id);
+        REQUIRE(it != orders.end());
+        REQUIRE(it->first == node.Id);
+        REQUIRE(it->second == &node);
+    }
+    REQUIRE(orders.find(4) == orders.end());
+    REQUIRE(orders.find(1000001) == orders.end());
+
+    // Iterate all orders
+    std::set<uint64_t> ids;
+    for (const auto& order : orders)
+    {
+        REQUIRE(order.second->Id == order.first);
+        ids.insert(order.first);
+    }
+    REQUIRE(ids.size() == nodes.size());
+
+    // Erase orders
+    orders.erase(orders.find(17));
+    orders.erase(orders.find(0xFFFFFFFFFFFFull));
+    REQUIRE(orders.size() == (nodes.size() - 2));
+    REQUIRE(orders.find(17) == orders.end());
+    REQUIRE(orders.find(0xFFFFFFFFFFFFull) == orders.end());
+    REQUIRE(orders.find(3) != orders.end());
+
+    orders.clear();
+    REQUIRE(orders.empty());
+    REQUIRE(orders.begin() == orders.end());
+}
+
+TEST_CASE("Orders paged direct array", "[CppTrader][Matching]")
+{
+    std::vector<OrderNode> nodes;
+    for (uint64_t id = 1; id <= 100; ++id)
+        nodes.emplace_back(Order::BuyLimit(id, 0, 10, 10));
+    nodes.emplace_back(Order::BuyLimit(1000, 0, 10, 10));
+
+    OrdersPagedSmall<OrderNode> orders;
+    for (auto& node : nodes)
+        orders.insert(std::make_pair(node.Id, &node));
+
+    // Dense order Ids should be placed into pages of 16 orders, the one far from them should fall back to the hash map
+    REQUIRE(orders.size() == 101);
+    REQUIRE(orders.pages() == 7);
+    REQUIRE(orders.fallback().size() == 1);
+
+    // Pages should be released when the last order of the page is erased
+    for (uint64_t id = 1; id <= 40; ++id)
+        orders.erase(orders.find(id));
+    REQUIRE(orders.pages() == 5);
+
+    // Orders should be iterated in the Id order followed by the fallback ones
+    uint64_t expected = 41;
+    for (const auto& order : orders)
+    {
+        if (expected > 100)
+            expected = 1000;
+        REQUIRE(order.first == expected++);
+    }
+    REQUIRE(expected == 1001);
+}
+
+TEST_CASE("Orders paged direct array - sparse order Ids", "[CppTrader][Matching]")
+{
+    // Random 32-bit order Ids
+    std::mt19937 generator(12345);
+    std::set<uint64_t> unique;
+    while (unique.size() < 10000)
+        unique.insert(generator());
+    std::vector<OrderNode> nodes;
+    for (uint64_t id : unique)
+        nodes.emplace_back(Order::BuyLimit(id, 0, 10, 10));
+
+    OrdersPaged<OrderNode> orders;
+    for (auto& node : nodes)
+        REQUIRE(orders.insert(std::make_pair(node.Id, &node)).second);
+    REQUIRE(orders.size() == nodes.size());
+
+    // Sparse order Ids should not allocate a page for each order
+    REQUIRE(orders.pages() < 16);
+    REQUIRE(orders.fallback().size() > (nodes.size() - 16));
+    for (auto& node : nodes)
+        REQUIRE(orders.find(node.Id)->second == &node);
+
+    // Dense order Ids next to the paged ones should extend the directory window
+    uint64_t first = orders.begin()->first;
+    std::vector<OrderNode> dense;
+    for (uint64_t id = first + 1; id < first + 10000; ++id)
+        if (unique.find(id) == unique.end())
+            dense.emplace_back(Order::BuyLimit(id, 0, 10, 10));
+    for (auto& node : dense)
+        REQUIRE(orders.insert(std::make_pair(node.Id, &node)).second);
+    REQUIRE(orders.fallback().size() > (nodes.size() - 16));
+    REQUIRE(orders.size() == (nodes.size() + dense.size()));
+
+    // Order Ids placed into the hash map should not be duplicated in pages
+    for (const auto& fallback : orders.fallback())
+        REQUIRE(!orders.insert(std::make_pair(fallback.first, fallback.second)).second);
+
+    // Erased orders should release the directory window
+    for (auto& node : nodes)
+        orders.erase(orders.find(node.Id));
+    for (auto& node : dense)
+        orders.erase(orders.find(node.Id));
+    REQUIRE(orders.empty());
+    REQUIRE(orders.pages() == 0);
+}
+
+TEST_CASE("Orders container - market manager", "[CppTrader][Matching]")
+{
+    MarketManagerT<MarketTraits<LevelsAVL, OrdersPaged>> market;
+
+    // Prepare symbol & order book
+    const char name[8] = "test";
+    Symbol symbol = { 0, name };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+
+    // Add dense and sparse orders
+    REQUIRE(market.AddOrder(Order::BuyLimit(1, 0, 100, 10)) == ErrorCode::OK);
+    REQUIRE(market.AddOrder(Order::BuyLimit(2, 0, 100, 20)) == ErrorCode::OK);
+    REQUIRE(market.AddOrder(Order::SellLimit(0x7FFFFFFFFFFFFFFFull, 0, 110, 30)) == ErrorCode::OK);
+    REQUIRE(market.AddOrder(Order::BuyLimit(2, 0, 100, 20)) == ErrorCode::ORDER_DUPLICATE);
+    REQUIRE(market.orders().size() == 3);
+    REQUIRE(market.GetOrder(2)->Quantity == 20);
+    REQUIRE(market.GetOrder(0x7FFFFFFFFFFFFFFFull)->Quantity == 30);
+
+    REQUIRE(market.ReduceOrder(1, 5) == ErrorCode::OK);
+    REQUIRE(market.GetOrder(1)->LeavesQuantity == 5);
+    REQUIRE(market.ExecuteOrder(0x7FFFFFFFFFFFFFFFull, 30) == ErrorCode::OK);
+    REQUIRE(market.GetOrder(0x7FFFFFFFFFFFFFFFull) == nullptr);
+    REQUIRE(market.DeleteOrder(2) == ErrorCode::OK);
+    REQUIRE(market.orders().size() == 1);
+}
+
+TEST_CASE("Order node layout", "[CppTrader][Matching]")
+{
+    OrderNode node(Order::BuyLimit(1, 0, 10, 10));
+    auto offset = [&node](const void* field) { return (size_t)((const char*)field - (const char*)&node); };
+
+    // Fields used to match orders should be placed into the first 64 bytes
+    REQUIRE(offset(&node.next) < 64);
+    REQUIRE(offset(&node.prev) < 64);
+    REQUIRE(offset(&node.Level) < 64);
+    REQUIRE(offset(&node.Id) < 64);
+    REQUIRE(offset(&node.Price) < 64);
+    REQUIRE(offset(&node.LeavesQuantity) < 64);
+    REQUIRE(offset(&node.MaxVisibleQuantity) < 64);
+    REQUIRE(offset(&node.SymbolId) < 64);
+    REQUIRE(offset(&node.Type) < 64);
+    REQUIRE(offset(&node.Side) < 64);
+    REQUIRE(offset(&node.TimeInForce) < 64);
+
+    // Rarely used fields should be placed after them
+    REQUIRE(offset(&node.StopPrice) >= 64);
+    REQUIRE(offset(&node.TrailingDistance) >= 64);
+    REQUIRE(offset(&node.TrailingStep) >= 64);
+}
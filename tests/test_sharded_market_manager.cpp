@@ -0,0 +1,181 @@
+//
+// Created by Ivan Shynkarenka on 25.08.2017
+//
+
+#include "test.h"
+
+#include "trader/matching/sharded_market_manager.h"
+
+using namespace CppTrader::Matching;
+
+namespace {
+
+class CountingMarketHandler : public MarketHandler
+{
+public:
+    size_t add_orders = 0;
+    size_t delete_orders = 0;
+    size_t execute_orders = 0;
+
+protected:
+    void onAddOrder(const Order& order) override { ++add_orders; }
+    void onDeleteOrder(const Order& order) override { ++delete_orders; }
+    void onExecuteOrder(const Order& order, uint64_t price, uint64_t quantity) override { ++execute_orders; }
+};
+
+} // namespace
+
+TEST_CASE("Sharded market manager", "[CppTrader][Matching]")
+{
+    CountingMarketHandler handler;
+    MarketManager market(handler);
+
+    std::vector<CountingMarketHandler> handlers(3);
+    ShardedMarketManager sharded({ &handlers[0], &handlers[1], &handlers[2] }, 1024);
+    REQUIRE(sharded.shards() == 3);
+
+    // Prepare symbols & order books
+    const uint32_t symbols = 8;
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        Symbol symbol = { i, "test" };
+        market.AddSymbol(symbol);
+        market.AddOrderBook(symbol);
+        sharded.AddSymbol(symbol);
+        sharded.AddOrderBook(symbol);
+    }
+
+    // Enable automatic matching
+    market.EnableMatching();
+    sharded.EnableMatching();
+
+    // Unknown orders are not routed
+    REQUIRE(sharded.DeleteOrder(1000000) == ErrorCode::ORDER_NOT_FOUND);
+
+    uint64_t seed = 777;
+    auto random = [&seed](uint64_t range) { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return (seed >> 33) % range; };
+
+    // Apply the same random order flow to both market managers
+    uint64_t id = 1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        uint32_t symbol = (uint32_t)random(symbols);
+        uint64_t price = 100 + random(20);
+        uint64_t quantity = 1 + random(100);
+
+        // Find the alive order to update
+        uint64_t victim = 1 + random(id);
+        const Order* order_ptr = market.GetOrder(victim);
+
+        switch (random(8))
+        {
+            case 0:
+            case 1:
+                REQUIRE(market.AddOrder(Order::BuyLimit(id, symbol, price, quantity)) == ErrorCode::OK);
+                REQUIRE(sharded.AddOrder(Order::BuyLimit(id, symbol, price, quantity)) == ErrorCode::OK);
+                ++id;
+                break;
+            case 2:
+            case 3:
+                REQUIRE(market.AddOrder(Order::SellLimit(id, symbol, price, quantity)) == ErrorCode::OK);
+                REQUIRE(sharded.AddOrder(Order::SellLimit(id, symbol, price, quantity)) == ErrorCode::OK);
+                ++id;
+                break;
+            case 4:
+                if (order_ptr != nullptr)
+                {
+                    quantity = std::min(quantity, order_ptr->LeavesQuantity);
+                    REQUIRE(market.ReduceOrder(victim, quantity) == ErrorCode::OK);
+                    REQUIRE(sharded.ReduceOrder(victim, quantity) == ErrorCode::OK);
+                }
+                break;
+            case 5:
+                if (order_ptr != nullptr)
+                {
+                    REQUIRE(market.ModifyOrder(victim, price, quantity) == ErrorCode::OK);
+                    REQUIRE(sharded.ModifyOrder(victim, price, quantity) == ErrorCode::OK);
+                }
+                break;
+            case 6:
+                if (order_ptr != nullptr)
+                {
+                    REQUIRE(market.ReplaceOrder(victim, id, price, quantity) == ErrorCode::OK);
+                    REQUIRE(sharded.ReplaceOrder(victim, id, price, quantity) == ErrorCode::OK);
+                    ++id;
+                }
+                break;
+            default:
+                if (order_ptr != nullptr)
+                {
+                    REQUIRE(market.DeleteOrder(victim) == ErrorCode::OK);
+                    REQUIRE(sharded.DeleteOrder(victim) == ErrorCode::OK);
+                }
+                break;
+        }
+    }
+
+    sharded.Flush();
+
+    // Only alive orders are routed
+    REQUIRE(sharded.routes() == market.orders().size());
+
+    // Compare order books
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        const OrderBook* expected = market.GetOrderBook(i);
+        const OrderBook* actual = sharded.shard(sharded.GetShard(i)).GetOrderBook(i);
+        REQUIRE(actual != nullptr);
+        REQUIRE(actual->bids().size() == expected->bids().size());
+        REQUIRE(actual->asks().size() == expected->asks().size());
+        if (expected->best_bid() != nullptr)
+        {
+            REQUIRE(actual->best_bid()->Price == expected->best_bid()->Price);
+            REQUIRE(actual->best_bid()->TotalVolume == expected->best_bid()->TotalVolume);
+        }
+        if (expected->best_ask() != nullptr)
+        {
+            REQUIRE(actual->best_ask()->Price == expected->best_ask()->Price);
+            REQUIRE(actual->best_ask()->TotalVolume == expected->best_ask()->TotalVolume);
+        }
+    }
+
+    // Compare orders
+    for (const auto& order : market.orders())
+    {
+        const Order* actual = sharded.shard(sharded.GetShard(order.second->SymbolId)).GetOrder(order.first);
+        REQUIRE(actual != nullptr);
+        REQUIRE(actual->Price == order.second->Price);
+        REQUIRE(actual->LeavesQuantity == order.second->LeavesQuantity);
+    }
+
+    // Compare market events streams
+    size_t add_orders = 0;
+    size_t delete_orders = 0;
+    size_t execute_orders = 0;
+    for (const auto& shard_handler : handlers)
+    {
+        add_orders += shard_handler.add_orders;
+        delete_orders += shard_handler.delete_orders;
+        execute_orders += shard_handler.execute_orders;
+    }
+    REQUIRE(add_orders == handler.add_orders);
+    REQUIRE(delete_orders == handler.delete_orders);
+    REQUIRE(execute_orders == handler.execute_orders);
+
+    // Alive order Id cannot be reused on another shard
+    uint64_t alive = market.orders().begin()->first;
+    uint32_t symbol = market.orders().begin()->second->SymbolId;
+    uint32_t other = (symbol + 1) % symbols;
+    REQUIRE(sharded.AddOrder(Order::BuyLimit(alive, other, 100, 10)) == ErrorCode::ORDER_DUPLICATE);
+    sharded.Flush();
+    REQUIRE(sharded.shard(sharded.GetShard(symbol)).GetOrder(alive) != nullptr);
+    REQUIRE(sharded.shard(sharded.GetShard(other)).GetOrder(alive) == nullptr);
+
+    // Deleted order Id may be reused on another shard
+    REQUIRE(sharded.DeleteOrder(alive) == ErrorCode::OK);
+    sharded.Flush();
+    REQUIRE(sharded.AddOrder(Order::BuyLimit(alive, other, 100, 10)) == ErrorCode::OK);
+    sharded.Flush();
+    REQUIRE(sharded.shard(sharded.GetShard(other)).GetOrder(alive) != nullptr);
+    REQUIRE(sharded.routes() == market.orders().size());
+}
@@ -0,0 +1,191 @@
+//
+// Created by Ivan Shynkarenka on 27.08.2017
+//
+
+#include "test.h"
+
+#include "trader/matching/market_manager.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace CppTrader::Matching;
+
+namespace {
+
+// Check the top of the book with the order book price levels
+void CheckTopOfBook(const OrderBook& order_book)
+{
+    OrderBook::TopOfBook top = order_book.top_of_book();
+
+    size_t bids = 0;
+    for (auto level_ptr = order_book.best_bid(); (level_ptr != nullptr) && (bids < OrderBook::TopOfBook::DEPTH); level_ptr = order_book.bids().lower(*level_ptr), ++bids)
+    {
+        REQUIRE(top.Bids[bids].Price == level_ptr->Price);
+        REQUIRE(top.Bids[bids].Volume == level_ptr->VisibleVolume);
+        REQUIRE(top.Bids[bids].Orders == level_ptr->Orders);
+    }
+    REQUIRE(top.BidLevels == bids);
+
+    size_t asks = 0;
+    for (auto level_ptr = order_book.best_ask(); (level_ptr != nullptr) && (asks < OrderBook::TopOfBook::DEPTH); level_ptr = order_book.asks().higher(*level_ptr), ++asks)
+    {
+        REQUIRE(top.Asks[asks].Price == level_ptr->Price);
+        REQUIRE(top.Asks[asks].Volume == level_ptr->VisibleVolume);
+        REQUIRE(top.Asks[asks].Orders == level_ptr->Orders);
+    }
+    REQUIRE(top.AskLevels == asks);
+}
+
+} // namespace
+
+TEST_CASE("Top of the book", "[CppTrader][Matching]")
+{
+    MarketHandler market_handler;
+    MarketManager market(market_handler);
+
+    Symbol symbol = { 0, "test" };
+    REQUIRE(market.AddSymbol(symbol) == ErrorCode::OK);
+    REQUIRE(market.AddOrderBook(symbol) == ErrorCode::OK);
+    const OrderBook* order_book_ptr = market.GetOrderBook(0);
+
+    // Empty top of the book
+    REQUIRE(order_book_ptr->top_of_book().Sequence == 0);
+    REQUIRE(order_book_ptr->top_of_book().best_bid() == nullptr);
+    REQUIRE(order_book_ptr->top_of_book().best_ask() == nullptr);
+
+    // Fill bid price levels
+    uint64_t id = 1;
+    for (uint64_t price = 10; price <= 15; ++price)
+        REQUIRE(market.AddOrder(Order::BuyLimit(id++, 0, price, 10)) == ErrorCode::OK);
+    REQUIRE(market.AddOrder(Order::BuyLimit(id++, 0, 15, 20)) == ErrorCode::OK);
+    REQUIRE(market.AddOrder(Order::SellLimit(id++, 0, 20, 30)) == ErrorCode::OK);
+    CheckTopOfBook(*order_book_ptr);
+
+    OrderBook::TopOfBook top = order_book_ptr->top_of_book();
+    REQUIRE(top.BidLevels == OrderBook::TopOfBook::DEPTH);
+    REQUIRE(top.best_bid()->Price == 15);
+    REQUIRE(top.best_bid()->Volume == 30);
+    REQUIRE(top.best_bid()->Orders == 2);
+    REQUIRE(top.Bids[OrderBook::TopOfBook::DEPTH - 1].Price == 11);
+    REQUIRE(top.AskLevels == 1);
+    REQUIRE(top.best_ask()->Price == 20);
+
+    // Price levels behind the published depth are not published
+    uint64_t sequence = top.Sequence;
+    REQUIRE(market.AddOrder(Order::BuyLimit(id++, 0, 10, 10)) == ErrorCode::OK);
+    REQUIRE(market.AddOrder(Order::BuyLimit(id++, 0, 5, 10)) == ErrorCode::OK);
+    REQUIRE(order_book_ptr->top_of_book().Sequence == sequence);
+
+    // Matching updates the top of the book
+    market.EnableMatching();
+    REQUIRE(market.AddOrder(Order::SellLimit(id++, 0, 14, 40)) == ErrorCode::OK);
+    REQUIRE(order_book_ptr->top_of_book().Sequence > sequence);
+    CheckTopOfBook(*order_book_ptr);
+    REQUIRE(order_book_ptr->top_of_book().best_bid()->Price == 13);
+    REQUIRE(order_book_ptr->top_of_book().best_bid()->Volume == 10);
+    REQUIRE(order_book_ptr->top_of_book().best_ask()->Price == 20);
+}
+
+TEST_CASE("Top of the book (random)", "[CppTrader][Matching]")
+{
+    MarketHandler market_handler;
+    MarketManager market(market_handler);
+
+    Symbol symbol = { 0, "test" };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+    market.EnableMatching();
+    const OrderBook* order_book_ptr = market.GetOrderBook(0);
+
+    uint64_t seed = 42;
+    auto random = [&seed](uint64_t range) { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return (seed >> 33) % range; };
+
+    uint64_t id = 1;
+    for (int i = 0; i < 10000; ++i)
+    {
+        uint64_t victim = 1 + random(id);
+        const Order* order_ptr = market.GetOrder(victim);
+
+        switch (random(6))
+        {
+            case 0:
+                market.AddOrder(Order::BuyLimit(id++, 0, 90 + random(20), 1 + random(50)));
+                break;
+            case 1:
+                market.AddOrder(Order::SellLimit(id++, 0, 100 + random(20), 1 + random(50)));
+                break;
+            case 2:
+                market.AddOrder(Order::Limit(id++, 0, random(2) ? OrderSide::BUY : OrderSide::SELL, 95 + random(10), 100, OrderTimeInForce::GTC, 10));
+                break;
+            case 3:
+                if (order_ptr != nullptr)
+                    market.ReduceOrder(victim, 1 + random(order_ptr->LeavesQuantity));
+                break;
+            case 4:
+                if (order_ptr != nullptr)
+                    market.ModifyOrder(victim, 95 + random(10), 1 + random(50));
+                break;
+            default:
+                if (order_ptr != nullptr)
+                    market.DeleteOrder(victim);
+                break;
+        }
+
+        CheckTopOfBook(*order_book_ptr);
+    }
+}
+
+TEST_CASE("Top of the book concurrent readers", "[CppTrader][Matching]")
+{
+    MarketHandler market_handler;
+    MarketManager market(market_handler);
+
+    Symbol symbol = { 0, "test" };
+    market.AddSymbol(symbol);
+    market.AddOrderBook(symbol);
+    const OrderBook* order_book_ptr = market.GetOrderBook(0);
+
+    // Readers check that each polled top of the book is consistent
+    std::atomic<bool> running(true);
+    std::atomic<size_t> errors(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i)
+    {
+        readers.emplace_back([order_book_ptr, &running, &errors]()
+        {
+            uint64_t sequence = 0;
+            while (running.load(std::memory_order_acquire))
+            {
+                OrderBook::TopOfBook top = order_book_ptr->top_of_book();
+                bool valid = (top.Sequence >= sequence) && (top.BidLevels <= OrderBook::TopOfBook::DEPTH);
+                for (size_t j = 0; valid && (j < top.BidLevels); ++j)
+                {
+                    // All orders have the same quantity and better levels have higher prices
+                    valid = (top.Bids[j].Volume == top.Bids[j].Orders * 10) && ((j == 0) || (top.Bids[j].Price < top.Bids[j - 1].Price));
+                }
+                if (!valid)
+                    ++errors;
+                sequence = top.Sequence;
+            }
+        });
+    }
+
+    // Writer modifies bid price levels
+    uint64_t id = 1;
+    for (int i = 0; i < 100000; ++i)
+    {
+        market.AddOrder(Order::BuyLimit(id, 0, 100 + (id % 7), 10));
+        if (id > 20)
+            market.DeleteOrder(id - 20);
+        ++id;
+    }
+
+    running.store(false, std::memory_order_release);
+    for (auto& reader : readers)
+        reader.join();
+
+    REQUIRE(errors == 0);
+    CheckTopOfBook(*order_book_ptr);
+}